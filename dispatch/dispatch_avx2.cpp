@@ -0,0 +1,18 @@
+// Kernels targeting AVX2 and FMA (two entities per YMM register)
+
+#include "kernels.hpp"
+
+#if !defined(KLN_ENABLE_ISE_AVX2) || defined(KLN_ENABLE_ISE_AVX512)
+#    error "dispatch_avx2.cpp must be compiled for AVX2 only"
+#endif
+
+namespace kln
+{
+namespace dispatch
+{
+    namespace detail
+    {
+        kernel_table const avx2_kernels = make_kernels(isa::avx2);
+    }
+} // namespace dispatch
+} // namespace kln
@@ -0,0 +1,18 @@
+// Kernels targeting AVX-512F (four entities per ZMM register)
+
+#include "kernels.hpp"
+
+#ifndef KLN_ENABLE_ISE_AVX512
+#    error "dispatch_avx512.cpp must be compiled with AVX-512 enabled"
+#endif
+
+namespace kln
+{
+namespace dispatch
+{
+    namespace detail
+    {
+        kernel_table const avx512_kernels = make_kernels(isa::avx512);
+    }
+} // namespace dispatch
+} // namespace kln
@@ -0,0 +1,19 @@
+// Kernels targeting the baseline instruction set (SSE3)
+
+#include "kernels.hpp"
+
+#if defined(KLEIN_SSE_4_1) || defined(KLN_ENABLE_ISE_AVX2) \
+    || defined(KLN_ENABLE_ISE_AVX512)
+#    error "dispatch_sse3.cpp must be compiled for SSE3 only"
+#endif
+
+namespace kln
+{
+namespace dispatch
+{
+    namespace detail
+    {
+        kernel_table const sse3_kernels = make_kernels(isa::sse3);
+    }
+} // namespace dispatch
+} // namespace kln
@@ -0,0 +1,18 @@
+// Kernels targeting SSE4.1 (dot product instructions)
+
+#include "kernels.hpp"
+
+#if !defined(KLEIN_SSE_4_1) || defined(KLN_ENABLE_ISE_AVX2)
+#    error "dispatch_sse41.cpp must be compiled for SSE4.1 only"
+#endif
+
+namespace kln
+{
+namespace dispatch
+{
+    namespace detail
+    {
+        kernel_table const sse41_kernels = make_kernels(isa::sse41);
+    }
+} // namespace dispatch
+} // namespace kln
@@ -0,0 +1,41 @@
+// File: kernel_table.hpp
+// Purpose: Table of function pointers filled in once per instruction set by
+// the dispatch library.
+
+#pragma once
+
+#include "klein_dispatch.hpp"
+
+namespace kln
+{
+namespace dispatch
+{
+    namespace detail
+    {
+        struct kernel_table
+        {
+            isa set;
+            void (*motor_plane)(motor const&, plane const*, plane*, size_t);
+            void (*motor_line)(motor const&, line const*, line*, size_t);
+            void (*motor_point)(motor const&, point const*, point*, size_t);
+            void (*motor_direction)(motor const&,
+                                    direction const*,
+                                    direction*,
+                                    size_t);
+            void (*rotor_plane)(rotor const&, plane const*, plane*, size_t);
+            void (*rotor_line)(rotor const&, line const*, line*, size_t);
+            void (*rotor_point)(rotor const&, point const*, point*, size_t);
+            void (*rotor_direction)(rotor const&,
+                                    direction const*,
+                                    direction*,
+                                    size_t);
+        };
+
+        // One table per instruction set, defined in dispatch_<isa>.cpp
+        extern kernel_table const sse3_kernels;
+        extern kernel_table const sse41_kernels;
+        extern kernel_table const avx2_kernels;
+        extern kernel_table const avx512_kernels;
+    } // namespace detail
+} // namespace dispatch
+} // namespace kln
@@ -0,0 +1,120 @@
+// File: kernels.hpp
+// Purpose: Kernel definitions shared by the per-instruction-set translation
+// units of the dispatch library.
+//
+// Notes:
+// 1. This header is included by dispatch_sse3.cpp, dispatch_sse41.cpp,
+//    dispatch_avx2.cpp, and dispatch_avx512.cpp, each compiled with different
+//    architecture flags. The kernels are defined in an anonymous namespace so
+//    that every translation unit gets its own copy.
+// 2. The kernels must only call the KLN_INLINE routines in kln::detail.
+//    Ordinary inline functions (e.g. entity constructors) are emitted as weak
+//    symbols, and the linker is free to pick the copy compiled for the widest
+//    instruction set, which would fault on processors lacking it. This is
+//    also why the library is compiled with inlining enabled in every
+//    configuration (see CMakeLists.txt).
+
+#pragma once
+
+#include "kernel_table.hpp"
+
+namespace kln
+{
+namespace dispatch
+{
+    namespace detail
+    {
+        namespace
+        {
+            // The bodies below mirror the variadic operator() overloads of
+            // kln::motor and kln::rotor.
+
+            void motor_plane(motor const& m,
+                             plane const* in,
+                             plane* out,
+                             size_t count)
+            {
+                kln::detail::sw012<true, true>(
+                    &in->p0_, m.p1_, &m.p2_, &out->p0_, count);
+            }
+
+            void motor_line(motor const& m,
+                            line const* in,
+                            line* out,
+                            size_t count)
+            {
+                kln::detail::swMM<true, true, true>(
+                    &in->p1_, m.p1_, &m.p2_, &out->p1_, count);
+            }
+
+            void motor_point(motor const& m,
+                             point const* in,
+                             point* out,
+                             size_t count)
+            {
+                kln::detail::sw312<true, true>(
+                    &in->p3_, m.p1_, &m.p2_, &out->p3_, count);
+            }
+
+            void motor_direction(motor const& m,
+                                 direction const* in,
+                                 direction* out,
+                                 size_t count)
+            {
+                kln::detail::sw312<true, false>(
+                    &in->p3_, m.p1_, nullptr, &out->p3_, count);
+            }
+
+            void rotor_plane(rotor const& r,
+                             plane const* in,
+                             plane* out,
+                             size_t count)
+            {
+                kln::detail::sw012<true, false>(
+                    &in->p0_, r.p1_, nullptr, &out->p0_, count);
+            }
+
+            void rotor_line(rotor const& r,
+                            line const* in,
+                            line* out,
+                            size_t count)
+            {
+                kln::detail::swMM<true, false, true>(
+                    &in->p1_, r.p1_, nullptr, &out->p1_, count);
+            }
+
+            void rotor_point(rotor const& r,
+                             point const* in,
+                             point* out,
+                             size_t count)
+            {
+                // Conjugation of a plane and point with a rotor is identical
+                kln::detail::sw012<true, false>(
+                    &in->p3_, r.p1_, nullptr, &out->p3_, count);
+            }
+
+            void rotor_direction(rotor const& r,
+                                 direction const* in,
+                                 direction* out,
+                                 size_t count)
+            {
+                kln::detail::sw012<true, false>(
+                    &in->p3_, r.p1_, nullptr, &out->p3_, count);
+            }
+
+            constexpr kernel_table make_kernels(isa set)
+            {
+                return {set,
+                        motor_plane,
+                        motor_line,
+                        motor_point,
+                        motor_direction,
+                        rotor_plane,
+                        rotor_line,
+                        rotor_point,
+                        rotor_direction};
+            }
+        } // namespace
+    }     // namespace detail
+} // namespace dispatch
+} // namespace kln
@@ -0,0 +1,254 @@
+#include "kernel_table.hpp"
+
+#include <atomic>
+
+#ifdef _MSC_VER
+#    include <intrin.h>
+#else
+#    include <cpuid.h>
+#endif
+
+namespace kln
+{
+namespace dispatch
+{
+    namespace
+    {
+        struct cpu_features
+        {
+            bool sse3;
+            bool sse41;
+            bool avx2;
+            bool avx512;
+        };
+
+        void cpuid(int leaf, int subleaf, unsigned (&regs)[4]) noexcept
+        {
+#ifdef _MSC_VER
+            int out[4];
+            __cpuidex(out, leaf, subleaf);
+            for (size_t i = 0; i != 4; ++i)
+            {
+                regs[i] = static_cast<unsigned>(out[i]);
+            }
+#else
+            __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        }
+
+        // Extended control register 0 indicates which register files the OS
+        // saves and restores on a context switch.
+        unsigned long long xcr0() noexcept
+        {
+#ifdef _MSC_VER
+            return _xgetbv(0);
+#else
+            unsigned eax;
+            unsigned edx;
+            __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+        }
+
+        cpu_features detect() noexcept
+        {
+            // EAX, EBX, ECX, EDX
+            unsigned regs[4];
+            cpuid(0, 0, regs);
+            unsigned max_leaf = regs[0];
+
+            cpu_features out{};
+            cpuid(1, 0, regs);
+            out.sse3     = (regs[2] & (1u << 0)) != 0;
+            out.sse41    = out.sse3 && (regs[2] & (1u << 19)) != 0;
+            bool fma     = (regs[2] & (1u << 12)) != 0;
+            bool osxsave = (regs[2] & (1u << 27)) != 0;
+            bool avx     = (regs[2] & (1u << 28)) != 0;
+
+            if (!out.sse41 || !osxsave || !avx || !fma || max_leaf < 7)
+            {
+                return out;
+            }
+
+            // XMM and YMM state (bits 1 and 2) must be enabled by the OS, as
+            // well as opmask and ZMM state (bits 5, 6, and 7) for AVX-512
+            unsigned long long xcr = xcr0();
+            bool ymm_state         = (xcr & 0x6) == 0x6;
+            bool zmm_state         = (xcr & 0xe6) == 0xe6;
+
+            cpuid(7, 0, regs);
+            out.avx2   = ymm_state && (regs[1] & (1u << 5)) != 0;
+            out.avx512 = out.avx2 && zmm_state && (regs[1] & (1u << 16)) != 0;
+            return out;
+        }
+
+        cpu_features const& features() noexcept
+        {
+            static cpu_features const out = detect();
+            return out;
+        }
+
+        detail::kernel_table const* table_for(isa set) noexcept
+        {
+            switch (set)
+            {
+            case isa::sse3:
+                return &detail::sse3_kernels;
+            case isa::sse41:
+                return &detail::sse41_kernels;
+            case isa::avx2:
+                return &detail::avx2_kernels;
+            case isa::avx512:
+                return &detail::avx512_kernels;
+            }
+            return &detail::sse3_kernels;
+        }
+
+        detail::kernel_table const* select_widest() noexcept
+        {
+            cpu_features const& f = features();
+            if (f.avx512)
+            {
+                return &detail::avx512_kernels;
+            }
+            else if (f.avx2)
+            {
+                return &detail::avx2_kernels;
+            }
+            else if (f.sse41)
+            {
+                return &detail::sse41_kernels;
+            }
+            return &detail::sse3_kernels;
+        }
+
+        std::atomic<detail::kernel_table const*> active_table{nullptr};
+
+        detail::kernel_table const& kernels() noexcept
+        {
+            detail::kernel_table const* out
+                = active_table.load(std::memory_order_acquire);
+            if (out == nullptr)
+            {
+                // Concurrent first calls may each perform detection, but they
+                // all arrive at the same table.
+                out = select_widest();
+                active_table.store(out, std::memory_order_release);
+            }
+            return *out;
+        }
+    } // namespace
+
+    isa active_isa() noexcept
+    {
+        return kernels().set;
+    }
+
+    char const* isa_name(isa set) noexcept
+    {
+        switch (set)
+        {
+        case isa::sse3:
+            return "sse3";
+        case isa::sse41:
+            return "sse4.1";
+        case isa::avx2:
+            return "avx2";
+        case isa::avx512:
+            return "avx512";
+        }
+        return "unknown";
+    }
+
+    bool is_supported(isa set) noexcept
+    {
+        cpu_features const& f = features();
+        switch (set)
+        {
+        case isa::sse3:
+            return f.sse3;
+        case isa::sse41:
+            return f.sse41;
+        case isa::avx2:
+            return f.avx2;
+        case isa::avx512:
+            return f.avx512;
+        }
+        return false;
+    }
+
+    bool select_isa(isa set) noexcept
+    {
+        if (!is_supported(set))
+        {
+            return false;
+        }
+        active_table.store(table_for(set), std::memory_order_release);
+        return true;
+    }
+
+    void conjugate(motor const& m,
+                   plane const* in,
+                   plane* out,
+                   size_t count) noexcept
+    {
+        kernels().motor_plane(m, in, out, count);
+    }
+
+    void conjugate(motor const& m,
+                   line const* in,
+                   line* out,
+                   size_t count) noexcept
+    {
+        kernels().motor_line(m, in, out, count);
+    }
+
+    void conjugate(motor const& m,
+                   point const* in,
+                   point* out,
+                   size_t count) noexcept
+    {
+        kernels().motor_point(m, in, out, count);
+    }
+
+    void conjugate(motor const& m,
+                   direction const* in,
+                   direction* out,
+                   size_t count) noexcept
+    {
+        kernels().motor_direction(m, in, out, count);
+    }
+
+    void conjugate(rotor const& r,
+                   plane const* in,
+                   plane* out,
+                   size_t count) noexcept
+    {
+        kernels().rotor_plane(r, in, out, count);
+    }
+
+    void conjugate(rotor const& r,
+                   line const* in,
+                   line* out,
+                   size_t count) noexcept
+    {
+        kernels().rotor_line(r, in, out, count);
+    }
+
+    void conjugate(rotor const& r,
+                   point const* in,
+                   point* out,
+                   size_t count) noexcept
+    {
+        kernels().rotor_point(r, in, out, count);
+    }
+
+    void conjugate(rotor const& r,
+                   direction const* in,
+                   direction* out,
+                   size_t count) noexcept
+    {
+        kernels().rotor_direction(r, in, out, count);
+    }
+} // namespace dispatch
+} // namespace kln
@@ -0,0 +1,141 @@
+// File: klein_dispatch.hpp
+// Purpose: Runtime CPU dispatch for the batch (variadic) sandwich routines.
+//
+// Notes:
+// 1. The header-only entity types are compiled for whichever instruction set
+//    the including translation unit targets. The routines declared here are
+//    instead compiled once per instruction set in the klein_dispatch library,
+//    and the widest set supported by the running CPU and OS is selected the
+//    first time any of them is called.
+// 2. This header may be included from translation units targeting any
+//    instruction set (SSE3 or later).
+
+#pragma once
+
+#include <klein/direction.hpp>
+#include <klein/line.hpp>
+#include <klein/motor.hpp>
+#include <klein/plane.hpp>
+#include <klein/point.hpp>
+#include <klein/rotor.hpp>
+
+#include <cstddef>
+
+namespace kln
+{
+namespace dispatch
+{
+    /// \defgroup dispatch Runtime dispatch
+    ///
+    /// The batch conjugation routines below are equivalent to the variadic
+    /// `operator()` overloads of `kln::rotor` and `kln::motor` (e.g.
+    /// `motor::operator()(point* in, point* out, size_t count)`), but select
+    /// between SSE3, SSE4.1, AVX2/FMA, and AVX-512 kernels at runtime. This
+    /// permits shipping a single binary built for the lowest common
+    /// denominator while still exercising the widest vector units available.
+    ///
+    /// The routines are provided by the `klein::klein_dispatch` static library.
+    ///
+    /// !!! example
+    ///
+    ///     ```c++
+    ///         #include <klein_dispatch.hpp>
+    ///
+    ///         kln::motor m = /* ... */;
+    ///         std::vector<kln::point> points = /* ... */;
+    ///         kln::dispatch::conjugate(
+    ///             m, points.data(), points.data(), points.size());
+    ///
+    ///         // Log the kernel set in use
+    ///         std::printf("klein: %s\n",
+    ///                     kln::dispatch::isa_name(kln::dispatch::active_isa()));
+    ///     ```
+    ///
+    /// As with the member operators, `in` and `out` may only alias if they are
+    /// equal (in place application).
+
+    /// \addtogroup dispatch
+    /// @{
+
+    /// Instruction sets for which kernels are compiled, from narrowest to
+    /// widest.
+    enum class isa
+    {
+        sse3,
+        sse41,
+        avx2,
+        avx512
+    };
+
+    /// Returns the instruction set of the kernels currently in use. The first
+    /// call performs CPU feature detection if no kernel set has been selected
+    /// yet.
+    [[nodiscard]] isa active_isa() noexcept;
+
+    /// Returns a human-readable name for the instruction set (e.g. "avx2").
+    [[nodiscard]] char const* isa_name(isa set) noexcept;
+
+    /// Returns true if both the CPU and the operating system support the
+    /// instruction set.
+    [[nodiscard]] bool is_supported(isa set) noexcept;
+
+    /// Overrides the automatically selected kernel set, for example to compare
+    /// code paths or to work around a platform issue. Returns false and leaves
+    /// the selection unchanged if the instruction set is unsupported.
+    ///
+    /// !!! danger
+    ///
+    ///     This function is not synchronized with concurrent calls to the
+    ///     conjugation routines. Call it before spawning worker threads.
+    bool select_isa(isa set) noexcept;
+
+    /// Conjugates `count` planes with the motor `m`.
+    void conjugate(motor const& m,
+                   plane const* in,
+                   plane* out,
+                   size_t count) noexcept;
+
+    /// Conjugates `count` lines with the motor `m`.
+    void conjugate(motor const& m,
+                   line const* in,
+                   line* out,
+                   size_t count) noexcept;
+
+    /// Conjugates `count` points with the motor `m`.
+    void conjugate(motor const& m,
+                   point const* in,
+                   point* out,
+                   size_t count) noexcept;
+
+    /// Conjugates `count` directions with the motor `m`.
+    void conjugate(motor const& m,
+                   direction const* in,
+                   direction* out,
+                   size_t count) noexcept;
+
+    /// Conjugates `count` planes with the rotor `r`.
+    void conjugate(rotor const& r,
+                   plane const* in,
+                   plane* out,
+                   size_t count) noexcept;
+
+    /// Conjugates `count` lines with the rotor `r`.
+    void conjugate(rotor const& r,
+                   line const* in,
+                   line* out,
+                   size_t count) noexcept;
+
+    /// Conjugates `count` points with the rotor `r`.
+    void conjugate(rotor const& r,
+                   point const* in,
+                   point* out,
+                   size_t count) noexcept;
+
+    /// Conjugates `count` directions with the rotor `r`.
+    void conjugate(rotor const& r,
+                   direction const* in,
+                   direction* out,
+                   size_t count) noexcept;
+    /// @}
+} // namespace dispatch
+} // namespace kln
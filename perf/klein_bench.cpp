@@ -0,0 +1,604 @@
+// File: klein_bench.cpp
+// Purpose: Throughput benchmarks of the public Klein operations
+//
+// Usage:
+//     klein_bench [--filter=<substring>] [--min-time=<seconds>]
+//                 [--max-size=<count>] [--json=<path>]
+//
+// Every operation is timed over working sets of 1, 10, ..., 10^7 entities (up
+// to --max-size, which may be raised to 10^8 and beyond) and reported in ns
+// per entity and entities per second. Each result is labeled with the level of
+// the memory hierarchy its working set (inputs and outputs) fits in: L1, L2,
+// L3, or DRAM.
+//
+// Operations are measured in several modes:
+//     single   - the single-entity API called in a loop
+//     variadic - the batch call operators of motors and rotors
+//     batch    - the free batch routines and prepared forms
+//     parallel - the batch routines of kln::parallel on the default pool
+//     stream   - the non-temporal forms of the batch call operators
+//
+// The packed entities (point_f16, ...) are benchmarked in batch mode.
+//
+// With --json, the results are also written in a format modeled after Google
+// Benchmark's, for regression tracking.
+
+#include <klein/klein.hpp>
+#include <klein/parallel.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#    include <unistd.h>
+#endif
+
+using namespace kln;
+
+namespace
+{
+#if defined(__GNUC__) || defined(__clang__)
+// Forces the compiler to assume the memory at p is read and written
+void escape(void const* p)
+{
+    asm volatile("" : : "g"(p) : "memory");
+}
+#else
+void const* volatile sink;
+
+void escape(void const* p)
+{
+    sink = p;
+}
+#endif
+
+char const* isa()
+{
+#if defined(KLN_ENABLE_ISE_AVX512)
+    return "avx512";
+#elif defined(KLN_ENABLE_ISE_AVX2)
+    return "avx2";
+#elif defined(KLEIN_SSE_4_1)
+    return "sse4.1";
+#else
+    return "sse3";
+#endif
+}
+
+struct cache_sizes
+{
+    size_t l1 = 32 << 10;
+    size_t l2 = 1 << 20;
+    size_t l3 = 32 << 20;
+};
+
+cache_sizes query_cache_sizes()
+{
+    cache_sizes out;
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+    long l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (l1 > 0)
+    {
+        out.l1 = static_cast<size_t>(l1);
+    }
+    if (l2 > 0)
+    {
+        out.l2 = static_cast<size_t>(l2);
+    }
+    if (l3 > 0)
+    {
+        out.l3 = static_cast<size_t>(l3);
+    }
+#endif
+    return out;
+}
+
+struct result
+{
+    std::string name;
+    char const* mode;
+    size_t size;
+    size_t bytes;
+    char const* regime;
+    size_t iterations;
+    double ns_per_op;
+    double ops_per_second;
+};
+
+class runner
+{
+public:
+    double min_time = 0.1;
+    size_t max_size = 10000000;
+    std::string filter;
+    cache_sizes caches = query_cache_sizes();
+    std::vector<result> results;
+
+    [[nodiscard]] bool enabled(char const* name, char const* mode) const
+    {
+        std::string full = std::string{name} + '/' + mode;
+        return filter.empty() || full.find(filter) != std::string::npos;
+    }
+
+    [[nodiscard]] std::vector<size_t> sizes() const
+    {
+        std::vector<size_t> out;
+        for (size_t n = 1; n <= max_size; n *= 10)
+        {
+            out.push_back(n);
+        }
+        return out;
+    }
+
+    // Times pass, which processes n entities touching bytes bytes of memory
+    // in all, and records the result
+    template <typename F>
+    void measure(char const* name,
+                 char const* mode,
+                 size_t n,
+                 size_t bytes,
+                 F&& pass)
+    {
+        using clock = std::chrono::steady_clock;
+
+        // Warm up the caches (and the branch predictors) with a first pass
+        pass();
+
+        // Grow the number of passes per timing until the timing is long enough
+        // for the clock overhead not to matter
+        size_t iterations = 1;
+        double elapsed    = 0.0;
+        while (true)
+        {
+            auto start = clock::now();
+            for (size_t i = 0; i != iterations; ++i)
+            {
+                pass();
+            }
+            std::chrono::duration<double> d = clock::now() - start;
+            elapsed                         = d.count();
+            if (elapsed >= min_time || iterations >= (size_t{1} << 40))
+            {
+                break;
+            }
+            double scale = elapsed > 0.0 ? 1.4 * min_time / elapsed : 10.0;
+            iterations   = static_cast<size_t>(
+                static_cast<double>(iterations) * std::clamp(scale, 2.0, 10.0));
+        }
+
+        result r;
+        r.name       = name;
+        r.mode       = mode;
+        r.size       = n;
+        r.bytes      = bytes;
+        r.regime     = bytes <= caches.l1   ? "L1"
+                       : bytes <= caches.l2 ? "L2"
+                       : bytes <= caches.l3 ? "L3"
+                                            : "DRAM";
+        r.iterations = iterations;
+        double ops   = static_cast<double>(iterations) * static_cast<double>(n);
+        r.ns_per_op  = elapsed * 1e9 / ops;
+        r.ops_per_second = ops / elapsed;
+        results.push_back(r);
+
+        std::printf("%-26s %-8s %9zu %-4s %10.3f ns/op %12.4g ops/s\n",
+                    name,
+                    mode,
+                    n,
+                    r.regime,
+                    r.ns_per_op,
+                    r.ops_per_second);
+        std::fflush(stdout);
+    }
+
+    void write_json(char const* path) const
+    {
+        std::FILE* f = std::fopen(path, "w");
+        if (!f)
+        {
+            std::fprintf(stderr, "Unable to open %s\n", path);
+            return;
+        }
+
+        std::fprintf(f, "{\n  \"context\": {\n");
+        std::fprintf(f, "    \"library\": \"klein\",\n");
+        std::fprintf(f, "    \"isa\": \"%s\",\n", isa());
+        std::fprintf(f, "    \"min_time\": %g,\n", min_time);
+        std::fprintf(f,
+                     "    \"caches\": "
+                     "{\"L1\": %zu, \"L2\": %zu, \"L3\": %zu}\n",
+                     caches.l1,
+                     caches.l2,
+                     caches.l3);
+        std::fprintf(f, "  },\n  \"benchmarks\": [\n");
+        for (size_t i = 0; i != results.size(); ++i)
+        {
+            result const& r = results[i];
+            std::fprintf(f,
+                         "    {\"name\": \"%s/%s/%zu\", \"op\": \"%s\", "
+                         "\"mode\": \"%s\", \"size\": %zu, \"bytes\": %zu, "
+                         "\"regime\": \"%s\", \"iterations\": %zu, "
+                         "\"time_unit\": \"ns\", \"ns_per_op\": %.6g, "
+                         "\"items_per_second\": %.6g}%s\n",
+                         r.name.c_str(),
+                         r.mode,
+                         r.size,
+                         r.name.c_str(),
+                         r.mode,
+                         r.size,
+                         r.bytes,
+                         r.regime,
+                         r.iterations,
+                         r.ns_per_op,
+                         r.ops_per_second,
+                         i + 1 == results.size() ? "" : ",");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        std::fclose(f);
+    }
+};
+
+// The extent of the translations of packed motors
+constexpr float packed_extent = 16.f;
+
+// Random inputs. Motors and rotors are normalized, and points are normalized
+// and lie within a few units of the origin.
+struct generator
+{
+    std::mt19937 rng{1};
+
+    float uniform(float lo, float hi)
+    {
+        return std::uniform_real_distribution<float>{lo, hi}(rng);
+    }
+
+    void operator()(rotor& out)
+    {
+        out = rotor{uniform(-3.f, 3.f),
+                    uniform(-1.f, 1.f),
+                    uniform(-1.f, 1.f),
+                    uniform(0.1f, 1.f)};
+    }
+
+    void operator()(translator& out)
+    {
+        out = translator{uniform(0.1f, 5.f),
+                         uniform(-1.f, 1.f),
+                         uniform(-1.f, 1.f),
+                         uniform(0.1f, 1.f)};
+    }
+
+    void operator()(motor& out)
+    {
+        rotor r;
+        translator t;
+        (*this)(r);
+        (*this)(t);
+        out = t * r;
+    }
+
+    void operator()(point& out)
+    {
+        out = point{uniform(-5.f, 5.f), uniform(-5.f, 5.f), uniform(-5.f, 5.f)};
+    }
+
+    void operator()(plane& out)
+    {
+        out = plane{uniform(-1.f, 1.f),
+                    uniform(-1.f, 1.f),
+                    uniform(0.1f, 1.f),
+                    uniform(-5.f, 5.f)};
+    }
+
+    void operator()(line& out)
+    {
+        point a;
+        point b;
+        (*this)(a);
+        (*this)(b);
+        out = a & b;
+    }
+
+    void operator()(mat3x4& out)
+    {
+        motor m;
+        (*this)(m);
+        out = m.as_mat3x4();
+    }
+
+    void operator()(point_f16& out)
+    {
+        out = pack(make<point>());
+    }
+
+    void operator()(motor_q16& out)
+    {
+        out = pack(make<motor>(), packed_extent);
+    }
+
+    template <typename T>
+    T make()
+    {
+        T out;
+        (*this)(out);
+        return out;
+    }
+};
+
+// Benchmarks f(in, out, n) mapping n entities of type In to n of type Out,
+// where Out may be an array type for routines writing several values per
+// entity
+template <typename In, typename Out, size_t OutCount = 1, typename F>
+void bench(runner& r, char const* name, char const* mode, F&& f)
+{
+    if (!r.enabled(name, mode))
+    {
+        return;
+    }
+
+    generator gen;
+    for (size_t n : r.sizes())
+    {
+        std::vector<In> in(n);
+        std::vector<Out> out(n * OutCount);
+        for (In& x : in)
+        {
+            gen(x);
+        }
+
+        r.measure(name,
+                  mode,
+                  n,
+                  n * (sizeof(In) + OutCount * sizeof(Out)),
+                  [&] {
+                      f(in.data(), out.data(), n);
+                      escape(out.data());
+                  });
+    }
+}
+
+// Benchmarks the single-entity operation f over n entities
+template <typename In, typename Out, typename F>
+void bench_single(runner& r, char const* name, F&& f)
+{
+    bench<In, Out>(r, name, "single", [&](In* in, Out* out, size_t n) {
+        for (size_t i = 0; i != n; ++i)
+        {
+            out[i] = f(in[i]);
+        }
+    });
+}
+
+void bench_products(runner& r)
+{
+    generator gen;
+    auto m = gen.make<motor>();
+    auto q = gen.make<rotor>();
+    auto p = gen.make<plane>();
+    auto x = gen.make<point>();
+    auto l = gen.make<line>();
+
+    bench_single<motor, motor>(r, "motor*motor", [=](motor a) {
+        return a * m;
+    });
+    bench_single<rotor, rotor>(r, "rotor*rotor", [=](rotor a) {
+        return a * q;
+    });
+    bench_single<plane, line>(r, "plane^plane", [=](plane a) { return a ^ p; });
+    bench_single<line, point>(r, "line^plane", [=](line a) { return a ^ p; });
+    bench_single<point, line>(r, "point&point", [=](point a) { return a & x; });
+    bench_single<point, plane>(r, "point&line", [=](point a) { return a & l; });
+}
+
+template <typename T>
+void bench_sandwich(runner& r, char const* name)
+{
+    generator gen;
+    auto m = gen.make<motor>();
+    auto q = gen.make<rotor>();
+
+    std::string motor_name = std::string{"motor("} + name + ')';
+    std::string rotor_name = std::string{"rotor("} + name + ')';
+    auto motor_batch       = [=](T* in, T* out, size_t n) { m(in, out, n); };
+    auto rotor_batch       = [=](T* in, T* out, size_t n) { q(in, out, n); };
+    auto motor_stream      = [=](T* in, T* out, size_t n) {
+        m(in, out, n, non_temporal{});
+    };
+    auto rotor_stream = [=](T* in, T* out, size_t n) {
+        q(in, out, n, non_temporal{});
+    };
+
+    bench_single<T, T>(r, motor_name.c_str(), [=](T a) { return m(a); });
+    bench<T, T>(r, motor_name.c_str(), "variadic", motor_batch);
+    bench<T, T>(r, motor_name.c_str(), "stream", motor_stream);
+    bench_single<T, T>(r, rotor_name.c_str(), [=](T a) { return q(a); });
+    bench<T, T>(r, rotor_name.c_str(), "variadic", rotor_batch);
+    bench<T, T>(r, rotor_name.c_str(), "stream", rotor_stream);
+}
+
+void bench_transforms(runner& r)
+{
+    bench_sandwich<point>(r, "point");
+    bench_sandwich<plane>(r, "plane");
+    bench_sandwich<line>(r, "line");
+
+    generator gen;
+    motor m = gen.make<motor>();
+    prepared_motor prepared{m};
+    mat4x4 mat = gen.make<motor>().as_mat4x4();
+
+    auto prepared_points = [=](point* in, point* out, size_t n) {
+        prepared(in, out, n);
+    };
+    auto prepared_lines = [=](line* in, line* out, size_t n) {
+        prepared(in, out, n);
+    };
+    auto mat_points = [=](point* in, point* out, size_t n) {
+        apply(mat, in, out, n);
+    };
+    auto parallel_points = [=](point* in, point* out, size_t n) {
+        parallel::apply(m, in, out, n);
+    };
+    bench<point, point>(r, "motor(point)", "parallel", parallel_points);
+    bench<point, point>(r, "prepared_motor(point)", "batch", prepared_points);
+    bench<line, line>(r, "prepared_motor(line)", "batch", prepared_lines);
+    bench<point, point>(r, "mat4x4(point)", "batch", mat_points);
+}
+
+void bench_exp_log(runner& r)
+{
+    auto log_batch = [](motor* in, line* out, size_t n) { log(in, out, n); };
+    auto exp_batch = [](line* in, motor* out, size_t n) { exp(in, out, n); };
+
+    auto log_parallel = [](motor* in, line* out, size_t n) {
+        parallel::log(in, out, n);
+    };
+
+    bench_single<motor, line>(r, "log(motor)", [](motor a) { return log(a); });
+    bench<motor, line>(r, "log(motor)", "batch", log_batch);
+    bench<motor, line>(r, "log(motor)", "parallel", log_parallel);
+    bench_single<line, motor>(r, "exp(line)", [](line a) { return exp(a); });
+    bench<line, motor>(r, "exp(line)", "batch", exp_batch);
+}
+
+void bench_normalize(runner& r)
+{
+    bench_single<motor, motor>(
+        r, "motor::normalized", [](motor a) { return a.normalized(); });
+    bench_single<plane, plane>(
+        r, "plane::normalized", [](plane a) { return a.normalized(); });
+    bench_single<line, line>(
+        r, "line::normalized", [](line a) { return a.normalized(); });
+    bench_single<point, point>(
+        r, "point::normalized", [](point a) { return a.normalized(); });
+}
+
+void bench_matrix(runner& r)
+{
+    auto to_mat3x4 = [](motor* in, mat3x4* out, size_t n) {
+        as_mat3x4(in, out, n);
+    };
+    auto to_mat4x4 = [](motor* in, mat4x4* out, size_t n) {
+        as_mat4x4(in, out, n);
+    };
+    auto to_packed = [](motor* in, float* out, size_t n) {
+        as_packed3x4(in, out, n);
+    };
+    auto from_mat = [](mat3x4* in, motor* out, size_t n) {
+        from_mat3x4(in, out, n);
+    };
+
+    bench_single<motor, mat3x4>(
+        r, "motor::as_mat3x4", [](motor a) { return a.as_mat3x4(); });
+    bench<motor, mat3x4>(r, "motor::as_mat3x4", "batch", to_mat3x4);
+    bench_single<motor, mat4x4>(
+        r, "motor::as_mat4x4", [](motor a) { return a.as_mat4x4(); });
+    bench<motor, mat4x4>(r, "motor::as_mat4x4", "batch", to_mat4x4);
+    bench<motor, float, 12>(r, "as_packed3x4", "batch", to_packed);
+    bench_single<mat3x4, motor>(r, "motor::from_mat3x4", [](mat3x4 const& a) {
+        return motor::from_mat3x4(a);
+    });
+    bench<mat3x4, motor>(r, "motor::from_mat3x4", "batch", from_mat);
+}
+
+void bench_packed(runner& r)
+{
+    generator gen;
+    motor m = gen.make<motor>();
+
+    auto pack_points = [](point* in, point_f16* out, size_t n) {
+        pack(in, out, n);
+    };
+    auto unpack_points = [](point_f16* in, point* out, size_t n) {
+        unpack(in, out, n);
+    };
+    auto unpack_motors = [](motor_q16* in, motor* out, size_t n) {
+        unpack(in, out, n, packed_extent);
+    };
+
+    // Packed points are transformed a block at a time through a buffer that
+    // stays in L1
+    auto transform_points = [=](point_f16* in, point_f16* out, size_t n) {
+        constexpr size_t block_size = 256;
+        point block[block_size];
+        for (size_t i = 0; i < n; i += block_size)
+        {
+            size_t count = std::min(block_size, n - i);
+            unpack(in + i, block, count);
+            m(block, block, count);
+            pack(block, out + i, count);
+        }
+    };
+
+    bench<point, point_f16>(r, "pack(point)", "batch", pack_points);
+    bench<point_f16, point>(r, "unpack(point_f16)", "batch", unpack_points);
+    bench<motor_q16, motor>(r, "unpack(motor_q16)", "batch", unpack_motors);
+    bench<point_f16, point_f16>(
+        r, "motor(point_f16)", "batch", transform_points);
+}
+
+void usage()
+{
+    std::printf(
+        "Usage: klein_bench [--filter=<substring>] [--min-time=<seconds>]\n"
+        "                   [--max-size=<count>] [--json=<path>]\n");
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    runner r;
+    char const* json = nullptr;
+    for (int i = 1; i != argc; ++i)
+    {
+        char const* arg = argv[i];
+        if (std::strncmp(arg, "--filter=", 9) == 0)
+        {
+            r.filter = arg + 9;
+        }
+        else if (std::strncmp(arg, "--min-time=", 11) == 0)
+        {
+            r.min_time = std::atof(arg + 11);
+        }
+        else if (std::strncmp(arg, "--max-size=", 11) == 0)
+        {
+            r.max_size = static_cast<size_t>(std::atof(arg + 11));
+        }
+        else if (std::strncmp(arg, "--json=", 7) == 0)
+        {
+            json = arg + 7;
+        }
+        else
+        {
+            usage();
+            return std::strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    std::printf("klein %s, L1 %zu KiB, L2 %zu KiB, L3 %zu KiB\n",
+                isa(),
+                r.caches.l1 >> 10,
+                r.caches.l2 >> 10,
+                r.caches.l3 >> 10);
+
+    bench_products(r);
+    bench_transforms(r);
+    bench_exp_log(r);
+    bench_normalize(r);
+    bench_matrix(r);
+    bench_packed(r);
+
+    if (json)
+    {
+        r.write_json(json);
+    }
+    return 0;
+}
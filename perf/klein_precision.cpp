@@ -0,0 +1,387 @@
+// File: klein_precision.cpp
+// Purpose: Accuracy and throughput of the reciprocal and square root
+// approximations at each kln::precision
+//
+// Usage:
+//     klein_precision [--samples=<count>] [--min-time=<seconds>]
+//                     [--json=<path>]
+//
+// Each routine (reciprocal, reciprocal square root, square root) is evaluated
+// at each precision over inputs swept across several ranges of float
+// exponents, with --samples evenly spaced inputs per binade. The error of
+// every result is measured in units in the last place (ULP) of the correctly
+// rounded result, computed in double precision, and the maximum and mean
+// errors are reported per range. The throughput of each routine is measured
+// over a buffer resident in L1. The normalization of motors at each precision
+// is measured the same way, its error being that of the norm of the result.
+//
+// Build the executable once per instruction set target to compare backends.
+
+#include <klein/klein.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace kln;
+
+namespace
+{
+#if defined(__GNUC__) || defined(__clang__)
+// Forces the compiler to assume the memory at p is read and written
+void escape(void const* p)
+{
+    asm volatile("" : : "g"(p) : "memory");
+}
+#else
+void const* volatile sink;
+
+void escape(void const* p)
+{
+    sink = p;
+}
+#endif
+
+char const* isa()
+{
+#if defined(KLN_ENABLE_ISE_AVX512)
+    return "avx512";
+#elif defined(KLN_ENABLE_ISE_AVX2)
+    return "avx2";
+#elif defined(KLEIN_SSE_4_1)
+    return "sse4.1";
+#else
+    return "sse3";
+#endif
+}
+
+char const* name(precision p)
+{
+    switch (p)
+    {
+        case precision::fast:
+            return "fast";
+        case precision::refined:
+            return "refined";
+        default:
+            return "exact";
+    }
+}
+
+// Inputs of a range span the binades [2^lo, 2^hi)
+struct range
+{
+    char const* name;
+    int lo;
+    int hi;
+};
+
+// The extreme binades are left out: the reciprocal of an input near the
+// largest float is denormal, which the estimates flush to zero.
+constexpr range ranges[] = {{"tiny", -120, -32},
+                            {"small", -32, -1},
+                            {"unit", -1, 1},
+                            {"large", 1, 32},
+                            {"huge", 32, 120}};
+
+struct result
+{
+    std::string routine;
+    char const* precision;
+    char const* range;
+    double max_ulp;
+    double mean_ulp;
+    double ns_per_op;
+};
+
+// The size of an ULP of the float nearest to x
+double ulp(double x)
+{
+    float f = static_cast<float>(std::fabs(x));
+    return static_cast<double>(std::nextafter(f, INFINITY)) - f;
+}
+
+class harness
+{
+public:
+    size_t samples  = 1 << 14;
+    double min_time = 0.1;
+    std::vector<result> results;
+
+    // Measures the error of f, which maps 4 floats to 4 floats, against the
+    // double precision reference ref, then the throughput of f
+    template <typename F, typename R>
+    void run(char const* routine, precision p, F&& f, R&& ref)
+    {
+        for (range const& r : ranges)
+        {
+            double max_ulp = 0.0;
+            double sum_ulp = 0.0;
+            size_t count   = 0;
+            for (int e = r.lo; e != r.hi; ++e)
+            {
+                float base = std::ldexp(1.f, e);
+                for (size_t i = 0; i < samples; i += 4)
+                {
+                    alignas(16) float in[4];
+                    alignas(16) float out[4];
+                    for (size_t j = 0; j != 4; ++j)
+                    {
+                        in[j] = base
+                                + base * static_cast<float>(i + j)
+                                      / static_cast<float>(samples);
+                    }
+                    _mm_store_ps(out, f(_mm_load_ps(in)));
+                    for (size_t j = 0; j != 4; ++j)
+                    {
+                        double expected = ref(static_cast<double>(in[j]));
+                        double error    = std::fabs(out[j] - expected)
+                                       / ulp(expected);
+                        max_ulp = std::max(max_ulp, error);
+                        sum_ulp += error;
+                        ++count;
+                    }
+                }
+            }
+
+            result res;
+            res.routine   = routine;
+            res.precision = name(p);
+            res.range     = r.name;
+            res.max_ulp   = max_ulp;
+            res.mean_ulp  = sum_ulp / static_cast<double>(count);
+            res.ns_per_op = throughput(f);
+            results.push_back(res);
+            print(res);
+        }
+    }
+
+    // Measures the deviation from one of the norm of normalized motors
+    template <precision P>
+    void run_motor_normalize()
+    {
+        std::mt19937 rng{1};
+        std::uniform_real_distribution<float> dist{-4.f, 4.f};
+        std::vector<motor> in(1024);
+        for (motor& m : in)
+        {
+            m = motor{dist(rng),
+                      dist(rng),
+                      dist(rng),
+                      dist(rng),
+                      dist(rng),
+                      dist(rng),
+                      dist(rng),
+                      dist(rng)};
+        }
+
+        double max_ulp = 0.0;
+        double sum_ulp = 0.0;
+        for (motor const& m : in)
+        {
+            float b[4];
+            _mm_storeu_ps(b, m.normalized<P>().p1_);
+            double norm = 0.0;
+            for (size_t i = 0; i != 4; ++i)
+            {
+                norm += static_cast<double>(b[i]) * b[i];
+            }
+            // The norm of a motor is that of its rotor part
+            double error = std::fabs(std::sqrt(norm) - 1.0) / ulp(1.0);
+            max_ulp      = std::max(max_ulp, error);
+            sum_ulp += error;
+        }
+
+        std::vector<motor> out(in.size());
+        auto pass = [&] {
+            for (size_t i = 0; i != in.size(); ++i)
+            {
+                out[i] = in[i].normalized<P>();
+            }
+            escape(out.data());
+        };
+
+        result res;
+        res.routine   = "motor::normalize";
+        res.precision = name(P);
+        res.range     = "random";
+        res.max_ulp   = max_ulp;
+        res.mean_ulp  = sum_ulp / static_cast<double>(in.size());
+        res.ns_per_op = time(pass) / static_cast<double>(in.size());
+        results.push_back(res);
+        print(res);
+    }
+
+    void write_json(char const* path) const
+    {
+        std::FILE* f = std::fopen(path, "w");
+        if (!f)
+        {
+            std::fprintf(stderr, "Unable to open %s\n", path);
+            return;
+        }
+
+        std::fprintf(f, "{\n  \"context\": {\n");
+        std::fprintf(f, "    \"library\": \"klein\",\n");
+        std::fprintf(f, "    \"isa\": \"%s\",\n", isa());
+        std::fprintf(f, "    \"samples_per_binade\": %zu\n", samples);
+        std::fprintf(f, "  },\n  \"results\": [\n");
+        for (size_t i = 0; i != results.size(); ++i)
+        {
+            result const& r = results[i];
+            std::fprintf(f,
+                         "    {\"routine\": \"%s\", \"precision\": \"%s\", "
+                         "\"range\": \"%s\", \"max_ulp\": %.6g, "
+                         "\"mean_ulp\": %.6g, \"ns_per_op\": %.6g}%s\n",
+                         r.routine.c_str(),
+                         r.precision,
+                         r.range,
+                         r.max_ulp,
+                         r.mean_ulp,
+                         r.ns_per_op,
+                         i + 1 == results.size() ? "" : ",");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        std::fclose(f);
+    }
+
+private:
+    static void print(result const& r)
+    {
+        std::printf("%-18s %-8s %-7s %12.4g max ulp %12.4g mean ulp %8.3f "
+                    "ns/op\n",
+                    r.routine.c_str(),
+                    r.precision,
+                    r.range,
+                    r.max_ulp,
+                    r.mean_ulp,
+                    r.ns_per_op);
+        std::fflush(stdout);
+    }
+
+    // Seconds per call of pass, grown until the timing is long enough for the
+    // clock overhead not to matter
+    template <typename F>
+    double time(F&& pass) const
+    {
+        using clock = std::chrono::steady_clock;
+
+        pass();
+        size_t iterations = 1;
+        while (true)
+        {
+            auto start = clock::now();
+            for (size_t i = 0; i != iterations; ++i)
+            {
+                pass();
+            }
+            std::chrono::duration<double> d = clock::now() - start;
+            if (d.count() >= min_time || iterations >= (size_t{1} << 40))
+            {
+                return d.count() * 1e9 / static_cast<double>(iterations);
+            }
+            iterations *= 2;
+        }
+    }
+
+    // Nanoseconds per float of f applied to a buffer of inputs in [0.5, 2)
+    template <typename F>
+    double throughput(F&& f) const
+    {
+        constexpr size_t count = 4096;
+        alignas(16) static float buffer[count];
+        for (size_t i = 0; i != count; ++i)
+        {
+            buffer[i] = 0.5f + 1.5f * static_cast<float>(i) / count;
+        }
+
+        auto pass = [&] {
+            for (size_t i = 0; i != count; i += 4)
+            {
+                _mm_store_ps(buffer + i, f(_mm_load_ps(buffer + i)));
+            }
+            escape(buffer);
+        };
+        // The routines are applied in place, so the inputs drift. Restoring
+        // them between timings is unnecessary as long as they remain normal,
+        // which repeated reciprocals and square roots of [0.5, 2) do.
+        return time(pass) / count;
+    }
+};
+
+template <precision P>
+void run_routines(harness& h)
+{
+    h.run(
+        "reciprocal",
+        P,
+        [](__m128 a) { return detail::reciprocal<P>(a); },
+        [](double x) { return 1.0 / x; });
+    h.run(
+        "reciprocal_sqrt",
+        P,
+        [](__m128 a) { return detail::reciprocal_sqrt<P>(a); },
+        [](double x) { return 1.0 / std::sqrt(x); });
+    h.run(
+        "square_root",
+        P,
+        [](__m128 a) { return detail::square_root<P>(a); },
+        [](double x) { return std::sqrt(x); });
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    harness h;
+    char const* json = nullptr;
+
+    for (int i = 1; i != argc; ++i)
+    {
+        char const* arg = argv[i];
+        if (std::strncmp(arg, "--samples=", 10) == 0)
+        {
+            size_t samples = std::strtoull(arg + 10, nullptr, 10);
+            h.samples      = std::max<size_t>(samples, 4);
+        }
+        else if (std::strncmp(arg, "--min-time=", 11) == 0)
+        {
+            h.min_time = std::atof(arg + 11);
+        }
+        else if (std::strncmp(arg, "--json=", 7) == 0)
+        {
+            json = arg + 7;
+        }
+        else
+        {
+            std::fprintf(stderr,
+                         "Usage: %s [--samples=<count>] [--min-time=<seconds>] "
+                         "[--json=<path>]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    std::printf("klein precision (%s), %zu samples per binade\n",
+                isa(),
+                h.samples);
+
+    run_routines<precision::fast>(h);
+    run_routines<precision::refined>(h);
+    run_routines<precision::exact>(h);
+
+    h.run_motor_normalize<precision::fast>();
+    h.run_motor_normalize<precision::refined>();
+    h.run_motor_normalize<precision::exact>();
+
+    if (json)
+    {
+        h.write_json(json);
+    }
+    return 0;
+}
@@ -0,0 +1,777 @@
+#pragma once
+
+#include "culling.hpp"
+#include "line.hpp"
+#include "point.hpp"
+#include "raycast.hpp"
+
+#include "detail/soa.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace kln
+{
+namespace parallel
+{
+    class thread_pool;
+}
+
+/// \defgroup bvh Bounding volume hierarchy
+/// @{
+///
+/// A bounding volume hierarchy over primitives given by their axis-aligned
+/// bounding boxes. A box is the intersection of three slabs, each bounded by
+/// a pair of parallel planes $x = x_\text{min}$ and $x = x_\text{max}$ (and
+/// likewise in $y$ and $z$). A ray line meets the two planes of a slab at two
+/// points, and passes through the box if the intervals between the meets of
+/// the three slabs overlap. Since the planes are axis-aligned, each meet
+/// reduces to a single multiply-add per plane.
+///
+/// The hierarchy is built top-down with the surface area heuristic (SAH),
+/// evaluated over a fixed number of bins of the primitive centroids along each
+/// axis. Nodes are stored flattened in depth-first order in 32 byte records,
+/// two to a cache line: the first child of an interior node immediately follows
+/// it, and the node stores the index of its second child. Leaves refer to a
+/// contiguous run of the primitive order produced by the builder.
+///
+/// The constructor builds the hierarchy on the calling thread. A second
+/// constructor, defined in `parallel.hpp` (which `klein.hpp` does not
+/// include), spreads the build across the threads of a
+/// `parallel::thread_pool` and produces the same hierarchy.
+///
+/// Queries traverse the tree for packets of four (or eight when
+/// `KLN_ENABLE_ISE_AVX2` is defined) rays or points at a time in
+/// structure-of-arrays form, descending into a node if any member of the
+/// packet may touch it. Visibility queries against a `plane_set` stop
+/// testing a plane below any node entirely on its positive side.
+///
+/// All storage is owned by the caller. The primitive bounds passed on
+/// construction are referenced by the queries and must outlive the
+/// hierarchy.
+///
+/// !!! example
+///
+///     ```cpp
+///         kln::bounding_box bounds[triangle_count];
+///         kln::triangle_bounds(vertices, indices, triangle_count, bounds);
+///
+///         kln::bvh_node nodes[kln::bvh::node_capacity(triangle_count)];
+///         uint32_t order[triangle_count];
+///         kln::bvh tree{bounds, triangle_count, nodes, order};
+///
+///         tree.intersect(records, origins, rays, hits, ray_count);
+///     ```
+
+/// \ingroup bvh
+struct bounding_box
+{
+    float min[3];
+    float max[3];
+
+    /// Half the surface area
+    [[nodiscard]] float half_area() const noexcept
+    {
+        float dx = max[0] - min[0];
+        float dy = max[1] - min[1];
+        float dz = max[2] - min[2];
+        return dx * dy + dy * dz + dz * dx;
+    }
+
+    void extend(bounding_box const& other) noexcept
+    {
+        for (size_t i = 0; i != 3; ++i)
+        {
+            min[i] = std::min(min[i], other.min[i]);
+            max[i] = std::max(max[i], other.max[i]);
+        }
+    }
+
+    /// An empty box, which any call to `extend` replaces
+    [[nodiscard]] static bounding_box empty() noexcept
+    {
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        return {{inf, inf, inf}, {-inf, -inf, -inf}};
+    }
+};
+
+/// \ingroup bvh
+struct bvh_node
+{
+    /// Flag set in `count` of an interior node
+    static constexpr uint32_t interior = 0x80000000;
+
+    float min[3];
+
+    /// Index into the primitive order of the first primitive of a leaf, or
+    /// the index of the second child of an interior node
+    uint32_t offset;
+
+    float max[3];
+
+    /// Number of primitives of a leaf. For an interior node, `interior` plus
+    /// the axis (0, 1, or 2) along which its children were split.
+    uint32_t count;
+
+    [[nodiscard]] bool is_leaf() const noexcept
+    {
+        return (count & interior) == 0;
+    }
+};
+
+static_assert(sizeof(bvh_node) == 32, "bvh_node must fill half a cache line");
+
+/// \ingroup bvh
+///
+/// Returns the bounds of the `count` normalized points in `points`.
+inline bounding_box bounds(point const* points, size_t count) noexcept
+{
+    bounding_box out = bounding_box::empty();
+    for (size_t i = 0; i != count; ++i)
+    {
+        float p[3] = {points[i].x(), points[i].y(), points[i].z()};
+        out.extend({{p[0], p[1], p[2]}, {p[0], p[1], p[2]}});
+    }
+    return out;
+}
+
+/// \ingroup bvh
+///
+/// Writes the bounds of the `count` triangles whose vertices are
+/// `vertices[indices[3 * i + k]]` for `k` in `[0, 3)` to `out`.
+inline void triangle_bounds(point const* vertices,
+                            uint32_t const* indices,
+                            size_t count,
+                            bounding_box* out) noexcept
+{
+    for (size_t i = 0; i != count; ++i)
+    {
+        point p[3] = {vertices[indices[3 * i]],
+                      vertices[indices[3 * i + 1]],
+                      vertices[indices[3 * i + 2]]};
+        out[i]     = bounds(p, 3);
+    }
+}
+
+namespace detail
+{
+    // Lane mask of the rays of a packet passing through the box within the
+    // distance of their closest hit so far
+    template <typename V>
+    KLN_INLINE V KLN_VEC_CALL slab_test(ray_packet<V> const& packet,
+                                        V const* inv,
+                                        float const* lo,
+                                        float const* hi) noexcept
+    {
+        using namespace soa;
+
+        // With inv = |u| / u, (lo - o) * inv is the distance along the ray
+        // to its meet with the plane through lo perpendicular to the axis.
+        V t_near = zero<V>();
+        V t_far  = packet.best;
+        for (size_t k = 0; k != 3; ++k)
+        {
+            V o    = packet.o[k + 1];
+            V t0   = mul(sub(set1<V>(lo[k]), o), inv[k]);
+            V t1   = mul(sub(set1<V>(hi[k]), o), inv[k]);
+            t_near = max(t_near, min(t0, t1));
+            t_far  = min(t_far, max(t0, t1));
+        }
+        return cmple(t_near, t_far);
+    }
+
+    // Lane mask of the points inside the box
+    template <typename V>
+    KLN_INLINE V KLN_VEC_CALL contains(V const* p,
+                                       float const* lo,
+                                       float const* hi) noexcept
+    {
+        using namespace soa;
+
+        V inside = bit_and(cmpge(p[1], set1<V>(lo[0])),
+                           cmple(p[1], set1<V>(hi[0])));
+        for (size_t k = 1; k != 3; ++k)
+        {
+            inside = bit_and(inside, cmpge(p[k + 1], set1<V>(lo[k])));
+            inside = bit_and(inside, cmple(p[k + 1], set1<V>(hi[k])));
+        }
+        return inside;
+    }
+} // namespace detail
+
+/// \ingroup bvh
+class bvh final
+{
+public:
+    /// Largest number of primitives in a leaf
+    static constexpr size_t max_leaf_size = 4;
+
+    /// Number of bins per axis over which the SAH is evaluated
+    static constexpr size_t bin_count = 12;
+
+    /// Depth beyond which the builder splits at the median centroid, which
+    /// bounds the depth of the tree by `median_depth + 32`
+    static constexpr size_t median_depth = 32;
+
+    /// Size of the traversal stacks, which hold at most one entry per level
+    /// plus the two children of the node visited last
+    static constexpr size_t stack_size = median_depth + 32 + 2;
+
+    /// Smallest number of primitives in a subtree that the parallel build
+    /// splits further before handing its children to separate threads
+    static constexpr size_t parallel_threshold = 4096;
+
+    /// Number of nodes a hierarchy over `count` primitives may need
+    [[nodiscard]] static constexpr size_t node_capacity(size_t count) noexcept
+    {
+        return count == 0 ? 0 : 2 * count - 1;
+    }
+
+    bvh() = default;
+
+    /// Builds a hierarchy over the `count` primitives with the given bounds.
+    /// `nodes` must have room for `node_capacity(count)` nodes and `order`
+    /// for `count` primitive indices.
+    bvh(bounding_box const* bounds,
+        size_t count,
+        bvh_node* nodes,
+        uint32_t* order) noexcept
+        : bounds_{bounds}
+        , nodes_{nodes}
+        , order_{order}
+    {
+        for (size_t i = 0; i != count; ++i)
+        {
+            order_[i] = static_cast<uint32_t>(i);
+        }
+        if (count != 0)
+        {
+            build(0, static_cast<uint32_t>(count), 0, 0);
+            compact();
+        }
+    }
+
+    /// As above, building the subtrees on the threads of `pool`, or of
+    /// `parallel::default_pool()` if null. Defined in `parallel.hpp`.
+    bvh(bounding_box const* bounds,
+        size_t count,
+        bvh_node* nodes,
+        uint32_t* order,
+        parallel::thread_pool* pool);
+
+    [[nodiscard]] size_t node_count() const noexcept
+    {
+        return node_count_;
+    }
+
+    /// Finds the closest hit of each of the `count` rays, as in the
+    /// `intersect` routine of the raycast module, with the triangles
+    /// described by `records` (indexed as the primitives of the hierarchy).
+    void intersect(triangle_record const* records,
+                   point const* origins,
+                   line const* rays,
+                   ray_hit* hits,
+                   size_t count) const noexcept
+    {
+        size_t i = 0;
+#ifdef KLN_ENABLE_ISE_AVX2
+        for (; i + 8 <= count; i += 8)
+        {
+            intersect<__m256>(records, origins + i, rays + i, hits + i);
+        }
+#endif
+        for (; i + 4 <= count; i += 4)
+        {
+            intersect<__m128>(records, origins + i, rays + i, hits + i);
+        }
+
+        if (i != count)
+        {
+            // Pad the tail by repeating the last ray
+            size_t n = count - i;
+            point o[4];
+            line r[4];
+            ray_hit h[4];
+            for (size_t j = 0; j != 4; ++j)
+            {
+                size_t src = i + std::min(j, n - 1);
+                o[j]       = origins[src];
+                r[j]       = rays[src];
+            }
+            intersect<__m128>(records, o, r, h);
+            std::copy(h, h + n, hits + i);
+        }
+    }
+
+    /// Calls `f(i, primitive)` for each of the `count` normalized points
+    /// `points[i]` and each primitive whose bounds contain it.
+    template <typename F>
+    void query(point const* points, size_t count, F&& f) const noexcept
+    {
+        size_t i = 0;
+#ifdef KLN_ENABLE_ISE_AVX2
+        for (; i + 8 <= count; i += 8)
+        {
+            query<__m256>(points + i, i, 8, f);
+        }
+#endif
+        for (; i + 4 <= count; i += 4)
+        {
+            query<__m128>(points + i, i, 4, f);
+        }
+
+        if (i != count)
+        {
+            size_t n = count - i;
+            point p[4];
+            for (size_t j = 0; j != 4; ++j)
+            {
+                p[j] = points[i + std::min(j, n - 1)];
+            }
+            query<__m128>(p, i, n, f);
+        }
+    }
+
+    /// Calls `f(primitive)` for each primitive whose bounds do not lie
+    /// entirely on the negative side of any plane of `planes`.
+    template <typename F>
+    void cull(plane_set const& planes, F&& f) const noexcept
+    {
+        if (node_count_ == 0)
+        {
+            return;
+        }
+
+        uint32_t all = planes.size() == 32
+                           ? 0xffffffff
+                           : (uint32_t{1} << planes.size()) - 1;
+
+        uint32_t stack[stack_size];
+        uint32_t active[stack_size];
+        size_t top    = 0;
+        stack[top]    = 0;
+        active[top++] = all;
+        while (top != 0)
+        {
+            --top;
+            bvh_node const& node = nodes_[stack[top]];
+            uint32_t mask        = active[top];
+            if (!classify(planes, node.min, node.max, mask))
+            {
+                continue;
+            }
+
+            if (node.is_leaf())
+            {
+                for (uint32_t k = 0; k != node.count; ++k)
+                {
+                    uint32_t primitive    = order_[node.offset + k];
+                    bounding_box const& b = bounds_[primitive];
+                    uint32_t leaf_mask    = mask;
+                    if (classify(planes, b.min, b.max, leaf_mask))
+                    {
+                        f(primitive);
+                    }
+                }
+            }
+            else
+            {
+                uint32_t self = static_cast<uint32_t>(&node - nodes_);
+                stack[top]    = node.offset;
+                active[top++] = mask;
+                stack[top]    = self + 1;
+                active[top++] = mask;
+            }
+        }
+    }
+
+    bounding_box const* bounds_ = nullptr;
+    bvh_node* nodes_            = nullptr;
+
+    /// Primitive indices, permuted such that the primitives of each leaf are
+    /// contiguous
+    uint32_t* order_   = nullptr;
+    size_t node_count_ = 0;
+
+private:
+    static float centroid(bounding_box const& b, size_t axis) noexcept
+    {
+        // Twice the centroid, which orders the same
+        return b.min[axis] + b.max[axis];
+    }
+
+    // Builds the subtree over order_[begin, end) into nodes_[index, index +
+    // node_capacity(end - begin)). The first child's subtree takes the nodes
+    // following index and the second child's the nodes past the first
+    // child's capacity, so that the two can be built independently.
+    // compact() closes the gaps this leaves.
+    void build(uint32_t begin,
+               uint32_t end,
+               size_t depth,
+               uint32_t index) noexcept
+    {
+        uint32_t split = partition(begin, end, depth, index);
+        if (split != begin)
+        {
+            build(begin, split, depth + 1, index + 1);
+            build(split, end, depth + 1, nodes_[index].offset);
+        }
+    }
+
+    // Fills in nodes_[index] for the subtree over order_[begin, end). For an
+    // interior node, partitions the range between the two children and
+    // returns the start of the second one; returns begin for a leaf.
+    uint32_t partition(uint32_t begin,
+                       uint32_t end,
+                       size_t depth,
+                       uint32_t index) noexcept
+    {
+        bvh_node& node = nodes_[index];
+
+        bounding_box box     = bounding_box::empty();
+        bounding_box centers = bounding_box::empty();
+        for (uint32_t i = begin; i != end; ++i)
+        {
+            bounding_box const& b = bounds_[order_[i]];
+            box.extend(b);
+            float c[3] = {centroid(b, 0), centroid(b, 1), centroid(b, 2)};
+            centers.extend({{c[0], c[1], c[2]}, {c[0], c[1], c[2]}});
+        }
+        std::copy(box.min, box.min + 3, node.min);
+        std::copy(box.max, box.max + 3, node.max);
+
+        uint32_t n = end - begin;
+        if (n == 1)
+        {
+            make_leaf(node, begin, n);
+            return begin;
+        }
+
+        // Evaluate the SAH at each bin boundary of each axis
+        size_t best_axis = 0;
+        size_t best_bin  = 0;
+        float best_cost  = std::numeric_limits<float>::infinity();
+        for (size_t axis = 0; axis != 3; ++axis)
+        {
+            float extent = centers.max[axis] - centers.min[axis];
+            if (!(extent > 0.f))
+            {
+                continue;
+            }
+            float scale = static_cast<float>(bin_count) / extent;
+
+            bounding_box bin_box[bin_count];
+            uint32_t bin_size[bin_count] = {};
+            std::fill(bin_box, bin_box + bin_count, bounding_box::empty());
+            for (uint32_t i = begin; i != end; ++i)
+            {
+                bounding_box const& b = bounds_[order_[i]];
+                size_t bin = bin_of(b, axis, centers.min[axis], scale);
+                bin_box[bin].extend(b);
+                ++bin_size[bin];
+            }
+
+            // Sweep from the right, then from the left
+            float right_area[bin_count];
+            bounding_box acc = bounding_box::empty();
+            uint32_t right_size[bin_count];
+            uint32_t size = 0;
+            for (size_t i = bin_count - 1; i != 0; --i)
+            {
+                acc.extend(bin_box[i]);
+                size += bin_size[i];
+                right_area[i] = size == 0 ? 0.f : acc.half_area();
+                right_size[i] = size;
+            }
+
+            acc  = bounding_box::empty();
+            size = 0;
+            for (size_t i = 1; i != bin_count; ++i)
+            {
+                acc.extend(bin_box[i - 1]);
+                size += bin_size[i - 1];
+                if (size == 0 || right_size[i] == 0)
+                {
+                    continue;
+                }
+                float cost
+                    = acc.half_area() * static_cast<float>(size)
+                      + right_area[i] * static_cast<float>(right_size[i]);
+                if (cost < best_cost)
+                {
+                    best_cost = cost;
+                    best_axis = axis;
+                    best_bin  = i;
+                }
+            }
+        }
+
+        // Traversing a node costs about as much as intersecting a primitive
+        float area      = box.half_area();
+        float leaf_cost = area * static_cast<float>(n);
+        if (n <= max_leaf_size && leaf_cost <= area + best_cost)
+        {
+            make_leaf(node, begin, n);
+            return begin;
+        }
+
+        uint32_t* first = order_ + begin;
+        uint32_t* last  = order_ + end;
+        uint32_t* mid   = first;
+        if (depth < median_depth
+            && best_cost < std::numeric_limits<float>::infinity())
+        {
+            float lo    = centers.min[best_axis];
+            float scale = static_cast<float>(bin_count)
+                          / (centers.max[best_axis] - lo);
+            mid         = std::partition(first, last, [&](uint32_t i) {
+                return bin_of(bounds_[i], best_axis, lo, scale) < best_bin;
+            });
+        }
+        if (mid == first || mid == last)
+        {
+            // Split at the median centroid along the longest axis of the
+            // centroid bounds (or anywhere, if the centroids coincide)
+            best_axis = 0;
+            for (size_t axis = 1; axis != 3; ++axis)
+            {
+                if (centers.max[axis] - centers.min[axis]
+                    > centers.max[best_axis] - centers.min[best_axis])
+                {
+                    best_axis = axis;
+                }
+            }
+            mid = first + n / 2;
+            std::nth_element(first, mid, last, [&](uint32_t a, uint32_t b) {
+                return centroid(bounds_[a], best_axis)
+                       < centroid(bounds_[b], best_axis);
+            });
+        }
+
+        uint32_t split = static_cast<uint32_t>(mid - order_);
+        uint32_t second
+            = index + 1 + static_cast<uint32_t>(node_capacity(split - begin));
+        node.offset = second;
+        node.count  = bvh_node::interior | static_cast<uint32_t>(best_axis);
+        return split;
+    }
+
+    // Moves the nodes down over the unused nodes left by build(), keeping
+    // the depth-first order. Every node lands at or before its position, and
+    // nodes are visited in increasing order of position, so no node is
+    // overwritten before it is moved.
+    void compact() noexcept
+    {
+        // Second children yet to be visited, and the new indices of their
+        // parents
+        uint32_t pending[stack_size];
+        uint32_t parents[stack_size];
+        size_t top    = 0;
+        uint32_t from = 0;
+        uint32_t to   = 0;
+        while (true)
+        {
+            bvh_node node = nodes_[from];
+            nodes_[to]    = node;
+            if (!node.is_leaf())
+            {
+                pending[top]   = node.offset;
+                parents[top++] = to++;
+                ++from;
+                continue;
+            }
+
+            ++to;
+            if (top == 0)
+            {
+                break;
+            }
+            from                        = pending[--top];
+            nodes_[parents[top]].offset = to;
+        }
+        node_count_ = to;
+    }
+
+    static size_t bin_of(bounding_box const& b,
+                         size_t axis,
+                         float lo,
+                         float scale) noexcept
+    {
+        float f = (centroid(b, axis) - lo) * scale;
+        return std::min(static_cast<size_t>(std::max(f, 0.f)), bin_count - 1);
+    }
+
+    static void make_leaf(bvh_node& node, uint32_t begin, uint32_t n) noexcept
+    {
+        node.offset = begin;
+        node.count  = n;
+    }
+
+    // Tests the box against the planes of the mask. Returns false if the box
+    // lies entirely on the negative side of one, and otherwise clears the
+    // bits of the planes it lies entirely on the positive side of.
+    static bool classify(plane_set const& planes,
+                         float const* lo,
+                         float const* hi,
+                         uint32_t& mask) noexcept
+    {
+        for (size_t k = 0; k != planes.size(); ++k)
+        {
+            if ((mask & (uint32_t{1} << k)) == 0)
+            {
+                continue;
+            }
+
+            // Signed distances of the corners furthest along and against the
+            // plane's normal
+            float n[3]    = {planes.a_[k], planes.b_[k], planes.c_[k]};
+            float d_front = planes.d_[k];
+            float d_back  = planes.d_[k];
+            for (size_t i = 0; i != 3; ++i)
+            {
+                d_front += n[i] * (n[i] > 0.f ? hi[i] : lo[i]);
+                d_back += n[i] * (n[i] > 0.f ? lo[i] : hi[i]);
+            }
+
+            if (d_front < 0.f)
+            {
+                return false;
+            }
+            if (d_back > 0.f)
+            {
+                mask &= ~(uint32_t{1} << k);
+            }
+        }
+        return true;
+    }
+
+    template <typename V>
+    void intersect(triangle_record const* records,
+                   point const* origins,
+                   line const* rays,
+                   ray_hit* hits) const noexcept
+    {
+        using namespace detail::soa;
+
+        detail::ray_packet<V> packet{origins, rays};
+        if (node_count_ != 0)
+        {
+            // A ray parallel to an axis has an infinite reciprocal, and the
+            // slab test would then compute 0 * inf = NaN for an origin on one
+            // of the planes of a box, rejecting a box the ray grazes. Capped
+            // at the largest finite float, the ray meets such a plane at 0
+            // and the opposite one at a huge distance.
+            V big = set1<V>(std::numeric_limits<float>::max());
+            V inv[3];
+            for (size_t k = 0; k != 3; ++k)
+            {
+                inv[k] = div(packet.u_norm, packet.u[k + 1]);
+                inv[k] = min(max(inv[k], sub(zero<V>(), big)), big);
+            }
+
+            // Whether most rays travel in the negative direction along each
+            // axis
+            bool negative[3];
+            for (size_t k = 0; k != 3; ++k)
+            {
+                int mask     = movemask(packet.u[k + 1]);
+                size_t lanes = 0;
+                for (size_t j = 0; j != width<V>; ++j)
+                {
+                    lanes += (mask >> j) & 1;
+                }
+                negative[k] = 2 * lanes > width<V>;
+            }
+
+            uint32_t stack[stack_size];
+            size_t top   = 0;
+            stack[top++] = 0;
+            while (top != 0)
+            {
+                uint32_t index       = stack[--top];
+                bvh_node const& node = nodes_[index];
+                V hit = detail::slab_test(packet, inv, node.min, node.max);
+                if (movemask(hit) == 0)
+                {
+                    continue;
+                }
+
+                if (node.is_leaf())
+                {
+                    for (uint32_t k = 0; k != node.count; ++k)
+                    {
+                        uint32_t primitive = order_[node.offset + k];
+                        packet.intersect(records[primitive], primitive);
+                    }
+                }
+                else
+                {
+                    // Visit the child nearer to most rays first
+                    bool flip    = negative[node.count & ~bvh_node::interior];
+                    stack[top++] = flip ? index + 1 : node.offset;
+                    stack[top++] = flip ? node.offset : index + 1;
+                }
+            }
+        }
+        packet.store(hits);
+    }
+
+    template <typename V, typename F>
+    void query(point const* points,
+               size_t first,
+               size_t n,
+               F& f) const noexcept
+    {
+        using namespace detail::soa;
+
+        if (node_count_ == 0)
+        {
+            return;
+        }
+
+        V p[4];
+        load<1>(&points->p3_, p);
+        int valid = (1 << n) - 1;
+
+        uint32_t stack[stack_size];
+        size_t top   = 0;
+        stack[top++] = 0;
+        while (top != 0)
+        {
+            uint32_t index       = stack[--top];
+            bvh_node const& node = nodes_[index];
+            int inside
+                = movemask(detail::contains(p, node.min, node.max)) & valid;
+            if (inside == 0)
+            {
+                continue;
+            }
+
+            if (node.is_leaf())
+            {
+                for (uint32_t k = 0; k != node.count; ++k)
+                {
+                    uint32_t primitive    = order_[node.offset + k];
+                    bounding_box const& b = bounds_[primitive];
+                    int hit = movemask(detail::contains(p, b.min, b.max))
+                              & inside;
+                    for (size_t j = 0; j != n; ++j)
+                    {
+                        if (hit & (1 << j))
+                        {
+                            f(first + j, primitive);
+                        }
+                    }
+                }
+            }
+            else
+            {
+                stack[top++] = node.offset;
+                stack[top++] = index + 1;
+            }
+        }
+    }
+};
+/// @}
+} // namespace kln
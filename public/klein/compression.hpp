@@ -0,0 +1,373 @@
+#pragma once
+
+#include "geometric_product.hpp"
+#include "interpolation.hpp"
+#include "motor.hpp"
+#include "rotor.hpp"
+#include "translator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace kln
+{
+/// \defgroup compression Clip compression
+/// @{
+///
+/// An animation clip stores one motor per joint (track) per frame, 32 bytes
+/// apiece. The routines here compress such a clip to a stream of 12 byte
+/// keys, and remove tracks that do not move at all from the stream entirely.
+///
+/// Each key splits its motor into a rotor and a translator ($\mathbf{m} =
+/// \mathbf{t}\mathbf{r}$). The rotor is a unit 4-vector, so it is stored as
+/// the three components other than the one with the largest magnitude (the
+/// "smallest three"), each quantized to 15 bits, together with the 2 bit
+/// index of the omitted component which is recovered from the unit norm on
+/// decompression. The translator is stored as its three ideal components
+/// quantized to 16 bits each over the range spanned by its track.
+///
+/// The stream is frame-major: all keys of a frame are contiguous, so decoding
+/// a pose (or a pair of poses to blend) is a single forward pass over memory
+/// that writes the local motors of every joint directly into the output array
+/// consumed by `forward_kinematics`.
+///
+/// Compression records for every track the largest error it introduced,
+/// measured against the source clip. Rotation error is the largest absolute
+/// error of a rotor component, translation error the largest distance between
+/// a source and decompressed translation.
+
+/// \ingroup compression
+struct compressed_key
+{
+    /// Smallest three rotor components, 15 bits each. The top bits of the
+    /// first two hold the index of the omitted component.
+    uint16_t rotor[3];
+
+    /// Translator components quantized over the track's range
+    uint16_t translation[3];
+};
+
+/// \ingroup compression
+struct compressed_track
+{
+    /// Sentinel `stream_index` of a track whose only key is `key`
+    static constexpr uint16_t constant = 0xffff;
+
+    float translation_min[3];
+    float translation_scale[3];
+
+    /// Largest absolute error of any rotor component over the clip
+    float rotation_error;
+
+    /// Largest distance between a source and decompressed translation
+    float translation_error;
+
+    /// The key of a constant track
+    compressed_key key;
+
+    /// The index of this track's key within each frame of the stream, or
+    /// `constant`
+    uint16_t stream_index;
+};
+
+namespace detail
+{
+    constexpr float quantize_rotor_scale = 32767.f;
+
+    KLN_INLINE void split_motor(motor const& m, float* r, float* t) noexcept
+    {
+        rotor rot{m.p1_};
+        translator tr;
+        tr.p2_ = (m * ~rot).p2_;
+
+        float p2[4];
+        _mm_storeu_ps(r, rot.p1_);
+        _mm_storeu_ps(p2, tr.p2_);
+        t[0] = p2[1];
+        t[1] = p2[2];
+        t[2] = p2[3];
+    }
+
+    KLN_INLINE compressed_key encode_key(compressed_track const& track,
+                                         float const* r,
+                                         float const* t) noexcept
+    {
+        size_t largest = 0;
+        for (size_t i = 1; i != 4; ++i)
+        {
+            if (std::abs(r[i]) > std::abs(r[largest]))
+            {
+                largest = i;
+            }
+        }
+
+        // r and -r are the same rotation, so flip the sign to make the
+        // omitted component positive.
+        float sign = r[largest] < 0.f ? -1.f : 1.f;
+
+        compressed_key out;
+        size_t j = 0;
+        for (size_t i = 0; i != 4; ++i)
+        {
+            if (i == largest)
+            {
+                continue;
+            }
+            // [-1/sqrt2, 1/sqrt2] -> [0, 32767]
+            float v = (sign * r[i] * 1.41421356f + 1.f) * 0.5f;
+            v       = std::min(std::max(v, 0.f), 1.f);
+            out.rotor[j++]
+                = static_cast<uint16_t>(std::lround(v * quantize_rotor_scale));
+        }
+        out.rotor[0] |= static_cast<uint16_t>((largest & 1) << 15);
+        out.rotor[1] |= static_cast<uint16_t>((largest >> 1) << 15);
+
+        for (size_t i = 0; i != 3; ++i)
+        {
+            float q = track.translation_scale[i] == 0.f
+                          ? 0.f
+                          : (t[i] - track.translation_min[i])
+                                / track.translation_scale[i];
+            out.translation[i] = static_cast<uint16_t>(
+                std::lround(std::min(std::max(q, 0.f), 65535.f)));
+        }
+        return out;
+    }
+
+    KLN_INLINE motor decode_key(compressed_track const& track,
+                                compressed_key const& key) noexcept
+    {
+        size_t largest = static_cast<size_t>((key.rotor[0] >> 15)
+                                             | ((key.rotor[1] >> 15) << 1));
+        float r[4];
+        float norm = 0.f;
+        size_t j   = 0;
+        for (size_t i = 0; i != 4; ++i)
+        {
+            if (i == largest)
+            {
+                continue;
+            }
+            float v = static_cast<float>(key.rotor[j++] & 0x7fff)
+                      / quantize_rotor_scale;
+            r[i] = (v * 2.f - 1.f) * 0.707106781f;
+            norm += r[i] * r[i];
+        }
+        r[largest] = std::sqrt(std::max(1.f - norm, 0.f));
+
+        float t[4] = {0.f};
+        for (size_t i = 0; i != 3; ++i)
+        {
+            t[i + 1] = track.translation_min[i]
+                       + track.translation_scale[i]
+                             * static_cast<float>(key.translation[i]);
+        }
+
+        translator tr;
+        tr.p2_ = _mm_loadu_ps(t);
+        return tr * rotor{_mm_loadu_ps(r)};
+    }
+} // namespace detail
+
+/// \ingroup compression
+///
+/// View of a compressed clip. The tracks and stream are owned by the caller.
+struct compressed_clip
+{
+    compressed_track const* tracks;
+    compressed_key const* stream;
+    uint32_t track_count;
+    uint32_t frame_count;
+
+    /// Number of tracks with keys in the stream (the keys per frame)
+    uint32_t animated_count;
+
+    /// Number of keys in the stream
+    [[nodiscard]] size_t key_count() const noexcept
+    {
+        return static_cast<size_t>(frame_count) * animated_count;
+    }
+
+    /// Decodes the pose at `frame` into the `track_count` motors at `out`.
+    void decode(size_t frame, motor* out) const noexcept
+    {
+        compressed_key const* keys = stream + frame * animated_count;
+        for (size_t i = 0; i != track_count; ++i)
+        {
+            compressed_track const& track = tracks[i];
+            compressed_key const& key
+                = track.stream_index == compressed_track::constant
+                      ? track.key
+                      : keys[track.stream_index];
+            out[i] = detail::decode_key(track, key);
+        }
+    }
+
+    /// Decodes the pose at the fractional frame `t` (clamped to the clip) by
+    /// blending the adjacent frames with `nlerp`. Does nothing if the clip
+    /// has no frames.
+    void sample(float t, motor* out) const noexcept
+    {
+        if (frame_count == 0)
+        {
+            return;
+        }
+
+        size_t last  = static_cast<size_t>(frame_count) - 1;
+        t            = std::min(std::max(t, 0.f), static_cast<float>(last));
+        size_t frame = std::min(static_cast<size_t>(t), last);
+        size_t next  = std::min(frame + 1, last);
+        float u      = t - static_cast<float>(frame);
+
+        compressed_key const* k0 = stream + frame * animated_count;
+        compressed_key const* k1 = stream + next * animated_count;
+        for (size_t i = 0; i != track_count; ++i)
+        {
+            compressed_track const& track = tracks[i];
+            if (track.stream_index == compressed_track::constant)
+            {
+                out[i] = detail::decode_key(track, track.key);
+            }
+            else
+            {
+                out[i] = detail::nlerp(
+                    detail::decode_key(track, k0[track.stream_index]),
+                    detail::decode_key(track, k1[track.stream_index]),
+                    u);
+            }
+        }
+    }
+};
+
+/// \ingroup compression
+///
+/// Compresses a clip of `frame_count` poses of `track_count` (at most 65535)
+/// normalized motors each, stored frame-major in `poses`. A track is stored
+/// as a single constant key if its rotor components and translation never
+/// deviate from those of its first frame by more than `tolerance`.
+///
+/// `tracks` must have room for `track_count` entries and `stream` for
+/// `track_count * frame_count` keys in the worst case. The returned view
+/// refers to both. A clip without frames has no first pose to compare the
+/// others to, and compresses to an empty clip with no tracks.
+inline compressed_clip compress_clip(motor const* poses,
+                                     size_t track_count,
+                                     size_t frame_count,
+                                     float tolerance,
+                                     compressed_track* tracks,
+                                     compressed_key* stream) noexcept
+{
+    if (frame_count == 0)
+    {
+        return {tracks, stream, 0, 0, 0};
+    }
+
+    uint16_t animated = 0;
+    for (size_t i = 0; i != track_count; ++i)
+    {
+        compressed_track& track = tracks[i];
+
+        float r0[4];
+        float t0[3];
+        detail::split_motor(poses[i], r0, t0);
+
+        float t_min[3] = {t0[0], t0[1], t0[2]};
+        float t_max[3] = {t0[0], t0[1], t0[2]};
+        bool constant  = true;
+        for (size_t f = 1; f != frame_count; ++f)
+        {
+            float r[4];
+            float t[3];
+            detail::split_motor(poses[f * track_count + i], r, t);
+
+            float same = 0.f;
+            float flip = 0.f;
+            for (size_t k = 0; k != 4; ++k)
+            {
+                same = std::max(same, std::abs(r[k] - r0[k]));
+                flip = std::max(flip, std::abs(r[k] + r0[k]));
+            }
+            for (size_t k = 0; k != 3; ++k)
+            {
+                t_min[k] = std::min(t_min[k], t[k]);
+                t_max[k] = std::max(t_max[k], t[k]);
+                same     = std::max(same, std::abs(t[k] - t0[k]) * 2.f);
+                flip     = std::max(flip, std::abs(t[k] - t0[k]) * 2.f);
+            }
+            constant = constant && std::min(same, flip) <= tolerance;
+        }
+
+        for (size_t k = 0; k != 3; ++k)
+        {
+            track.translation_min[k]   = t_min[k];
+            track.translation_scale[k] = (t_max[k] - t_min[k]) / 65535.f;
+        }
+        track.rotation_error    = 0.f;
+        track.translation_error = 0.f;
+
+        if (constant)
+        {
+            track.stream_index = compressed_track::constant;
+            track.key          = detail::encode_key(track, r0, t0);
+        }
+        else
+        {
+            track.stream_index = animated++;
+        }
+    }
+
+    for (size_t f = 0; f != frame_count; ++f)
+    {
+        compressed_key* keys = stream + f * animated;
+        for (size_t i = 0; i != track_count; ++i)
+        {
+            compressed_track& track = tracks[i];
+
+            float r[4];
+            float t[3];
+            detail::split_motor(poses[f * track_count + i], r, t);
+
+            compressed_key key;
+            if (track.stream_index == compressed_track::constant)
+            {
+                key = track.key;
+            }
+            else
+            {
+                key                      = detail::encode_key(track, r, t);
+                keys[track.stream_index] = key;
+            }
+
+            // Measure the error actually introduced
+            float dr[4];
+            float dt[3];
+            detail::split_motor(detail::decode_key(track, key), dr, dt);
+            float dot  = dr[0] * r[0] + dr[1] * r[1] + dr[2] * r[2]
+                        + dr[3] * r[3];
+            float sign = dot < 0.f ? -1.f : 1.f;
+            for (size_t k = 0; k != 4; ++k)
+            {
+                track.rotation_error = std::max(
+                    track.rotation_error, std::abs(sign * dr[k] - r[k]));
+            }
+            float d2 = 0.f;
+            for (size_t k = 0; k != 3; ++k)
+            {
+                // The translator's ideal components are half the translation
+                float d = 2.f * (dt[k] - t[k]);
+                d2 += d * d;
+            }
+            track.translation_error
+                = std::max(track.translation_error, std::sqrt(d2));
+        }
+    }
+
+    return {tracks,
+            stream,
+            static_cast<uint32_t>(track_count),
+            static_cast<uint32_t>(frame_count),
+            animated};
+}
+/// @}
+} // namespace kln
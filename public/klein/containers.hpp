@@ -0,0 +1,678 @@
+#pragma once
+
+#include "detail/soa.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace kln
+{
+/// \defgroup containers Containers
+/// @{
+///
+/// The batch routines take raw pointers to entities and leave the alignment
+/// and lifetime of the underlying storage to the caller. The containers here
+/// manage that storage:
+///
+/// - `aligned_vector<T>` stores entities contiguously (as an array of `T`,
+///   ready to be passed to any batch routine) starting on a cache line
+///   boundary, with its capacity padded to a multiple of eight entities.
+/// - `soa_vector<T>` stores entities transposed: one array per float
+///   component of `T`, each starting on a cache line boundary and padded to a
+///   multiple of sixteen entities. Groups of four, eight, or sixteen entities
+///   load straight into the registers of the SoA kernels and the wide
+///   entities (`point_x8`, ...) without any shuffling.
+///
+/// In both containers, the entities between `size()` and `capacity()` are
+/// kept zeroed, so that kernels processing whole SIMD groups may read (and
+/// write) past the last entity without touching uninitialized memory.
+///
+/// Storage is obtained from an allocator, which is any type providing
+///
+/// ```cpp
+///     void* allocate(size_t bytes, size_t alignment) noexcept;
+///     void deallocate(void* p, size_t bytes, size_t alignment) noexcept;
+/// ```
+///
+/// where `allocate` returns null on failure. `heap_allocator` uses the global
+/// aligned `operator new`. An `arena_allocator` carves allocations out of a
+/// caller-provided `arena`, so that batches rebuilt every frame need not touch
+/// the heap at all. As with the rest of the library, nothing throws:
+/// operations that may allocate return `false` if the allocation fails, and
+/// leave the container unchanged.
+///
+/// !!! example
+///
+///     ```cpp
+///         alignas(64) static char frame_memory[1 << 20];
+///         kln::arena frame{frame_memory, sizeof(frame_memory)};
+///
+///         // Each frame
+///         frame.reset();
+///         kln::aligned_vector<kln::point, kln::arena_allocator> points{frame};
+///         points.resize(count);
+///         // ... fill points
+///         m(points.data(), points.data(), points.size());
+///
+///         // SoA form, processed eight points at a time (AVX2)
+///         kln::soa_vector<kln::point> soa;
+///         soa.assign(points.data(), points.size());
+///         for (size_t i = 0; i < soa.size(); i += 8)
+///         {
+///             kln::point_x8 p;
+///             soa.load(i, p.p3_);
+///             soa.store(i, m8(p).p3_);
+///         }
+///     ```
+
+/// \ingroup containers
+///
+/// Alignment of the storage of all containers: one cache line
+constexpr size_t container_alignment = 64;
+
+/// \ingroup containers
+///
+/// Allocates from the global heap with the aligned `operator new`.
+struct heap_allocator
+{
+    [[nodiscard]] void* allocate(size_t bytes, size_t alignment) noexcept
+    {
+        return ::operator new(bytes, std::align_val_t{alignment}, std::nothrow);
+    }
+
+    void deallocate(void* p, size_t, size_t alignment) noexcept
+    {
+        ::operator delete(p, std::align_val_t{alignment});
+    }
+};
+
+/// \ingroup containers
+///
+/// A linear allocator over a buffer owned by the caller. Allocations are
+/// bumped off the front of the buffer and are only reclaimed all at once by
+/// `reset` (apart from the most recent allocation, which is reclaimed when it
+/// is freed).
+class arena final
+{
+public:
+    arena(void* buffer, size_t size) noexcept
+        : begin_{static_cast<char*>(buffer)}
+        , size_{size}
+    {}
+
+    arena(arena const&) = delete;
+    arena& operator=(arena const&) = delete;
+
+    /// Returns `bytes` bytes aligned to `alignment` (a power of two), or null
+    /// if the arena is exhausted.
+    [[nodiscard]] void* allocate(size_t bytes, size_t alignment) noexcept
+    {
+        uintptr_t base    = reinterpret_cast<uintptr_t>(begin_);
+        uintptr_t aligned = (base + used_ + alignment - 1) & ~(alignment - 1);
+        size_t offset     = static_cast<size_t>(aligned - base);
+        // Test the requested size on its own first so that requests larger
+        // than the whole arena visibly fail (this also keeps GCC's bounds
+        // checking from flagging the zeroing in the containers)
+        if (bytes > size_ || offset > size_ - bytes)
+        {
+            return nullptr;
+        }
+        used_ = offset + bytes;
+        return begin_ + offset;
+    }
+
+    void deallocate(void* p, size_t bytes, size_t) noexcept
+    {
+        char* c = static_cast<char*>(p);
+        if (c + bytes == begin_ + used_)
+        {
+            used_ = static_cast<size_t>(c - begin_);
+        }
+    }
+
+    /// Reclaims all allocations. Containers allocated from the arena must no
+    /// longer be used (other than being destroyed) afterwards.
+    void reset() noexcept
+    {
+        used_ = 0;
+    }
+
+    /// Number of bytes allocated, including alignment padding
+    [[nodiscard]] size_t used() const noexcept
+    {
+        return used_;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept
+    {
+        return size_;
+    }
+
+private:
+    char* begin_;
+    size_t size_;
+    size_t used_ = 0;
+};
+
+/// \ingroup containers
+///
+/// Allocates from an `arena`, which must outlive the allocator.
+class arena_allocator final
+{
+public:
+    arena_allocator(arena& a) noexcept
+        : arena_{&a}
+    {}
+
+    [[nodiscard]] void* allocate(size_t bytes, size_t alignment) noexcept
+    {
+        return arena_->allocate(bytes, alignment);
+    }
+
+    void deallocate(void* p, size_t bytes, size_t alignment) noexcept
+    {
+        arena_->deallocate(p, bytes, alignment);
+    }
+
+private:
+    arena* arena_;
+};
+
+namespace detail
+{
+    // Zero-initialized, 64-byte aligned storage obtained from an allocator.
+    // Handles the move operations and the release of the storage for the
+    // containers.
+    template <typename Allocator>
+    class container_storage
+    {
+    public:
+        container_storage() = default;
+
+        explicit container_storage(Allocator allocator) noexcept
+            : allocator_{std::move(allocator)}
+        {}
+
+        container_storage(container_storage&& other) noexcept
+            : allocator_{other.allocator_}
+            , data_{std::exchange(other.data_, nullptr)}
+            , bytes_{std::exchange(other.bytes_, 0)}
+        {}
+
+        container_storage& operator=(container_storage&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                allocator_ = other.allocator_;
+                data_      = std::exchange(other.data_, nullptr);
+                bytes_     = std::exchange(other.bytes_, 0);
+            }
+            return *this;
+        }
+
+        ~container_storage()
+        {
+            release();
+        }
+
+        [[nodiscard]] void* allocate(size_t bytes) noexcept
+        {
+            void* out = allocator_.allocate(bytes, container_alignment);
+            if (out)
+            {
+                std::memset(out, 0, bytes);
+            }
+            return out;
+        }
+
+        // Replaces the storage with data, of size bytes, from allocate
+        void replace(void* data, size_t bytes) noexcept
+        {
+            release();
+            data_  = data;
+            bytes_ = bytes;
+        }
+
+        void release() noexcept
+        {
+            if (data_)
+            {
+                allocator_.deallocate(data_, bytes_, container_alignment);
+                data_  = nullptr;
+                bytes_ = 0;
+            }
+        }
+
+        Allocator allocator_;
+        void* data_   = nullptr;
+        size_t bytes_ = 0;
+    };
+
+    // Rounds count up to a multiple of multiple
+    constexpr size_t pad(size_t count, size_t multiple) noexcept
+    {
+        return (count + multiple - 1) / multiple * multiple;
+    }
+} // namespace detail
+
+/// \ingroup containers
+///
+/// A growable array of entities (or any trivially copyable type), 64-byte
+/// aligned and padded to a multiple of eight entities.
+template <typename T, typename Allocator = heap_allocator>
+class aligned_vector final
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "aligned_vector only holds trivially copyable types");
+
+public:
+    /// Capacities are rounded up to a multiple of this many entities
+    static constexpr size_t padding = 8;
+
+    aligned_vector() = default;
+
+    explicit aligned_vector(Allocator allocator) noexcept
+        : storage_{std::move(allocator)}
+    {}
+
+    aligned_vector(aligned_vector&& other) noexcept
+        : storage_{std::move(other.storage_)}
+        , size_{std::exchange(other.size_, 0)}
+        , capacity_{std::exchange(other.capacity_, 0)}
+    {}
+
+    aligned_vector& operator=(aligned_vector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            storage_  = std::move(other.storage_);
+            size_     = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] T* data() noexcept
+    {
+        return static_cast<T*>(storage_.data_);
+    }
+
+    [[nodiscard]] T const* data() const noexcept
+    {
+        return static_cast<T const*>(storage_.data_);
+    }
+
+    [[nodiscard]] T& operator[](size_t i) noexcept
+    {
+        return data()[i];
+    }
+
+    [[nodiscard]] T const& operator[](size_t i) const noexcept
+    {
+        return data()[i];
+    }
+
+    [[nodiscard]] T* begin() noexcept
+    {
+        return data();
+    }
+
+    [[nodiscard]] T* end() noexcept
+    {
+        return data() + size_;
+    }
+
+    [[nodiscard]] T const* begin() const noexcept
+    {
+        return data();
+    }
+
+    [[nodiscard]] T const* end() const noexcept
+    {
+        return data() + size_;
+    }
+
+    /// Ensures room for `count` entities without further allocation.
+    bool reserve(size_t count) noexcept
+    {
+        if (count <= capacity_)
+        {
+            return true;
+        }
+
+        size_t capacity = detail::pad(count, padding);
+        size_t bytes    = capacity * sizeof(T);
+        void* data      = storage_.allocate(bytes);
+        if (!data)
+        {
+            return false;
+        }
+        if (size_ != 0)
+        {
+            std::memcpy(data, storage_.data_, size_ * sizeof(T));
+        }
+        storage_.replace(data, bytes);
+        capacity_ = capacity;
+        return true;
+    }
+
+    /// Sets the number of entities to `count`. Added entities are zeroed.
+    bool resize(size_t count) noexcept
+    {
+        if (!reserve(count))
+        {
+            return false;
+        }
+        if (count < size_)
+        {
+            zero(count, size_);
+        }
+        size_ = count;
+        return true;
+    }
+
+    bool push_back(T const& x) noexcept
+    {
+        // `x` may refer to an entity of this container, which growing frees
+        T copy = x;
+        if (size_ == capacity_ && !reserve(std::max(2 * capacity_, padding)))
+        {
+            return false;
+        }
+        data()[size_++] = copy;
+        return true;
+    }
+
+    /// Copies the `count` entities at `in`, which must not point into this
+    /// container.
+    bool assign(T const* in, size_t count) noexcept
+    {
+        if (!resize(count))
+        {
+            return false;
+        }
+        std::memcpy(static_cast<void*>(data()), in, count * sizeof(T));
+        return true;
+    }
+
+    void clear() noexcept
+    {
+        zero(0, size_);
+        size_ = 0;
+    }
+
+private:
+    void zero(size_t first, size_t last) noexcept
+    {
+        std::memset(
+            static_cast<void*>(data() + first), 0, (last - first) * sizeof(T));
+    }
+
+    detail::container_storage<Allocator> storage_;
+    size_t size_     = 0;
+    size_t capacity_ = 0;
+};
+
+/// \ingroup containers
+///
+/// A growable array of entities stored in structure-of-arrays form: the
+/// component `k` of the entity `i` (the float at index `k` of the entity's
+/// partitions, in memory order) is stored at `component(k)[i]`. Each
+/// component array is 64-byte aligned, and capacities are padded to a
+/// multiple of sixteen entities so that groups of any SIMD width starting at
+/// a multiple of that width are aligned and lie within the storage.
+template <typename T, typename Allocator = heap_allocator>
+class soa_vector final
+{
+    static_assert(std::is_trivially_copyable_v<T>
+                      && sizeof(T) % sizeof(__m128) == 0,
+                  "soa_vector holds entities made of __m128 partitions");
+
+public:
+    /// Number of partitions of an entity
+    static constexpr size_t partitions = sizeof(T) / sizeof(__m128);
+
+    /// Number of float components of an entity (and of component arrays)
+    static constexpr size_t components = 4 * partitions;
+
+    /// Capacities are rounded up to a multiple of this many entities
+    static constexpr size_t padding = 16;
+
+    soa_vector() = default;
+
+    explicit soa_vector(Allocator allocator) noexcept
+        : storage_{std::move(allocator)}
+    {}
+
+    soa_vector(soa_vector&& other) noexcept
+        : storage_{std::move(other.storage_)}
+        , size_{std::exchange(other.size_, 0)}
+        , capacity_{std::exchange(other.capacity_, 0)}
+    {}
+
+    soa_vector& operator=(soa_vector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            storage_  = std::move(other.storage_);
+            size_     = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    /// The array holding component `k` of every entity
+    [[nodiscard]] float* component(size_t k) noexcept
+    {
+        return static_cast<float*>(storage_.data_) + k * capacity_;
+    }
+
+    [[nodiscard]] float const* component(size_t k) const noexcept
+    {
+        return static_cast<float const*>(storage_.data_) + k * capacity_;
+    }
+
+    /// Gathers entity `i`.
+    [[nodiscard]] T get(size_t i) const noexcept
+    {
+        float data[components];
+        for (size_t k = 0; k != components; ++k)
+        {
+            data[k] = component(k)[i];
+        }
+        T out;
+        std::memcpy(static_cast<void*>(&out), data, sizeof(T));
+        return out;
+    }
+
+    /// Scatters `x` to entity `i`.
+    void set(size_t i, T const& x) noexcept
+    {
+        float data[components];
+        std::memcpy(data, static_cast<void const*>(&x), sizeof(T));
+        for (size_t k = 0; k != components; ++k)
+        {
+            component(k)[i] = data[k];
+        }
+    }
+
+    /// Loads component `k` of the entities `[i, i + width<V>)` into `out[k]`
+    /// for each `k`. `V` is `__m128`, or `__m256` if `KLN_ENABLE_ISE_AVX2` is
+    /// defined. Entities up to `capacity()` may be loaded.
+    template <typename V>
+    void load(size_t i, V* out) const noexcept
+    {
+        for (size_t k = 0; k != components; ++k)
+        {
+            out[k] = detail::soa::loadu<V>(component(k) + i);
+        }
+    }
+
+    /// Inverse of `load`
+    template <typename V>
+    void store(size_t i, V const* in) noexcept
+    {
+        for (size_t k = 0; k != components; ++k)
+        {
+            detail::soa::storeu(in[k], component(k) + i);
+        }
+    }
+
+    /// Ensures room for `count` entities without further allocation.
+    bool reserve(size_t count) noexcept
+    {
+        if (count <= capacity_)
+        {
+            return true;
+        }
+
+        size_t capacity = detail::pad(count, padding);
+        size_t bytes    = components * capacity * sizeof(float);
+        float* data     = static_cast<float*>(storage_.allocate(bytes));
+        if (!data)
+        {
+            return false;
+        }
+        if (size_ != 0)
+        {
+            for (size_t k = 0; k != components; ++k)
+            {
+                std::memcpy(
+                    data + k * capacity, component(k), size_ * sizeof(float));
+            }
+        }
+        storage_.replace(data, bytes);
+        capacity_ = capacity;
+        return true;
+    }
+
+    /// Sets the number of entities to `count`. Added entities are zeroed.
+    bool resize(size_t count) noexcept
+    {
+        if (!reserve(count))
+        {
+            return false;
+        }
+        if (count < size_)
+        {
+            for (size_t k = 0; k != components; ++k)
+            {
+                std::memset(
+                    component(k) + count, 0, (size_ - count) * sizeof(float));
+            }
+        }
+        size_ = count;
+        return true;
+    }
+
+    bool push_back(T const& x) noexcept
+    {
+        if (size_ == capacity_ && !reserve(std::max(2 * capacity_, padding)))
+        {
+            return false;
+        }
+        set(size_++, x);
+        return true;
+    }
+
+    /// Transposes the `count` entities at `in` into the container, replacing
+    /// its contents.
+    bool assign(T const* in, size_t count) noexcept
+    {
+        if (!resize(count))
+        {
+            return false;
+        }
+
+        __m128 const* src = reinterpret_cast<__m128 const*>(in);
+        size_t i          = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            for (size_t j = 0; j != partitions; ++j)
+            {
+                __m128 r[4];
+                detail::soa::load4<partitions>(src + partitions * i + j, r);
+                for (size_t c = 0; c != 4; ++c)
+                {
+                    _mm_store_ps(component(4 * j + c) + i, r[c]);
+                }
+            }
+        }
+        for (; i != count; ++i)
+        {
+            set(i, in[i]);
+        }
+        return true;
+    }
+
+    /// Transposes the entities of the container back into `size()` entities
+    /// starting at `out`.
+    void store(T* out) const noexcept
+    {
+        __m128* dst = reinterpret_cast<__m128*>(out);
+        size_t i    = 0;
+        for (; i + 4 <= size_; i += 4)
+        {
+            for (size_t j = 0; j != partitions; ++j)
+            {
+                __m128 r[4];
+                for (size_t c = 0; c != 4; ++c)
+                {
+                    r[c] = _mm_load_ps(component(4 * j + c) + i);
+                }
+                detail::soa::store4<partitions>(r, dst + partitions * i + j);
+            }
+        }
+        for (; i != size_; ++i)
+        {
+            out[i] = get(i);
+        }
+    }
+
+    void clear() noexcept
+    {
+        resize(0);
+    }
+
+private:
+    detail::container_storage<Allocator> storage_;
+    size_t size_     = 0;
+    size_t capacity_ = 0;
+};
+/// @}
+} // namespace kln
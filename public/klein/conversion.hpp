@@ -0,0 +1,357 @@
+#pragma once
+
+#include "mat3x4.hpp"
+#include "mat4x4.hpp"
+#include "motor.hpp"
+
+#include "detail/soa.hpp"
+
+namespace kln
+{
+/// \defgroup conversion Matrix conversion
+/// @{
+///
+/// Batch conversion between motors and matrices, in both directions. The
+/// single motor conversions are `motor::as_mat3x4`, `motor::as_mat4x4`,
+/// `motor::from_mat3x4` and `motor::from_mat4x4`. The routines here produce
+/// the same results for arrays of motors and matrices, four (or eight when
+/// `KLN_ENABLE_ISE_AVX2` is defined) at a time in structure-of-arrays form.
+///
+/// Besides `mat3x4` and `mat4x4` arrays, motors can be converted to and from
+/// a packed layout of 12 floats per motor: the three rows of the 3x4 matrix,
+/// each holding three rotation entries followed by a translation entry. This
+/// is the layout GPU APIs commonly expect for per-instance affine transforms
+/// (a `float3x4` with row-major packing), so the output can be written
+/// straight into a mapped upload buffer.
+///
+/// Motors passed to `as_mat3x4` and `as_packed3x4` must be normalized.
+/// Matrices passed to the `from_*` routines must represent a rotation
+/// followed by a translation.
+///
+/// !!! example
+///
+///     ```cpp
+///         // Upload the world transforms of all instances
+///         float* mapped = map_buffer(instance_count * 12 * sizeof(float));
+///         kln::as_packed3x4(motors, mapped, instance_count);
+///
+///         // Import the transforms of an asset
+///         kln::from_mat3x4(matrices, motors, count);
+///     ```
+
+namespace detail
+{
+    // Upper three rows of the column-major matrices of the motors b + c, one
+    // register per entry. The last column is the translation.
+    template <typename V>
+    KLN_INLINE void motor_to_rows(V const* b, V const* c, V (&r)[3][4]) noexcept
+    {
+        using namespace soa;
+
+        // See mat4x4_12 for the derivation
+        V two  = set1<V>(2.f);
+        V b0_2 = mul(b[0], b[0]);
+        V b1_2 = mul(b[1], b[1]);
+        V b2_2 = mul(b[2], b[2]);
+        V b3_2 = mul(b[3], b[3]);
+        V b0b1 = mul(b[0], b[1]);
+        V b0b2 = mul(b[0], b[2]);
+        V b0b3 = mul(b[0], b[3]);
+        V b1b2 = mul(b[1], b[2]);
+        V b1b3 = mul(b[1], b[3]);
+        V b2b3 = mul(b[2], b[3]);
+
+        r[0][0] = sub(add(b0_2, b1_2), add(b2_2, b3_2));
+        r[1][0] = mul(two, sub(b1b2, b0b3));
+        r[2][0] = mul(two, add(b0b2, b1b3));
+
+        r[0][1] = mul(two, add(b0b3, b1b2));
+        r[1][1] = sub(add(b0_2, b2_2), add(b1_2, b3_2));
+        r[2][1] = mul(two, sub(b2b3, b0b1));
+
+        r[0][2] = mul(two, sub(b1b3, b0b2));
+        r[1][2] = mul(two, add(b0b1, b2b3));
+        r[2][2] = sub(add(b0_2, b3_2), add(b1_2, b2_2));
+
+        r[0][3] = mul(
+            two,
+            fmsub(b[2],
+                  c[3],
+                  fmadd(b[0], c[1], fmadd(b[3], c[2], mul(b[1], c[0])))));
+        r[1][3] = mul(
+            two,
+            fmsub(b[3],
+                  c[1],
+                  fmadd(b[1], c[3], fmadd(b[0], c[2], mul(b[2], c[0])))));
+        r[2][3] = mul(
+            two,
+            fmsub(b[1],
+                  c[2],
+                  fmadd(b[2], c[1], fmadd(b[0], c[3], mul(b[3], c[0])))));
+    }
+
+    // Motors b + c of the matrices with the upper three rows r
+    template <typename V>
+    KLN_INLINE void motor_from_rows(V const (&r)[3][4], V* b, V* c) noexcept
+    {
+        using namespace soa;
+
+        // Shepperd's method, as in motor::from_mat3x4, with the branch on the
+        // largest diagonal entry replaced by selects
+        V one     = set1<V>(1.f);
+        V q[4][4] = {
+            {add(one, add(r[0][0], add(r[1][1], r[2][2]))),
+             sub(r[1][2], r[2][1]),
+             sub(r[2][0], r[0][2]),
+             sub(r[0][1], r[1][0])},
+            {sub(r[1][2], r[2][1]),
+             add(one, sub(r[0][0], add(r[1][1], r[2][2]))),
+             add(r[1][0], r[0][1]),
+             add(r[2][0], r[0][2])},
+            {sub(r[2][0], r[0][2]),
+             add(r[1][0], r[0][1]),
+             add(sub(one, r[0][0]), sub(r[1][1], r[2][2])),
+             add(r[2][1], r[1][2])},
+            {sub(r[0][1], r[1][0]),
+             add(r[2][0], r[0][2]),
+             add(r[2][1], r[1][2]),
+             sub(sub(one, r[0][0]), sub(r[1][1], r[2][2]))}};
+
+        V largest = q[0][0];
+        V v[4]    = {q[0][0], q[0][1], q[0][2], q[0][3]};
+        for (size_t k = 1; k != 4; ++k)
+        {
+            V mask  = cmpgt(q[k][k], largest);
+            largest = select(mask, q[k][k], largest);
+            for (size_t j = 0; j != 4; ++j)
+            {
+                v[j] = select(mask, q[k][j], v[j]);
+            }
+        }
+
+        V s = div(one,
+                  sqrt(fmadd(v[0],
+                             v[0],
+                             dot3(v[1], v[2], v[3], v[1], v[2], v[3]))));
+        for (size_t j = 0; j != 4; ++j)
+        {
+            b[j] = mul(v[j], s);
+        }
+
+        // Translator with ideal part -t / 2 times the rotor
+        V half = set1<V>(-0.5f);
+        V c1   = mul(half, r[0][3]);
+        V c2   = mul(half, r[1][3]);
+        V c3   = mul(half, r[2][3]);
+        c[0]   = dot3(c1, c2, c3, b[1], b[2], b[3]);
+        c[1]   = fmadd(c1, b[0], fmsub(b[2], c3, mul(b[3], c2)));
+        c[2]   = fmadd(c2, b[0], fmsub(b[3], c1, mul(b[1], c3)));
+        c[3]   = fmadd(c3, b[0], fmsub(b[1], c2, mul(b[2], c1)));
+    }
+
+    // Converts width<V> motors to column-major matrices, where the fourth
+    // row is (0, 0, 0, 1) if Normalized and (0, 0, 0, |b|^2) otherwise
+    template <bool Normalized, typename V>
+    KLN_INLINE void motor_to_mat(motor const* in, __m128* out) noexcept
+    {
+        using namespace soa;
+
+        V b[4];
+        V c[4];
+        load<2>(&in->p1_, b);
+        load<2>(&in->p2_, c);
+        V r[3][4];
+        motor_to_rows(b, c, r);
+
+        V w = Normalized
+                  ? set1<V>(1.f)
+                  : fmadd(b[0], b[0], dot3(b[1], b[2], b[3], b[1], b[2], b[3]));
+        for (size_t j = 0; j != 4; ++j)
+        {
+            V col[4] = {r[0][j], r[1][j], r[2][j], j == 3 ? w : zero<V>()};
+            store<4>(col, out + j);
+        }
+    }
+
+    template <typename V>
+    KLN_INLINE void mat_to_motor(__m128 const* in, motor* out) noexcept
+    {
+        using namespace soa;
+
+        V r[3][4];
+        for (size_t j = 0; j != 4; ++j)
+        {
+            V col[4];
+            load<4>(in + j, col);
+            for (size_t i = 0; i != 3; ++i)
+            {
+                r[i][j] = col[i];
+            }
+        }
+        V b[4];
+        V c[4];
+        motor_from_rows(r, b, c);
+        store<2>(b, &out->p1_);
+        store<2>(c, &out->p2_);
+    }
+
+    template <typename V>
+    KLN_INLINE void motor_to_packed(motor const* in, float* out) noexcept
+    {
+        using namespace soa;
+        constexpr size_t w = width<V>;
+
+        V b[4];
+        V c[4];
+        load<2>(&in->p1_, b);
+        load<2>(&in->p2_, c);
+        V r[3][4];
+        motor_to_rows(b, c, r);
+
+        // The output need not be 16-byte aligned
+        __m128 rows[w];
+        for (size_t i = 0; i != 3; ++i)
+        {
+            store<1>(r[i], rows);
+            for (size_t k = 0; k != w; ++k)
+            {
+                _mm_storeu_ps(out + 12 * k + 4 * i, rows[k]);
+            }
+        }
+    }
+
+    template <typename V>
+    KLN_INLINE void packed_to_motor(float const* in, motor* out) noexcept
+    {
+        using namespace soa;
+        constexpr size_t w = width<V>;
+
+        V r[3][4];
+        __m128 rows[w];
+        for (size_t i = 0; i != 3; ++i)
+        {
+            for (size_t k = 0; k != w; ++k)
+            {
+                rows[k] = _mm_loadu_ps(in + 12 * k + 4 * i);
+            }
+            load<1>(rows, r[i]);
+        }
+        V b[4];
+        V c[4];
+        motor_from_rows(r, b, c);
+        store<2>(b, &out->p1_);
+        store<2>(c, &out->p2_);
+    }
+
+    // Invokes f(V{}, i) for each full group of entities starting at i and
+    // returns the index of the first entity not processed
+    template <typename F>
+    KLN_INLINE size_t batch_convert(size_t count, F&& f) noexcept
+    {
+        size_t i = 0;
+#ifdef KLN_ENABLE_ISE_AVX2
+        for (; i + 8 <= count; i += 8)
+        {
+            f(__m256{}, i);
+        }
+#endif
+        for (; i + 4 <= count; i += 4)
+        {
+            f(__m128{}, i);
+        }
+        return i;
+    }
+} // namespace detail
+
+/// Converts the `count` normalized motors in `in` to 3x4 matrices.
+inline void as_mat3x4(motor const* in, mat3x4* out, size_t count) noexcept
+{
+    size_t i = detail::batch_convert(count, [&](auto v, size_t first) {
+        detail::motor_to_mat<true, decltype(v)>(in + first, out[first].cols);
+    });
+    for (; i != count; ++i)
+    {
+        out[i] = in[i].as_mat3x4();
+    }
+}
+
+/// Converts the `count` motors in `in` to 4x4 matrices.
+inline void as_mat4x4(motor const* in, mat4x4* out, size_t count) noexcept
+{
+    size_t i = detail::batch_convert(count, [&](auto v, size_t first) {
+        detail::motor_to_mat<false, decltype(v)>(in + first, out[first].cols);
+    });
+    for (; i != count; ++i)
+    {
+        out[i] = in[i].as_mat4x4();
+    }
+}
+
+/// Writes the 3x4 matrices of the `count` normalized motors in `in` to `out`
+/// as 12 floats per motor: the three rows of each matrix in turn.
+inline void as_packed3x4(motor const* in, float* out, size_t count) noexcept
+{
+    size_t i = detail::batch_convert(count, [&](auto v, size_t first) {
+        detail::motor_to_packed<decltype(v)>(in + first, out + 12 * first);
+    });
+    for (; i != count; ++i)
+    {
+        mat3x4 m = in[i].as_mat3x4();
+        for (size_t r = 0; r != 3; ++r)
+        {
+            for (size_t c = 0; c != 4; ++c)
+            {
+                out[12 * i + 4 * r + c] = m.data[4 * c + r];
+            }
+        }
+    }
+}
+
+/// Recovers the motors of the `count` matrices in `in`. See
+/// `motor::from_mat3x4`.
+inline void from_mat3x4(mat3x4 const* in, motor* out, size_t count) noexcept
+{
+    size_t i = detail::batch_convert(count, [&](auto v, size_t first) {
+        detail::mat_to_motor<decltype(v)>(in[first].cols, out + first);
+    });
+    for (; i != count; ++i)
+    {
+        out[i] = motor::from_mat3x4(in[i]);
+    }
+}
+
+/// Recovers the motors of the `count` matrices in `in`, ignoring their last
+/// rows. See `motor::from_mat3x4`.
+inline void from_mat4x4(mat4x4 const* in, motor* out, size_t count) noexcept
+{
+    size_t i = detail::batch_convert(count, [&](auto v, size_t first) {
+        detail::mat_to_motor<decltype(v)>(in[first].cols, out + first);
+    });
+    for (; i != count; ++i)
+    {
+        out[i] = motor::from_mat4x4(in[i]);
+    }
+}
+
+/// Recovers the motors of the `count` matrices stored in `in` with the
+/// packed layout of `as_packed3x4`.
+inline void from_packed3x4(float const* in, motor* out, size_t count) noexcept
+{
+    size_t i = detail::batch_convert(count, [&](auto v, size_t first) {
+        detail::packed_to_motor<decltype(v)>(in + 12 * first, out + first);
+    });
+    for (; i != count; ++i)
+    {
+        mat3x4 m;
+        for (size_t r = 0; r != 3; ++r)
+        {
+            for (size_t c = 0; c != 4; ++c)
+            {
+                m.data[4 * c + r] = in[12 * i + 4 * r + c];
+            }
+        }
+        out[i] = motor::from_mat3x4(m);
+    }
+}
+/// @}
+} // namespace kln
@@ -0,0 +1,311 @@
+#pragma once
+
+#include "plane.hpp"
+#include "point.hpp"
+
+#include "detail/soa.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace kln
+{
+/// \defgroup culling Culling
+/// @{
+///
+/// Classification of points and bounding spheres against a fixed set of
+/// planes, such as the six planes of a view frustum.
+///
+/// The signed distance of a normalized point $P$ from a normalized plane
+/// $p = a\mathbf{e}_1 + b\mathbf{e}_2 + c\mathbf{e}_3 + d\mathbf{e}_0$ is the
+/// $\mathbf{e}_{0123}$ coefficient of $p\wedge P$, that is $ax + by + cz + d$.
+/// A `plane_set` normalizes its planes once and stores them in
+/// structure-of-arrays form, so that the distances of four (or eight when
+/// `KLN_ENABLE_ISE_AVX2` is defined) objects from one plane cost four
+/// broadcasts and four vertical multiply-adds.
+///
+/// The results are bitmasks with bit `k` referring to plane `k`. An object is
+/// "outside" plane `k` if it lies entirely on its negative side, and "inside"
+/// if it lies entirely on its positive side. A frustum with inward facing
+/// planes thus rejects every object with a nonzero outside mask, and accepts
+/// without clipping every object whose inside mask has all bits set.
+///
+/// `classify` computes the complete masks. When only visibility matters,
+/// `cull` is cheaper: it stops testing planes as soon as every object in the
+/// group at hand has been rejected, and writes out only the indices of the
+/// objects that survive.
+///
+/// !!! example
+///
+///     ```cpp
+///         kln::plane frustum[6] = {/* inward facing planes */};
+///         kln::plane_set planes{frustum, 6};
+///
+///         // Indices of the spheres that may be visible
+///         size_t visible_count
+///             = planes.cull(centers, radii, visible, sphere_count);
+///     ```
+
+/// \ingroup culling
+class plane_set final
+{
+public:
+    /// The masks produced have one bit per plane
+    static constexpr size_t max_planes = 32;
+
+    plane_set() = default;
+
+    /// Stores normalized copies of the first `count` planes in `planes`.
+    /// Planes beyond the first `max_planes` are ignored.
+    plane_set(plane const* planes, size_t count) noexcept
+        : size_{std::min(count, max_planes)}
+    {
+        for (size_t k = 0; k != size_; ++k)
+        {
+            float p[4];
+            _mm_storeu_ps(p, planes[k].normalized().p0_);
+            d_[k] = p[0];
+            a_[k] = p[1];
+            b_[k] = p[2];
+            c_[k] = p[3];
+        }
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    /// The (normalized) plane `k`
+    [[nodiscard]] plane operator[](size_t k) const noexcept
+    {
+        return {a_[k], b_[k], c_[k], d_[k]};
+    }
+
+    /// For each of the `count` normalized points, writes the mask of the
+    /// planes it lies strictly on the negative side of to `outside` and the
+    /// mask of the planes it lies strictly on the positive side of to
+    /// `inside`. Either output may be null.
+    void classify(point const* points,
+                  uint32_t* outside,
+                  uint32_t* inside,
+                  size_t count) const noexcept
+    {
+        for_each_group<false, false>(points, nullptr, outside, inside, count);
+    }
+
+    /// For each of the `count` spheres, with normalized center `centers[i]`
+    /// and radius `radii[i]`, writes the mask of the planes it lies entirely
+    /// on the negative side of to `outside` and the mask of the planes it
+    /// lies entirely on the positive side of to `inside`. Either output may
+    /// be null.
+    void classify(point const* centers,
+                  float const* radii,
+                  uint32_t* outside,
+                  uint32_t* inside,
+                  size_t count) const noexcept
+    {
+        for_each_group<true, false>(centers, radii, outside, inside, count);
+    }
+
+    /// Writes the indices of the normalized points that do not lie strictly
+    /// on the negative side of any plane to `visible`, in increasing order,
+    /// and returns their number.
+    size_t cull(point const* points,
+                uint32_t* visible,
+                size_t count) const noexcept
+    {
+        return for_each_group<false, true>(
+            points, nullptr, visible, nullptr, count);
+    }
+
+    /// Writes the indices of the spheres that do not lie entirely on the
+    /// negative side of any plane to `visible`, in increasing order, and
+    /// returns their number.
+    size_t cull(point const* centers,
+                float const* radii,
+                uint32_t* visible,
+                size_t count) const noexcept
+    {
+        return for_each_group<true, true>(
+            centers, radii, visible, nullptr, count);
+    }
+
+    // Plane coefficients, one array per basis element
+    float d_[max_planes];
+    float a_[max_planes];
+    float b_[max_planes];
+    float c_[max_planes];
+    size_t size_ = 0;
+
+private:
+    // Classifies the width<V> objects starting at centers. In culling mode,
+    // returns the lane mask of objects outside some plane and stops as soon as
+    // every lane is set. Otherwise, writes the complete masks.
+    template <typename V, bool Spheres, bool Cull>
+    int group(point const* centers,
+              float const* radii,
+              uint32_t* outside,
+              uint32_t* inside) const noexcept
+    {
+        using namespace detail::soa;
+
+        V p[4];
+        load<1>(&centers->p3_, p);
+        V r = zero<V>();
+        if constexpr (Spheres)
+        {
+            r = loadu<V>(radii);
+        }
+        V nr = neg(r);
+
+        V out = zero<V>();
+        V in  = zero<V>();
+        for (size_t k = 0; k != size_; ++k)
+        {
+            V dist = fmadd(set1<V>(d_[k]),
+                           p[0],
+                           dot3(set1<V>(a_[k]),
+                                set1<V>(b_[k]),
+                                set1<V>(c_[k]),
+                                p[1],
+                                p[2],
+                                p[3]));
+
+            if constexpr (Cull)
+            {
+                out = bit_or(out, cmplt(dist, nr));
+                if (movemask(out) == (1 << width<V>) - 1)
+                {
+                    break;
+                }
+            }
+            else
+            {
+                V bit = set1_bits<V>(uint32_t{1} << k);
+                out   = bit_or(out, bit_and(cmplt(dist, nr), bit));
+                in    = bit_or(in, bit_and(cmpgt(dist, r), bit));
+            }
+        }
+
+        if constexpr (Cull)
+        {
+            return movemask(out);
+        }
+        else
+        {
+            if (outside)
+            {
+                storeu_bits(out, outside);
+            }
+            if (inside)
+            {
+                storeu_bits(in, inside);
+            }
+            return 0;
+        }
+    }
+
+    // Classifies the group starting at object i and writes its results
+    template <typename V, bool Spheres, bool Cull>
+    KLN_INLINE void process(point const* centers,
+                            float const* radii,
+                            uint32_t* outside,
+                            uint32_t* inside,
+                            size_t i,
+                            size_t& visible) const noexcept
+    {
+        if constexpr (Cull)
+        {
+            int rejected = group<V, Spheres, true>(
+                centers + i, Spheres ? radii + i : nullptr, nullptr, nullptr);
+            for (size_t j = 0; j != detail::soa::width<V>; ++j)
+            {
+                if ((rejected & (1 << j)) == 0)
+                {
+                    outside[visible++] = static_cast<uint32_t>(i + j);
+                }
+            }
+        }
+        else
+        {
+            group<V, Spheres, false>(centers + i,
+                                     Spheres ? radii + i : nullptr,
+                                     outside ? outside + i : nullptr,
+                                     inside ? inside + i : nullptr);
+        }
+    }
+
+    // Shared driver. In culling mode, `outside` receives the visible indices
+    // and the count is returned.
+    template <bool Spheres, bool Cull>
+    size_t for_each_group(point const* centers,
+                          float const* radii,
+                          uint32_t* outside,
+                          uint32_t* inside,
+                          size_t count) const noexcept
+    {
+        size_t visible = 0;
+        size_t i       = 0;
+#ifdef KLN_ENABLE_ISE_AVX2
+        for (; i + 8 <= count; i += 8)
+        {
+            process<__m256, Spheres, Cull>(
+                centers, radii, outside, inside, i, visible);
+        }
+#endif
+        for (; i + 4 <= count; i += 4)
+        {
+            process<__m128, Spheres, Cull>(
+                centers, radii, outside, inside, i, visible);
+        }
+
+        if (i != count)
+        {
+            // Pad the tail by repeating the last object and discard the
+            // surplus results
+            size_t n = count - i;
+            point c[4];
+            float r[4];
+            uint32_t o[4];
+            uint32_t in[4];
+            for (size_t j = 0; j != 4; ++j)
+            {
+                size_t src = i + std::min(j, n - 1);
+                c[j]       = centers[src];
+                r[j]       = Spheres ? radii[src] : 0.f;
+            }
+
+            if constexpr (Cull)
+            {
+                int rejected = group<__m128, Spheres, true>(
+                    c, r, nullptr, nullptr);
+                for (size_t j = 0; j != n; ++j)
+                {
+                    if ((rejected & (1 << j)) == 0)
+                    {
+                        outside[visible++] = static_cast<uint32_t>(i + j);
+                    }
+                }
+            }
+            else
+            {
+                group<__m128, Spheres, false>(c, r, o, in);
+                for (size_t j = 0; j != n; ++j)
+                {
+                    if (outside)
+                    {
+                        outside[i + j] = o[j];
+                    }
+                    if (inside)
+                    {
+                        inside[i + j] = in[j];
+                    }
+                }
+            }
+        }
+        return visible;
+    }
+};
+/// @}
+} // namespace kln
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "x86/x86_f64.hpp"
+#include "x86/x86_f64_exp_log.hpp"
+#include "x86/x86_f64_geometric_product.hpp"
+#include "x86/x86_f64_sandwich.hpp"
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "x86/x86_soa.hpp"
+#include "x86/x86_soa_exp_log.hpp"
+#include "x86/x86_soa_geometric_product.hpp"
+#include "x86/x86_soa_sandwich.hpp"
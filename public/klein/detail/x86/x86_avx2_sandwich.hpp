@@ -0,0 +1,227 @@
+// File: x86_avx2_sandwich.hpp
+// Purpose: AVX2/FMA loop bodies for the variadic sandwich routines defined in
+// x86_sandwich.hpp.
+//
+// Notes:
+// 1. The temporaries computed at the top of sw012, sw312, and swMM depend only
+//    on the rotor/motor being applied. They are computed once with SSE, then
+//    broadcast to both 128-bit lanes of a YMM register.
+// 2. Point and plane kernels process two entities per 256-bit register (one
+//    per lane). A line occupies two partitions, so the line kernel processes
+//    one line per 256-bit register with p1 in the low lane and p2 in the high
+//    lane.
+// 3. Any remaining entity is handled with 128-bit FMA instructions.
+// 4. As with the SSE kernels, in and out are permitted to alias iff in == out.
+// 5. If Stream is true, out is written with streaming stores and the input is
+//    prefetched ahead of use (see kln::non_temporal).
+
+#pragma once
+
+#include "x86_sse.hpp"
+
+namespace kln
+{
+namespace detail
+{
+    // Partition memory layouts
+    //     LSB --> MSB
+    // p0: (e0, e1, e2, e3)
+    // p1: (1, e23, e31, e12)
+    // p2: (e0123, e01, e02, e03)
+    // p3: (e123, e032, e013, e021)
+
+    KLN_INLINE __m256 KLN_VEC_CALL broadcast_lanes(__m128 a) noexcept
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(a), a, 1);
+    }
+
+    // Writes the two 128-bit lanes of a to out, bypassing the caches if
+    // Stream is true. As out is only 16-byte aligned in general, the lanes
+    // are streamed separately (the write-combining buffers merge them).
+    template <bool Stream>
+    KLN_INLINE void KLN_VEC_CALL store_lanes(__m128* out, __m256 a) noexcept
+    {
+        float* dst = reinterpret_cast<float*>(out);
+        if constexpr (Stream)
+        {
+            _mm_stream_ps(dst, _mm256_castps256_ps128(a));
+            _mm_stream_ps(dst + 4, _mm256_extractf128_ps(a, 1));
+        }
+        else
+        {
+            _mm256_storeu_ps(dst, a);
+        }
+    }
+
+    // Loop body of sw012 (motor or rotor applied to planes, or rotor applied
+    // to points and directions). See sw012 for the definition of the
+    // temporaries. tmp4 is ignored if Translate is false.
+    template <bool Translate, bool Stream>
+    KLN_INLINE void KLN_VEC_CALL sw012_avx2(__m128 const* KLN_RESTRICT a,
+                                            __m128 tmp1,
+                                            __m128 tmp2,
+                                            __m128 tmp3,
+                                            [[maybe_unused]] __m128 tmp4,
+                                            __m128* out,
+                                            size_t count) noexcept
+    {
+        __m256 t1 = broadcast_lanes(tmp1);
+        __m256 t2 = broadcast_lanes(tmp2);
+        __m256 t3 = broadcast_lanes(tmp3);
+        [[maybe_unused]] __m256 t4;
+        if constexpr (Translate)
+        {
+            t4 = broadcast_lanes(tmp4);
+        }
+
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2)
+        {
+            prefetch_ahead<Stream>(a + i);
+
+            __m256 in = _mm256_loadu_ps(reinterpret_cast<float const*>(a + i));
+            __m256 p  = _mm256_mul_ps(t1, KLN_SWIZZLE_256(in, 1, 3, 2, 0));
+            p = _mm256_fmadd_ps(t2, KLN_SWIZZLE_256(in, 2, 1, 3, 0), p);
+            p = _mm256_fmadd_ps(t3, in, p);
+
+            if constexpr (Translate)
+            {
+                // Lane-local equivalent of hi_dp
+                p = _mm256_add_ps(p, _mm256_dp_ps(t4, in, 0b11100001));
+            }
+
+            store_lanes<Stream>(out + i, p);
+        }
+
+        if (i != count)
+        {
+            __m128 in = a[i];
+            __m128 p  = _mm_mul_ps(tmp1, KLN_SWIZZLE(in, 1, 3, 2, 0));
+            p         = _mm_fmadd_ps(tmp2, KLN_SWIZZLE(in, 2, 1, 3, 0), p);
+            p         = _mm_fmadd_ps(tmp3, in, p);
+
+            if constexpr (Translate)
+            {
+                p = _mm_add_ps(p, hi_dp(tmp4, in));
+            }
+
+            store_entity<Stream>(out + i, p);
+        }
+    }
+
+    // Loop body of sw312 (motor applied to points and directions). See sw312
+    // for the definition of the temporaries. tmp4 is ignored if Translate is
+    // false.
+    template <bool Translate, bool Stream>
+    KLN_INLINE void KLN_VEC_CALL sw312_avx2(__m128 const* KLN_RESTRICT a,
+                                            __m128 tmp1,
+                                            __m128 tmp2,
+                                            __m128 tmp3,
+                                            [[maybe_unused]] __m128 tmp4,
+                                            __m128* out,
+                                            size_t count) noexcept
+    {
+        __m256 t1 = broadcast_lanes(tmp1);
+        __m256 t2 = broadcast_lanes(tmp2);
+        __m256 t3 = broadcast_lanes(tmp3);
+        [[maybe_unused]] __m256 t4;
+        if constexpr (Translate)
+        {
+            t4 = broadcast_lanes(tmp4);
+        }
+
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2)
+        {
+            prefetch_ahead<Stream>(a + i);
+
+            __m256 in = _mm256_loadu_ps(reinterpret_cast<float const*>(a + i));
+            __m256 p  = _mm256_mul_ps(t1, KLN_SWIZZLE_256(in, 2, 1, 3, 0));
+            p = _mm256_fmadd_ps(t2, KLN_SWIZZLE_256(in, 1, 3, 2, 0), p);
+            p = _mm256_fmadd_ps(t3, in, p);
+
+            if constexpr (Translate)
+            {
+                p = _mm256_fmadd_ps(t4, KLN_SWIZZLE_256(in, 0, 0, 0, 0), p);
+            }
+
+            store_lanes<Stream>(out + i, p);
+        }
+
+        if (i != count)
+        {
+            __m128 in = a[i];
+            __m128 p  = _mm_mul_ps(tmp1, KLN_SWIZZLE(in, 2, 1, 3, 0));
+            p         = _mm_fmadd_ps(tmp2, KLN_SWIZZLE(in, 1, 3, 2, 0), p);
+            p         = _mm_fmadd_ps(tmp3, in, p);
+
+            if constexpr (Translate)
+            {
+                p = _mm_fmadd_ps(tmp4, KLN_SWIZZLE(in, 0, 0, 0, 0), p);
+            }
+
+            store_entity<Stream>(out + i, p);
+        }
+    }
+
+    // Loop body of swMM for full lines (InputP2 is true). See swMM for the
+    // definition of the temporaries. Because the rotational temporaries applied
+    // to p2 are identical to those applied to p1, a single set of broadcast
+    // registers is used for both halves of the line. tmp7, tmp8, and tmp9 are
+    // ignored if Translate is false.
+    template <bool Translate, bool Stream>
+    KLN_INLINE void KLN_VEC_CALL swMM_avx2(__m128 const* KLN_RESTRICT in,
+                                          __m128 tmp,
+                                          __m128 tmp2,
+                                          __m128 tmp3,
+                                          [[maybe_unused]] __m128 tmp7,
+                                          [[maybe_unused]] __m128 tmp8,
+                                          [[maybe_unused]] __m128 tmp9,
+                                          __m128* out,
+                                          size_t count) noexcept
+    {
+        __m256 t1 = broadcast_lanes(tmp);
+        __m256 t2 = broadcast_lanes(tmp2);
+        __m256 t3 = broadcast_lanes(tmp3);
+
+        // The translational temporaries only contribute to the p2 (high) lane
+        [[maybe_unused]] __m256 t7;
+        [[maybe_unused]] __m256 t8;
+        [[maybe_unused]] __m256 t9;
+        if constexpr (Translate)
+        {
+            __m256 zero = _mm256_setzero_ps();
+            t7          = _mm256_insertf128_ps(zero, tmp7, 1);
+            t8          = _mm256_insertf128_ps(zero, tmp8, 1);
+            t9          = _mm256_insertf128_ps(zero, tmp9, 1);
+        }
+
+        for (size_t i = 0; i != count; ++i)
+        {
+            prefetch_ahead<Stream>(in + 2 * i);
+
+            // (p1, p2)
+            __m256 l
+                = _mm256_loadu_ps(reinterpret_cast<float const*>(in + 2 * i));
+            __m256 l_xzwy = KLN_SWIZZLE_256(l, 1, 3, 2, 0);
+            __m256 l_xwyz = KLN_SWIZZLE_256(l, 2, 1, 3, 0);
+
+            __m256 p = _mm256_mul_ps(t1, l);
+            p        = _mm256_fmadd_ps(t2, l_xzwy, p);
+            p        = _mm256_fmadd_ps(t3, l_xwyz, p);
+
+            if constexpr (Translate)
+            {
+                // Broadcast p1 (and its swizzles) to both lanes
+                p = _mm256_fmadd_ps(t7, _mm256_permute2f128_ps(l, l, 0), p);
+                p = _mm256_fmadd_ps(
+                    t8, _mm256_permute2f128_ps(l_xwyz, l_xwyz, 0), p);
+                p = _mm256_fmadd_ps(
+                    t9, _mm256_permute2f128_ps(l_xzwy, l_xzwy, 0), p);
+            }
+
+            store_lanes<Stream>(out + 2 * i, p);
+        }
+    }
+} // namespace detail
+} // namespace kln
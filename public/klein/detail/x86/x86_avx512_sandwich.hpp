@@ -0,0 +1,212 @@
+// File: x86_avx512_sandwich.hpp
+// Purpose: AVX-512 loop bodies for the variadic sandwich routines defined in
+// x86_sandwich.hpp.
+//
+// Notes:
+// 1. The layout mirrors x86_avx2_sandwich.hpp with four 128-bit lanes per ZMM
+//    register instead of two. Point and plane kernels process four entities
+//    per iteration, and the line kernel processes two lines per iteration
+//    (p1, p2, p1, p2).
+// 2. The final partial iteration is handled with masked loads and stores so
+//    no scalar remainder loop is needed.
+// 3. As with the SSE kernels, in and out are permitted to alias iff in == out.
+// 4. If Stream is true, out is written with streaming stores and the input is
+//    prefetched ahead of use (see kln::non_temporal).
+
+#pragma once
+
+#include "x86_sse.hpp"
+
+namespace kln
+{
+namespace detail
+{
+    // Partition memory layouts
+    //     LSB --> MSB
+    // p0: (e0, e1, e2, e3)
+    // p1: (1, e23, e31, e12)
+    // p2: (e0123, e01, e02, e03)
+    // p3: (e123, e032, e013, e021)
+
+    // Mask selecting the first n 128-bit lanes of a ZMM register (n <= 4)
+    KLN_INLINE __mmask16 lane_mask(size_t n) noexcept
+    {
+        return n >= 4 ? static_cast<__mmask16>(0xffff)
+                      : static_cast<__mmask16>((1u << (4 * n)) - 1);
+    }
+
+    // Writes the first n 128-bit lanes of a to out, bypassing the caches if
+    // Stream is true. There is no masked streaming store, and out is only
+    // 16-byte aligned in general, so the lanes are streamed separately (the
+    // write-combining buffers merge them).
+    template <bool Stream>
+    KLN_INLINE void KLN_VEC_CALL store_lanes(__m128* out,
+                                             __m512 a,
+                                             size_t n) noexcept
+    {
+        float* dst = reinterpret_cast<float*>(out);
+        if constexpr (Stream)
+        {
+            _mm_stream_ps(dst, _mm512_castps512_ps128(a));
+            if (n > 1)
+            {
+                _mm_stream_ps(dst + 4, _mm512_extractf32x4_ps(a, 1));
+            }
+            if (n > 2)
+            {
+                _mm_stream_ps(dst + 8, _mm512_extractf32x4_ps(a, 2));
+            }
+            if (n > 3)
+            {
+                _mm_stream_ps(dst + 12, _mm512_extractf32x4_ps(a, 3));
+            }
+        }
+        else
+        {
+            _mm512_mask_storeu_ps(dst, lane_mask(n), a);
+        }
+    }
+
+    // Loop body of sw012. See sw012 for the definition of the temporaries.
+    // tmp4 is ignored if Translate is false.
+    template <bool Translate, bool Stream>
+    KLN_INLINE void KLN_VEC_CALL sw012_avx512(__m128 const* KLN_RESTRICT a,
+                                              __m128 tmp1,
+                                              __m128 tmp2,
+                                              __m128 tmp3,
+                                              [[maybe_unused]] __m128 tmp4,
+                                              __m128* out,
+                                              size_t count) noexcept
+    {
+        __m512 t1 = _mm512_broadcast_f32x4(tmp1);
+        __m512 t2 = _mm512_broadcast_f32x4(tmp2);
+        __m512 t3 = _mm512_broadcast_f32x4(tmp3);
+        [[maybe_unused]] __m512 t4;
+        if constexpr (Translate)
+        {
+            t4 = _mm512_broadcast_f32x4(tmp4);
+        }
+
+        for (size_t i = 0; i < count; i += 4)
+        {
+            prefetch_ahead<Stream>(a + i);
+
+            __mmask16 mask = lane_mask(count - i);
+            __m512 in      = _mm512_maskz_loadu_ps(mask, a + i);
+            __m512 p       = _mm512_mul_ps(t1, KLN_SWIZZLE_512(in, 1, 3, 2, 0));
+            p = _mm512_fmadd_ps(t2, KLN_SWIZZLE_512(in, 2, 1, 3, 0), p);
+            p = _mm512_fmadd_ps(t3, in, p);
+
+            if constexpr (Translate)
+            {
+                // Lane-local equivalent of hi_dp accumulated into the low
+                // component of each lane
+                __m512 dp = _mm512_mul_ps(t4, in);
+                __m512 hi = _mm512_add_ps(KLN_SWIZZLE_512(dp, 0, 0, 0, 1),
+                                          KLN_SWIZZLE_512(dp, 0, 0, 0, 2));
+                hi        = _mm512_add_ps(hi, KLN_SWIZZLE_512(dp, 0, 0, 0, 3));
+                p         = _mm512_mask_add_ps(p, 0x1111, p, hi);
+            }
+
+            store_lanes<Stream>(out + i, p, count - i);
+        }
+    }
+
+    // Loop body of sw312. See sw312 for the definition of the temporaries.
+    // tmp4 is ignored if Translate is false.
+    template <bool Translate, bool Stream>
+    KLN_INLINE void KLN_VEC_CALL sw312_avx512(__m128 const* KLN_RESTRICT a,
+                                              __m128 tmp1,
+                                              __m128 tmp2,
+                                              __m128 tmp3,
+                                              [[maybe_unused]] __m128 tmp4,
+                                              __m128* out,
+                                              size_t count) noexcept
+    {
+        __m512 t1 = _mm512_broadcast_f32x4(tmp1);
+        __m512 t2 = _mm512_broadcast_f32x4(tmp2);
+        __m512 t3 = _mm512_broadcast_f32x4(tmp3);
+        [[maybe_unused]] __m512 t4;
+        if constexpr (Translate)
+        {
+            t4 = _mm512_broadcast_f32x4(tmp4);
+        }
+
+        for (size_t i = 0; i < count; i += 4)
+        {
+            prefetch_ahead<Stream>(a + i);
+
+            __mmask16 mask = lane_mask(count - i);
+            __m512 in      = _mm512_maskz_loadu_ps(mask, a + i);
+            __m512 p       = _mm512_mul_ps(t1, KLN_SWIZZLE_512(in, 2, 1, 3, 0));
+            p = _mm512_fmadd_ps(t2, KLN_SWIZZLE_512(in, 1, 3, 2, 0), p);
+            p = _mm512_fmadd_ps(t3, in, p);
+
+            if constexpr (Translate)
+            {
+                p = _mm512_fmadd_ps(t4, KLN_SWIZZLE_512(in, 0, 0, 0, 0), p);
+            }
+
+            store_lanes<Stream>(out + i, p, count - i);
+        }
+    }
+
+    // Loop body of swMM for full lines (InputP2 is true). See swMM_avx2 for
+    // the role of each temporary. tmp7, tmp8, and tmp9 are ignored if
+    // Translate is false.
+    template <bool Translate, bool Stream>
+    KLN_INLINE void KLN_VEC_CALL swMM_avx512(__m128 const* KLN_RESTRICT in,
+                                             __m128 tmp,
+                                             __m128 tmp2,
+                                             __m128 tmp3,
+                                             [[maybe_unused]] __m128 tmp7,
+                                             [[maybe_unused]] __m128 tmp8,
+                                             [[maybe_unused]] __m128 tmp9,
+                                             __m128* out,
+                                             size_t count) noexcept
+    {
+        __m512 t1 = _mm512_broadcast_f32x4(tmp);
+        __m512 t2 = _mm512_broadcast_f32x4(tmp2);
+        __m512 t3 = _mm512_broadcast_f32x4(tmp3);
+
+        // The translational temporaries only contribute to the p2 lanes
+        [[maybe_unused]] __m512 t7;
+        [[maybe_unused]] __m512 t8;
+        [[maybe_unused]] __m512 t9;
+        if constexpr (Translate)
+        {
+            t7 = _mm512_maskz_mov_ps(0xf0f0, _mm512_broadcast_f32x4(tmp7));
+            t8 = _mm512_maskz_mov_ps(0xf0f0, _mm512_broadcast_f32x4(tmp8));
+            t9 = _mm512_maskz_mov_ps(0xf0f0, _mm512_broadcast_f32x4(tmp9));
+        }
+
+        for (size_t i = 0; i < count; i += 2)
+        {
+            prefetch_ahead<Stream>(in + 2 * i);
+
+            // (p1, p2, p1, p2)
+            __mmask16 mask = count - i >= 2 ? 0xffff : 0x00ff;
+            __m512 l       = _mm512_maskz_loadu_ps(mask, in + 2 * i);
+            __m512 l_xzwy  = KLN_SWIZZLE_512(l, 1, 3, 2, 0);
+            __m512 l_xwyz  = KLN_SWIZZLE_512(l, 2, 1, 3, 0);
+
+            __m512 p = _mm512_mul_ps(t1, l);
+            p        = _mm512_fmadd_ps(t2, l_xzwy, p);
+            p        = _mm512_fmadd_ps(t3, l_xwyz, p);
+
+            if constexpr (Translate)
+            {
+                // Duplicate each line's p1 (and its swizzles) into its p2 lane
+                constexpr int dup = _MM_SHUFFLE(2, 2, 0, 0);
+                p = _mm512_fmadd_ps(t7, _mm512_shuffle_f32x4(l, l, dup), p);
+                p = _mm512_fmadd_ps(
+                    t8, _mm512_shuffle_f32x4(l_xwyz, l_xwyz, dup), p);
+                p = _mm512_fmadd_ps(
+                    t9, _mm512_shuffle_f32x4(l_xzwy, l_xzwy, dup), p);
+            }
+
+            store_lanes<Stream>(out + 2 * i, p, count - i >= 2 ? 4 : 2);
+        }
+    }
+} // namespace detail
+} // namespace kln
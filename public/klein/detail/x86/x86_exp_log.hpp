@@ -18,6 +18,13 @@ namespace detail
     // p2: (e0123, e01, e02, e03)
     // p3: (e123, e032, e013, e021)
 
+    // Squared norm of the Euclidean part of a bivector below which exp and log
+    // switch to their first order expansions. Normalizing the ideal part
+    // scales by the squared norm to the power -3/2, which overflows not far
+    // below this threshold. Above it, the closed forms are exact to float
+    // precision.
+    constexpr float ideal_threshold = 1e-25f;
+
     // a := p1
     // b := p2
     // a + b is a general bivector but it is most likely *non-simple* meaning
@@ -51,6 +58,17 @@ namespace detail
         __m128 a2 = hi_dp_bc(a, a);
         __m128 ab = hi_dp_bc(a, b);
 
+        // A (nearly) purely ideal bivector cannot be normalized. Its
+        // exponential is 1 + a + b + (a . b) e0123 up to terms of order
+        // |a|^2, which are below float precision here. For a = 0, this is the
+        // translator 1 + b.
+        if (_mm_cvtss_f32(a2) < ideal_threshold)
+        {
+            p1_out = _mm_move_ss(a, _mm_set_ss(1.f));
+            p2_out = _mm_move_ss(b, ab);
+            return;
+        }
+
         // Next, we need the sqrt of that quantity. Since e0123 squares to 0,
         // this has a closed form solution.
         //
@@ -146,7 +164,18 @@ namespace detail
 
         // Next, we need to compute the norm as in the exponential.
         __m128 a2 = hi_dp_bc(a, a);
-        // TODO: handle case when a2 is 0
+
+        // A motor with a (nearly) vanishing Euclidean bivector part is close
+        // to a (scaled) translator p + b. Its logarithm is (a + b) / p up to
+        // terms below float precision.
+        if (_mm_cvtss_f32(a2) < ideal_threshold)
+        {
+            __m128 p_rcp = detail::rcp_nr1(_mm_shuffle_ps(p1, p1, 0));
+            p1_out       = _mm_mul_ps(a, p_rcp);
+            p2_out       = _mm_mul_ps(b, p_rcp);
+            return;
+        }
+
         __m128 ab          = hi_dp_bc(a, b);
         __m128 a2_sqrt_rcp = detail::rsqrt_nr1(a2);
         __m128 s           = _mm_mul_ps(a2, a2_sqrt_rcp);
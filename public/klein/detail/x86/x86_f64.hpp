@@ -0,0 +1,139 @@
+// File: x86_f64.hpp
+// Purpose: Vector primitives used by the double precision kernels.
+//
+// Notes:
+// 1. Each partition of a double precision entity occupies a single YMM
+//    register holding four doubles, in the same order as the four floats of
+//    the corresponding XMM partition. The kernels are line for line
+//    translations of the single precision kernels, with KLN_SWIZZLE_PD in
+//    place of KLN_SWIZZLE.
+// 2. Operations that the single precision kernels perform on the low
+//    component only (_mm_add_ss and friends) have no YMM equivalent and are
+//    expressed with blends or masked operands instead.
+// 3. Reciprocals and square roots are always computed with full precision
+//    division and square roots; there are no double precision estimates below
+//    AVX-512.
+
+#pragma once
+
+#include "x86_sse.hpp"
+
+#ifdef KLN_ENABLE_ISE_AVX2
+
+namespace kln
+{
+namespace detail
+{
+namespace f64
+{
+    // Sign mask of the low component, the counterpart of _mm_set_ss(-0.f)
+    [[nodiscard]] KLN_INLINE __m256d flip_lo() noexcept
+    {
+        return _mm256_set_pd(0.0, 0.0, 0.0, -0.0);
+    }
+
+    // Sign mask of the three high components
+    [[nodiscard]] KLN_INLINE __m256d flip_hi() noexcept
+    {
+        return _mm256_set_pd(-0.0, -0.0, -0.0, 0.0);
+    }
+
+    [[nodiscard]] KLN_INLINE __m256d set_lo(double a) noexcept
+    {
+        return _mm256_set_pd(0.0, 0.0, 0.0, a);
+    }
+
+    [[nodiscard]] KLN_INLINE double KLN_VEC_CALL lo(__m256d a) noexcept
+    {
+        return _mm256_cvtsd_f64(a);
+    }
+
+    // Component i of a
+    [[nodiscard]] KLN_INLINE double KLN_VEC_CALL lane(__m256d a,
+                                                      size_t i) noexcept
+    {
+        alignas(32) double out[4];
+        _mm256_store_pd(out, a);
+        return out[i];
+    }
+
+    // Zeroes the low component of a
+    [[nodiscard]] KLN_INLINE __m256d KLN_VEC_CALL mask_lo(__m256d a) noexcept
+    {
+        return _mm256_blend_pd(a, _mm256_setzero_pd(), 0b0001);
+    }
+
+    // Zeroes all but the low component of a
+    [[nodiscard]] KLN_INLINE __m256d KLN_VEC_CALL keep_lo(__m256d a) noexcept
+    {
+        return _mm256_blend_pd(_mm256_setzero_pd(), a, 0b0001);
+    }
+
+    // Sum of the four components of a, broadcast
+    [[nodiscard]] KLN_INLINE __m256d KLN_VEC_CALL hsum_bc(__m256d a) noexcept
+    {
+        // (a0 + a2, a1 + a3)
+        __m128d sum = _mm_add_pd(
+            _mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+        sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+        return _mm256_broadcastsd_pd(sum);
+    }
+
+    // a1 b1 + a2 b2 + a3 b3 broadcast to all components. Equivalent to the
+    // single precision hi_dp_bc.
+    [[nodiscard]] KLN_INLINE __m256d KLN_VEC_CALL hi_dp_bc(__m256d a,
+                                                           __m256d b) noexcept
+    {
+        return hsum_bc(mask_lo(_mm256_mul_pd(a, b)));
+    }
+
+    // a1 b1 + a2 b2 + a3 b3 in the low component, zero elsewhere
+    [[nodiscard]] KLN_INLINE __m256d KLN_VEC_CALL hi_dp(__m256d a,
+                                                        __m256d b) noexcept
+    {
+        return keep_lo(hi_dp_bc(a, b));
+    }
+
+    // Dot product of all four components broadcast
+    [[nodiscard]] KLN_INLINE __m256d KLN_VEC_CALL dp_bc(__m256d a,
+                                                        __m256d b) noexcept
+    {
+        return hsum_bc(_mm256_mul_pd(a, b));
+    }
+
+    [[nodiscard]] KLN_INLINE __m256d KLN_VEC_CALL reciprocal(__m256d a) noexcept
+    {
+        return _mm256_div_pd(_mm256_set1_pd(1.0), a);
+    }
+
+    [[nodiscard]] KLN_INLINE __m256d KLN_VEC_CALL
+    reciprocal_sqrt(__m256d a) noexcept
+    {
+        return _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(a));
+    }
+
+    // True if every component of a is within epsilon of that of b
+    [[nodiscard]] KLN_INLINE bool KLN_VEC_CALL
+    approx_eq(__m256d a, __m256d b, double epsilon) noexcept
+    {
+        __m256d diff
+            = _mm256_andnot_pd(_mm256_set1_pd(-0.0), _mm256_sub_pd(a, b));
+        __m256d cmp = _mm256_cmp_pd(diff, _mm256_set1_pd(epsilon), _CMP_LT_OQ);
+        return _mm256_movemask_pd(cmp) == 0xf;
+    }
+
+    // Widening and narrowing of a partition
+    [[nodiscard]] KLN_INLINE __m256d KLN_VEC_CALL widen(__m128 a) noexcept
+    {
+        return _mm256_cvtps_pd(a);
+    }
+
+    [[nodiscard]] KLN_INLINE __m128 KLN_VEC_CALL narrow(__m256d a) noexcept
+    {
+        return _mm256_cvtpd_ps(a);
+    }
+} // namespace f64
+} // namespace detail
+} // namespace kln
+
+#endif
@@ -0,0 +1,136 @@
+// File: x86_f64_exp_log.hpp
+// Purpose: Double precision counterparts of the bivector exponential and motor
+// logarithm. See x86_exp_log.hpp for the derivation.
+
+#pragma once
+
+#include "x86_f64.hpp"
+
+#include <cmath>
+
+#ifdef KLN_ENABLE_ISE_AVX2
+
+namespace kln
+{
+namespace detail
+{
+namespace f64
+{
+    // Squared norm of the Euclidean part of a bivector below which it is
+    // treated as purely ideal. Below this threshold, the Euclidean part
+    // contributes less than a double precision ulp to the result.
+    constexpr double ideal_threshold = 1e-30;
+
+    // a := p1
+    // b := p2
+    // Exponentiates the bivector a + b and returns the motor defined by
+    // partitions 1 and 2.
+    KLN_INLINE void KLN_VEC_CALL exp(__m256d a,
+                                     __m256d b,
+                                     __m256d& KLN_RESTRICT p1_out,
+                                     __m256d& KLN_RESTRICT p2_out) noexcept
+    {
+        __m256d a2 = hi_dp_bc(a, a);
+        __m256d ab = hi_dp_bc(a, b);
+
+        // A purely ideal bivector (including zero) cannot be normalized, but
+        // its exponential is simply the translator 1 + b.
+        if (lo(a2) < ideal_threshold)
+        {
+            p1_out = set_lo(1.0);
+            p2_out = mask_lo(b);
+            return;
+        }
+
+        // u + vI is the square root of the squared norm
+        __m256d a2_sqrt_rcp = reciprocal_sqrt(a2);
+        __m256d u           = _mm256_mul_pd(a2, a2_sqrt_rcp);
+        // Don't forget the minus later!
+        __m256d minus_v = _mm256_mul_pd(ab, a2_sqrt_rcp);
+
+        // The normalized bivector n
+        __m256d norm_real  = _mm256_mul_pd(a, a2_sqrt_rcp);
+        __m256d norm_ideal = _mm256_mul_pd(b, a2_sqrt_rcp);
+        norm_ideal         = _mm256_sub_pd(
+            norm_ideal,
+            _mm256_mul_pd(
+                a,
+                _mm256_mul_pd(
+                    ab, _mm256_mul_pd(a2_sqrt_rcp, reciprocal(a2)))));
+
+        // e^(u n + v n e0123) = cosu + sinu n + v n cosu e0123 - v sinu e0123
+        double uv[2] = {lo(u), lo(minus_v)};
+        double sinu  = std::sin(uv[0]);
+        double cosu  = std::cos(uv[0]);
+
+        __m256d sinu_vec = _mm256_set1_pd(sinu);
+        p1_out
+            = _mm256_add_pd(set_lo(cosu), _mm256_mul_pd(sinu_vec, norm_real));
+
+        __m256d cosu_vec    = _mm256_set_pd(cosu, cosu, cosu, 0.0);
+        __m256d minus_vcosu = _mm256_mul_pd(minus_v, cosu_vec);
+        p2_out              = _mm256_mul_pd(sinu_vec, norm_ideal);
+        p2_out = _mm256_add_pd(p2_out, _mm256_mul_pd(minus_vcosu, norm_real));
+        p2_out = _mm256_add_pd(set_lo(uv[1] * sinu), p2_out);
+    }
+
+    KLN_INLINE void KLN_VEC_CALL log(__m256d p1,
+                                     __m256d p2,
+                                     __m256d& KLN_RESTRICT p1_out,
+                                     __m256d& KLN_RESTRICT p2_out) noexcept
+    {
+        // Extract only the bivector components from the motor
+        __m256d a = mask_lo(p1);
+        __m256d b = mask_lo(p2);
+
+        __m256d a2 = hi_dp_bc(a, a);
+
+        // A motor without a Euclidean bivector part is a (scaled) translator
+        // p + b whose logarithm is b / p.
+        if (lo(a2) < ideal_threshold)
+        {
+            p1_out = _mm256_setzero_pd();
+            p2_out = _mm256_div_pd(b, KLN_SWIZZLE_PD(p1, 0, 0, 0, 0));
+            return;
+        }
+
+        __m256d ab          = hi_dp_bc(a, b);
+        __m256d a2_sqrt_rcp = reciprocal_sqrt(a2);
+        __m256d s           = _mm256_mul_pd(a2, a2_sqrt_rcp);
+        __m256d minus_t     = _mm256_mul_pd(ab, a2_sqrt_rcp);
+        // s + t e0123 is the norm of our bivector.
+
+        // p = cosu
+        // q = -v sinu
+        // s_scalar = sinu
+        // t_scalar = v cosu
+        double p        = lo(p1);
+        double q        = lo(p2);
+        double s_scalar = lo(s);
+        double t_scalar = -lo(minus_t);
+
+        bool p_zero = std::abs(p) < 1e-6;
+        double u = p_zero ? std::atan2(-q, t_scalar) : std::atan2(s_scalar, p);
+        double v = p_zero ? -q / s_scalar : t_scalar / p;
+
+        // (u + v e0123) * n is the logarithm
+        __m256d norm_real  = _mm256_mul_pd(a, a2_sqrt_rcp);
+        __m256d norm_ideal = _mm256_mul_pd(b, a2_sqrt_rcp);
+        norm_ideal         = _mm256_sub_pd(
+            norm_ideal,
+            _mm256_mul_pd(
+                a,
+                _mm256_mul_pd(
+                    ab, _mm256_mul_pd(a2_sqrt_rcp, reciprocal(a2)))));
+
+        __m256d uvec = _mm256_set1_pd(u);
+        p1_out       = _mm256_mul_pd(uvec, norm_real);
+        p2_out       = _mm256_mul_pd(uvec, norm_ideal);
+        p2_out = _mm256_sub_pd(
+            p2_out, _mm256_mul_pd(_mm256_set1_pd(v), norm_real));
+    }
+} // namespace f64
+} // namespace detail
+} // namespace kln
+
+#endif
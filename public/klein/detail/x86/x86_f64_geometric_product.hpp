@@ -0,0 +1,203 @@
+// File: x86_f64_geometric_product.hpp
+// Purpose: Double precision counterparts of the geometric products between
+// rotors, translators, motors, and lines. See x86_geometric_product.hpp for
+// the symbolic expansions; the kernels below evaluate them term for term.
+
+#pragma once
+
+#include "x86_f64.hpp"
+
+#ifdef KLN_ENABLE_ISE_AVX2
+
+namespace kln
+{
+namespace detail
+{
+namespace f64
+{
+    // Partition memory layouts
+    //     LSB --> MSB
+    // p0: (e0, e1, e2, e3)
+    // p1: (1, e23, e31, e12)
+    // p2: (e0123, e01, e02, e03)
+    // p3: (e123, e032, e013, e021)
+
+    KLN_INLINE void KLN_VEC_CALL gp11(__m256d a,
+                                      __m256d b,
+                                      __m256d& p1_out) noexcept
+    {
+        // (a0 b0 - a1 b1 - a2 b2 - a3 b3) +
+        // (a0 b1 - a2 b3 + a1 b0 + a3 b2)*e23
+        // (a0 b2 - a3 b1 + a2 b0 + a1 b3)*e31
+        // (a0 b3 - a1 b2 + a3 b0 + a2 b1)*e12
+        p1_out = _mm256_mul_pd(KLN_SWIZZLE_PD(a, 0, 0, 0, 0), b);
+        p1_out = _mm256_sub_pd(p1_out,
+                               _mm256_mul_pd(KLN_SWIZZLE_PD(a, 1, 3, 2, 1),
+                                             KLN_SWIZZLE_PD(b, 2, 1, 3, 1)));
+
+        __m256d tmp = _mm256_mul_pd(
+            KLN_SWIZZLE_PD(a, 3, 2, 1, 2), KLN_SWIZZLE_PD(b, 0, 0, 0, 2));
+        tmp = _mm256_add_pd(tmp,
+                            _mm256_mul_pd(KLN_SWIZZLE_PD(a, 2, 1, 3, 3),
+                                          KLN_SWIZZLE_PD(b, 1, 3, 2, 3)));
+        tmp = _mm256_xor_pd(tmp, flip_lo());
+
+        p1_out = _mm256_add_pd(p1_out, tmp);
+    }
+
+    // a := rotor p1, b := translator p2. With Flip, computes b * a rather than
+    // a * b.
+    template <bool Flip>
+    KLN_INLINE void KLN_VEC_CALL gpRT(__m256d a,
+                                      __m256d b,
+                                      __m256d& p2) noexcept
+    {
+        p2 = _mm256_mul_pd(
+            KLN_SWIZZLE_PD(a, 0, 0, 0, 1), KLN_SWIZZLE_PD(b, 3, 2, 1, 1));
+
+        if constexpr (Flip)
+        {
+            p2 = _mm256_add_pd(p2,
+                               _mm256_mul_pd(KLN_SWIZZLE_PD(a, 1, 3, 2, 2),
+                                             KLN_SWIZZLE_PD(b, 2, 1, 3, 2)));
+            p2 = _mm256_sub_pd(
+                p2,
+                _mm256_xor_pd(flip_lo(),
+                              _mm256_mul_pd(KLN_SWIZZLE_PD(a, 2, 1, 3, 3),
+                                            KLN_SWIZZLE_PD(b, 1, 3, 2, 3))));
+        }
+        else
+        {
+            p2 = _mm256_add_pd(p2,
+                               _mm256_mul_pd(KLN_SWIZZLE_PD(a, 2, 1, 3, 2),
+                                             KLN_SWIZZLE_PD(b, 1, 3, 2, 2)));
+            p2 = _mm256_sub_pd(
+                p2,
+                _mm256_xor_pd(flip_lo(),
+                              _mm256_mul_pd(KLN_SWIZZLE_PD(a, 1, 3, 2, 3),
+                                            KLN_SWIZZLE_PD(b, 2, 1, 3, 3))));
+        }
+    }
+
+    template <bool Flip>
+    KLN_INLINE void KLN_VEC_CALL gp12(__m256d a,
+                                      __m256d b,
+                                      __m256d& p2) noexcept
+    {
+        gpRT<Flip>(a, b, p2);
+        p2 = _mm256_sub_pd(
+            p2,
+            _mm256_xor_pd(flip_lo(),
+                          _mm256_mul_pd(a, KLN_SWIZZLE_PD(b, 0, 0, 0, 0))));
+    }
+
+    // Dual number u + v e0123 times the line (b, c)
+    KLN_INLINE void KLN_VEC_CALL gpDL(double u,
+                                      double v,
+                                      __m256d b,
+                                      __m256d c,
+                                      __m256d& KLN_RESTRICT p1,
+                                      __m256d& KLN_RESTRICT p2) noexcept
+    {
+        __m256d u_vec = _mm256_set1_pd(u);
+        __m256d v_vec = _mm256_set1_pd(v);
+        p1            = _mm256_mul_pd(u_vec, b);
+        p2            = _mm256_mul_pd(c, u_vec);
+        p2            = _mm256_sub_pd(p2, _mm256_mul_pd(b, v_vec));
+    }
+
+    KLN_INLINE void KLN_VEC_CALL gpLL(__m256d const& KLN_RESTRICT l1,
+                                      __m256d const& KLN_RESTRICT l2,
+                                      __m256d* KLN_RESTRICT out) noexcept
+    {
+        __m256d const& a = l1;
+        __m256d const& d = *(&l1 + 1);
+        __m256d const& b = l2;
+        __m256d const& c = *(&l2 + 1);
+
+        __m256d flip = flip_lo();
+
+        __m256d& p1 = *out;
+        __m256d& p2 = *(out + 1);
+
+        p1 = _mm256_mul_pd(
+            KLN_SWIZZLE_PD(a, 3, 1, 2, 1), KLN_SWIZZLE_PD(b, 2, 3, 1, 1));
+        p1 = _mm256_xor_pd(p1, flip);
+        p1 = _mm256_sub_pd(p1,
+                           _mm256_mul_pd(KLN_SWIZZLE_PD(a, 2, 3, 1, 3),
+                                         KLN_SWIZZLE_PD(b, 3, 1, 2, 3)));
+        __m256d a2 = KLN_SWIZZLE_PD(a, 2, 2, 2, 2);
+        __m256d b2 = KLN_SWIZZLE_PD(b, 2, 2, 2, 2);
+        p1         = _mm256_sub_pd(p1, keep_lo(_mm256_mul_pd(a2, b2)));
+
+        p2 = _mm256_mul_pd(
+            KLN_SWIZZLE_PD(a, 2, 1, 3, 1), KLN_SWIZZLE_PD(c, 1, 3, 2, 1));
+        p2 = _mm256_sub_pd(
+            p2,
+            _mm256_xor_pd(flip,
+                          _mm256_mul_pd(KLN_SWIZZLE_PD(a, 1, 3, 2, 3),
+                                        KLN_SWIZZLE_PD(c, 2, 1, 3, 3))));
+        p2 = _mm256_add_pd(p2,
+                           _mm256_mul_pd(KLN_SWIZZLE_PD(b, 1, 3, 2, 1),
+                                         KLN_SWIZZLE_PD(d, 2, 1, 3, 1)));
+        p2 = _mm256_sub_pd(
+            p2,
+            _mm256_xor_pd(flip,
+                          _mm256_mul_pd(KLN_SWIZZLE_PD(b, 2, 1, 3, 3),
+                                        KLN_SWIZZLE_PD(d, 1, 3, 2, 3))));
+        __m256d c2 = KLN_SWIZZLE_PD(c, 2, 2, 2, 2);
+        __m256d d2 = KLN_SWIZZLE_PD(d, 2, 2, 2, 2);
+        p2         = _mm256_add_pd(p2, keep_lo(_mm256_mul_pd(a2, c2)));
+        p2         = _mm256_add_pd(p2, keep_lo(_mm256_mul_pd(b2, d2)));
+    }
+
+    KLN_INLINE void KLN_VEC_CALL gpMM(__m256d const& KLN_RESTRICT m1,
+                                      __m256d const& KLN_RESTRICT m2,
+                                      __m256d* KLN_RESTRICT out) noexcept
+    {
+        __m256d const& a = m1;
+        __m256d const& b = *(&m1 + 1);
+        __m256d const& c = m2;
+        __m256d const& d = *(&m2 + 1);
+
+        __m256d& e = *out;
+        __m256d& f = *(out + 1);
+
+        __m256d a_xxxx = KLN_SWIZZLE_PD(a, 0, 0, 0, 0);
+        __m256d a_zyzw = KLN_SWIZZLE_PD(a, 3, 2, 1, 2);
+        __m256d a_ywyz = KLN_SWIZZLE_PD(a, 2, 1, 3, 1);
+        __m256d a_wzwy = KLN_SWIZZLE_PD(a, 1, 3, 2, 3);
+        __m256d c_wwyz = KLN_SWIZZLE_PD(c, 2, 1, 3, 3);
+        __m256d c_yzwy = KLN_SWIZZLE_PD(c, 1, 3, 2, 1);
+        __m256d s_flip = flip_lo();
+
+        e         = _mm256_mul_pd(a_xxxx, c);
+        __m256d t = _mm256_mul_pd(a_ywyz, c_yzwy);
+        t = _mm256_add_pd(
+            t, _mm256_mul_pd(a_zyzw, KLN_SWIZZLE_PD(c, 0, 0, 0, 2)));
+        t = _mm256_xor_pd(t, s_flip);
+        e = _mm256_add_pd(e, t);
+        e = _mm256_sub_pd(e, _mm256_mul_pd(a_wzwy, c_wwyz));
+
+        f = _mm256_mul_pd(a_xxxx, d);
+        f = _mm256_add_pd(f, _mm256_mul_pd(b, KLN_SWIZZLE_PD(c, 0, 0, 0, 0)));
+        f = _mm256_add_pd(
+            f, _mm256_mul_pd(a_ywyz, KLN_SWIZZLE_PD(d, 1, 3, 2, 1)));
+        f = _mm256_add_pd(
+            f, _mm256_mul_pd(KLN_SWIZZLE_PD(b, 2, 1, 3, 1), c_yzwy));
+        t = _mm256_mul_pd(a_zyzw, KLN_SWIZZLE_PD(d, 0, 0, 0, 2));
+        t = _mm256_add_pd(
+            t, _mm256_mul_pd(a_wzwy, KLN_SWIZZLE_PD(d, 2, 1, 3, 3)));
+        t = _mm256_add_pd(t,
+                          _mm256_mul_pd(KLN_SWIZZLE_PD(b, 0, 0, 0, 2),
+                                        KLN_SWIZZLE_PD(c, 3, 2, 1, 2)));
+        t = _mm256_add_pd(
+            t, _mm256_mul_pd(KLN_SWIZZLE_PD(b, 1, 3, 2, 3), c_wwyz));
+        t = _mm256_xor_pd(t, s_flip);
+        f = _mm256_sub_pd(f, t);
+    }
+} // namespace f64
+} // namespace detail
+} // namespace kln
+
+#endif
@@ -0,0 +1,308 @@
+// File: x86_f64_sandwich.hpp
+// Purpose: Double precision counterparts of the sandwich operators applying
+// rotors, translators, and motors to planes, points, and lines. See
+// x86_sandwich.hpp for the symbolic expansions. Only the single entity forms
+// are provided.
+
+#pragma once
+
+#include "x86_f64.hpp"
+
+#ifdef KLN_ENABLE_ISE_AVX2
+
+namespace kln
+{
+namespace detail
+{
+namespace f64
+{
+    // Partition memory layouts
+    //     LSB --> MSB
+    // p0: (e0, e1, e2, e3)
+    // p1: (1, e23, e31, e12)
+    // p2: (e0123, e01, e02, e03)
+    // p3: (e123, e032, e013, e021)
+
+    // Apply a translator to a plane. The low component of b is expected to be
+    // the scalar component of the translator (see sw02 in x86_sandwich.hpp).
+    [[nodiscard]] KLN_INLINE __m256d KLN_VEC_CALL sw02(__m256d a,
+                                                       __m256d b) noexcept
+    {
+        __m256d tmp = hi_dp(a, b);
+        tmp         = _mm256_mul_pd(tmp, set_lo(2.0 / lo(b)));
+        return _mm256_add_pd(a, tmp);
+    }
+
+    // Apply a translator to a line
+    // a := p1 input
+    // d := p2 input
+    // c := p2 translator
+    KLN_INLINE void KLN_VEC_CALL swL2(__m256d a,
+                                      __m256d d,
+                                      __m256d c,
+                                      __m256d* out) noexcept
+    {
+        __m256d& p1_out = *out;
+        __m256d& p2_out = *(out + 1);
+
+        p1_out = a;
+
+        p2_out = _mm256_mul_pd(
+            KLN_SWIZZLE_PD(a, 1, 3, 2, 0), KLN_SWIZZLE_PD(c, 2, 1, 3, 0));
+        p2_out = _mm256_sub_pd(p2_out,
+                               _mm256_mul_pd(KLN_SWIZZLE_PD(a, 2, 1, 3, 0),
+                                             KLN_SWIZZLE_PD(c, 1, 3, 2, 0)));
+        p2_out = _mm256_sub_pd(
+            p2_out,
+            _mm256_xor_pd(_mm256_mul_pd(a, KLN_SWIZZLE_PD(c, 0, 0, 0, 0)),
+                          flip_lo()));
+        p2_out = _mm256_add_pd(p2_out, p2_out);
+        p2_out = _mm256_add_pd(p2_out, d);
+    }
+
+    // Apply a rotor (b) or motor (b, c) to a line (in[0], in[1]). If
+    // Translate is false, c is ignored.
+    template <bool Translate>
+    KLN_INLINE void KLN_VEC_CALL swMM(__m256d const* KLN_RESTRICT in,
+                                      __m256d b,
+                                      [[maybe_unused]] __m256d const* c,
+                                      __m256d* out) noexcept
+    {
+        __m256d tmp   = _mm256_mul_pd(b, b);
+        __m256d b_tmp = KLN_SWIZZLE_PD(b, 0, 0, 0, 1);
+        tmp           = _mm256_add_pd(tmp, _mm256_mul_pd(b_tmp, b_tmp));
+        b_tmp         = KLN_SWIZZLE_PD(b, 2, 1, 3, 2);
+        __m256d tmp2  = _mm256_mul_pd(b_tmp, b_tmp);
+        b_tmp         = KLN_SWIZZLE_PD(b, 1, 3, 2, 3);
+        tmp2          = _mm256_add_pd(tmp2, _mm256_mul_pd(b_tmp, b_tmp));
+        tmp = _mm256_sub_pd(tmp, _mm256_xor_pd(tmp2, flip_lo()));
+        // tmp is scaled by a (and d)
+
+        __m256d bzero = KLN_SWIZZLE_PD(b, 0, 0, 0, 0);
+        __m256d scale = _mm256_set_pd(2.0, 2.0, 2.0, 0.0);
+        tmp2          = _mm256_mul_pd(bzero, KLN_SWIZZLE_PD(b, 2, 1, 3, 0));
+        tmp2          = _mm256_add_pd(
+            tmp2, _mm256_mul_pd(b, KLN_SWIZZLE_PD(b, 1, 3, 2, 0)));
+        tmp2 = _mm256_mul_pd(tmp2, scale);
+        // tmp2 is scaled by (a0, a2, a3, a1) (and likewise for d)
+
+        __m256d tmp3 = _mm256_mul_pd(b, KLN_SWIZZLE_PD(b, 2, 1, 3, 0));
+        tmp3         = _mm256_sub_pd(
+            tmp3, _mm256_mul_pd(bzero, KLN_SWIZZLE_PD(b, 1, 3, 2, 0)));
+        tmp3 = _mm256_mul_pd(tmp3, scale);
+        // tmp3 is scaled by (a0, a3, a1, a2) (and likewise for d)
+
+        __m256d const p1_in = in[0]; // a
+        __m256d const p2_in = in[1]; // d
+
+        __m256d p1_out = _mm256_mul_pd(tmp, p1_in);
+        p1_out         = _mm256_add_pd(
+            p1_out, _mm256_mul_pd(tmp2, KLN_SWIZZLE_PD(p1_in, 1, 3, 2, 0)));
+        p1_out = _mm256_add_pd(
+            p1_out, _mm256_mul_pd(tmp3, KLN_SWIZZLE_PD(p1_in, 2, 1, 3, 0)));
+
+        __m256d p2_out = _mm256_mul_pd(tmp, p2_in);
+        p2_out         = _mm256_add_pd(
+            p2_out, _mm256_mul_pd(tmp2, KLN_SWIZZLE_PD(p2_in, 1, 3, 2, 0)));
+        p2_out = _mm256_add_pd(
+            p2_out, _mm256_mul_pd(tmp3, KLN_SWIZZLE_PD(p2_in, 2, 1, 3, 0)));
+
+        if constexpr (Translate)
+        {
+            __m256d czero = KLN_SWIZZLE_PD(*c, 0, 0, 0, 0);
+            __m256d tmp7  = _mm256_mul_pd(b, *c);
+            tmp7          = _mm256_sub_pd(tmp7,
+                                 _mm256_mul_pd(KLN_SWIZZLE_PD(b, 0, 0, 0, 1),
+                                               KLN_SWIZZLE_PD(*c, 0, 0, 0, 1)));
+            tmp7          = _mm256_sub_pd(tmp7,
+                                 _mm256_mul_pd(KLN_SWIZZLE_PD(b, 1, 3, 3, 2),
+                                               KLN_SWIZZLE_PD(*c, 1, 3, 3, 2)));
+            tmp7          = _mm256_sub_pd(tmp7,
+                                 _mm256_mul_pd(KLN_SWIZZLE_PD(b, 2, 1, 2, 3),
+                                               KLN_SWIZZLE_PD(*c, 2, 1, 2, 3)));
+            tmp7          = _mm256_add_pd(tmp7, tmp7);
+
+            __m256d tmp8 = _mm256_mul_pd(b, KLN_SWIZZLE_PD(*c, 2, 1, 3, 0));
+            tmp8         = _mm256_add_pd(
+                tmp8, _mm256_mul_pd(KLN_SWIZZLE_PD(b, 1, 3, 2, 0), czero));
+            tmp8 = _mm256_add_pd(
+                tmp8, _mm256_mul_pd(KLN_SWIZZLE_PD(b, 2, 1, 3, 0), *c));
+            tmp8 = _mm256_sub_pd(
+                tmp8, _mm256_mul_pd(bzero, KLN_SWIZZLE_PD(*c, 1, 3, 2, 0)));
+            tmp8 = _mm256_mul_pd(tmp8, scale);
+
+            __m256d tmp9 = _mm256_mul_pd(b, KLN_SWIZZLE_PD(*c, 1, 3, 2, 0));
+            tmp9         = _mm256_add_pd(
+                tmp9, _mm256_mul_pd(bzero, KLN_SWIZZLE_PD(*c, 2, 1, 3, 0)));
+            tmp9 = _mm256_add_pd(
+                tmp9, _mm256_mul_pd(KLN_SWIZZLE_PD(b, 1, 3, 2, 0), *c));
+            tmp9 = _mm256_sub_pd(
+                tmp9, _mm256_mul_pd(KLN_SWIZZLE_PD(b, 2, 1, 3, 0), czero));
+            tmp9 = _mm256_mul_pd(tmp9, scale);
+
+            p2_out = _mm256_add_pd(p2_out, _mm256_mul_pd(tmp7, p1_in));
+            p2_out = _mm256_add_pd(
+                p2_out,
+                _mm256_mul_pd(tmp8, KLN_SWIZZLE_PD(p1_in, 2, 1, 3, 0)));
+            p2_out = _mm256_add_pd(
+                p2_out,
+                _mm256_mul_pd(tmp9, KLN_SWIZZLE_PD(p1_in, 1, 3, 2, 0)));
+        }
+
+        out[0] = p1_out;
+        out[1] = p2_out;
+    }
+
+    // Apply a rotor (b) or motor (b, c) to a plane a. If Translate is false,
+    // c is ignored. Without translation, this also applies a rotor to a point
+    // or direction.
+    template <bool Translate>
+    [[nodiscard]] KLN_INLINE __m256d KLN_VEC_CALL
+    sw012(__m256d a, __m256d b, [[maybe_unused]] __m256d const* c) noexcept
+    {
+        // Double-cover scale
+        __m256d dc_scale = _mm256_set_pd(2.0, 2.0, 2.0, 1.0);
+        __m256d b_xwyz   = KLN_SWIZZLE_PD(b, 2, 1, 3, 0);
+        __m256d b_xzwy   = KLN_SWIZZLE_PD(b, 1, 3, 2, 0);
+        __m256d b_xxxx   = KLN_SWIZZLE_PD(b, 0, 0, 0, 0);
+
+        __m256d tmp1 = _mm256_mul_pd(
+            KLN_SWIZZLE_PD(b, 0, 0, 0, 2), KLN_SWIZZLE_PD(b, 2, 1, 3, 2));
+        tmp1 = _mm256_add_pd(tmp1,
+                             _mm256_mul_pd(KLN_SWIZZLE_PD(b, 1, 3, 2, 1),
+                                           KLN_SWIZZLE_PD(b, 3, 2, 1, 1)));
+        // Scale later with (a0, a2, a3, a1)
+        tmp1 = _mm256_mul_pd(tmp1, dc_scale);
+
+        __m256d tmp2 = _mm256_mul_pd(b, b_xwyz);
+        tmp2         = _mm256_sub_pd(
+            tmp2,
+            _mm256_xor_pd(flip_lo(),
+                          _mm256_mul_pd(KLN_SWIZZLE_PD(b, 0, 0, 0, 3),
+                                        KLN_SWIZZLE_PD(b, 1, 3, 2, 3))));
+        // Scale later with (a0, a3, a1, a2)
+        tmp2 = _mm256_mul_pd(tmp2, dc_scale);
+
+        // Alternately add and subtract to improve low component stability
+        __m256d tmp3 = _mm256_mul_pd(b, b);
+        tmp3         = _mm256_sub_pd(tmp3, _mm256_mul_pd(b_xwyz, b_xwyz));
+        tmp3         = _mm256_add_pd(tmp3, _mm256_mul_pd(b_xxxx, b_xxxx));
+        tmp3         = _mm256_sub_pd(tmp3, _mm256_mul_pd(b_xzwy, b_xzwy));
+        // Scale later with a
+
+        __m256d p = _mm256_mul_pd(tmp1, KLN_SWIZZLE_PD(a, 1, 3, 2, 0));
+        p = _mm256_add_pd(
+            p, _mm256_mul_pd(tmp2, KLN_SWIZZLE_PD(a, 2, 1, 3, 0)));
+        p = _mm256_add_pd(p, _mm256_mul_pd(tmp3, a));
+
+        if constexpr (Translate)
+        {
+            __m256d tmp4 = _mm256_mul_pd(b_xxxx, *c);
+            tmp4         = _mm256_add_pd(
+                tmp4, _mm256_mul_pd(b_xzwy, KLN_SWIZZLE_PD(*c, 2, 1, 3, 0)));
+            tmp4 = _mm256_add_pd(
+                tmp4, _mm256_mul_pd(b, KLN_SWIZZLE_PD(*c, 0, 0, 0, 0)));
+
+            // NOTE: The high component of tmp4 is meaningless here
+            tmp4 = _mm256_sub_pd(
+                tmp4, _mm256_mul_pd(b_xwyz, KLN_SWIZZLE_PD(*c, 1, 3, 2, 0)));
+            tmp4 = _mm256_mul_pd(tmp4, dc_scale);
+
+            p = _mm256_add_pd(p, hi_dp(tmp4, a));
+        }
+
+        return p;
+    }
+
+    // Apply a translator to a point.
+    // Assumes e0123 component of p2 is exactly 0
+    [[nodiscard]] KLN_INLINE __m256d KLN_VEC_CALL sw32(__m256d a,
+                                                       __m256d b) noexcept
+    {
+        __m256d tmp = _mm256_mul_pd(KLN_SWIZZLE_PD(a, 0, 0, 0, 0), b);
+        tmp = _mm256_mul_pd(_mm256_set_pd(-2.0, -2.0, -2.0, 0.0), tmp);
+        return _mm256_add_pd(a, tmp);
+    }
+
+    // Apply a motor (b, c) to a point a. If Translate is false, c is ignored
+    // (this applies a motor to a direction).
+    template <bool Translate>
+    [[nodiscard]] KLN_INLINE __m256d KLN_VEC_CALL
+    sw312(__m256d a, __m256d b, [[maybe_unused]] __m256d const* c) noexcept
+    {
+        __m256d two   = _mm256_set_pd(2.0, 2.0, 2.0, 0.0);
+        __m256d bzero = KLN_SWIZZLE_PD(b, 0, 0, 0, 0);
+
+        __m256d tmp1 = _mm256_mul_pd(b, KLN_SWIZZLE_PD(b, 2, 1, 3, 0));
+        tmp1         = _mm256_sub_pd(
+            tmp1, _mm256_mul_pd(bzero, KLN_SWIZZLE_PD(b, 1, 3, 2, 0)));
+        tmp1 = _mm256_mul_pd(tmp1, two);
+        // tmp1 needs to be scaled by (_, a3, a1, a2)
+
+        __m256d tmp2 = _mm256_mul_pd(bzero, KLN_SWIZZLE_PD(b, 2, 1, 3, 0));
+        tmp2         = _mm256_add_pd(
+            tmp2, _mm256_mul_pd(KLN_SWIZZLE_PD(b, 1, 3, 2, 0), b));
+        tmp2 = _mm256_mul_pd(tmp2, two);
+        // tmp2 needs to be scaled by (_, a2, a3, a1)
+
+        __m256d tmp3  = _mm256_mul_pd(b, b);
+        __m256d b_tmp = KLN_SWIZZLE_PD(b, 0, 0, 0, 1);
+        tmp3          = _mm256_add_pd(tmp3, _mm256_mul_pd(b_tmp, b_tmp));
+        b_tmp         = KLN_SWIZZLE_PD(b, 2, 1, 3, 2);
+        __m256d tmp4  = _mm256_mul_pd(b_tmp, b_tmp);
+        b_tmp         = KLN_SWIZZLE_PD(b, 1, 3, 2, 3);
+        tmp4          = _mm256_add_pd(tmp4, _mm256_mul_pd(b_tmp, b_tmp));
+        tmp3 = _mm256_sub_pd(tmp3, _mm256_xor_pd(tmp4, flip_lo()));
+        // tmp3 needs to be scaled by (a0, a1, a2, a3)
+
+        __m256d p = _mm256_mul_pd(tmp1, KLN_SWIZZLE_PD(a, 2, 1, 3, 0));
+        p = _mm256_add_pd(
+            p, _mm256_mul_pd(tmp2, KLN_SWIZZLE_PD(a, 1, 3, 2, 0)));
+        p = _mm256_add_pd(p, _mm256_mul_pd(tmp3, a));
+
+        if constexpr (Translate)
+        {
+            tmp4 = _mm256_mul_pd(
+                KLN_SWIZZLE_PD(b, 1, 3, 2, 0), KLN_SWIZZLE_PD(*c, 2, 1, 3, 0));
+            tmp4 = _mm256_sub_pd(tmp4, _mm256_mul_pd(bzero, *c));
+            tmp4 = _mm256_sub_pd(tmp4,
+                                 _mm256_mul_pd(KLN_SWIZZLE_PD(b, 2, 1, 3, 0),
+                                               KLN_SWIZZLE_PD(*c, 1, 3, 2, 0)));
+            tmp4 = _mm256_sub_pd(
+                tmp4, _mm256_mul_pd(b, KLN_SWIZZLE_PD(*c, 0, 0, 0, 0)));
+
+            // Mask low component and scale other components by 2
+            tmp4 = _mm256_mul_pd(tmp4, two);
+            // tmp4 needs to be scaled by (_, a0, a0, a0)
+
+            p = _mm256_add_pd(
+                p, _mm256_mul_pd(tmp4, KLN_SWIZZLE_PD(a, 0, 0, 0, 0)));
+        }
+
+        return p;
+    }
+
+    // Conjugate origin with motor. The motor MUST be normalized. b is the
+    // rotor component (p1) c is the translator component (p2)
+    [[nodiscard]] KLN_INLINE __m256d KLN_VEC_CALL swo12(__m256d b,
+                                                        __m256d c) noexcept
+    {
+        __m256d tmp = _mm256_mul_pd(b, KLN_SWIZZLE_PD(c, 0, 0, 0, 0));
+        tmp         = _mm256_add_pd(
+            tmp, _mm256_mul_pd(KLN_SWIZZLE_PD(b, 0, 0, 0, 0), c));
+        tmp = _mm256_add_pd(tmp,
+                            _mm256_mul_pd(KLN_SWIZZLE_PD(b, 2, 1, 3, 0),
+                                          KLN_SWIZZLE_PD(c, 1, 3, 2, 0)));
+        tmp = _mm256_sub_pd(_mm256_mul_pd(KLN_SWIZZLE_PD(b, 1, 3, 2, 0),
+                                          KLN_SWIZZLE_PD(c, 2, 1, 3, 0)),
+                            tmp);
+        tmp = _mm256_mul_pd(tmp, _mm256_set_pd(2.0, 2.0, 2.0, 0.0));
+
+        // b0^2 + b1^2 + b2^2 + b3^2 assumed to equal 1
+        return _mm256_add_pd(tmp, set_lo(1.0));
+    }
+} // namespace f64
+} // namespace detail
+} // namespace kln
+
+#endif
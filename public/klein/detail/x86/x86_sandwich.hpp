@@ -16,6 +16,12 @@
 
 #include "x86_sse.hpp"
 
+#ifdef KLN_ENABLE_ISE_AVX512
+#    include "x86_avx512_sandwich.hpp"
+#elif defined(KLN_ENABLE_ISE_AVX2)
+#    include "x86_avx2_sandwich.hpp"
+#endif
+
 namespace kln
 {
 namespace detail
@@ -235,7 +241,7 @@ namespace detail
     // and p2)
     //
     // Note: in and out are permitted to alias iff a == out.
-    template <bool Variadic, bool Translate, bool InputP2>
+    template <bool Variadic, bool Translate, bool InputP2, bool Stream = false>
     KLN_INLINE void KLN_VEC_CALL swMM(__m128 const* KLN_RESTRICT in,
                                       __m128 const& KLN_RESTRICT b,
                                       [[maybe_unused]] __m128 const* KLN_RESTRICT c,
@@ -366,41 +372,89 @@ namespace detail
             tmp9 = _mm_mul_ps(tmp9, scale);
         }
 
+#ifdef KLN_ENABLE_ISE_AVX512
+        if constexpr (Variadic && InputP2)
+        {
+            // tmp4, tmp5, and tmp6 are identical to tmp, tmp2, and tmp3
+            if constexpr (Translate)
+            {
+                swMM_avx512<true, Stream>(
+                    in, tmp, tmp2, tmp3, tmp7, tmp8, tmp9, out, count);
+            }
+            else
+            {
+                __m128 zero = _mm_setzero_ps();
+                swMM_avx512<false, Stream>(
+                    in, tmp, tmp2, tmp3, zero, zero, zero, out, count);
+            }
+            return;
+        }
+#elif defined(KLN_ENABLE_ISE_AVX2)
+        if constexpr (Variadic && InputP2)
+        {
+            // tmp4, tmp5, and tmp6 are identical to tmp, tmp2, and tmp3
+            if constexpr (Translate)
+            {
+                swMM_avx2<true, Stream>(
+                    in, tmp, tmp2, tmp3, tmp7, tmp8, tmp9, out, count);
+            }
+            else
+            {
+                __m128 zero = _mm_setzero_ps();
+                swMM_avx2<false, Stream>(
+                    in, tmp, tmp2, tmp3, zero, zero, zero, out, count);
+            }
+            return;
+        }
+#endif
+
         size_t limit            = Variadic ? count : 1;
         constexpr size_t stride = InputP2 ? 2 : 1;
         for (size_t i = 0; i != limit; ++i)
         {
-            __m128 const& p1_in = in[stride * i]; // a
-            __m128& p1_out      = out[stride * i];
+            prefetch_ahead<Stream>(in + stride * i);
+
+            // Inputs are copied before any output is written so that in-place
+            // application (in == out) is well-defined
+            __m128 const p1_in = in[stride * i]; // a
 
-            p1_out = _mm_mul_ps(tmp, p1_in);
+            __m128 p1_out = _mm_mul_ps(tmp, p1_in);
             p1_out = _mm_add_ps(
                 p1_out, _mm_mul_ps(tmp2, KLN_SWIZZLE(p1_in, 1, 3, 2, 0)));
             p1_out = _mm_add_ps(
                 p1_out, _mm_mul_ps(tmp3, KLN_SWIZZLE(p1_in, 2, 1, 3, 0)));
 
+            [[maybe_unused]] __m128 p2_out;
             if constexpr (InputP2)
             {
-                __m128 const& p2_in = in[2 * i + 1]; // d
-                __m128& p2_out      = out[2 * i + 1];
-                p2_out              = _mm_mul_ps(tmp4, p2_in);
-                p2_out              = _mm_add_ps(
+                __m128 const p2_in = in[2 * i + 1]; // d
+                p2_out             = _mm_mul_ps(tmp4, p2_in);
+                p2_out             = _mm_add_ps(
                     p2_out, _mm_mul_ps(tmp5, KLN_SWIZZLE(p2_in, 1, 3, 2, 0)));
                 p2_out = _mm_add_ps(
                     p2_out, _mm_mul_ps(tmp6, KLN_SWIZZLE(p2_in, 2, 1, 3, 0)));
             }
+            else if constexpr (Translate)
+            {
+                p2_out = out[2 * i + 1];
+            }
 
             // If what is being applied is a rotor, the non-directional
             // components of the line are left untouched
             if constexpr (Translate)
             {
-                __m128& p2_out = out[2 * i + 1];
-                p2_out         = _mm_add_ps(p2_out, _mm_mul_ps(tmp7, p1_in));
-                p2_out         = _mm_add_ps(
+                p2_out = _mm_add_ps(p2_out, _mm_mul_ps(tmp7, p1_in));
+                p2_out = _mm_add_ps(
                     p2_out, _mm_mul_ps(tmp8, KLN_SWIZZLE(p1_in, 2, 1, 3, 0)));
                 p2_out = _mm_add_ps(
                     p2_out, _mm_mul_ps(tmp9, KLN_SWIZZLE(p1_in, 1, 3, 2, 0)));
             }
+
+            store_entity<Stream>(out + stride * i, p1_out);
+            if constexpr (InputP2 || Translate)
+            {
+                store_entity<Stream>(out + 2 * i + 1, p2_out);
+            }
         }
     }
 
@@ -411,7 +465,9 @@ namespace detail
     // If Translate is false, c is ignored (rotor application).
     // If Variadic is true, a and out must point to a contiguous block of memory
     // equivalent to __m128[count]
-    template <bool Variadic = false, bool Translate = true>
+    // If Stream is true, out is written with streaming stores (see
+    // kln::non_temporal) and the caller issues the store fence.
+    template <bool Variadic = false, bool Translate = true, bool Stream = false>
     KLN_INLINE void KLN_VEC_CALL sw012(__m128 const* KLN_RESTRICT a,
                                        __m128 b,
                                        [[maybe_unused]] __m128 const* KLN_RESTRICT c,
@@ -500,20 +556,56 @@ namespace detail
         // The temporaries (tmp1, tmp2, tmp3, tmp4) strictly only have a
         // dependence on b and c.
 
+#ifdef KLN_ENABLE_ISE_AVX512
+        if constexpr (Variadic)
+        {
+            if constexpr (Translate)
+            {
+                sw012_avx512<true, Stream>(
+                    a, tmp1, tmp2, tmp3, tmp4, out, count);
+            }
+            else
+            {
+                sw012_avx512<false, Stream>(
+                    a, tmp1, tmp2, tmp3, _mm_setzero_ps(), out, count);
+            }
+            return;
+        }
+#elif defined(KLN_ENABLE_ISE_AVX2)
+        if constexpr (Variadic)
+        {
+            if constexpr (Translate)
+            {
+                sw012_avx2<true, Stream>(
+                    a, tmp1, tmp2, tmp3, tmp4, out, count);
+            }
+            else
+            {
+                sw012_avx2<false, Stream>(
+                    a, tmp1, tmp2, tmp3, _mm_setzero_ps(), out, count);
+            }
+            return;
+        }
+#endif
+
         size_t limit = Variadic ? count : 1;
         for (size_t i = 0; i != limit; ++i)
         {
+            prefetch_ahead<Stream>(a + i);
+
             // Compute the lower block for components e1, e2, and e3
-            __m128& p = out[i];
-            p         = _mm_mul_ps(tmp1, KLN_SWIZZLE(a[i], 1, 3, 2, 0));
-            p = _mm_add_ps(p, _mm_mul_ps(tmp2, KLN_SWIZZLE(a[i], 2, 1, 3, 0)));
-            p = _mm_add_ps(p, _mm_mul_ps(tmp3, a[i]));
+            __m128 in = a[i];
+            __m128 p  = _mm_mul_ps(tmp1, KLN_SWIZZLE(in, 1, 3, 2, 0));
+            p = _mm_add_ps(p, _mm_mul_ps(tmp2, KLN_SWIZZLE(in, 2, 1, 3, 0)));
+            p = _mm_add_ps(p, _mm_mul_ps(tmp3, in));
 
             if constexpr (Translate)
             {
-                __m128 tmp5 = hi_dp(tmp4, a[i]);
+                __m128 tmp5 = hi_dp(tmp4, in);
                 p           = _mm_add_ps(p, tmp5);
             }
+
+            store_entity<Stream>(out + i, p);
         }
     }
 
@@ -535,8 +627,8 @@ namespace detail
         return tmp;
     }
 
-    // Apply a motor to a point
-    template <bool Variadic = false, bool Translate = true>
+    // Apply a motor to a point. See sw012 for the template parameters.
+    template <bool Variadic = false, bool Translate = true, bool Stream = false>
     KLN_INLINE void KLN_VEC_CALL sw312(__m128 const* KLN_RESTRICT a,
                                        __m128 b,
                                        [[maybe_unused]] __m128 const* KLN_RESTRICT c,
@@ -606,19 +698,39 @@ namespace detail
             // tmp4 needs to be scaled by (_, a0, a0, a0)
         }
 
+#ifdef KLN_ENABLE_ISE_AVX512
+        if constexpr (Variadic)
+        {
+            sw312_avx512<Translate, Stream>(
+                a, tmp1, tmp2, tmp3, tmp4, out, count);
+            return;
+        }
+#elif defined(KLN_ENABLE_ISE_AVX2)
+        if constexpr (Variadic)
+        {
+            sw312_avx2<Translate, Stream>(
+                a, tmp1, tmp2, tmp3, tmp4, out, count);
+            return;
+        }
+#endif
+
         size_t limit = Variadic ? count : 1;
         for (size_t i = 0; i != limit; ++i)
         {
-            __m128& p = out[i];
-            p         = _mm_mul_ps(tmp1, KLN_SWIZZLE(a[i], 2, 1, 3, 0));
-            p = _mm_add_ps(p, _mm_mul_ps(tmp2, KLN_SWIZZLE(a[i], 1, 3, 2, 0)));
-            p = _mm_add_ps(p, _mm_mul_ps(tmp3, a[i]));
+            prefetch_ahead<Stream>(a + i);
+
+            __m128 in = a[i];
+            __m128 p  = _mm_mul_ps(tmp1, KLN_SWIZZLE(in, 2, 1, 3, 0));
+            p = _mm_add_ps(p, _mm_mul_ps(tmp2, KLN_SWIZZLE(in, 1, 3, 2, 0)));
+            p = _mm_add_ps(p, _mm_mul_ps(tmp3, in));
 
             if constexpr (Translate)
             {
                 p = _mm_add_ps(
-                    p, _mm_mul_ps(tmp4, KLN_SWIZZLE(a[i], 0, 0, 0, 0)));
+                    p, _mm_mul_ps(tmp4, KLN_SWIZZLE(in, 0, 0, 0, 0)));
             }
+
+            store_entity<Stream>(out + i, p);
         }
     }
 
@@ -0,0 +1,741 @@
+// File: x86_soa.hpp
+// Purpose: Width-agnostic vector primitives used by the structure-of-arrays
+// (SoA) kernels.
+//
+// Notes:
+// 1. In SoA form, each register holds a single basis component of several
+//    distinct entities (4 per XMM register, 8 per YMM register). Kernels
+//    written in this form need no swizzles at all; each term of the symbolic
+//    expansion maps to exactly one vertical multiply or fused multiply-add.
+// 2. The primitives below are overloaded on the register type so that a single
+//    kernel template (parameterized on V) can be instantiated for either
+//    __m128 or __m256. The __m256 overloads are only available when
+//    KLN_ENABLE_ISE_AVX2 is defined.
+// 3. The transcendental approximations (sin, cos, atan2) are polynomial and
+//    evaluated entirely in registers. They are accurate to a few ulp over the
+//    range of arguments produced by the exponential and logarithmic maps.
+
+#pragma once
+
+#include "x86_sse.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kln
+{
+namespace detail
+{
+namespace soa
+{
+    // Number of float lanes held by the vector type V
+    template <typename V>
+    constexpr size_t width = sizeof(V) / sizeof(float);
+
+    template <typename V>
+    [[nodiscard]] KLN_INLINE V set1(float f) noexcept;
+
+    template <>
+    [[nodiscard]] KLN_INLINE __m128 set1<__m128>(float f) noexcept
+    {
+        return _mm_set1_ps(f);
+    }
+
+    template <typename V>
+    [[nodiscard]] KLN_INLINE V zero() noexcept
+    {
+        return set1<V>(0.f);
+    }
+
+    // Broadcast of an integer bit pattern, for building per-lane masks
+    template <typename V>
+    [[nodiscard]] KLN_INLINE V set1_bits(uint32_t bits) noexcept;
+
+    template <>
+    [[nodiscard]] KLN_INLINE __m128 set1_bits<__m128>(uint32_t bits) noexcept
+    {
+        return _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(bits)));
+    }
+
+    // Unaligned loads and stores of width<V> consecutive scalars
+    template <typename V>
+    [[nodiscard]] KLN_INLINE V loadu(float const* in) noexcept;
+
+    template <>
+    [[nodiscard]] KLN_INLINE __m128 loadu<__m128>(float const* in) noexcept
+    {
+        return _mm_loadu_ps(in);
+    }
+
+    KLN_INLINE void KLN_VEC_CALL storeu(__m128 a, float* out) noexcept
+    {
+        _mm_storeu_ps(out, a);
+    }
+
+    KLN_INLINE void KLN_VEC_CALL storeu_bits(__m128 a, uint32_t* out) noexcept
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_castps_si128(a));
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL add(__m128 a, __m128 b) noexcept
+    {
+        return _mm_add_ps(a, b);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL sub(__m128 a, __m128 b) noexcept
+    {
+        return _mm_sub_ps(a, b);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL mul(__m128 a, __m128 b) noexcept
+    {
+        return _mm_mul_ps(a, b);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL div(__m128 a, __m128 b) noexcept
+    {
+        return _mm_div_ps(a, b);
+    }
+
+    // a * b + c
+    KLN_INLINE __m128 KLN_VEC_CALL fmadd(__m128 a, __m128 b, __m128 c) noexcept
+    {
+#ifdef KLN_ENABLE_ISE_AVX2
+        return _mm_fmadd_ps(a, b, c);
+#else
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+    }
+
+    // a * b - c
+    KLN_INLINE __m128 KLN_VEC_CALL fmsub(__m128 a, __m128 b, __m128 c) noexcept
+    {
+#ifdef KLN_ENABLE_ISE_AVX2
+        return _mm_fmsub_ps(a, b, c);
+#else
+        return _mm_sub_ps(_mm_mul_ps(a, b), c);
+#endif
+    }
+
+    // c - a * b
+    KLN_INLINE __m128 KLN_VEC_CALL fnmadd(__m128 a, __m128 b, __m128 c) noexcept
+    {
+#ifdef KLN_ENABLE_ISE_AVX2
+        return _mm_fnmadd_ps(a, b, c);
+#else
+        return _mm_sub_ps(c, _mm_mul_ps(a, b));
+#endif
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL min(__m128 a, __m128 b) noexcept
+    {
+        return _mm_min_ps(a, b);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL max(__m128 a, __m128 b) noexcept
+    {
+        return _mm_max_ps(a, b);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL sqrt(__m128 a) noexcept
+    {
+        return _mm_sqrt_ps(a);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL rcp_nr1(__m128 a) noexcept
+    {
+        return detail::rcp_nr1(a);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL rsqrt_nr1(__m128 a) noexcept
+    {
+        return detail::rsqrt_nr1(a);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL bit_and(__m128 a, __m128 b) noexcept
+    {
+        return _mm_and_ps(a, b);
+    }
+
+    // ~a & b
+    KLN_INLINE __m128 KLN_VEC_CALL bit_andnot(__m128 a, __m128 b) noexcept
+    {
+        return _mm_andnot_ps(a, b);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL bit_or(__m128 a, __m128 b) noexcept
+    {
+        return _mm_or_ps(a, b);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL bit_xor(__m128 a, __m128 b) noexcept
+    {
+        return _mm_xor_ps(a, b);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL cmplt(__m128 a, __m128 b) noexcept
+    {
+        return _mm_cmplt_ps(a, b);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL cmple(__m128 a, __m128 b) noexcept
+    {
+        return _mm_cmple_ps(a, b);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL cmpgt(__m128 a, __m128 b) noexcept
+    {
+        return _mm_cmpgt_ps(a, b);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL cmpge(__m128 a, __m128 b) noexcept
+    {
+        return _mm_cmpge_ps(a, b);
+    }
+
+    // Bitmask with one bit per lane set if the lane's sign bit is set
+    KLN_INLINE int KLN_VEC_CALL movemask(__m128 a) noexcept
+    {
+        return _mm_movemask_ps(a);
+    }
+
+    // Per-lane mask ? a : b. Each lane of the mask must be all ones or all
+    // zeros.
+    KLN_INLINE __m128 KLN_VEC_CALL select(__m128 mask,
+                                          __m128 a,
+                                          __m128 b) noexcept
+    {
+#ifdef KLEIN_SSE_4_1
+        return _mm_blendv_ps(b, a, mask);
+#else
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+#endif
+    }
+
+    // Round to the nearest integer (ties to even)
+    KLN_INLINE __m128 KLN_VEC_CALL round(__m128 a) noexcept
+    {
+#ifdef KLEIN_SSE_4_1
+        return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#else
+        return _mm_cvtepi32_ps(_mm_cvtps_epi32(a));
+#endif
+    }
+
+    // The integer conversions are used to manipulate the quadrant bits in the
+    // trigonometric routines below.
+    KLN_INLINE __m128i KLN_VEC_CALL to_int(__m128 a) noexcept
+    {
+        return _mm_cvtps_epi32(a);
+    }
+
+    // Returns all ones in each lane where (i & bit) != 0.
+    KLN_INLINE __m128 KLN_VEC_CALL test_bit(__m128i i, int bit) noexcept
+    {
+        __m128i b = _mm_set1_epi32(bit);
+        return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(i, b), b));
+    }
+
+    // Gather component k of four AoS partitions into register k. Stride is
+    // measured in partitions (2 for entities occupying two partitions such as
+    // lines and motors).
+    template <size_t Stride>
+    KLN_INLINE void load4(__m128 const* in, __m128* out) noexcept
+    {
+        __m128 r0 = in[0];
+        __m128 r1 = in[Stride];
+        __m128 r2 = in[2 * Stride];
+        __m128 r3 = in[3 * Stride];
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        out[0] = r0;
+        out[1] = r1;
+        out[2] = r2;
+        out[3] = r3;
+    }
+
+    // Inverse of load4. If Stream is true, the partitions are written with
+    // streaming stores.
+    template <size_t Stride, bool Stream = false>
+    KLN_INLINE void store4(__m128 const* in, __m128* out) noexcept
+    {
+        __m128 r0 = in[0];
+        __m128 r1 = in[1];
+        __m128 r2 = in[2];
+        __m128 r3 = in[3];
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        store_entity<Stream>(out, r0);
+        store_entity<Stream>(out + Stride, r1);
+        store_entity<Stream>(out + 2 * Stride, r2);
+        store_entity<Stream>(out + 3 * Stride, r3);
+    }
+
+    // As store4, but entity j is written to out[Stride * index[j]]
+    template <size_t Stride, typename I>
+    KLN_INLINE void scatter4(__m128 const* in,
+                             I const* index,
+                             __m128* out) noexcept
+    {
+        __m128 r0 = in[0];
+        __m128 r1 = in[1];
+        __m128 r2 = in[2];
+        __m128 r3 = in[3];
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        out[Stride * index[0]] = r0;
+        out[Stride * index[1]] = r1;
+        out[Stride * index[2]] = r2;
+        out[Stride * index[3]] = r3;
+    }
+
+    // As load4, but entity j is read from in[Stride * index[j]]
+    template <size_t Stride, typename I>
+    KLN_INLINE void gather4(__m128 const* in,
+                            I const* index,
+                            __m128* out) noexcept
+    {
+        __m128 r0 = in[Stride * index[0]];
+        __m128 r1 = in[Stride * index[1]];
+        __m128 r2 = in[Stride * index[2]];
+        __m128 r3 = in[Stride * index[3]];
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        out[0] = r0;
+        out[1] = r1;
+        out[2] = r2;
+        out[3] = r3;
+    }
+
+#ifdef KLN_ENABLE_ISE_AVX2
+    // In-lane 4x4 transpose of four YMM registers
+    KLN_INLINE void transpose_lanes(__m256& r0,
+                                    __m256& r1,
+                                    __m256& r2,
+                                    __m256& r3) noexcept
+    {
+        __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+        __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+        __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+        __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+        r0        = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+        r1        = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+        r2        = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        r3        = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    }
+
+    // Gather component k of eight AoS partitions into register k. Entities 0-3
+    // occupy the low 128-bit lane and entities 4-7 the high lane.
+    template <size_t Stride>
+    KLN_INLINE void load8(__m128 const* in, __m256* out) noexcept
+    {
+        __m256 r0 = _mm256_insertf128_ps(
+            _mm256_castps128_ps256(in[0]), in[4 * Stride], 1);
+        __m256 r1 = _mm256_insertf128_ps(
+            _mm256_castps128_ps256(in[Stride]), in[5 * Stride], 1);
+        __m256 r2 = _mm256_insertf128_ps(
+            _mm256_castps128_ps256(in[2 * Stride]), in[6 * Stride], 1);
+        __m256 r3 = _mm256_insertf128_ps(
+            _mm256_castps128_ps256(in[3 * Stride]), in[7 * Stride], 1);
+        transpose_lanes(r0, r1, r2, r3);
+        out[0] = r0;
+        out[1] = r1;
+        out[2] = r2;
+        out[3] = r3;
+    }
+
+    // As load8, but entity j is read from in[Stride * index[j]]
+    template <size_t Stride, typename I>
+    KLN_INLINE void gather8(__m128 const* in,
+                            I const* index,
+                            __m256* out) noexcept
+    {
+        __m256 r0 = _mm256_insertf128_ps(
+            _mm256_castps128_ps256(in[Stride * index[0]]),
+            in[Stride * index[4]],
+            1);
+        __m256 r1 = _mm256_insertf128_ps(
+            _mm256_castps128_ps256(in[Stride * index[1]]),
+            in[Stride * index[5]],
+            1);
+        __m256 r2 = _mm256_insertf128_ps(
+            _mm256_castps128_ps256(in[Stride * index[2]]),
+            in[Stride * index[6]],
+            1);
+        __m256 r3 = _mm256_insertf128_ps(
+            _mm256_castps128_ps256(in[Stride * index[3]]),
+            in[Stride * index[7]],
+            1);
+        transpose_lanes(r0, r1, r2, r3);
+        out[0] = r0;
+        out[1] = r1;
+        out[2] = r2;
+        out[3] = r3;
+    }
+
+    // Inverse of load8. If Stream is true, the partitions are written with
+    // streaming stores.
+    template <size_t Stride, bool Stream = false>
+    KLN_INLINE void store8(__m256 const* in, __m128* out) noexcept
+    {
+        __m256 r0 = in[0];
+        __m256 r1 = in[1];
+        __m256 r2 = in[2];
+        __m256 r3 = in[3];
+        transpose_lanes(r0, r1, r2, r3);
+        store_entity<Stream>(out, _mm256_castps256_ps128(r0));
+        store_entity<Stream>(out + Stride, _mm256_castps256_ps128(r1));
+        store_entity<Stream>(out + 2 * Stride, _mm256_castps256_ps128(r2));
+        store_entity<Stream>(out + 3 * Stride, _mm256_castps256_ps128(r3));
+        store_entity<Stream>(out + 4 * Stride, _mm256_extractf128_ps(r0, 1));
+        store_entity<Stream>(out + 5 * Stride, _mm256_extractf128_ps(r1, 1));
+        store_entity<Stream>(out + 6 * Stride, _mm256_extractf128_ps(r2, 1));
+        store_entity<Stream>(out + 7 * Stride, _mm256_extractf128_ps(r3, 1));
+    }
+
+    // As store8, but entity j is written to out[Stride * index[j]]
+    template <size_t Stride, typename I>
+    KLN_INLINE void scatter8(__m256 const* in,
+                             I const* index,
+                             __m128* out) noexcept
+    {
+        __m256 r0 = in[0];
+        __m256 r1 = in[1];
+        __m256 r2 = in[2];
+        __m256 r3 = in[3];
+        transpose_lanes(r0, r1, r2, r3);
+        out[Stride * index[0]] = _mm256_castps256_ps128(r0);
+        out[Stride * index[1]] = _mm256_castps256_ps128(r1);
+        out[Stride * index[2]] = _mm256_castps256_ps128(r2);
+        out[Stride * index[3]] = _mm256_castps256_ps128(r3);
+        out[Stride * index[4]] = _mm256_extractf128_ps(r0, 1);
+        out[Stride * index[5]] = _mm256_extractf128_ps(r1, 1);
+        out[Stride * index[6]] = _mm256_extractf128_ps(r2, 1);
+        out[Stride * index[7]] = _mm256_extractf128_ps(r3, 1);
+    }
+
+    template <>
+    [[nodiscard]] KLN_INLINE __m256 set1<__m256>(float f) noexcept
+    {
+        return _mm256_set1_ps(f);
+    }
+
+    template <>
+    [[nodiscard]] KLN_INLINE __m256 set1_bits<__m256>(uint32_t bits) noexcept
+    {
+        return _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(bits)));
+    }
+
+    template <>
+    [[nodiscard]] KLN_INLINE __m256 loadu<__m256>(float const* in) noexcept
+    {
+        return _mm256_loadu_ps(in);
+    }
+
+    KLN_INLINE void KLN_VEC_CALL storeu(__m256 a, float* out) noexcept
+    {
+        _mm256_storeu_ps(out, a);
+    }
+
+    KLN_INLINE void KLN_VEC_CALL storeu_bits(__m256 a, uint32_t* out) noexcept
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                            _mm256_castps_si256(a));
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL add(__m256 a, __m256 b) noexcept
+    {
+        return _mm256_add_ps(a, b);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL sub(__m256 a, __m256 b) noexcept
+    {
+        return _mm256_sub_ps(a, b);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL mul(__m256 a, __m256 b) noexcept
+    {
+        return _mm256_mul_ps(a, b);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL div(__m256 a, __m256 b) noexcept
+    {
+        return _mm256_div_ps(a, b);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL fmadd(__m256 a, __m256 b, __m256 c) noexcept
+    {
+        return _mm256_fmadd_ps(a, b, c);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL fmsub(__m256 a, __m256 b, __m256 c) noexcept
+    {
+        return _mm256_fmsub_ps(a, b, c);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL fnmadd(__m256 a, __m256 b, __m256 c) noexcept
+    {
+        return _mm256_fnmadd_ps(a, b, c);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL min(__m256 a, __m256 b) noexcept
+    {
+        return _mm256_min_ps(a, b);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL max(__m256 a, __m256 b) noexcept
+    {
+        return _mm256_max_ps(a, b);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL sqrt(__m256 a) noexcept
+    {
+        return _mm256_sqrt_ps(a);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL rcp_nr1(__m256 a) noexcept
+    {
+        // See detail::rcp_nr1 for the derivation
+        __m256 xn = _mm256_rcp_ps(a);
+        return _mm256_mul_ps(xn, _mm256_fnmadd_ps(a, xn, _mm256_set1_ps(2.f)));
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL rsqrt_nr1(__m256 a) noexcept
+    {
+        // See detail::rsqrt_nr1 for the derivation
+        __m256 xn   = _mm256_rsqrt_ps(a);
+        __m256 axn2 = _mm256_mul_ps(a, _mm256_mul_ps(xn, xn));
+        __m256 xn3  = _mm256_sub_ps(_mm256_set1_ps(3.f), axn2);
+        return _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), xn), xn3);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL bit_and(__m256 a, __m256 b) noexcept
+    {
+        return _mm256_and_ps(a, b);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL bit_andnot(__m256 a, __m256 b) noexcept
+    {
+        return _mm256_andnot_ps(a, b);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL bit_or(__m256 a, __m256 b) noexcept
+    {
+        return _mm256_or_ps(a, b);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL bit_xor(__m256 a, __m256 b) noexcept
+    {
+        return _mm256_xor_ps(a, b);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL cmplt(__m256 a, __m256 b) noexcept
+    {
+        return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL cmple(__m256 a, __m256 b) noexcept
+    {
+        return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL cmpgt(__m256 a, __m256 b) noexcept
+    {
+        return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL cmpge(__m256 a, __m256 b) noexcept
+    {
+        return _mm256_cmp_ps(a, b, _CMP_GE_OQ);
+    }
+
+    KLN_INLINE int KLN_VEC_CALL movemask(__m256 a) noexcept
+    {
+        return _mm256_movemask_ps(a);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL select(__m256 mask,
+                                          __m256 a,
+                                          __m256 b) noexcept
+    {
+        return _mm256_blendv_ps(b, a, mask);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL round(__m256 a) noexcept
+    {
+        return _mm256_round_ps(
+            a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+
+    KLN_INLINE __m256i KLN_VEC_CALL to_int(__m256 a) noexcept
+    {
+        return _mm256_cvtps_epi32(a);
+    }
+
+    KLN_INLINE __m256 KLN_VEC_CALL test_bit(__m256i i, int bit) noexcept
+    {
+        __m256i b = _mm256_set1_epi32(bit);
+        return _mm256_castsi256_ps(
+            _mm256_cmpeq_epi32(_mm256_and_si256(i, b), b));
+    }
+#endif
+
+    // Width-generic forms of the transposing loads and stores above, selected
+    // by the register type
+    template <size_t Stride>
+    KLN_INLINE void load(__m128 const* in, __m128* out) noexcept
+    {
+        load4<Stride>(in, out);
+    }
+
+    template <size_t Stride>
+    KLN_INLINE void store(__m128 const* in, __m128* out) noexcept
+    {
+        store4<Stride>(in, out);
+    }
+
+    template <size_t Stride, typename I>
+    KLN_INLINE void gather(__m128 const* in,
+                           I const* index,
+                           __m128* out) noexcept
+    {
+        gather4<Stride>(in, index, out);
+    }
+
+#ifdef KLN_ENABLE_ISE_AVX2
+    template <size_t Stride>
+    KLN_INLINE void load(__m128 const* in, __m256* out) noexcept
+    {
+        load8<Stride>(in, out);
+    }
+
+    template <size_t Stride>
+    KLN_INLINE void store(__m256 const* in, __m128* out) noexcept
+    {
+        store8<Stride>(in, out);
+    }
+
+    template <size_t Stride, typename I>
+    KLN_INLINE void gather(__m128 const* in,
+                           I const* index,
+                           __m256* out) noexcept
+    {
+        gather8<Stride>(in, index, out);
+    }
+#endif
+
+    template <typename V>
+    [[nodiscard]] KLN_INLINE V KLN_VEC_CALL neg(V a) noexcept
+    {
+        return bit_xor(a, set1<V>(-0.f));
+    }
+
+    template <typename V>
+    [[nodiscard]] KLN_INLINE V KLN_VEC_CALL abs(V a) noexcept
+    {
+        return bit_andnot(set1<V>(-0.f), a);
+    }
+
+    // a1 b1 + a2 b2 + a3 b3
+    template <typename V>
+    [[nodiscard]] KLN_INLINE V KLN_VEC_CALL
+    dot3(V a1, V a2, V a3, V b1, V b2, V b3) noexcept
+    {
+        return fmadd(a3, b3, fmadd(a2, b2, mul(a1, b1)));
+    }
+
+    // Simultaneous sine and cosine.
+    //
+    // The argument is reduced to [-pi/4, pi/4] with a three-part Cody-Waite
+    // decomposition of pi/2, after which minimax polynomials of degree 7 (sin)
+    // and 8 (cos) are evaluated. The maximum absolute error is below 2^-23 for
+    // |x| < 8192. Accuracy degrades gracefully beyond that range.
+    template <typename V>
+    KLN_INLINE void KLN_VEC_CALL sincos(V x,
+                                        V& KLN_RESTRICT s,
+                                        V& KLN_RESTRICT c) noexcept
+    {
+        // Quadrant index q = round(x * 2/pi)
+        V q = round(mul(x, set1<V>(0.636619772367581343f)));
+
+        // x - q * pi/2 evaluated in extended precision
+        V r = fnmadd(q, set1<V>(1.5703125f), x);
+        r   = fnmadd(q, set1<V>(4.837512969970703125e-4f), r);
+        r   = fnmadd(q, set1<V>(7.54978995489188216e-8f), r);
+
+        V r2 = mul(r, r);
+
+        // sin(r) on [-pi/4, pi/4]
+        V ps = set1<V>(-1.9515295891e-4f);
+        ps   = fmadd(ps, r2, set1<V>(8.3321608736e-3f));
+        ps   = fmadd(ps, r2, set1<V>(-1.6666654611e-1f));
+        ps   = mul(ps, r2);
+        ps   = fmadd(ps, r, r);
+
+        // cos(r) on [-pi/4, pi/4]
+        V pc = set1<V>(2.443315711809948e-5f);
+        pc   = fmadd(pc, r2, set1<V>(-1.388731625493765e-3f));
+        pc   = fmadd(pc, r2, set1<V>(4.166664568298827e-2f));
+        pc   = mul(pc, mul(r2, r2));
+        pc   = fnmadd(set1<V>(0.5f), r2, pc);
+        pc   = add(pc, set1<V>(1.f));
+
+        // Quadrant fixup
+        // q mod 4 = 0: ( sin,  cos)
+        // q mod 4 = 1: ( cos, -sin)
+        // q mod 4 = 2: (-sin, -cos)
+        // q mod 4 = 3: (-cos,  sin)
+        auto qi      = to_int(q);
+        V swap       = test_bit(qi, 1);
+        V sin_neg    = bit_and(test_bit(qi, 2), set1<V>(-0.f));
+        V cos_neg    = bit_and(
+            bit_xor(test_bit(qi, 1), test_bit(qi, 2)), set1<V>(-0.f));
+        s            = bit_xor(select(swap, pc, ps), sin_neg);
+        c            = bit_xor(select(swap, ps, pc), cos_neg);
+    }
+
+    // Four-quadrant arctangent of y/x.
+    //
+    // The ratio is reduced to [0, tan(pi/8)] using the identities
+    // atan(z) = pi/2 - atan(1/z) and atan(z) = pi/4 + atan((z - 1)/(z + 1)),
+    // after which a degree 9 odd minimax polynomial is evaluated. The maximum
+    // absolute error is below 2^-22 (about 2 ulp at pi). atan2(0, 0) returns 0.
+    template <typename V>
+    [[nodiscard]] KLN_INLINE V KLN_VEC_CALL atan2(V y, V x) noexcept
+    {
+        V ax = abs(x);
+        V ay = abs(y);
+
+        // Evaluate atan(num/den) with num <= den so that z lies in [0, 1]
+        V swap = cmpgt(ay, ax);
+        V num  = select(swap, ax, ay);
+        V den  = select(swap, ay, ax);
+
+        // Guard against 0/0
+        den = select(cmpgt(den, zero<V>()), den, set1<V>(1.f));
+        V z = div(num, den);
+
+        // Second reduction to [0, tan(pi/8)]
+        V big    = cmpgt(z, set1<V>(0.4142135623730950f));
+        V z_red  = div(sub(z, set1<V>(1.f)), add(z, set1<V>(1.f)));
+        z        = select(big, z_red, z);
+        V offset = bit_and(big, set1<V>(0.7853981633974483f));
+
+        V z2 = mul(z, z);
+        V p  = set1<V>(8.05374449538e-2f);
+        p    = fmadd(p, z2, set1<V>(-1.38776856032e-1f));
+        p    = fmadd(p, z2, set1<V>(1.99777106478e-1f));
+        p    = fmadd(p, z2, set1<V>(-3.33329491539e-1f));
+        p    = mul(p, z2);
+        p    = fmadd(p, z, z);
+        p    = add(p, offset);
+
+        // Undo the first reduction
+        p = select(swap, sub(set1<V>(1.5707963267948966f), p), p);
+
+        // Reflect into the correct quadrant
+        V x_neg = cmplt(x, zero<V>());
+        p       = select(x_neg, sub(set1<V>(3.14159265358979323f), p), p);
+
+        // Apply the sign of y
+        return bit_xor(p, bit_and(y, set1<V>(-0.f)));
+    }
+} // namespace soa
+} // namespace detail
+} // namespace kln
@@ -0,0 +1,145 @@
+// File: x86_soa_exp_log.hpp
+// Purpose: Structure-of-arrays counterparts of the routines in
+// x86_exp_log.hpp.
+//
+// Notes:
+// 1. See x86_exp_log.hpp for the derivation. The structural differences are
+//    that the trigonometric functions are evaluated with the polynomial
+//    approximations in x86_soa.hpp, and that the logarithm always recovers the
+//    angle with atan2(s, p) while selecting the better conditioned of the two
+//    divisions for the pitch per lane.
+// 2. Lanes whose Euclidean bivector part is below detail::ideal_threshold
+//    (pure translations, in practice) are handled with per-lane selects
+//    where the AoS routines branch, using the same first order expansions.
+
+#pragma once
+
+#include "x86_exp_log.hpp"
+#include "x86_soa.hpp"
+
+namespace kln
+{
+namespace detail
+{
+namespace soa
+{
+    // Decompose the bivector a + b (a := p1, b := p2, low components ignored)
+    // as (u + v e0123) n where n is a normalized line. The normalized line is
+    // written to n_real and n_ideal, u and minus_v are returned through the
+    // respective arguments, and the return value is a mask of lanes for which
+    // the Euclidean norm is too small to normalize.
+    template <typename V>
+    KLN_INLINE V decompose_bivector(V const* a,
+                                    V const* b,
+                                    V* n_real,
+                                    V* n_ideal,
+                                    V& u,
+                                    V& minus_v) noexcept
+    {
+        V a2 = dot3(a[1], a[2], a[3], a[1], a[2], a[3]);
+        V ab = dot3(a[1], a[2], a[3], b[1], b[2], b[3]);
+
+        V degenerate = cmplt(a2, set1<V>(ideal_threshold));
+        a2           = select(degenerate, set1<V>(1.f), a2);
+
+        V a2_sqrt_rcp = rsqrt_nr1(a2);
+        u             = mul(a2, a2_sqrt_rcp);
+        minus_v       = mul(ab, a2_sqrt_rcp);
+
+        // ab / |a|^3
+        V ab_scaled = mul(ab, mul(a2_sqrt_rcp, rcp_nr1(a2)));
+
+        for (size_t i = 1; i != 4; ++i)
+        {
+            n_real[i]  = mul(a[i], a2_sqrt_rcp);
+            n_ideal[i] = fnmadd(a[i], ab_scaled, mul(b[i], a2_sqrt_rcp));
+        }
+
+        return degenerate;
+    }
+
+    // Exponentiate the bivector a + b (a := p1, b := p2) producing a motor
+    template <typename V>
+    KLN_INLINE void exp(V const* a, V const* b, V* p1_out, V* p2_out) noexcept
+    {
+        V n_real[4];
+        V n_ideal[4];
+        V u;
+        V minus_v;
+        V degenerate = decompose_bivector(a, b, n_real, n_ideal, u, minus_v);
+
+        V sinu;
+        V cosu;
+        sincos(u, sinu, cosu);
+
+        // cosu + sinu n + v n cosu e0123 - v sinu e0123
+        V minus_vcosu = mul(minus_v, cosu);
+        V out1[4];
+        V out2[4];
+        out1[0] = cosu;
+        out2[0] = mul(minus_v, sinu);
+        for (size_t i = 1; i != 4; ++i)
+        {
+            out1[i] = mul(sinu, n_real[i]);
+            out2[i] = fmadd(minus_vcosu, n_real[i], mul(sinu, n_ideal[i]));
+        }
+
+        // A (nearly) purely ideal bivector exponentiates to
+        // 1 + a + b + (a . b) e0123
+        V ab      = dot3(a[1], a[2], a[3], b[1], b[2], b[3]);
+        p1_out[0] = select(degenerate, set1<V>(1.f), out1[0]);
+        p2_out[0] = select(degenerate, ab, out2[0]);
+        for (size_t i = 1; i != 4; ++i)
+        {
+            p1_out[i] = select(degenerate, a[i], out1[i]);
+            p2_out[i] = select(degenerate, b[i], out2[i]);
+        }
+    }
+
+    // Logarithm of the motor p1 + p2 producing a bivector
+    template <typename V>
+    KLN_INLINE void log(V const* p1, V const* p2, V* p1_out, V* p2_out) noexcept
+    {
+        V n_real[4];
+        V n_ideal[4];
+        V s;
+        V minus_t;
+        V degenerate = decompose_bivector(p1, p2, n_real, n_ideal, s, minus_t);
+
+        // p = cosu
+        // q = -v sinu
+        // s = sinu
+        // t = v cosu
+        V p = p1[0];
+        V q = p2[0];
+        V t = neg(minus_t);
+
+        // Recover v from whichever of p and s is better conditioned. For a
+        // normalized motor, p^2 + s^2 = 1 so the divisor is at least 1/sqrt2.
+        V p_small = cmplt(abs(p), s);
+        V u       = atan2(s, p);
+        V v       = select(p_small, div(neg(q), s), div(t, p));
+
+        // (u + v e0123) n
+        V out1[4];
+        V out2[4];
+        for (size_t i = 1; i != 4; ++i)
+        {
+            out1[i] = mul(u, n_real[i]);
+            out2[i] = fnmadd(v, n_real[i], mul(u, n_ideal[i]));
+        }
+
+        // The logarithm of a motor close to the translator p + b is
+        // (a + b) / p
+        V p_rcp   = rcp_nr1(select(degenerate, p, set1<V>(1.f)));
+        p1_out[0] = zero<V>();
+        p2_out[0] = zero<V>();
+        for (size_t i = 1; i != 4; ++i)
+        {
+            p1_out[i] = select(degenerate, mul(p1[i], p_rcp), out1[i]);
+            p2_out[i] = select(degenerate, mul(p2[i], p_rcp), out2[i]);
+        }
+    }
+} // namespace soa
+} // namespace detail
+} // namespace kln
@@ -0,0 +1,297 @@
+// File: x86_soa_geometric_product.hpp
+// Purpose: Structure-of-arrays counterparts of the routines in
+// x86_geometric_product.hpp.
+//
+// Notes:
+// 1. Each argument points to the four registers of a partition, ordered as in
+//    the AoS partition layout. For example, a motor's p1 is passed as
+//    (scalar, e23, e31, e12) and register k holds component k of every entity
+//    in the batch.
+// 2. Outputs are computed into temporaries before being written, so outputs
+//    may alias inputs.
+// 3. The symbolic expansions match those documented in
+//    x86_geometric_product.hpp, which are not repeated here unless they differ.
+
+#pragma once
+
+#include "x86_soa.hpp"
+
+namespace kln
+{
+namespace detail
+{
+namespace soa
+{
+    // Partition memory layouts
+    //     LSB --> MSB
+    // p0: (e0, e1, e2, e3)
+    // p1: (1, e23, e31, e12)
+    // p2: (e0123, e01, e02, e03)
+    // p3: (e123, e032, e013, e021)
+
+    // plane * plane
+    template <typename V>
+    KLN_INLINE void gp00(V const* a, V const* b, V* p1_out, V* p2_out) noexcept
+    {
+        V s   = dot3(a[1], a[2], a[3], b[1], b[2], b[3]);
+        V e23 = fmsub(a[2], b[3], mul(a[3], b[2]));
+        V e31 = fmsub(a[3], b[1], mul(a[1], b[3]));
+        V e12 = fmsub(a[1], b[2], mul(a[2], b[1]));
+        V e01 = fmsub(a[0], b[1], mul(a[1], b[0]));
+        V e02 = fmsub(a[0], b[2], mul(a[2], b[0]));
+        V e03 = fmsub(a[0], b[3], mul(a[3], b[0]));
+
+        p1_out[0] = s;
+        p1_out[1] = e23;
+        p1_out[2] = e31;
+        p1_out[3] = e12;
+        p2_out[0] = zero<V>();
+        p2_out[1] = e01;
+        p2_out[2] = e02;
+        p2_out[3] = e03;
+    }
+
+    // plane * point (or point * plane if Flip is true)
+    // a := plane p0
+    // b := point p3
+    template <bool Flip, typename V>
+    KLN_INLINE void gp03(V const* a, V const* b, V* p1_out, V* p2_out) noexcept
+    {
+        V e23   = mul(a[1], b[0]);
+        V e31   = mul(a[2], b[0]);
+        V e12   = mul(a[3], b[0]);
+        V e0123 = fmadd(a[0], b[0], dot3(a[1], a[2], a[3], b[1], b[2], b[3]));
+        V e01   = fmsub(a[3], b[2], mul(a[2], b[3]));
+        V e02   = fmsub(a[1], b[3], mul(a[3], b[1]));
+        V e03   = fmsub(a[2], b[1], mul(a[1], b[2]));
+
+        if constexpr (Flip)
+        {
+            e0123 = neg(e0123);
+        }
+
+        p1_out[0] = zero<V>();
+        p1_out[1] = e23;
+        p1_out[2] = e31;
+        p1_out[3] = e12;
+        p2_out[0] = e0123;
+        p2_out[1] = e01;
+        p2_out[2] = e02;
+        p2_out[3] = e03;
+    }
+
+    // point * point, rescaled to produce a translator
+    template <typename V>
+    KLN_INLINE void gp33(V const* a, V const* b, V* p2_out) noexcept
+    {
+        // (a0 b1 - a1 b0) / (a0 b0) e01 +
+        // (a0 b2 - a2 b0) / (a0 b0) e02 +
+        // (a0 b3 - a3 b0) / (a0 b0) e03
+        V inv = rcp_nr1(mul(a[0], b[0]));
+        V e01 = mul(fmsub(a[0], b[1], mul(a[1], b[0])), inv);
+        V e02 = mul(fmsub(a[0], b[2], mul(a[2], b[0])), inv);
+        V e03 = mul(fmsub(a[0], b[3], mul(a[3], b[0])), inv);
+
+        p2_out[0] = zero<V>();
+        p2_out[1] = e01;
+        p2_out[2] = e02;
+        p2_out[3] = e03;
+    }
+
+    // rotor * rotor
+    template <typename V>
+    KLN_INLINE void gp11(V const* a, V const* b, V* p1_out) noexcept
+    {
+        // (a0 b0 - a1 b1 - a2 b2 - a3 b3) +
+        // (a0 b1 + a3 b2 + a1 b0 - a2 b3) e23 +
+        // (a0 b2 + a1 b3 + a2 b0 - a3 b1) e31 +
+        // (a0 b3 + a2 b1 + a3 b0 - a1 b2) e12
+        V s   = fmsub(a[0], b[0], dot3(a[1], a[2], a[3], b[1], b[2], b[3]));
+        V e23 = fmadd(a[0], b[1], mul(a[3], b[2]));
+        e23   = fmadd(a[1], b[0], e23);
+        e23   = fnmadd(a[2], b[3], e23);
+        V e31 = fmadd(a[0], b[2], mul(a[1], b[3]));
+        e31   = fmadd(a[2], b[0], e31);
+        e31   = fnmadd(a[3], b[1], e31);
+        V e12 = fmadd(a[0], b[3], mul(a[2], b[1]));
+        e12   = fmadd(a[3], b[0], e12);
+        e12   = fnmadd(a[1], b[2], e12);
+
+        p1_out[0] = s;
+        p1_out[1] = e23;
+        p1_out[2] = e31;
+        p1_out[3] = e12;
+    }
+
+    // rotor * translator (or translator * rotor if Flip is true)
+    // a := rotor p1
+    // b := translator p2 (the e0123 component is ignored)
+    template <bool Flip, typename V>
+    KLN_INLINE void gpRT(V const* a, V const* b, V* p2_out) noexcept
+    {
+        V e0123 = dot3(a[1], a[2], a[3], b[1], b[2], b[3]);
+        V e01;
+        V e02;
+        V e03;
+        if constexpr (Flip)
+        {
+            e01 = fmadd(a[0], b[1], fmsub(a[2], b[3], mul(a[3], b[2])));
+            e02 = fmadd(a[0], b[2], fmsub(a[3], b[1], mul(a[1], b[3])));
+            e03 = fmadd(a[0], b[3], fmsub(a[1], b[2], mul(a[2], b[1])));
+        }
+        else
+        {
+            e01 = fmadd(a[0], b[1], fmsub(a[3], b[2], mul(a[2], b[3])));
+            e02 = fmadd(a[0], b[2], fmsub(a[1], b[3], mul(a[3], b[1])));
+            e03 = fmadd(a[0], b[3], fmsub(a[2], b[1], mul(a[1], b[2])));
+        }
+
+        p2_out[0] = e0123;
+        p2_out[1] = e01;
+        p2_out[2] = e02;
+        p2_out[3] = e03;
+    }
+
+    // rotor * motor p2 (or motor p2 * rotor if Flip is true)
+    // a := rotor p1
+    // b := motor p2
+    template <bool Flip, typename V>
+    KLN_INLINE void gp12(V const* a, V const* b, V* p2_out) noexcept
+    {
+        V b0 = b[0];
+        V tmp[4];
+        gpRT<Flip>(a, b, tmp);
+        p2_out[0] = fmadd(a[0], b0, tmp[0]);
+        p2_out[1] = fnmadd(a[1], b0, tmp[1]);
+        p2_out[2] = fnmadd(a[2], b0, tmp[2]);
+        p2_out[3] = fnmadd(a[3], b0, tmp[3]);
+    }
+
+    // line * line
+    // a := line 1 p1
+    // b := line 1 p2
+    // c := line 2 p1
+    // d := line 2 p2
+    template <typename V>
+    KLN_INLINE void gpLL(V const* a,
+                         V const* b,
+                         V const* c,
+                         V const* d,
+                         V* p1_out,
+                         V* p2_out) noexcept
+    {
+        // -(a1 c1 + a2 c2 + a3 c3) +
+        // (a3 c2 - a2 c3) e23 +
+        // (a1 c3 - a3 c1) e31 +
+        // (a2 c1 - a1 c2) e12 +
+        // (a1 d1 + a2 d2 + a3 d3 + b1 c1 + b2 c2 + b3 c3) e0123 +
+        // (a3 d2 - a2 d3 + b3 c2 - b2 c3) e01 +
+        // (a1 d3 - a3 d1 + b1 c3 - b3 c1) e02 +
+        // (a2 d1 - a1 d2 + b2 c1 - b1 c2) e03
+        V s     = neg(dot3(a[1], a[2], a[3], c[1], c[2], c[3]));
+        V e23   = fmsub(a[3], c[2], mul(a[2], c[3]));
+        V e31   = fmsub(a[1], c[3], mul(a[3], c[1]));
+        V e12   = fmsub(a[2], c[1], mul(a[1], c[2]));
+        V e0123 = add(dot3(a[1], a[2], a[3], d[1], d[2], d[3]),
+                      dot3(b[1], b[2], b[3], c[1], c[2], c[3]));
+        V e01 = fmsub(a[3], d[2], mul(a[2], d[3]));
+        e01   = fmadd(b[3], c[2], e01);
+        e01   = fnmadd(b[2], c[3], e01);
+        V e02 = fmsub(a[1], d[3], mul(a[3], d[1]));
+        e02   = fmadd(b[1], c[3], e02);
+        e02   = fnmadd(b[3], c[1], e02);
+        V e03 = fmsub(a[2], d[1], mul(a[1], d[2]));
+        e03   = fmadd(b[2], c[1], e03);
+        e03   = fnmadd(b[1], c[2], e03);
+
+        p1_out[0] = s;
+        p1_out[1] = e23;
+        p1_out[2] = e31;
+        p1_out[3] = e12;
+        p2_out[0] = e0123;
+        p2_out[1] = e01;
+        p2_out[2] = e02;
+        p2_out[3] = e03;
+    }
+
+    // motor * motor
+    // a := motor 1 p1
+    // b := motor 1 p2
+    // c := motor 2 p1
+    // d := motor 2 p2
+    template <typename V>
+    KLN_INLINE void gpMM(V const* a,
+                         V const* b,
+                         V const* c,
+                         V const* d,
+                         V* p1_out,
+                         V* p2_out) noexcept
+    {
+        // (a0 d0 + b0 c0 + a1 d1 + b1 c1 + a2 d2 + a3 d3 + b2 c2 + b3 c3)
+        //  e0123 +
+        // (a0 d1 + b1 c0 + a3 d2 + b3 c2 - a1 d0 - a2 d3 - b0 c1 - b2 c3)
+        //  e01 +
+        // (a0 d2 + b2 c0 + a1 d3 + b1 c3 - a2 d0 - a3 d1 - b0 c2 - b3 c1)
+        //  e02 +
+        // (a0 d3 + b3 c0 + a2 d1 + b2 c1 - a3 d0 - a1 d2 - b0 c3 - b1 c2)
+        //  e03
+        V e0123 = fmadd(a[0], d[0], mul(b[0], c[0]));
+        e0123   = add(e0123, dot3(a[1], a[2], a[3], d[1], d[2], d[3]));
+        e0123   = add(e0123, dot3(b[1], b[2], b[3], c[1], c[2], c[3]));
+
+        V e01 = fmadd(a[0], d[1], mul(b[1], c[0]));
+        e01   = fmadd(a[3], d[2], e01);
+        e01   = fmadd(b[3], c[2], e01);
+        e01   = fnmadd(a[1], d[0], e01);
+        e01   = fnmadd(a[2], d[3], e01);
+        e01   = fnmadd(b[0], c[1], e01);
+        e01   = fnmadd(b[2], c[3], e01);
+
+        V e02 = fmadd(a[0], d[2], mul(b[2], c[0]));
+        e02   = fmadd(a[1], d[3], e02);
+        e02   = fmadd(b[1], c[3], e02);
+        e02   = fnmadd(a[2], d[0], e02);
+        e02   = fnmadd(a[3], d[1], e02);
+        e02   = fnmadd(b[0], c[2], e02);
+        e02   = fnmadd(b[3], c[1], e02);
+
+        V e03 = fmadd(a[0], d[3], mul(b[3], c[0]));
+        e03   = fmadd(a[2], d[1], e03);
+        e03   = fmadd(b[2], c[1], e03);
+        e03   = fnmadd(a[3], d[0], e03);
+        e03   = fnmadd(a[1], d[2], e03);
+        e03   = fnmadd(b[0], c[3], e03);
+        e03   = fnmadd(b[1], c[2], e03);
+
+        gp11(a, c, p1_out);
+        p2_out[0] = e0123;
+        p2_out[1] = e01;
+        p2_out[2] = e02;
+        p2_out[3] = e03;
+    }
+
+    // Normalizes the motor p1 + p2 in place such that m ~m = 1. See
+    // motor::normalize for the derivation.
+    template <typename V>
+    KLN_INLINE void normalize_motor(V* p1, V* p2) noexcept
+    {
+        V b2 = fmadd(
+            p1[0], p1[0], dot3(p1[1], p1[2], p1[3], p1[1], p1[2], p1[3]));
+        V s  = rsqrt_nr1(b2);
+        V bc = fnmadd(
+            p1[0], p2[0], dot3(p1[1], p1[2], p1[3], p2[1], p2[2], p2[3]));
+        V t  = mul(mul(bc, rcp_nr1(b2)), s);
+
+        p2[0] = fmadd(p1[0], t, mul(p2[0], s));
+        for (size_t i = 1; i != 4; ++i)
+        {
+            p2[i] = fnmadd(p1[i], t, mul(p2[i], s));
+        }
+        for (size_t i = 0; i != 4; ++i)
+        {
+            p1[i] = mul(p1[i], s);
+        }
+    }
+} // namespace soa
+} // namespace detail
+} // namespace kln
@@ -0,0 +1,317 @@
+// File: x86_soa_sandwich.hpp
+// Purpose: Structure-of-arrays counterparts of the routines in
+// x86_sandwich.hpp.
+//
+// Notes:
+// 1. See x86_soa_geometric_product.hpp for the argument conventions.
+// 2. In SoA form, the action of a motor b + c (b := p1, c := p2) is most
+//    cheaply expressed by first forming the 3x3 rotation block R and the
+//    translation column t once per motor lane, then applying them with
+//    vertical multiply-adds. The entries of R and t are exactly the quadratic
+//    forms appearing in the symbolic expansions of sw312 and sw012.
+
+#pragma once
+
+#include "x86_soa.hpp"
+
+namespace kln
+{
+namespace detail
+{
+namespace soa
+{
+    // Partition memory layouts
+    //     LSB --> MSB
+    // p0: (e0, e1, e2, e3)
+    // p1: (1, e23, e31, e12)
+    // p2: (e0123, e01, e02, e03)
+    // p3: (e123, e032, e013, e021)
+
+    // Rotation block of the rotor b stored in row-major order. The rows act on
+    // the (e032, e013, e021) components of a point, the (e1, e2, e3) components
+    // of a plane, or the (e23, e31, e12) components of a line.
+    template <typename V>
+    KLN_INLINE void rotation(V const* b, V* r) noexcept
+    {
+        V b00 = mul(b[0], b[0]);
+        V b11 = mul(b[1], b[1]);
+        V b22 = mul(b[2], b[2]);
+        V b33 = mul(b[3], b[3]);
+        V b01 = mul(b[0], b[1]);
+        V b02 = mul(b[0], b[2]);
+        V b03 = mul(b[0], b[3]);
+        V b12 = mul(b[1], b[2]);
+        V b13 = mul(b[1], b[3]);
+        V b23 = mul(b[2], b[3]);
+
+        V two = set1<V>(2.f);
+
+        r[0] = sub(add(b00, b11), add(b22, b33));
+        r[1] = mul(two, add(b03, b12));
+        r[2] = mul(two, sub(b13, b02));
+        r[3] = mul(two, sub(b12, b03));
+        r[4] = sub(add(b00, b22), add(b11, b33));
+        r[5] = mul(two, add(b01, b23));
+        r[6] = mul(two, add(b02, b13));
+        r[7] = mul(two, sub(b23, b01));
+        r[8] = sub(add(b00, b33), add(b11, b22));
+    }
+
+    // Translation column of the motor b + c, scaled by the homogeneous
+    // coordinate of a point.
+    template <typename V>
+    KLN_INLINE void translation(V const* b, V const* c, V* t) noexcept
+    {
+        // 2(b2 c3 - b0 c1 - b3 c2 - b1 c0) e032 +
+        // 2(b3 c1 - b0 c2 - b1 c3 - b2 c0) e013 +
+        // 2(b1 c2 - b0 c3 - b2 c1 - b3 c0) e021
+        V two = set1<V>(2.f);
+        V t0  = fmsub(b[2], c[3], mul(b[0], c[1]));
+        t0    = fnmadd(b[3], c[2], t0);
+        t0    = fnmadd(b[1], c[0], t0);
+        V t1  = fmsub(b[3], c[1], mul(b[0], c[2]));
+        t1    = fnmadd(b[1], c[3], t1);
+        t1    = fnmadd(b[2], c[0], t1);
+        V t2  = fmsub(b[1], c[2], mul(b[0], c[3]));
+        t2    = fnmadd(b[2], c[1], t2);
+        t2    = fnmadd(b[3], c[0], t2);
+        t[0]  = mul(two, t0);
+        t[1]  = mul(two, t1);
+        t[2]  = mul(two, t2);
+    }
+
+    // r * (a1, a2, a3)
+    template <typename V>
+    KLN_INLINE void rotate(V const* r, V a1, V a2, V a3, V* out) noexcept
+    {
+        out[0] = fmadd(r[2], a3, fmadd(r[1], a2, mul(r[0], a1)));
+        out[1] = fmadd(r[5], a3, fmadd(r[4], a2, mul(r[3], a1)));
+        out[2] = fmadd(r[8], a3, fmadd(r[7], a2, mul(r[6], a1)));
+    }
+
+    // Apply a motor (or rotor if Translate is false) to a point or direction.
+    // a := p3
+    // b := p1
+    // c := p2 (ignored if Translate is false)
+    template <bool Translate, typename V>
+    KLN_INLINE void sw312(V const* a,
+                          V const* b,
+                          [[maybe_unused]] V const* c,
+                          V* out) noexcept
+    {
+        V r[9];
+        rotation(b, r);
+        V xyz[3];
+        rotate(r, a[1], a[2], a[3], xyz);
+
+        if constexpr (Translate)
+        {
+            V t[3];
+            translation(b, c, t);
+            xyz[0] = fmadd(t[0], a[0], xyz[0]);
+            xyz[1] = fmadd(t[1], a[0], xyz[1]);
+            xyz[2] = fmadd(t[2], a[0], xyz[2]);
+        }
+
+        V w    = mul(a[0], dot3(b[0], b[1], b[2], b[0], b[1], b[2]));
+        out[0] = fmadd(b[3], mul(b[3], a[0]), w);
+        out[1] = xyz[0];
+        out[2] = xyz[1];
+        out[3] = xyz[2];
+    }
+
+    // Apply a motor (or rotor if Translate is false) to a plane.
+    // a := p0
+    // b := p1
+    // c := p2 (ignored if Translate is false)
+    template <bool Translate, typename V>
+    KLN_INLINE void sw012(V const* a,
+                          V const* b,
+                          [[maybe_unused]] V const* c,
+                          V* out) noexcept
+    {
+        V r[9];
+        rotation(b, r);
+        V xyz[3];
+        rotate(r, a[1], a[2], a[3], xyz);
+
+        // a0 (b0^2 + b1^2 + b2^2 + b3^2) e0 (rotor contribution)
+        V e0 = mul(a[0], dot3(b[0], b[1], b[2], b[0], b[1], b[2]));
+        e0   = fmadd(b[3], mul(b[3], a[0]), e0);
+
+        if constexpr (Translate)
+        {
+            // 2a1(b0 c1 + b2 c3 + b1 c0 - b3 c2) +
+            // 2a2(b0 c2 + b3 c1 + b2 c0 - b1 c3) +
+            // 2a3(b0 c3 + b1 c2 + b3 c0 - b2 c1) e0
+            V u0 = fmadd(b[0], c[1], mul(b[2], c[3]));
+            u0   = fmadd(b[1], c[0], u0);
+            u0   = fnmadd(b[3], c[2], u0);
+            V u1 = fmadd(b[0], c[2], mul(b[3], c[1]));
+            u1   = fmadd(b[2], c[0], u1);
+            u1   = fnmadd(b[1], c[3], u1);
+            V u2 = fmadd(b[0], c[3], mul(b[1], c[2]));
+            u2   = fmadd(b[3], c[0], u2);
+            u2   = fnmadd(b[2], c[1], u2);
+            e0   = fmadd(set1<V>(2.f), dot3(a[1], a[2], a[3], u0, u1, u2), e0);
+        }
+
+        out[0] = e0;
+        out[1] = xyz[0];
+        out[2] = xyz[1];
+        out[3] = xyz[2];
+    }
+
+    // Apply a motor (or rotor if Translate is false) to a line.
+    // a := line p1
+    // d := line p2
+    // b := motor p1
+    // c := motor p2 (ignored if Translate is false)
+    template <bool Translate, typename V>
+    KLN_INLINE void swMM(V const* a,
+                         V const* d,
+                         V const* b,
+                         [[maybe_unused]] V const* c,
+                         V* p1_out,
+                         V* p2_out) noexcept
+    {
+        V r[9];
+        rotation(b, r);
+        V real[3];
+        rotate(r, a[1], a[2], a[3], real);
+        V ideal[3];
+        rotate(r, d[1], d[2], d[3], ideal);
+
+        if constexpr (Translate)
+        {
+            // Coupling of the line's Euclidean part with the motor's ideal part
+            //
+            // 2a1(b1 c1 - b0 c0 - b2 c2 - b3 c3) +
+            // 2a2(b2 c1 + b1 c2 + b0 c3 - b3 c0) +
+            // 2a3(b3 c1 + b1 c3 - b0 c2 + b2 c0) e01 +
+            //
+            // 2a1(b2 c1 + b1 c2 - b0 c3 + b3 c0) +
+            // 2a2(b2 c2 - b0 c0 - b1 c1 - b3 c3) +
+            // 2a3(b3 c2 + b2 c3 + b0 c1 - b1 c0) e02 +
+            //
+            // 2a1(b3 c1 + b1 c3 + b0 c2 - b2 c0) +
+            // 2a2(b3 c2 + b2 c3 - b0 c1 + b1 c0) +
+            // 2a3(b3 c3 - b0 c0 - b1 c1 - b2 c2) e03
+            V b0c0 = mul(b[0], c[0]);
+            V b1c1 = mul(b[1], c[1]);
+            V b2c2 = mul(b[2], c[2]);
+            V b3c3 = mul(b[3], c[3]);
+            V s0   = add(b0c0, add(b1c1, add(b2c2, b3c3)));
+
+            V b0c1 = mul(b[0], c[1]);
+            V b1c0 = mul(b[1], c[0]);
+            V b0c2 = mul(b[0], c[2]);
+            V b2c0 = mul(b[2], c[0]);
+            V b0c3 = mul(b[0], c[3]);
+            V b3c0 = mul(b[3], c[0]);
+
+            V sym12 = fmadd(b[2], c[1], mul(b[1], c[2]));
+            V sym13 = fmadd(b[3], c[1], mul(b[1], c[3]));
+            V sym23 = fmadd(b[3], c[2], mul(b[2], c[3]));
+
+            V two = set1<V>(2.f);
+            V s[9];
+            s[0] = mul(two, sub(add(b1c1, b1c1), s0));
+            s[1] = mul(two, add(sym12, sub(b0c3, b3c0)));
+            s[2] = mul(two, add(sym13, sub(b2c0, b0c2)));
+            s[3] = mul(two, add(sym12, sub(b3c0, b0c3)));
+            s[4] = mul(two, sub(add(b2c2, b2c2), s0));
+            s[5] = mul(two, add(sym23, sub(b0c1, b1c0)));
+            s[6] = mul(two, add(sym13, sub(b0c2, b2c0)));
+            s[7] = mul(two, add(sym23, sub(b1c0, b0c1)));
+            s[8] = mul(two, sub(add(b3c3, b3c3), s0));
+
+            V coupling[3];
+            rotate(s, a[1], a[2], a[3], coupling);
+            ideal[0] = add(ideal[0], coupling[0]);
+            ideal[1] = add(ideal[1], coupling[1]);
+            ideal[2] = add(ideal[2], coupling[2]);
+        }
+
+        p1_out[0] = zero<V>();
+        p1_out[1] = real[0];
+        p1_out[2] = real[1];
+        p1_out[3] = real[2];
+        p2_out[0] = zero<V>();
+        p2_out[1] = ideal[0];
+        p2_out[2] = ideal[1];
+        p2_out[3] = ideal[2];
+    }
+
+    // Apply a translator to a point.
+    // a := p3
+    // c := translator p2
+    template <typename V>
+    KLN_INLINE void sw32(V const* a, V const* c, V* out) noexcept
+    {
+        // a0 e123 +
+        // (a1 - 2 a0 c1) e032 +
+        // (a2 - 2 a0 c2) e013 +
+        // (a3 - 2 a0 c3) e021
+        V a0_2 = add(a[0], a[0]);
+        out[0] = a[0];
+        out[1] = fnmadd(a0_2, c[1], a[1]);
+        out[2] = fnmadd(a0_2, c[2], a[2]);
+        out[3] = fnmadd(a0_2, c[3], a[3]);
+    }
+
+    // Apply a translator to a plane.
+    // a := p0
+    // c := translator p2
+    template <typename V>
+    KLN_INLINE void sw02(V const* a, V const* c, V* out) noexcept
+    {
+        // (a0 + 2(a1 c1 + a2 c2 + a3 c3)) e0 +
+        // a1 e1 +
+        // a2 e2 +
+        // a3 e3
+        V dp   = dot3(a[1], a[2], a[3], c[1], c[2], c[3]);
+        out[0] = fmadd(set1<V>(2.f), dp, a[0]);
+        out[1] = a[1];
+        out[2] = a[2];
+        out[3] = a[3];
+    }
+
+    // Apply a translator to a line.
+    // a := line p1
+    // d := line p2
+    // c := translator p2
+    template <typename V>
+    KLN_INLINE void swL2(V const* a,
+                         V const* d,
+                         V const* c,
+                         V* p1_out,
+                         V* p2_out) noexcept
+    {
+        // a1 e23 +
+        // a2 e31 +
+        // a3 e12 +
+        //
+        // (2(a2 c3 - a3 c2 - a1 c0) + d1) e01 +
+        // (2(a3 c1 - a1 c3 - a2 c0) + d2) e02 +
+        // (2(a1 c2 - a2 c1 - a3 c0) + d3) e03
+        V two = set1<V>(2.f);
+        V e01 = fmsub(a[2], c[3], mul(a[3], c[2]));
+        e01   = fnmadd(a[1], c[0], e01);
+        V e02 = fmsub(a[3], c[1], mul(a[1], c[3]));
+        e02   = fnmadd(a[2], c[0], e02);
+        V e03 = fmsub(a[1], c[2], mul(a[2], c[1]));
+        e03   = fnmadd(a[3], c[0], e03);
+
+        p1_out[0] = zero<V>();
+        p1_out[1] = a[1];
+        p1_out[2] = a[2];
+        p1_out[3] = a[3];
+        p2_out[0] = zero<V>();
+        p2_out[1] = fmadd(two, e01, d[1]);
+        p2_out[2] = fmadd(two, e02, d[2]);
+        p2_out[3] = fmadd(two, e03, d[3]);
+    }
+} // namespace soa
+} // namespace detail
+} // namespace kln
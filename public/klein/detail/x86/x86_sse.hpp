@@ -3,12 +3,17 @@
 // intrinsics
 #pragma once
 
-#ifdef KLEIN_SSE_4_1
+#if defined(KLN_ENABLE_ISE_AVX2) || defined(KLN_ENABLE_ISE_AVX512)
+#    include <immintrin.h>
+#elif defined(KLEIN_SSE_4_1)
 #    include <smmintrin.h>
 #else
 #    include <tmmintrin.h>
 #endif
 
+#include <cstddef>
+#include <cstdint>
+
 // Little-endian XMM register swizzle
 //
 // KLN_SWIZZLE(reg, 3, 2, 1, 0) is the identity.
@@ -20,6 +25,30 @@
         _mm_shuffle_ps((reg), (reg), _MM_SHUFFLE(x, y, z, w))
 #endif
 
+#ifdef KLN_ENABLE_ISE_AVX2
+// Swizzle applied independently to both 128-bit lanes of a YMM register. The
+// lane-local semantics match KLN_SWIZZLE.
+#    ifndef KLN_SWIZZLE_256
+#        define KLN_SWIZZLE_256(reg, x, y, z, w) \
+            _mm256_permute_ps((reg), _MM_SHUFFLE(x, y, z, w))
+#    endif
+
+// Swizzle of the four doubles of a YMM register, crossing 128-bit lanes. The
+// semantics match KLN_SWIZZLE with each float replaced by a double.
+#    ifndef KLN_SWIZZLE_PD
+#        define KLN_SWIZZLE_PD(reg, x, y, z, w) \
+            _mm256_permute4x64_pd((reg), _MM_SHUFFLE(x, y, z, w))
+#    endif
+#endif
+
+#ifdef KLN_ENABLE_ISE_AVX512
+// Swizzle applied independently to all four 128-bit lanes of a ZMM register.
+#    ifndef KLN_SWIZZLE_512
+#        define KLN_SWIZZLE_512(reg, x, y, z, w) \
+            _mm512_permute_ps((reg), _MM_SHUFFLE(x, y, z, w))
+#    endif
+#endif
+
 #ifndef KLN_RESTRICT
 #    define KLN_RESTRICT __restrict
 #endif
@@ -44,8 +73,69 @@
 
 namespace kln
 {
+/// Precision of the reciprocals and square roots evaluated by normalization
+/// and inversion. Routines accepting a precision take it as a template
+/// argument defaulting to `refined`, so that it can be chosen per call site,
+/// e.g. `m.normalize<kln::precision::exact>()`.
+enum class precision
+{
+    /// The `rcpps` and `rsqrtps` estimates (about 12 bits)
+    fast,
+    /// The estimates refined by a Newton-Raphson iteration (about 22 bits)
+    refined,
+    /// `divps` and `sqrtps` (within an ULP or so)
+    exact
+};
+
+/// Tag selecting the non-temporal form of a batch routine, as in
+/// `m(points, points, count, kln::non_temporal{})`. The non-temporal forms
+/// compute the same results, but write them with streaming stores that
+/// bypass the caches, and prefetch their input ahead of use.
+///
+/// This pays off for batches whose output far exceeds the last level cache
+/// and is not read again soon (a vertex buffer about to be uploaded, a
+/// frame of replicated transforms, ...). A regular store first reads the
+/// destination cache line from memory, and the written lines then evict
+/// useful data from the caches. For batches that fit in the caches, the
+/// regular forms are faster. The non-temporal forms end with a store fence,
+/// so that their output is visible to other threads once they return.
+struct non_temporal
+{};
+
 namespace detail
 {
+    // Distance in bytes ahead of the current input at which the streaming
+    // batch kernels prefetch
+    constexpr size_t stream_prefetch_distance = 1024;
+
+    // Writes a to out, bypassing the caches if Stream is true. Streaming
+    // stores require out to be 16-byte aligned, as entities are.
+    template <bool Stream>
+    KLN_INLINE void KLN_VEC_CALL store_entity(__m128* out, __m128 a) noexcept
+    {
+        if constexpr (Stream)
+        {
+            _mm_stream_ps(reinterpret_cast<float*>(out), a);
+        }
+        else
+        {
+            *out = a;
+        }
+    }
+
+    // Prefetches the input of a streaming kernel ahead of in, for a single
+    // use. Prefetches past the end of the input are harmless.
+    template <bool Stream>
+    KLN_INLINE void prefetch_ahead(void const* in) noexcept
+    {
+        if constexpr (Stream)
+        {
+            uintptr_t address
+                = reinterpret_cast<uintptr_t>(in) + stream_prefetch_distance;
+            _mm_prefetch(reinterpret_cast<char const*>(address), _MM_HINT_NTA);
+        }
+    }
+
     // DP high components and caller ignores returned high components
     KLN_INLINE __m128 KLN_VEC_CALL hi_dp_ss(__m128 a, __m128 b) noexcept
     {
@@ -105,6 +195,60 @@ namespace detail
         return _mm_mul_ps(a, rsqrt_nr1(a));
     }
 
+    // Reciprocal at the precision P
+    template <precision P = precision::refined>
+    KLN_INLINE __m128 KLN_VEC_CALL reciprocal(__m128 a) noexcept
+    {
+        if constexpr (P == precision::fast)
+        {
+            return _mm_rcp_ps(a);
+        }
+        else if constexpr (P == precision::refined)
+        {
+            return rcp_nr1(a);
+        }
+        else
+        {
+            return _mm_div_ps(_mm_set1_ps(1.f), a);
+        }
+    }
+
+    // Reciprocal square root at the precision P
+    template <precision P = precision::refined>
+    KLN_INLINE __m128 KLN_VEC_CALL reciprocal_sqrt(__m128 a) noexcept
+    {
+        if constexpr (P == precision::fast)
+        {
+            return _mm_rsqrt_ps(a);
+        }
+        else if constexpr (P == precision::refined)
+        {
+            return rsqrt_nr1(a);
+        }
+        else
+        {
+            return _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(a));
+        }
+    }
+
+    // Square root at the precision P
+    template <precision P = precision::refined>
+    KLN_INLINE __m128 KLN_VEC_CALL square_root(__m128 a) noexcept
+    {
+        if constexpr (P == precision::fast)
+        {
+            return _mm_mul_ps(a, _mm_rsqrt_ps(a));
+        }
+        else if constexpr (P == precision::refined)
+        {
+            return sqrt_nr1(a);
+        }
+        else
+        {
+            return _mm_sqrt_ps(a);
+        }
+    }
+
 #ifdef KLEIN_SSE_4_1
     KLN_INLINE __m128 KLN_VEC_CALL hi_dp(__m128 a, __m128 b) noexcept
     {
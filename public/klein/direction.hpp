@@ -67,17 +67,19 @@ public:
     /// Normalize this direction by dividing all components by the
     /// magnitude (by default, `rsqrtps` is used with a single Newton-Raphson
     /// refinement iteration)
+    template <precision P = precision::refined>
     void normalize() noexcept
     {
-        __m128 tmp = detail::rsqrt_nr1(detail::hi_dp_bc(p3_, p3_));
+        __m128 tmp = detail::reciprocal_sqrt<P>(detail::hi_dp_bc(p3_, p3_));
         p3_        = _mm_mul_ps(p3_, tmp);
     }
 
     /// Return a normalized copy of this direction
+    template <precision P = precision::refined>
     direction normalized() const noexcept
     {
         direction out = *this;
-        out.normalize();
+        out.normalize<P>();
         return out;
     }
 
@@ -0,0 +1,246 @@
+#pragma once
+
+#include "line.hpp"
+#include "plane.hpp"
+#include "point.hpp"
+
+#include "detail/soa.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace kln
+{
+/// \defgroup distance Distances
+/// @{
+///
+/// Batch Euclidean distance queries. Each routine measures `count` entities
+/// against a single fixed entity (or, for lines, pairwise against a second
+/// array) and writes one float per entity.
+///
+/// The distances are what the joins and inner products of the other modules
+/// would produce, e.g. the distance from a point $P$ to a line $\ell$ is the
+/// norm of the plane $P\vee\ell$, but only the handful of coefficients that
+/// contribute are ever computed. The entities are transposed to
+/// structure-of-arrays form, four (or eight when `KLN_ENABLE_ISE_AVX2` is
+/// defined) at a time, and the fixed entity is broadcast once.
+///
+/// Points must be normalized. Planes and lines need not be.
+///
+/// !!! example
+///
+///     ```cpp
+///         kln::plane ground{0.f, 1.f, 0.f, 0.f};
+///         float height[count];
+///         kln::distance(points, ground, height, count);
+///     ```
+
+namespace detail
+{
+    // Evaluates f for groups of entities a[i] (and b[i] unless b is null) and
+    // stores the resulting registers to out. A partial tail is padded by
+    // repeating the last entity.
+    template <typename A, typename B, typename F>
+    KLN_INLINE void batch_distance(A const* a,
+                                   B const* b,
+                                   float* out,
+                                   size_t count,
+                                   F&& f) noexcept
+    {
+        size_t i = 0;
+#ifdef KLN_ENABLE_ISE_AVX2
+        for (; i + 8 <= count; i += 8)
+        {
+            soa::storeu(f(__m256{}, a + i, b ? b + i : nullptr), out + i);
+        }
+#endif
+        for (; i + 4 <= count; i += 4)
+        {
+            soa::storeu(f(__m128{}, a + i, b ? b + i : nullptr), out + i);
+        }
+
+        if (i != count)
+        {
+            size_t n = count - i;
+            A pad_a[4];
+            B pad_b[4];
+            for (size_t j = 0; j != 4; ++j)
+            {
+                size_t src = i + std::min(j, n - 1);
+                pad_a[j]   = a[src];
+                if (b)
+                {
+                    pad_b[j] = b[src];
+                }
+            }
+
+            float tail[4];
+            soa::storeu(f(__m128{}, pad_a, b ? pad_b : nullptr), tail);
+            std::copy(tail, tail + n, out + i);
+        }
+    }
+
+    // Distance between the lines with directions u1, u2 and moments m1, m2
+    template <typename V>
+    KLN_INLINE V KLN_VEC_CALL line_distance(V const* u1,
+                                            V const* m1,
+                                            V const* u2,
+                                            V const* m2) noexcept
+    {
+        using namespace soa;
+
+        // With m = x \times u for any point x on the line, the reciprocal
+        // product u1.m2 + u2.m1 is (x1 - x2).(u1 \times u2).
+        V reciprocal = add(dot3(u1[0], u1[1], u1[2], m2[0], m2[1], m2[2]),
+                           dot3(u2[0], u2[1], u2[2], m1[0], m1[1], m1[2]));
+        V c[3]       = {fmsub(u1[1], u2[2], mul(u1[2], u2[1])),
+                        fmsub(u1[2], u2[0], mul(u1[0], u2[2])),
+                        fmsub(u1[0], u2[1], mul(u1[1], u2[0]))};
+        V c2         = dot3(c[0], c[1], c[2], c[0], c[1], c[2]);
+        V skew       = mul(abs(reciprocal), soa::rsqrt_nr1(c2));
+
+        // Parallel lines: with unit directions pointing the same way, the
+        // difference of the moments is (x2 - x1) \times u
+        V u1_2 = dot3(u1[0], u1[1], u1[2], u1[0], u1[1], u1[2]);
+        V u2_2 = dot3(u2[0], u2[1], u2[2], u2[0], u2[1], u2[2]);
+        V dp   = dot3(u1[0], u1[1], u1[2], u2[0], u2[1], u2[2]);
+        V n1   = bit_xor(soa::rsqrt_nr1(u1_2), bit_and(dp, set1<V>(-0.f)));
+        V n2   = soa::rsqrt_nr1(u2_2);
+        V d[3] = {fmsub(m2[0], n2, mul(m1[0], n1)),
+                  fmsub(m2[1], n2, mul(m1[1], n1)),
+                  fmsub(m2[2], n2, mul(m1[2], n1))};
+
+        V parallel = sqrt(dot3(d[0], d[1], d[2], d[0], d[1], d[2]));
+
+        // The skew formula loses all precision as the lines approach parallel
+        V threshold = mul(set1<V>(1e-6f), mul(u1_2, u2_2));
+        return select(cmplt(c2, threshold), parallel, skew);
+    }
+} // namespace detail
+
+/// Writes the signed distance of each of the `count` points from the plane
+/// `p` to `out`. The distance is positive on the side the plane's normal
+/// points to.
+inline void distance(point const* points,
+                     plane p,
+                     float* out,
+                     size_t count) noexcept
+{
+    float c[4];
+    _mm_storeu_ps(c, p.normalized().p0_);
+
+    detail::batch_distance(
+        points,
+        static_cast<point const*>(nullptr),
+        out,
+        count,
+        [&](auto v, point const* a, point const*) {
+            using namespace detail::soa;
+            using V = decltype(v);
+
+            V x[4];
+            load<1>(&a->p3_, x);
+            return fmadd(set1<V>(c[0]),
+                         x[0],
+                         dot3(set1<V>(c[1]),
+                              set1<V>(c[2]),
+                              set1<V>(c[3]),
+                              x[1],
+                              x[2],
+                              x[3]));
+        });
+}
+
+/// Writes the distance of each of the `count` points from the line `l` to
+/// `out`.
+inline void distance(point const* points,
+                     line l,
+                     float* out,
+                     size_t count) noexcept
+{
+    // With u the direction of the line and m its moment, the plane joining a
+    // point x and the line has normal x \times u - m.
+    float u[4];
+    float m[4];
+    _mm_storeu_ps(u, l.p1_);
+    _mm_storeu_ps(m, l.p2_);
+    float inv_norm = 1.f / std::sqrt(u[1] * u[1] + u[2] * u[2] + u[3] * u[3]);
+
+    detail::batch_distance(
+        points,
+        static_cast<point const*>(nullptr),
+        out,
+        count,
+        [&](auto v, point const* a, point const*) {
+            using namespace detail::soa;
+            using V = decltype(v);
+
+            V x[4];
+            load<1>(&a->p3_, x);
+            V u1   = set1<V>(u[1]);
+            V u2   = set1<V>(u[2]);
+            V u3   = set1<V>(u[3]);
+            V n[3] = {fmsub(x[2], u3, fmadd(x[3], u2, set1<V>(m[1]))),
+                      fmsub(x[3], u1, fmadd(x[1], u3, set1<V>(m[2]))),
+                      fmsub(x[1], u2, fmadd(x[2], u1, set1<V>(m[3])))};
+            return mul(sqrt(dot3(n[0], n[1], n[2], n[0], n[1], n[2])),
+                       set1<V>(inv_norm));
+        });
+}
+
+/// Writes the distance between each of the `count` lines and the line `l`
+/// to `out`.
+inline void distance(line const* lines,
+                     line l,
+                     float* out,
+                     size_t count) noexcept
+{
+    float u[4];
+    float m[4];
+    _mm_storeu_ps(u, l.p1_);
+    _mm_storeu_ps(m, l.p2_);
+
+    detail::batch_distance(
+        lines,
+        static_cast<line const*>(nullptr),
+        out,
+        count,
+        [&](auto v, line const* a, line const*) {
+            using namespace detail::soa;
+            using V = decltype(v);
+
+            V a1[4];
+            V a2[4];
+            load<2>(&a->p1_, a1);
+            load<2>(&a->p2_, a2);
+            V b1[3] = {set1<V>(u[1]), set1<V>(u[2]), set1<V>(u[3])};
+            V b2[3] = {set1<V>(m[1]), set1<V>(m[2]), set1<V>(m[3])};
+            return detail::line_distance(a1 + 1, a2 + 1, b1, b2);
+        });
+}
+
+/// Writes the distance between `a[i]` and `b[i]` to `out[i]` for each `i`
+/// in `[0, count)`.
+inline void distance(line const* a,
+                     line const* b,
+                     float* out,
+                     size_t count) noexcept
+{
+    detail::batch_distance(
+        a, b, out, count, [](auto v, line const* a, line const* b) {
+            using namespace detail::soa;
+            using V = decltype(v);
+
+            V a1[4];
+            V a2[4];
+            V b1[4];
+            V b2[4];
+            load<2>(&a->p1_, a1);
+            load<2>(&a->p2_, a2);
+            load<2>(&b->p1_, b1);
+            load<2>(&b->p2_, b2);
+            return detail::line_distance(a1 + 1, a2 + 1, b1 + 1, b2 + 1);
+        });
+}
+/// @}
+} // namespace kln
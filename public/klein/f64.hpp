@@ -0,0 +1,1084 @@
+// File: f64.hpp
+// Double precision entity types in the kln::d namespace.
+// This header is not included by klein.hpp and requires KLN_ENABLE_ISE_AVX2
+// (link klein::klein_f64).
+
+#pragma once
+
+#include "detail/f64.hpp"
+#include "line.hpp"
+#include "motor.hpp"
+#include "plane.hpp"
+#include "point.hpp"
+#include "rotor.hpp"
+#include "translator.hpp"
+
+#include <cmath>
+
+#ifdef KLN_ENABLE_ISE_AVX2
+
+namespace kln
+{
+/// Double precision entities
+namespace d
+{
+/// \defgroup f64 Double precision entities
+///
+/// The types in the `kln::d` namespace mirror the planes, points,
+/// directions, lines, rotors, translators, and motors of the `kln`
+/// namespace, with each partition held in a `__m256d` register of four
+/// doubles instead of a `__m128` register of four floats. The component
+/// layout of every partition is unchanged, and the kernels evaluate the same
+/// expansions as their single precision counterparts.
+///
+/// Single precision motors lose accuracy when they are composed many times
+/// in sequence, as when integrating the pose of a rigid body over a long
+/// simulation, or when chaining transforms far from the origin. Keeping
+/// such state in double precision and converting to single precision for
+/// bulk work (rendering, skinning, ...) avoids the drift.
+///
+/// !!! example
+///
+///     ```c++
+///         kln::d::motor pose{kln::d::rotor{0.f, 0.f, 0.f, 1.f}};
+///         kln::d::motor step = kln::d::exp(velocity * dt);
+///         for (size_t i = 0; i != steps; ++i)
+///         {
+///             pose = step * pose;
+///         }
+///
+///         // Convert for use with the single precision batch routines
+///         kln::motor m = pose.normalized().as_float();
+///     ```
+///
+/// Each type is constructible from its single precision counterpart
+/// (explicitly, since the conversion is not free), and converts back with
+/// `as_float()`. Geometric products compose rotors, translators, and motors,
+/// the call operator applies them to planes, points, directions, and lines,
+/// and `exp` and `log` map between lines and motors. Normalization and
+/// inversion always use full precision division and square roots.
+///
+/// !!! note
+///
+///     The double precision types are only available when
+///     `KLN_ENABLE_ISE_AVX2` is defined and the translation unit is compiled
+///     with AVX2 support. They are single entity types; there are no batch
+///     or incidence (meet, join, inner product) operations in double
+///     precision.
+
+/// \addtogroup f64
+/// @{
+
+class plane final
+{
+public:
+    plane() noexcept = default;
+
+    plane(__m256d ymm) noexcept
+        : p0_{ymm}
+    {}
+
+    /// The plane $ax + by + cz + d = 0$
+    plane(double a, double b, double c, double d) noexcept
+        : p0_{_mm256_set_pd(c, b, a, d)}
+    {}
+
+    explicit plane(kln::plane p) noexcept
+        : p0_{detail::f64::widen(p.p0_)}
+    {}
+
+    /// Round to the nearest single precision plane.
+    [[nodiscard]] kln::plane as_float() const noexcept
+    {
+        return {detail::f64::narrow(p0_)};
+    }
+
+    /// Normalize this plane $p$ such that $p \cdot p = 1$.
+    void normalize() noexcept
+    {
+        p0_ = _mm256_mul_pd(
+            p0_, detail::f64::reciprocal_sqrt(detail::f64::hi_dp_bc(p0_, p0_)));
+    }
+
+    /// Return a normalized copy of this plane.
+    [[nodiscard]] plane normalized() const noexcept
+    {
+        plane out = *this;
+        out.normalize();
+        return out;
+    }
+
+    /// Compute the plane norm, which is often used to compute distances
+    /// between points and lines.
+    [[nodiscard]] double norm() const noexcept
+    {
+        return std::sqrt(detail::f64::lo(detail::f64::hi_dp_bc(p0_, p0_)));
+    }
+
+    [[nodiscard]] bool KLN_VEC_CALL approx_eq(plane other, double epsilon) const
+        noexcept
+    {
+        return detail::f64::approx_eq(p0_, other.p0_, epsilon);
+    }
+
+    [[nodiscard]] double x() const noexcept
+    {
+        return detail::f64::lane(p0_, 1);
+    }
+
+    [[nodiscard]] double e1() const noexcept
+    {
+        return x();
+    }
+
+    [[nodiscard]] double y() const noexcept
+    {
+        return detail::f64::lane(p0_, 2);
+    }
+
+    [[nodiscard]] double e2() const noexcept
+    {
+        return y();
+    }
+
+    [[nodiscard]] double z() const noexcept
+    {
+        return detail::f64::lane(p0_, 3);
+    }
+
+    [[nodiscard]] double e3() const noexcept
+    {
+        return z();
+    }
+
+    [[nodiscard]] double d() const noexcept
+    {
+        return detail::f64::lo(p0_);
+    }
+
+    [[nodiscard]] double e0() const noexcept
+    {
+        return d();
+    }
+
+    /// Addresses the plane partition $(\mathbf{e}_0, \mathbf{e}_1,
+    /// \mathbf{e}_2, \mathbf{e}_3)$
+    __m256d p0_;
+};
+
+class point final
+{
+public:
+    point() noexcept = default;
+
+    point(__m256d ymm) noexcept
+        : p3_{ymm}
+    {}
+
+    /// Component-wise constructor (homogeneous coordinate is automatically
+    /// initialized to 1)
+    point(double x, double y, double z) noexcept
+        : p3_{_mm256_set_pd(z, y, x, 1.0)}
+    {}
+
+    explicit point(kln::point p) noexcept
+        : p3_{detail::f64::widen(p.p3_)}
+    {}
+
+    /// Round to the nearest single precision point.
+    [[nodiscard]] kln::point as_float() const noexcept
+    {
+        return {detail::f64::narrow(p3_)};
+    }
+
+    /// Normalize this point (division is done via the homogeneous coordinate)
+    void normalize() noexcept
+    {
+        p3_ = _mm256_div_pd(p3_, KLN_SWIZZLE_PD(p3_, 0, 0, 0, 0));
+    }
+
+    /// Return a normalized copy of this point.
+    [[nodiscard]] point normalized() const noexcept
+    {
+        point out = *this;
+        out.normalize();
+        return out;
+    }
+
+    [[nodiscard]] double x() const noexcept
+    {
+        return detail::f64::lane(p3_, 1);
+    }
+
+    [[nodiscard]] double e032() const noexcept
+    {
+        return x();
+    }
+
+    [[nodiscard]] double y() const noexcept
+    {
+        return detail::f64::lane(p3_, 2);
+    }
+
+    [[nodiscard]] double e013() const noexcept
+    {
+        return y();
+    }
+
+    [[nodiscard]] double z() const noexcept
+    {
+        return detail::f64::lane(p3_, 3);
+    }
+
+    [[nodiscard]] double e021() const noexcept
+    {
+        return z();
+    }
+
+    /// The homogeneous coordinate `w` is exactly $1$ when normalized.
+    [[nodiscard]] double w() const noexcept
+    {
+        return detail::f64::lo(p3_);
+    }
+
+    [[nodiscard]] double e123() const noexcept
+    {
+        return w();
+    }
+
+    /// Addresses the point partition $(\mathbf{e}_{123}, \mathbf{e}_{032},
+    /// \mathbf{e}_{013}, \mathbf{e}_{021})$
+    __m256d p3_;
+};
+
+/// A point at infinity, or direction
+class direction final
+{
+public:
+    direction() noexcept = default;
+
+    /// Create a normalized direction
+    direction(double x, double y, double z) noexcept
+        : p3_{_mm256_set_pd(z, y, x, 0.0)}
+    {
+        normalize();
+    }
+
+    direction(__m256d p3) noexcept
+        : p3_{p3}
+    {}
+
+    explicit direction(kln::direction d) noexcept
+        : p3_{detail::f64::widen(d.p3_)}
+    {}
+
+    /// Round to the nearest single precision direction.
+    [[nodiscard]] kln::direction as_float() const noexcept
+    {
+        return {detail::f64::narrow(p3_)};
+    }
+
+    [[nodiscard]] double x() const noexcept
+    {
+        return detail::f64::lane(p3_, 1);
+    }
+
+    [[nodiscard]] double y() const noexcept
+    {
+        return detail::f64::lane(p3_, 2);
+    }
+
+    [[nodiscard]] double z() const noexcept
+    {
+        return detail::f64::lane(p3_, 3);
+    }
+
+    /// Normalize this direction by dividing all components by the magnitude
+    void normalize() noexcept
+    {
+        p3_ = _mm256_mul_pd(
+            p3_, detail::f64::reciprocal_sqrt(detail::f64::hi_dp_bc(p3_, p3_)));
+    }
+
+    /// Return a normalized copy of this direction
+    [[nodiscard]] direction normalized() const noexcept
+    {
+        direction out = *this;
+        out.normalize();
+        return out;
+    }
+
+    /// Addresses the partition $(0, \mathbf{e}_{032}, \mathbf{e}_{013},
+    /// \mathbf{e}_{021})$
+    __m256d p3_;
+};
+
+/// A line, or more generally a bivector (see `kln::line`)
+class line final
+{
+public:
+    line() noexcept = default;
+
+    /// The multivector
+    /// $a\mathbf{e}_{01} + b\mathbf{e}_{02} + c\mathbf{e}_{03} +\
+    /// d\mathbf{e}_{23} + e\mathbf{e}_{31} + f\mathbf{e}_{12}$
+    line(double a, double b, double c, double d, double e, double f) noexcept
+        : p1_{_mm256_set_pd(f, e, d, 0.0)}
+        , p2_{_mm256_set_pd(c, b, a, 0.0)}
+    {}
+
+    line(__m256d ymm1, __m256d ymm2) noexcept
+        : p1_{ymm1}
+        , p2_{ymm2}
+    {}
+
+    explicit line(kln::line l) noexcept
+        : p1_{detail::f64::widen(l.p1_)}
+        , p2_{detail::f64::widen(l.p2_)}
+    {}
+
+    /// Round to the nearest single precision line.
+    [[nodiscard]] kln::line as_float() const noexcept
+    {
+        return {detail::f64::narrow(p1_), detail::f64::narrow(p2_)};
+    }
+
+    /// If a line is constructed as the regressive product (join) of two
+    /// points, the squared norm provided here is the squared distance between
+    /// the two points (provided the points are normalized). Returns $d^2 + e^2
+    /// + f^2$.
+    [[nodiscard]] double squared_norm() const noexcept
+    {
+        return detail::f64::lo(detail::f64::hi_dp_bc(p1_, p1_));
+    }
+
+    /// Returns the square root of the quantity produced by `squared_norm`.
+    [[nodiscard]] double norm() const noexcept
+    {
+        return std::sqrt(squared_norm());
+    }
+
+    /// Normalize a line such that $\ell^2 = -1$.
+    void normalize() noexcept
+    {
+        // See kln::line::normalize
+        __m256d b2 = detail::f64::hi_dp_bc(p1_, p1_);
+        __m256d s  = detail::f64::reciprocal_sqrt(b2);
+        __m256d bc = detail::f64::hi_dp_bc(p1_, p2_);
+        __m256d t  = _mm256_mul_pd(
+            _mm256_mul_pd(bc, detail::f64::reciprocal(b2)), s);
+
+        __m256d tmp = _mm256_mul_pd(p2_, s);
+        p2_         = _mm256_sub_pd(tmp, _mm256_mul_pd(p1_, t));
+        p1_         = _mm256_mul_pd(p1_, s);
+    }
+
+    /// Return a normalized copy of this line
+    [[nodiscard]] line normalized() const noexcept
+    {
+        line out = *this;
+        out.normalize();
+        return out;
+    }
+
+    [[nodiscard]] bool KLN_VEC_CALL approx_eq(line other, double epsilon) const
+        noexcept
+    {
+        return detail::f64::approx_eq(p1_, other.p1_, epsilon)
+               && detail::f64::approx_eq(p2_, other.p2_, epsilon);
+    }
+
+    [[nodiscard]] double e12() const noexcept
+    {
+        return detail::f64::lane(p1_, 3);
+    }
+
+    [[nodiscard]] double e21() const noexcept
+    {
+        return -e12();
+    }
+
+    [[nodiscard]] double e31() const noexcept
+    {
+        return detail::f64::lane(p1_, 2);
+    }
+
+    [[nodiscard]] double e13() const noexcept
+    {
+        return -e31();
+    }
+
+    [[nodiscard]] double e23() const noexcept
+    {
+        return detail::f64::lane(p1_, 1);
+    }
+
+    [[nodiscard]] double e32() const noexcept
+    {
+        return -e23();
+    }
+
+    [[nodiscard]] double e01() const noexcept
+    {
+        return detail::f64::lane(p2_, 1);
+    }
+
+    [[nodiscard]] double e10() const noexcept
+    {
+        return -e01();
+    }
+
+    [[nodiscard]] double e02() const noexcept
+    {
+        return detail::f64::lane(p2_, 2);
+    }
+
+    [[nodiscard]] double e20() const noexcept
+    {
+        return -e02();
+    }
+
+    [[nodiscard]] double e03() const noexcept
+    {
+        return detail::f64::lane(p2_, 3);
+    }
+
+    [[nodiscard]] double e30() const noexcept
+    {
+        return -e03();
+    }
+
+    /// Addresses the partition $(0, \mathbf{e}_{23}, \mathbf{e}_{31},
+    /// \mathbf{e}_{12})$
+    __m256d p1_;
+
+    /// Addresses the partition $(0, \mathbf{e}_{01}, \mathbf{e}_{02},
+    /// \mathbf{e}_{03})$
+    __m256d p2_;
+};
+
+class rotor final
+{
+public:
+    rotor() noexcept = default;
+
+    /// Rotation by `ang_rad` about the axis $(x, y, z)$ through the origin.
+    /// The axis need not be normalized.
+    rotor(double ang_rad, double x, double y, double z) noexcept
+    {
+        double inv_norm = -1.0 / std::sqrt(x * x + y * y + z * z);
+        double half     = 0.5 * ang_rad;
+        double scale    = std::sin(half) * inv_norm;
+        p1_             = _mm256_set_pd(z, y, x, std::cos(half));
+        p1_ = _mm256_mul_pd(p1_, _mm256_set_pd(scale, scale, scale, 1.0));
+    }
+
+    rotor(__m256d p1) noexcept
+        : p1_{p1}
+    {}
+
+    explicit rotor(kln::rotor r) noexcept
+        : p1_{detail::f64::widen(r.p1_)}
+    {}
+
+    /// Round to the nearest single precision rotor. The result is not
+    /// renormalized.
+    [[nodiscard]] kln::rotor as_float() const noexcept
+    {
+        return {detail::f64::narrow(p1_)};
+    }
+
+    /// Normalize a rotor such that $\mathbf{r}\widetilde{\mathbf{r}} = 1$.
+    void normalize() noexcept
+    {
+        p1_ = _mm256_mul_pd(
+            p1_, detail::f64::reciprocal_sqrt(detail::f64::dp_bc(p1_, p1_)));
+    }
+
+    /// Return a normalized copy of this rotor
+    [[nodiscard]] rotor normalized() const noexcept
+    {
+        rotor out = *this;
+        out.normalize();
+        return out;
+    }
+
+    /// Invert this rotor, such that $\mathbf{r}\mathbf{r}^{-1} = 1$.
+    void invert() noexcept
+    {
+        p1_ = _mm256_mul_pd(
+            p1_, detail::f64::reciprocal(detail::f64::dp_bc(p1_, p1_)));
+        p1_ = _mm256_xor_pd(p1_, detail::f64::flip_hi());
+    }
+
+    /// Return the inverse of this rotor
+    [[nodiscard]] rotor inverse() const noexcept
+    {
+        rotor out = *this;
+        out.invert();
+        return out;
+    }
+
+    /// Conjugates a plane $p$ with this rotor and returns the result
+    /// $rp\widetilde{r}$.
+    [[nodiscard]] plane KLN_VEC_CALL operator()(plane const& p) const noexcept
+    {
+        return {detail::f64::sw012<false>(p.p0_, p1_, nullptr)};
+    }
+
+    /// Conjugates a line $\ell$ with this rotor and returns the result
+    /// $r\ell \widetilde{r}$.
+    [[nodiscard]] line KLN_VEC_CALL operator()(line const& l) const noexcept
+    {
+        line out;
+        detail::f64::swMM<false>(&l.p1_, p1_, nullptr, &out.p1_);
+        return out;
+    }
+
+    /// Conjugates a point $p$ with this rotor and returns the result
+    /// $rp\widetilde{r}$.
+    [[nodiscard]] point KLN_VEC_CALL operator()(point const& p) const noexcept
+    {
+        return {detail::f64::sw012<false>(p.p3_, p1_, nullptr)};
+    }
+
+    /// Conjugates a direction $d$ with this rotor and returns the result
+    /// $rd\widetilde{r}$.
+    [[nodiscard]] direction KLN_VEC_CALL operator()(direction const& d) const
+        noexcept
+    {
+        return {detail::f64::sw012<false>(d.p3_, p1_, nullptr)};
+    }
+
+    [[nodiscard]] double scalar() const noexcept
+    {
+        return detail::f64::lo(p1_);
+    }
+
+    [[nodiscard]] double e23() const noexcept
+    {
+        return detail::f64::lane(p1_, 1);
+    }
+
+    [[nodiscard]] double e31() const noexcept
+    {
+        return detail::f64::lane(p1_, 2);
+    }
+
+    [[nodiscard]] double e12() const noexcept
+    {
+        return detail::f64::lane(p1_, 3);
+    }
+
+    __m256d p1_;
+};
+
+class translator final
+{
+public:
+    translator() noexcept = default;
+
+    /// Translation by `delta` along the direction $(x, y, z)$, which need not
+    /// be normalized.
+    translator(double delta, double x, double y, double z) noexcept
+    {
+        double scale = -0.5 * delta / std::sqrt(x * x + y * y + z * z);
+        p2_          = _mm256_mul_pd(_mm256_set_pd(z, y, x, 0.0),
+                            _mm256_set_pd(scale, scale, scale, 0.0));
+    }
+
+    translator(__m256d p2) noexcept
+        : p2_{p2}
+    {}
+
+    explicit translator(kln::translator t) noexcept
+        : p2_{detail::f64::widen(t.p2_)}
+    {}
+
+    /// Round to the nearest single precision translator.
+    [[nodiscard]] kln::translator as_float() const noexcept
+    {
+        kln::translator out;
+        out.p2_ = detail::f64::narrow(p2_);
+        return out;
+    }
+
+    /// Invert this translator, such that $\mathbf{t}\mathbf{t}^{-1} = 1$.
+    void invert() noexcept
+    {
+        p2_ = _mm256_xor_pd(p2_, detail::f64::flip_hi());
+    }
+
+    /// Return the inverse of this translator
+    [[nodiscard]] translator inverse() const noexcept
+    {
+        translator out = *this;
+        out.invert();
+        return out;
+    }
+
+    /// Conjugates a plane $p$ with this translator and returns the result
+    /// $tp\widetilde{t}$.
+    [[nodiscard]] plane KLN_VEC_CALL operator()(plane const& p) const noexcept
+    {
+        __m256d tmp = _mm256_blend_pd(p2_, detail::f64::set_lo(1.0), 0b0001);
+        return {detail::f64::sw02(p.p0_, tmp)};
+    }
+
+    /// Conjugates a line $\ell$ with this translator and returns the result
+    /// $t\ell\widetilde{t}$.
+    [[nodiscard]] line KLN_VEC_CALL operator()(line const& l) const noexcept
+    {
+        line out;
+        detail::f64::swL2(l.p1_, l.p2_, p2_, &out.p1_);
+        return out;
+    }
+
+    /// Conjugates a point $p$ with this translator and returns the result
+    /// $tp\widetilde{t}$.
+    [[nodiscard]] point KLN_VEC_CALL operator()(point const& p) const noexcept
+    {
+        return {detail::f64::sw32(p.p3_, p2_)};
+    }
+
+    constexpr double scalar() const noexcept
+    {
+        return 1.0;
+    }
+
+    [[nodiscard]] double e01() const noexcept
+    {
+        return detail::f64::lane(p2_, 1);
+    }
+
+    [[nodiscard]] double e02() const noexcept
+    {
+        return detail::f64::lane(p2_, 2);
+    }
+
+    [[nodiscard]] double e03() const noexcept
+    {
+        return detail::f64::lane(p2_, 3);
+    }
+
+    __m256d p2_;
+};
+
+class motor final
+{
+public:
+    motor() noexcept = default;
+
+    /// Direct initialization from components, corresponding to the
+    /// multivector
+    /// $a + b\mathbf{e}_{23} + c\mathbf{e}_{31} + d\mathbf{e}_{12} +\
+    /// e\mathbf{e}_{01} + f\mathbf{e}_{02} + g\mathbf{e}_{03} +\
+    /// h\mathbf{e}_{0123}$.
+    motor(double a,
+          double b,
+          double c,
+          double d,
+          double e,
+          double f,
+          double g,
+          double h) noexcept
+        : p1_{_mm256_set_pd(d, c, b, a)}
+        , p2_{_mm256_set_pd(g, f, e, h)}
+    {}
+
+    /// Produce a screw motion rotating and translating by given amounts along
+    /// a provided Euclidean axis.
+    motor(double ang_rad, double d, line l) noexcept
+    {
+        line log_m;
+        detail::f64::gpDL(
+            -ang_rad * 0.5, d * 0.5, l.p1_, l.p2_, log_m.p1_, log_m.p2_);
+        detail::f64::exp(log_m.p1_, log_m.p2_, p1_, p2_);
+    }
+
+    motor(__m256d p1, __m256d p2) noexcept
+        : p1_{p1}
+        , p2_{p2}
+    {}
+
+    explicit KLN_VEC_CALL motor(rotor r) noexcept
+        : p1_{r.p1_}
+        , p2_{_mm256_setzero_pd()}
+    {}
+
+    explicit KLN_VEC_CALL motor(translator t) noexcept
+        : p1_{detail::f64::set_lo(1.0)}
+        , p2_{t.p2_}
+    {}
+
+    explicit motor(kln::motor m) noexcept
+        : p1_{detail::f64::widen(m.p1_)}
+        , p2_{detail::f64::widen(m.p2_)}
+    {}
+
+    /// Round to the nearest single precision motor. The result is not
+    /// renormalized; call `normalized().as_float()` to round a motor that
+    /// may have drifted.
+    [[nodiscard]] kln::motor as_float() const noexcept
+    {
+        return {detail::f64::narrow(p1_), detail::f64::narrow(p2_)};
+    }
+
+    /// Normalizes this motor $m$ such that $m\widetilde{m} = 1$.
+    void normalize() noexcept
+    {
+        // See kln::motor::normalize
+        __m256d b2 = detail::f64::dp_bc(p1_, p1_);
+        __m256d s  = detail::f64::reciprocal_sqrt(b2);
+        __m256d bc = detail::f64::dp_bc(
+            _mm256_xor_pd(p1_, detail::f64::flip_lo()), p2_);
+        __m256d t = _mm256_mul_pd(
+            _mm256_mul_pd(bc, detail::f64::reciprocal(b2)), s);
+
+        __m256d tmp = _mm256_mul_pd(p2_, s);
+        p2_         = _mm256_sub_pd(
+            tmp,
+            _mm256_xor_pd(_mm256_mul_pd(p1_, t), detail::f64::flip_lo()));
+        p1_ = _mm256_mul_pd(p1_, s);
+    }
+
+    /// Return a normalized copy of this motor.
+    [[nodiscard]] motor normalized() const noexcept
+    {
+        motor out = *this;
+        out.normalize();
+        return out;
+    }
+
+    /// Invert this motor, such that $\mathbf{m}\mathbf{m}^{-1} = 1$.
+    void invert() noexcept
+    {
+        // See kln::motor::invert
+        __m256d b2     = detail::f64::dp_bc(p1_, p1_);
+        __m256d s      = detail::f64::reciprocal_sqrt(b2);
+        __m256d bc     = detail::f64::dp_bc(
+            _mm256_xor_pd(p1_, detail::f64::flip_lo()), p2_);
+        __m256d b2_inv = detail::f64::reciprocal(b2);
+        __m256d t      = _mm256_mul_pd(_mm256_mul_pd(bc, b2_inv), s);
+        __m256d neg    = detail::f64::flip_hi();
+
+        __m256d st = _mm256_mul_pd(s, t);
+        st         = _mm256_mul_pd(p1_, st);
+        p2_        = _mm256_sub_pd(
+            _mm256_mul_pd(p2_, b2_inv),
+            _mm256_xor_pd(_mm256_add_pd(st, st), detail::f64::flip_lo()));
+        p2_ = _mm256_xor_pd(p2_, neg);
+
+        p1_ = _mm256_xor_pd(_mm256_mul_pd(p1_, b2_inv), neg);
+    }
+
+    /// Return the inverse of this motor
+    [[nodiscard]] motor inverse() const noexcept
+    {
+        motor out = *this;
+        out.invert();
+        return out;
+    }
+
+    [[nodiscard]] bool KLN_VEC_CALL approx_eq(motor other, double epsilon) const
+        noexcept
+    {
+        return detail::f64::approx_eq(p1_, other.p1_, epsilon)
+               && detail::f64::approx_eq(p2_, other.p2_, epsilon);
+    }
+
+    /// Conjugates a plane $p$ with this motor and returns the result
+    /// $mp\widetilde{m}$.
+    [[nodiscard]] plane KLN_VEC_CALL operator()(plane const& p) const noexcept
+    {
+        return {detail::f64::sw012<true>(p.p0_, p1_, &p2_)};
+    }
+
+    /// Conjugates a line $\ell$ with this motor and returns the result
+    /// $m\ell \widetilde{m}$.
+    [[nodiscard]] line KLN_VEC_CALL operator()(line const& l) const noexcept
+    {
+        line out;
+        detail::f64::swMM<true>(&l.p1_, p1_, &p2_, &out.p1_);
+        return out;
+    }
+
+    /// Conjugates a point $p$ with this motor and returns the result
+    /// $mp\widetilde{m}$.
+    [[nodiscard]] point KLN_VEC_CALL operator()(point const& p) const noexcept
+    {
+        return {detail::f64::sw312<true>(p.p3_, p1_, &p2_)};
+    }
+
+    /// Conjugates the origin $O$ with this motor and returns the result
+    /// $mO\widetilde{m}$. The motor must be normalized.
+    [[nodiscard]] point KLN_VEC_CALL operator()(origin) const noexcept
+    {
+        return {detail::f64::swo12(p1_, p2_)};
+    }
+
+    /// Conjugates a direction $d$ with this motor and returns the result
+    /// $md\widetilde{m}$. Only the rotational part of the motor acts on the
+    /// direction.
+    [[nodiscard]] direction KLN_VEC_CALL operator()(direction const& d) const
+        noexcept
+    {
+        return {detail::f64::sw312<false>(d.p3_, p1_, nullptr)};
+    }
+
+    [[nodiscard]] double scalar() const noexcept
+    {
+        return detail::f64::lo(p1_);
+    }
+
+    [[nodiscard]] double e23() const noexcept
+    {
+        return detail::f64::lane(p1_, 1);
+    }
+
+    [[nodiscard]] double e31() const noexcept
+    {
+        return detail::f64::lane(p1_, 2);
+    }
+
+    [[nodiscard]] double e12() const noexcept
+    {
+        return detail::f64::lane(p1_, 3);
+    }
+
+    [[nodiscard]] double e01() const noexcept
+    {
+        return detail::f64::lane(p2_, 1);
+    }
+
+    [[nodiscard]] double e02() const noexcept
+    {
+        return detail::f64::lane(p2_, 2);
+    }
+
+    [[nodiscard]] double e03() const noexcept
+    {
+        return detail::f64::lane(p2_, 3);
+    }
+
+    [[nodiscard]] double e0123() const noexcept
+    {
+        return detail::f64::lo(p2_);
+    }
+
+    __m256d p1_;
+    __m256d p2_;
+};
+
+// Linear operations
+
+[[nodiscard]] inline line KLN_VEC_CALL operator+(line a, line b) noexcept
+{
+    return {_mm256_add_pd(a.p1_, b.p1_), _mm256_add_pd(a.p2_, b.p2_)};
+}
+
+[[nodiscard]] inline line KLN_VEC_CALL operator-(line a, line b) noexcept
+{
+    return {_mm256_sub_pd(a.p1_, b.p1_), _mm256_sub_pd(a.p2_, b.p2_)};
+}
+
+[[nodiscard]] inline line KLN_VEC_CALL operator*(line l, double s) noexcept
+{
+    __m256d vs = _mm256_set1_pd(s);
+    return {_mm256_mul_pd(l.p1_, vs), _mm256_mul_pd(l.p2_, vs)};
+}
+
+[[nodiscard]] inline line KLN_VEC_CALL operator*(double s, line l) noexcept
+{
+    return l * s;
+}
+
+[[nodiscard]] inline line KLN_VEC_CALL operator/(line l, double s) noexcept
+{
+    return l * (1.0 / s);
+}
+
+[[nodiscard]] inline line operator-(line l) noexcept
+{
+    __m256d flip = _mm256_set1_pd(-0.0);
+    return {_mm256_xor_pd(l.p1_, flip), _mm256_xor_pd(l.p2_, flip)};
+}
+
+/// Reversion operator
+[[nodiscard]] inline line operator~(line l) noexcept
+{
+    __m256d flip = detail::f64::flip_hi();
+    return {_mm256_xor_pd(l.p1_, flip), _mm256_xor_pd(l.p2_, flip)};
+}
+
+[[nodiscard]] inline motor KLN_VEC_CALL operator+(motor a, motor b) noexcept
+{
+    return {_mm256_add_pd(a.p1_, b.p1_), _mm256_add_pd(a.p2_, b.p2_)};
+}
+
+[[nodiscard]] inline motor KLN_VEC_CALL operator-(motor a, motor b) noexcept
+{
+    return {_mm256_sub_pd(a.p1_, b.p1_), _mm256_sub_pd(a.p2_, b.p2_)};
+}
+
+[[nodiscard]] inline motor KLN_VEC_CALL operator*(motor m, double s) noexcept
+{
+    __m256d vs = _mm256_set1_pd(s);
+    return {_mm256_mul_pd(m.p1_, vs), _mm256_mul_pd(m.p2_, vs)};
+}
+
+[[nodiscard]] inline motor KLN_VEC_CALL operator*(double s, motor m) noexcept
+{
+    return m * s;
+}
+
+[[nodiscard]] inline motor KLN_VEC_CALL operator/(motor m, double s) noexcept
+{
+    return m * (1.0 / s);
+}
+
+[[nodiscard]] inline motor operator-(motor m) noexcept
+{
+    __m256d flip = _mm256_set1_pd(-0.0);
+    return {_mm256_xor_pd(m.p1_, flip), _mm256_xor_pd(m.p2_, flip)};
+}
+
+/// Reversion operator
+[[nodiscard]] inline motor operator~(motor m) noexcept
+{
+    __m256d flip = detail::f64::flip_hi();
+    return {_mm256_xor_pd(m.p1_, flip), _mm256_xor_pd(m.p2_, flip)};
+}
+
+/// Reversion operator
+[[nodiscard]] inline rotor operator~(rotor r) noexcept
+{
+    return {_mm256_xor_pd(r.p1_, detail::f64::flip_hi())};
+}
+
+/// Reversion operator
+[[nodiscard]] inline translator operator~(translator t) noexcept
+{
+    return {_mm256_xor_pd(t.p2_, detail::f64::flip_hi())};
+}
+
+// Geometric products
+
+/// Compose the action of two rotors (`b` will be applied, then `a`)
+[[nodiscard]] inline rotor KLN_VEC_CALL operator*(rotor a, rotor b) noexcept
+{
+    rotor out;
+    detail::f64::gp11(a.p1_, b.p1_, out.p1_);
+    return out;
+}
+
+/// Compose the action of a translator and rotor (`b` will be applied, then
+/// `a`)
+[[nodiscard]] inline motor KLN_VEC_CALL operator*(rotor a, translator b) noexcept
+{
+    motor out;
+    out.p1_ = a.p1_;
+    detail::f64::gpRT<false>(a.p1_, b.p2_, out.p2_);
+    return out;
+}
+
+/// Compose the action of a rotor and translator (`b` will be applied, then
+/// `a`)
+[[nodiscard]] inline motor KLN_VEC_CALL operator*(translator b, rotor a) noexcept
+{
+    motor out;
+    out.p1_ = a.p1_;
+    detail::f64::gpRT<true>(a.p1_, b.p2_, out.p2_);
+    return out;
+}
+
+/// Compose the action of two translators (this operation is commutative for
+/// these operands).
+[[nodiscard]] inline translator KLN_VEC_CALL operator*(translator a,
+                                                       translator b) noexcept
+{
+    return {_mm256_add_pd(a.p2_, b.p2_)};
+}
+
+/// Compose the action of a rotor and motor (`b` will be applied, then `a`)
+[[nodiscard]] inline motor KLN_VEC_CALL operator*(rotor a, motor b) noexcept
+{
+    motor out;
+    detail::f64::gp11(a.p1_, b.p1_, out.p1_);
+    detail::f64::gp12<false>(a.p1_, b.p2_, out.p2_);
+    return out;
+}
+
+/// Compose the action of a rotor and motor (`a` will be applied, then `b`)
+[[nodiscard]] inline motor KLN_VEC_CALL operator*(motor b, rotor a) noexcept
+{
+    motor out;
+    detail::f64::gp11(b.p1_, a.p1_, out.p1_);
+    detail::f64::gp12<true>(a.p1_, b.p2_, out.p2_);
+    return out;
+}
+
+/// Compose the action of a translator and motor (`b` will be applied, then
+/// `a`)
+[[nodiscard]] inline motor KLN_VEC_CALL operator*(translator a, motor b) noexcept
+{
+    motor out;
+    out.p1_ = b.p1_;
+    detail::f64::gpRT<true>(b.p1_, a.p2_, out.p2_);
+    out.p2_ = _mm256_add_pd(out.p2_, b.p2_);
+    return out;
+}
+
+/// Compose the action of a translator and motor (`a` will be applied, then
+/// `b`)
+[[nodiscard]] inline motor KLN_VEC_CALL operator*(motor b, translator a) noexcept
+{
+    motor out;
+    out.p1_ = b.p1_;
+    detail::f64::gpRT<false>(b.p1_, a.p2_, out.p2_);
+    out.p2_ = _mm256_add_pd(out.p2_, b.p2_);
+    return out;
+}
+
+/// Compose the action of two motors (`b` will be applied, then `a`)
+[[nodiscard]] inline motor KLN_VEC_CALL operator*(motor a, motor b) noexcept
+{
+    motor out;
+    detail::f64::gpMM(a.p1_, b.p1_, &out.p1_);
+    return out;
+}
+
+/// Generate a motor $m$ that produces a screw motion about the common normal
+/// to lines $a$ and $b$. The motor given by $\sqrt{m}$ takes $b$ to $a$
+/// provided that $a$ and $b$ are both normalized.
+[[nodiscard]] inline motor KLN_VEC_CALL operator*(line a, line b) noexcept
+{
+    motor out;
+    detail::f64::gpLL(a.p1_, b.p1_, &out.p1_);
+    return out;
+}
+
+// Exponential and logarithm
+
+/// Takes the principal branch of the logarithm of the motor, returning a
+/// bivector. The logarithm presumes that the motor is normalized.
+[[nodiscard]] inline line KLN_VEC_CALL log(motor m) noexcept
+{
+    line out;
+    detail::f64::log(m.p1_, m.p2_, out.p1_, out.p2_);
+    return out;
+}
+
+/// Exponentiate a line to produce a motor that posesses this line as its
+/// axis.
+[[nodiscard]] inline motor KLN_VEC_CALL exp(line l) noexcept
+{
+    motor out;
+    detail::f64::exp(l.p1_, l.p2_, out.p1_, out.p2_);
+    return out;
+}
+} // namespace d
+} // namespace kln
+/// @}
+
+#endif
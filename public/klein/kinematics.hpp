@@ -0,0 +1,329 @@
+#pragma once
+
+#include "geometric_product.hpp"
+#include "motor.hpp"
+
+#include "detail/soa.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace kln
+{
+/// \defgroup kinematics Forward kinematics
+/// @{
+///
+/// Given the local pose of every joint of a hierarchy as a motor relative to
+/// its parent, the routines here produce the world-space motor of every joint
+/// (`world[j] = world[parent(j)] * local[j]`, and `world[j] = local[j]` for a
+/// root) in a single call.
+///
+/// The parent of each joint is given either as an index array (a root is its
+/// own parent) or as an array of backwards offsets (`parent(j) = j -
+/// offset[j]`, with an offset of zero denoting a root) as in the skeletal
+/// animation case study. Joints must be stored in topological order so that
+/// every parent precedes its children.
+///
+/// Joints are evaluated in groups of four (eight when `KLN_ENABLE_ISE_AVX2`
+/// is defined) whose parents have all been evaluated already. The parent
+/// world motors are gathered and the local motors loaded in
+/// structure-of-arrays form, composed with one vertical motor product per
+/// group, and written back. A group ends early at a root or at a joint whose
+/// parent lies within the group itself, so hierarchies stored level by level
+/// (breadth-first) fill every group while deep chains stored depth-first
+/// degrade gracefully towards the scalar product. When the storage order
+/// cannot be changed, `level_order` computes a breadth-first evaluation
+/// order that can be passed to the ordered overloads instead.
+///
+/// The range overloads evaluate a subset of the joints on the assumption that
+/// every parent outside the range has already been evaluated. This permits
+/// spreading independent subtrees across threads: evaluate the joints shared
+/// by all subtrees first, then hand each contiguous subtree (for example
+/// `[j, j + group_size)` in the case study layout) to a different thread.
+/// Independent instances of a skeleton can of course be evaluated
+/// concurrently without any such considerations.
+///
+/// !!! example
+///
+///     ```cpp
+///         // parent[0] == 0 marks the root
+///         kln::motor local[joint_count];
+///         kln::motor world[joint_count];
+///         kln::forward_kinematics(local, parent, world, joint_count);
+///     ```
+
+namespace detail
+{
+    struct fk_parent_index
+    {
+        size_t operator()(size_t j) const noexcept
+        {
+            return parent[j];
+        }
+
+        uint16_t const* parent;
+    };
+
+    struct fk_parent_offset
+    {
+        size_t operator()(size_t j) const noexcept
+        {
+            return j - offset[j];
+        }
+
+        uint8_t const* offset;
+    };
+
+    // Evaluates joints order[i] for i in [begin, end) if Ordered is true, and
+    // joints [begin, end) otherwise (in which case order is ignored).
+    template <bool Ordered, typename P>
+    KLN_INLINE void forward_kinematics(motor const* KLN_RESTRICT local,
+                                       P parent_of,
+                                       [[maybe_unused]] uint16_t const* order,
+                                       motor* KLN_RESTRICT world,
+                                       size_t begin,
+                                       size_t end) noexcept
+    {
+#ifdef KLN_ENABLE_ISE_AVX2
+        constexpr size_t max_width = 8;
+#else
+        constexpr size_t max_width = 4;
+#endif
+        uint32_t joint[max_width];
+        uint32_t parent[max_width];
+
+        size_t i = begin;
+        while (i != end)
+        {
+            // Extend the group starting at i while each joint's parent is
+            // already evaluated.
+            size_t limit = std::min(end - i, max_width);
+            size_t n     = 0;
+            for (; n != limit; ++n)
+            {
+                size_t j = i + n;
+                if constexpr (Ordered)
+                {
+                    j = order[j];
+                }
+                size_t p = parent_of(j);
+
+                if (p == j)
+                {
+                    break;
+                }
+
+                if constexpr (Ordered)
+                {
+                    if (std::find(joint, joint + n, p) != joint + n)
+                    {
+                        break;
+                    }
+                }
+                else if (p >= i)
+                {
+                    break;
+                }
+
+                joint[n]  = static_cast<uint32_t>(j);
+                parent[n] = static_cast<uint32_t>(p);
+            }
+
+#ifdef KLN_ENABLE_ISE_AVX2
+            if (n == 8)
+            {
+                __m256 a[4];
+                __m256 b[4];
+                __m256 c[4];
+                __m256 d[4];
+                soa::gather8<2>(&world->p1_, parent, a);
+                soa::gather8<2>(&world->p2_, parent, b);
+                if constexpr (Ordered)
+                {
+                    soa::gather8<2>(&local->p1_, joint, c);
+                    soa::gather8<2>(&local->p2_, joint, d);
+                }
+                else
+                {
+                    soa::load8<2>(&local[i].p1_, c);
+                    soa::load8<2>(&local[i].p2_, d);
+                }
+                soa::gpMM(a, b, c, d, a, b);
+                if constexpr (Ordered)
+                {
+                    soa::scatter8<2>(a, joint, &world->p1_);
+                    soa::scatter8<2>(b, joint, &world->p2_);
+                }
+                else
+                {
+                    soa::store8<2>(a, &world[i].p1_);
+                    soa::store8<2>(b, &world[i].p2_);
+                }
+                i += 8;
+                continue;
+            }
+#endif
+            if (n >= 4)
+            {
+                __m128 a[4];
+                __m128 b[4];
+                __m128 c[4];
+                __m128 d[4];
+                soa::gather4<2>(&world->p1_, parent, a);
+                soa::gather4<2>(&world->p2_, parent, b);
+                if constexpr (Ordered)
+                {
+                    soa::gather4<2>(&local->p1_, joint, c);
+                    soa::gather4<2>(&local->p2_, joint, d);
+                }
+                else
+                {
+                    soa::load4<2>(&local[i].p1_, c);
+                    soa::load4<2>(&local[i].p2_, d);
+                }
+                soa::gpMM(a, b, c, d, a, b);
+                if constexpr (Ordered)
+                {
+                    soa::scatter4<2>(a, joint, &world->p1_);
+                    soa::scatter4<2>(b, joint, &world->p2_);
+                }
+                else
+                {
+                    soa::store4<2>(a, &world[i].p1_);
+                    soa::store4<2>(b, &world[i].p2_);
+                }
+                i += 4;
+                continue;
+            }
+
+            if (n == 0)
+            {
+                // Root joint
+                size_t j = Ordered ? order[i] : i;
+                world[j] = local[j];
+                ++i;
+                continue;
+            }
+
+            for (size_t k = 0; k != n; ++k)
+            {
+                world[joint[k]] = world[parent[k]] * local[joint[k]];
+            }
+            i += n;
+        }
+    }
+} // namespace detail
+
+/// Computes the world-space motor of each of the `count` joints given the
+/// local motors and the parent index of each joint (`parent[j] == j` for a
+/// root). Requires `parent[j] <= j`.
+inline void forward_kinematics(motor const* local,
+                               uint16_t const* parent,
+                               motor* world,
+                               size_t count) noexcept
+{
+    detail::forward_kinematics<false>(
+        local, detail::fk_parent_index{parent}, nullptr, world, 0, count);
+}
+
+/// Evaluates only the joints in `[begin, end)`. The parents of these joints
+/// that lie outside the range must have been evaluated already.
+inline void forward_kinematics(motor const* local,
+                               uint16_t const* parent,
+                               motor* world,
+                               size_t begin,
+                               size_t end) noexcept
+{
+    detail::forward_kinematics<false>(
+        local, detail::fk_parent_index{parent}, nullptr, world, begin, end);
+}
+
+/// Computes the world-space motor of each of the `count` joints given the
+/// local motors and the backwards offset of each joint to its parent (an
+/// offset of zero denotes a root).
+inline void forward_kinematics(motor const* local,
+                               uint8_t const* parent_offset,
+                               motor* world,
+                               size_t count) noexcept
+{
+    detail::forward_kinematics<false>(local,
+                                      detail::fk_parent_offset{parent_offset},
+                                      nullptr,
+                                      world,
+                                      0,
+                                      count);
+}
+
+/// Evaluates only the joints in `[begin, end)`. The parents of these joints
+/// that lie outside the range must have been evaluated already.
+inline void forward_kinematics(motor const* local,
+                               uint8_t const* parent_offset,
+                               motor* world,
+                               size_t begin,
+                               size_t end) noexcept
+{
+    detail::forward_kinematics<false>(local,
+                                      detail::fk_parent_offset{parent_offset},
+                                      nullptr,
+                                      world,
+                                      begin,
+                                      end);
+}
+
+/// As above, but the joints are evaluated in the sequence given by `order`
+/// (a permutation of `[0, count)` in which every joint follows its parent,
+/// such as the one produced by `level_order`). Unlike the unordered overloads,
+/// joints need not be stored in topological order.
+inline void forward_kinematics(motor const* local,
+                               uint16_t const* parent,
+                               uint16_t const* order,
+                               motor* world,
+                               size_t count) noexcept
+{
+    detail::forward_kinematics<true>(
+        local, detail::fk_parent_index{parent}, order, world, 0, count);
+}
+
+/// Evaluates only the joints `order[i]` for `i` in `[begin, end)`. The parents
+/// of these joints that lie outside the range must have been evaluated
+/// already.
+inline void forward_kinematics(motor const* local,
+                               uint16_t const* parent,
+                               uint16_t const* order,
+                               motor* world,
+                               size_t begin,
+                               size_t end) noexcept
+{
+    detail::forward_kinematics<true>(
+        local, detail::fk_parent_index{parent}, order, world, begin, end);
+}
+
+/// Writes a breadth-first evaluation order of the `count` joints to `order`,
+/// grouping the joints of each hierarchy level together so that every SIMD
+/// group of the ordered `forward_kinematics` overloads is filled. `depth`
+/// must have room for `count` entries and receives the depth of each joint.
+/// Requires `parent[j] <= j`. Returns the number of levels.
+///
+/// The order depends only on the hierarchy and should be computed once per
+/// skeleton rather than per evaluation.
+inline size_t level_order(uint16_t const* parent,
+                          size_t count,
+                          uint16_t* order,
+                          uint16_t* depth) noexcept
+{
+    size_t levels = 0;
+    for (size_t j = 0; j != count; ++j)
+    {
+        depth[j]
+            = parent[j] == j ? 0 : static_cast<uint16_t>(depth[parent[j]] + 1);
+        order[j] = static_cast<uint16_t>(j);
+        levels   = std::max(levels, static_cast<size_t>(depth[j]) + 1);
+    }
+
+    std::sort(order, order + count, [depth](uint16_t a, uint16_t b) {
+        return depth[a] < depth[b] || (depth[a] == depth[b] && a < b);
+    });
+    return levels;
+}
+/// @}
+} // namespace kln
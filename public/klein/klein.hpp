@@ -6,9 +6,24 @@
 
 #pragma once
 
+#include "bvh.hpp"
+#include "compression.hpp"
+#include "containers.hpp"
+#include "conversion.hpp"
+#include "culling.hpp"
+#include "distance.hpp"
 #include "exp_log.hpp"
 #include "geometric_product.hpp"
 #include "inner_product.hpp"
+#include "interpolation.hpp"
 #include "join.hpp"
+#include "kinematics.hpp"
 #include "meet.hpp"
-#include "projection.hpp"
\ No newline at end of file
+#include "motor_chain.hpp"
+#include "packed.hpp"
+#include "prepared_motor.hpp"
+#include "projection.hpp"
+#include "raycast.hpp"
+#include "skinning.hpp"
+#include "spline.hpp"
+#include "transform.hpp"
\ No newline at end of file
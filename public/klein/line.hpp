@@ -268,31 +268,37 @@ public:
         return std::sqrt(squared_norm());
     }
 
+    template <precision P = precision::refined>
     void normalize() noexcept
     {
-        __m128 inv_norm = detail::rsqrt_nr1(detail::hi_dp_bc(p1_, p1_));
-        p1_             = _mm_mul_ps(p1_, inv_norm);
+        __m128 inv_norm
+            = detail::reciprocal_sqrt<P>(detail::hi_dp_bc(p1_, p1_));
+        p1_ = _mm_mul_ps(p1_, inv_norm);
     }
 
+    template <precision P = precision::refined>
     [[nodiscard]] branch normalized() const noexcept
     {
         branch out = *this;
-        out.normalize();
+        out.normalize<P>();
         return out;
     }
 
+    template <precision P = precision::refined>
     void invert() noexcept
     {
-        __m128 inv_norm = detail::rsqrt_nr1(detail::hi_dp_bc(p1_, p1_));
-        p1_             = _mm_mul_ps(p1_, inv_norm);
-        p1_             = _mm_mul_ps(p1_, inv_norm);
-        p1_             = _mm_xor_ps(_mm_set_ps(-0.f, -0.f, -0.f, 0.f), p1_);
+        __m128 inv_norm
+            = detail::reciprocal_sqrt<P>(detail::hi_dp_bc(p1_, p1_));
+        p1_ = _mm_mul_ps(p1_, inv_norm);
+        p1_ = _mm_mul_ps(p1_, inv_norm);
+        p1_ = _mm_xor_ps(_mm_set_ps(-0.f, -0.f, -0.f, 0.f), p1_);
     }
 
+    template <precision P = precision::refined>
     [[nodiscard]] branch inverse() const noexcept
     {
         branch out = *this;
-        out.invert();
+        out.invert<P>();
         return out;
     }
 
@@ -523,6 +529,7 @@ public:
     }
 
     /// Normalize a line such that $\ell^2 = -1$.
+    template <precision P = precision::refined>
     void normalize() noexcept
     {
         // l = b + c where b is p1 and c is p2
@@ -533,9 +540,9 @@ public:
         // 1/sqrt(l*~l) = 1/|b| + (b1 c1 + b2 c2 + b3 c3)/|b|^3 e0123
         //              = s + t e0123
         __m128 b2 = detail::hi_dp_bc(p1_, p1_);
-        __m128 s  = detail::rsqrt_nr1(b2);
+        __m128 s  = detail::reciprocal_sqrt<P>(b2);
         __m128 bc = detail::hi_dp_bc(p1_, p2_);
-        __m128 t  = _mm_mul_ps(_mm_mul_ps(bc, detail::rcp_nr1(b2)), s);
+        __m128 t  = _mm_mul_ps(_mm_mul_ps(bc, detail::reciprocal<P>(b2)), s);
 
         // p1 * (s + t e0123) = s * p1 - t p1_perp
         __m128 tmp = _mm_mul_ps(p2_, s);
@@ -544,20 +551,22 @@ public:
     }
 
     /// Return a normalized copy of this line
+    template <precision P = precision::refined>
     [[nodiscard]] line normalized() const noexcept
     {
         line out = *this;
-        out.normalize();
+        out.normalize<P>();
         return out;
     }
 
+    template <precision P = precision::refined>
     void invert() noexcept
     {
         // s, t computed as in the normalization
         __m128 b2     = detail::hi_dp_bc(p1_, p1_);
-        __m128 s      = detail::rsqrt_nr1(b2);
+        __m128 s      = detail::reciprocal_sqrt<P>(b2);
         __m128 bc     = detail::hi_dp_bc(p1_, p2_);
-        __m128 b2_inv = detail::rcp_nr1(b2);
+        __m128 b2_inv = detail::reciprocal<P>(b2);
         __m128 t      = _mm_mul_ps(_mm_mul_ps(bc, b2_inv), s);
         __m128 neg    = _mm_set_ps(-0.f, -0.f, -0.f, 0.f);
 
@@ -574,10 +583,11 @@ public:
         p1_ = _mm_xor_ps(_mm_mul_ps(p1_, b2_inv), neg);
     }
 
+    template <precision P = precision::refined>
     [[nodiscard]] line inverse() const noexcept
     {
         line out = *this;
-        out.invert();
+        out.invert<P>();
         return out;
     }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "detail/sse.hpp"
+#include "point.hpp"
 
 namespace kln
 {
@@ -25,6 +26,110 @@ struct mat4x4
         return out;
     }
 
-    // TODO: provide a transpose function
+    /// Transposes this matrix in place.
+    void transpose() noexcept
+    {
+        _MM_TRANSPOSE4_PS(cols[0], cols[1], cols[2], cols[3]);
+    }
+
+    /// Return a transposed copy of this matrix.
+    [[nodiscard]] mat4x4 transposed() const noexcept
+    {
+        mat4x4 out = *this;
+        out.transpose();
+        return out;
+    }
+
+    /// Inverts this matrix in place, assuming it represents an affine
+    /// transformation (its last row is (0, 0, 0, 1)). The linear part need
+    /// not be orthonormal, but must be invertible.
+    void invert_affine() noexcept
+    {
+        // The rows of the inverse of the linear part A with columns a0, a1, a2
+        // are the cross products a1 x a2, a2 x a0, and a0 x a1 divided by the
+        // determinant. The translation t maps to -A^-1 t.
+        __m128 r0 = cross(cols[1], cols[2]);
+        __m128 r1 = cross(cols[2], cols[0]);
+        __m128 r2 = cross(cols[0], cols[1]);
+
+        __m128 det = detail::dp_bc(cols[0], r0);
+        r0         = _mm_div_ps(r0, det);
+        r1         = _mm_div_ps(r1, det);
+        r2         = _mm_div_ps(r2, det);
+
+        // The cross products vanish in the last lane, where the translation
+        // of the inverse goes
+        __m128 w = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+
+        r0 = _mm_sub_ps(r0, _mm_and_ps(w, detail::dp_bc(r0, cols[3])));
+        r1 = _mm_sub_ps(r1, _mm_and_ps(w, detail::dp_bc(r1, cols[3])));
+        r2 = _mm_sub_ps(r2, _mm_and_ps(w, detail::dp_bc(r2, cols[3])));
+
+        __m128 r3 = _mm_set_ps(1.f, 0.f, 0.f, 0.f);
+
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        cols[0] = r0;
+        cols[1] = r1;
+        cols[2] = r2;
+        cols[3] = r3;
+    }
+
+    /// Return the inverse of this matrix, assuming it represents an affine
+    /// transformation. See `invert_affine`.
+    [[nodiscard]] mat4x4 affine_inverse() const noexcept
+    {
+        mat4x4 out = *this;
+        out.invert_affine();
+        return out;
+    }
+
+private:
+    // Cross product of the first three lanes (the last lane is zero)
+    [[nodiscard]] static __m128 KLN_VEC_CALL cross(__m128 a, __m128 b) noexcept
+    {
+        return _mm_sub_ps(
+            _mm_mul_ps(KLN_SWIZZLE(a, 3, 0, 2, 1), KLN_SWIZZLE(b, 3, 1, 0, 2)),
+            _mm_mul_ps(KLN_SWIZZLE(a, 3, 1, 0, 2), KLN_SWIZZLE(b, 3, 0, 2, 1)));
+    }
 };
+
+/// Matrix product. The result applies `b` first, then `a`.
+[[nodiscard]] inline mat4x4 KLN_VEC_CALL operator*(mat4x4 const& a,
+                                                  mat4x4 const& b) noexcept
+{
+    mat4x4 out;
+    out.cols[0] = a(b.cols[0]);
+    out.cols[1] = a(b.cols[1]);
+    out.cols[2] = a(b.cols[2]);
+    out.cols[3] = a(b.cols[3]);
+    return out;
+}
+
+/// Applies the matrix `m` to the `count` points in `in` and stores the result
+/// in `out`, as the batch call operator of a motor would. Aliasing is only
+/// permitted when `in == out`.
+inline void apply(mat4x4 const& m,
+                  point const* in,
+                  point* out,
+                  size_t count) noexcept
+{
+    // Points are laid out as (w, x, y, z). Rotating the lanes of each column
+    // the same way transforms the points in place without shuffling each of
+    // them to (x, y, z, w) and back.
+    __m128 w = KLN_SWIZZLE(m.cols[3], 2, 1, 0, 3);
+    __m128 x = KLN_SWIZZLE(m.cols[0], 2, 1, 0, 3);
+    __m128 y = KLN_SWIZZLE(m.cols[1], 2, 1, 0, 3);
+    __m128 z = KLN_SWIZZLE(m.cols[2], 2, 1, 0, 3);
+
+    for (size_t i = 0; i != count; ++i)
+    {
+        __m128 p = in[i].p3_;
+        __m128 r = _mm_mul_ps(w, KLN_SWIZZLE(p, 0, 0, 0, 0));
+        r        = _mm_add_ps(r, _mm_mul_ps(x, KLN_SWIZZLE(p, 1, 1, 1, 1)));
+        r        = _mm_add_ps(r, _mm_mul_ps(y, KLN_SWIZZLE(p, 2, 2, 2, 2)));
+        r        = _mm_add_ps(r, _mm_mul_ps(z, KLN_SWIZZLE(p, 3, 3, 3, 3)));
+
+        out[i].p3_ = r;
+    }
+}
 } // namespace kln
\ No newline at end of file
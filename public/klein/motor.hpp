@@ -143,6 +143,7 @@ public:
     }
 
     /// Normalizes this motor $m$ such that $m\widetilde{m} = 1$.
+    template <precision P = precision::refined>
     void normalize() noexcept
     {
         // m = b + c where b is p1 and c is p2
@@ -158,9 +159,9 @@ public:
         // Multiplying our original motor by this inverse will give us a
         // normalized motor.
         __m128 b2 = detail::dp_bc(p1_, p1_);
-        __m128 s  = detail::rsqrt_nr1(b2);
+        __m128 s  = detail::reciprocal_sqrt<P>(b2);
         __m128 bc = detail::dp_bc(_mm_xor_ps(p1_, _mm_set_ss(-0.f)), p2_);
-        __m128 t  = _mm_mul_ps(_mm_mul_ps(bc, detail::rcp_nr1(b2)), s);
+        __m128 t  = _mm_mul_ps(_mm_mul_ps(bc, detail::reciprocal<P>(b2)), s);
 
         // (s + t e0123) * motor =
         //
@@ -179,20 +180,22 @@ public:
     }
 
     /// Return a normalized copy of this motor.
+    template <precision P = precision::refined>
     [[nodiscard]] motor normalized() const noexcept
     {
         motor out = *this;
-        out.normalize();
+        out.normalize<P>();
         return out;
     }
 
+    template <precision P = precision::refined>
     void invert() noexcept
     {
         // s, t computed as in the normalization
         __m128 b2     = detail::dp_bc(p1_, p1_);
-        __m128 s      = detail::rsqrt_nr1(b2);
+        __m128 s      = detail::reciprocal_sqrt<P>(b2);
         __m128 bc     = detail::dp_bc(_mm_xor_ps(p1_, _mm_set_ss(-0.f)), p2_);
-        __m128 b2_inv = detail::rcp_nr1(b2);
+        __m128 b2_inv = detail::reciprocal<P>(b2);
         __m128 t      = _mm_mul_ps(_mm_mul_ps(bc, b2_inv), s);
         __m128 neg    = _mm_set_ps(-0.f, -0.f, -0.f, 0.f);
 
@@ -210,10 +213,11 @@ public:
         p1_ = _mm_xor_ps(_mm_mul_ps(p1_, b2_inv), neg);
     }
 
+    template <precision P = precision::refined>
     [[nodiscard]] motor inverse() const noexcept
     {
         motor out = *this;
-        out.invert();
+        out.invert<P>();
         return out;
     }
 
@@ -259,6 +263,27 @@ public:
         return out;
     }
 
+    /// Recover the motor of a 3x4 column-major matrix representing a rotation
+    /// followed by a translation (the inverse of `as_mat3x4`). The rotation
+    /// part must be orthonormal with a positive determinant.
+    ///
+    /// The rotor is extracted with Shepperd's method: of the four rotor
+    /// components, the largest is recovered from the diagonal and the others
+    /// are divided by it, so the extraction is well conditioned for any
+    /// rotation angle. Of the two motors $\pm m$ with the same action, the one
+    /// whose largest rotor component is positive is returned.
+    [[nodiscard]] static motor from_mat3x4(mat3x4 const& mat) noexcept
+    {
+        return from_columns(mat.data);
+    }
+
+    /// Recover the motor of a 4x4 column-major matrix representing a rotation
+    /// followed by a translation. The last row is ignored. See `from_mat3x4`.
+    [[nodiscard]] static motor from_mat4x4(mat4x4 const& mat) noexcept
+    {
+        return from_columns(mat.data);
+    }
+
     /// Conjugates a plane $p$ with this motor and returns the result
     /// $mp\widetilde{m}$.
     [[nodiscard]] plane KLN_VEC_CALL operator()(plane const& p) const noexcept
@@ -283,6 +308,17 @@ public:
         detail::sw012<true, true>(&in->p0_, p1_, &p2_, &out->p0_, count);
     }
 
+    /// Non-temporal form of the above: the result is written with
+    /// streaming stores that bypass the caches. See `kln::non_temporal`.
+    void KLN_VEC_CALL operator()(plane* in,
+                                 plane* out,
+                                 size_t count,
+                                 non_temporal) const noexcept
+    {
+        detail::sw012<true, true, true>(&in->p0_, p1_, &p2_, &out->p0_, count);
+        _mm_sfence();
+    }
+
     /// Conjugates a line $\ell$ with this motor and returns the result
     /// $m\ell \widetilde{m}$.
     [[nodiscard]] line KLN_VEC_CALL operator()(line const& l) const noexcept
@@ -306,6 +342,18 @@ public:
         detail::swMM<true, true, true>(&in->p1_, p1_, &p2_, &out->p1_, count);
     }
 
+    /// Non-temporal form of the above: the result is written with
+    /// streaming stores that bypass the caches. See `kln::non_temporal`.
+    void KLN_VEC_CALL operator()(line* in,
+                                 line* out,
+                                 size_t count,
+                                 non_temporal) const noexcept
+    {
+        detail::swMM<true, true, true, true>(
+            &in->p1_, p1_, &p2_, &out->p1_, count);
+        _mm_sfence();
+    }
+
     /// Conjugates a point $p$ with this motor and returns the result
     /// $mp\widetilde{m}$.
     [[nodiscard]] point KLN_VEC_CALL operator()(point const& p) const noexcept
@@ -330,6 +378,17 @@ public:
         detail::sw312<true, true>(&in->p3_, p1_, &p2_, &out->p3_, count);
     }
 
+    /// Non-temporal form of the above: the result is written with
+    /// streaming stores that bypass the caches. See `kln::non_temporal`.
+    void KLN_VEC_CALL operator()(point* in,
+                                 point* out,
+                                 size_t count,
+                                 non_temporal) const noexcept
+    {
+        detail::sw312<true, true, true>(&in->p3_, p1_, &p2_, &out->p3_, count);
+        _mm_sfence();
+    }
+
     /// Conjugates the origin $O$ with this motor and returns the result
     /// $mO\widetilde{m}$.
     [[nodiscard]] point KLN_VEC_CALL operator()(origin) const noexcept
@@ -370,6 +429,18 @@ public:
         detail::sw312<true, false>(&in->p3_, p1_, nullptr, &out->p3_, count);
     }
 
+    /// Non-temporal form of the above: the result is written with
+    /// streaming stores that bypass the caches. See `kln::non_temporal`.
+    void KLN_VEC_CALL operator()(direction* in,
+                                 direction* out,
+                                 size_t count,
+                                 non_temporal) const noexcept
+    {
+        detail::sw312<true, false, true>(
+            &in->p3_, p1_, nullptr, &out->p3_, count);
+        _mm_sfence();
+    }
+
     /// Motor addition
     motor& KLN_VEC_CALL operator+=(motor b) noexcept
     {
@@ -510,6 +581,66 @@ public:
 
     __m128 p1_;
     __m128 p2_;
+
+private:
+    // The upper 3x4 block of the column-major matrix d
+    [[nodiscard]] static motor from_columns(float const* d) noexcept
+    {
+        // Writing r(i, j) for d[4j + i], the products of the rotor components
+        // b are read off the matrix (see mat4x4_12) as
+        //
+        // 4b0^2 = 1 + r00 + r11 + r22    4b0 b1 = r12 - r21
+        // 4b1^2 = 1 + r00 - r11 - r22    4b0 b2 = r20 - r02
+        // 4b2^2 = 1 - r00 + r11 - r22    4b0 b3 = r01 - r10
+        // 4b3^2 = 1 - r00 - r11 + r22    4b1 b2 = r10 + r01
+        //                                4b1 b3 = r20 + r02
+        //                                4b2 b3 = r21 + r12
+        //
+        // Each row of q below is 4bk times the rotor. The row with the
+        // largest diagonal entry is normalized.
+        float q[4][4] = {{1.f + d[0] + d[5] + d[10],
+                          d[9] - d[6],
+                          d[2] - d[8],
+                          d[4] - d[1]},
+                         {d[9] - d[6],
+                          1.f + d[0] - d[5] - d[10],
+                          d[1] + d[4],
+                          d[2] + d[8]},
+                         {d[2] - d[8],
+                          d[1] + d[4],
+                          1.f - d[0] + d[5] - d[10],
+                          d[6] + d[9]},
+                         {d[4] - d[1],
+                          d[2] + d[8],
+                          d[6] + d[9],
+                          1.f - d[0] - d[5] + d[10]}};
+        size_t k = 0;
+        for (size_t i = 1; i != 4; ++i)
+        {
+            if (q[i][i] > q[k][k])
+            {
+                k = i;
+            }
+        }
+        float const* v = q[k];
+        float s = 1.f / std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]
+                                  + v[3] * v[3]);
+        float b[4] = {v[0] * s, v[1] * s, v[2] * s, v[3] * s};
+
+        // The motor is the translator 1 + c (with c = -t / 2 the ideal part of
+        // the translator displacing by the last column t) times the rotor.
+        float c1 = -0.5f * d[12];
+        float c2 = -0.5f * d[13];
+        float c3 = -0.5f * d[14];
+        return {b[0],
+                b[1],
+                b[2],
+                b[3],
+                c1 * b[0] + b[2] * c3 - b[3] * c2,
+                c2 * b[0] + b[3] * c1 - b[1] * c3,
+                c3 * b[0] + b[1] * c2 - b[2] * c1,
+                c1 * b[1] + c2 * b[2] + c3 * b[3]};
+    }
 };
 
 /// Motor addition
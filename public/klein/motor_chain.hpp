@@ -0,0 +1,207 @@
+#pragma once
+
+#include "direction.hpp"
+#include "geometric_product.hpp"
+#include "line.hpp"
+#include "mat3x4.hpp"
+#include "mat4x4.hpp"
+#include "motor.hpp"
+#include "plane.hpp"
+#include "point.hpp"
+
+#ifdef KLEIN_VALIDATE
+#    include <cassert>
+#endif
+
+namespace kln
+{
+/// \defgroup motor_chain Motor chains
+/// @{
+///
+/// A `motor_chain` records a product of motors such as
+/// $\mathbf{m}_3\mathbf{m}_2\mathbf{m}_1$ without evaluating it. The product
+/// is only formed when the chain is applied, and the chain picks the cheaper
+/// of two ways of applying it:
+///
+/// - For batches of at least `motor_chain::compose_threshold` entities, the
+///   motors are composed once with the geometric product and the result is
+///   applied with a single batch sandwich. The per-entity cost is then that
+///   of a single motor, however long the chain.
+/// - For fewer entities, each motor is applied in turn (rightmost first), which
+///   spares the motor products and the rounding they introduce.
+///
+/// Conversion to a matrix composes the motors in registers and feeds the
+/// result straight into the matrix conversion.
+///
+/// !!! example
+///
+///     ```cpp
+///         kln::motor_chain chain = kln::motor_chain{m3} * m2 * m1;
+///
+///         // Same result as (m3 * m2 * m1)(points, points, count)
+///         chain(points, points, count);
+///
+///         kln::mat4x4 model = chain.as_mat4x4();
+///     ```
+
+/// \ingroup motor_chain
+class motor_chain final
+{
+public:
+    /// Longest chain that can be recorded
+    static constexpr size_t max_length = 8;
+
+    /// Smallest batch for which the chain is composed before it is applied
+    static constexpr size_t compose_threshold = 2;
+
+    motor_chain() = default;
+
+    /// A chain consisting of the single motor `m`
+    motor_chain(motor m) noexcept
+        : length_{1}
+    {
+        motors_[0] = m;
+    }
+
+    /// Appends `m` on the right of the product, so that it is applied before
+    /// the motors recorded so far. The chain must not be full.
+    motor_chain& operator*=(motor m) noexcept
+    {
+#ifdef KLEIN_VALIDATE
+        assert(length_ < max_length
+               && "Motor appended to a chain already holding max_length "
+                  "motors");
+#endif
+        motors_[length_++] = m;
+        return *this;
+    }
+
+    [[nodiscard]] size_t length() const noexcept
+    {
+        return length_;
+    }
+
+    /// Evaluates the product of the chain. An empty chain is the identity.
+    [[nodiscard]] motor compose() const noexcept
+    {
+        if (length_ == 0)
+        {
+            return {1.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+        }
+        motor out = motors_[0];
+        for (size_t i = 1; i != length_; ++i)
+        {
+            out = out * motors_[i];
+        }
+        return out;
+    }
+
+    /// Convert the (normalized) product of the chain to a 3x4 column-major
+    /// matrix.
+    [[nodiscard]] mat3x4 as_mat3x4() const noexcept
+    {
+        motor m = compose();
+        mat3x4 out;
+        mat4x4_12<true, true>(m.p1_, &m.p2_, out.cols);
+        return out;
+    }
+
+    /// Convert the product of the chain to a 4x4 column-major matrix.
+    [[nodiscard]] mat4x4 as_mat4x4() const noexcept
+    {
+        motor m = compose();
+        mat4x4 out;
+        mat4x4_12<true>(m.p1_, &m.p2_, out.cols);
+        return out;
+    }
+
+    [[nodiscard]] plane KLN_VEC_CALL operator()(plane const& p) const noexcept
+    {
+        return apply(p);
+    }
+
+    [[nodiscard]] line KLN_VEC_CALL operator()(line const& l) const noexcept
+    {
+        return apply(l);
+    }
+
+    [[nodiscard]] point KLN_VEC_CALL operator()(point const& p) const noexcept
+    {
+        return apply(p);
+    }
+
+    [[nodiscard]] direction KLN_VEC_CALL operator()(direction const& d) const
+        noexcept
+    {
+        return apply(d);
+    }
+
+    /// Applies the chain to the `count` planes in `in` and stores the result
+    /// in `out`. Aliasing is only permitted when `in == out`.
+    void operator()(plane* in, plane* out, size_t count) const noexcept
+    {
+        apply(in, out, count);
+    }
+
+    /// Applies the chain to the `count` lines in `in` and stores the result
+    /// in `out`. Aliasing is only permitted when `in == out`.
+    void operator()(line* in, line* out, size_t count) const noexcept
+    {
+        apply(in, out, count);
+    }
+
+    /// Applies the chain to the `count` points in `in` and stores the result
+    /// in `out`. Aliasing is only permitted when `in == out`.
+    void operator()(point* in, point* out, size_t count) const noexcept
+    {
+        apply(in, out, count);
+    }
+
+    /// Applies the chain to the `count` directions in `in` and stores the
+    /// result in `out`. Aliasing is only permitted when `in == out`.
+    void operator()(direction* in, direction* out, size_t count) const noexcept
+    {
+        apply(in, out, count);
+    }
+
+    motor motors_[max_length];
+    size_t length_ = 0;
+
+private:
+    template <typename T>
+    [[nodiscard]] T apply(T x) const noexcept
+    {
+        for (size_t i = length_; i != 0; --i)
+        {
+            x = motors_[i - 1](x);
+        }
+        return x;
+    }
+
+    template <typename T>
+    void apply(T* in, T* out, size_t count) const noexcept
+    {
+        if (count >= compose_threshold)
+        {
+            compose()(in, out, count);
+            return;
+        }
+
+        for (size_t i = 0; i != count; ++i)
+        {
+            out[i] = apply(in[i]);
+        }
+    }
+};
+
+/// \ingroup motor_chain
+///
+/// Appends `m` on the right of the chain `c`.
+[[nodiscard]] inline motor_chain KLN_VEC_CALL operator*(motor_chain c,
+                                                        motor m) noexcept
+{
+    c *= m;
+    return c;
+}
+/// @}
+} // namespace kln
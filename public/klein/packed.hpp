@@ -0,0 +1,462 @@
+#pragma once
+
+#include "geometric_product.hpp"
+#include "motor.hpp"
+#include "plane.hpp"
+#include "point.hpp"
+#include "rotor.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+// F16C is available on every CPU supporting AVX2, but GCC and Clang only
+// enable it with -mf16c (the Klein AVX2 targets pass it)
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#    define KLN_F16C
+#    include <immintrin.h>
+#endif
+
+namespace kln
+{
+/// \defgroup packed Packed storage
+/// @{
+///
+/// Entities are 16 (points, planes) or 32 (motors) bytes of single precision
+/// floats. The batch transforms are bound by memory bandwidth once their
+/// inputs leave the caches, and large static geometry or transforms sent
+/// over the network rarely need that much precision. The types here store
+/// entities in 8 or 16 bytes:
+///
+/// - `point_f16` holds the four components of a point as half precision
+///   floats (8 bytes). Half precision has an 11 bit significand, so a
+///   coordinate $x$ is kept to within $|x| / 2048$, and coordinates beyond
+///   $65504$ become infinite.
+/// - `plane_snorm` holds a normalized plane as four 16 bit integers (8
+///   bytes): the normal as signed normalized values, and the distance to the
+///   origin in fixed point over $[-\mathrm{extent}, \mathrm{extent}]$.
+/// - `motor_q16` holds a normalized motor as eight 16 bit integers (16
+///   bytes): its rotor as signed normalized values, and its translation in
+///   fixed point over $[-\mathrm{extent}, \mathrm{extent}]$ on each axis.
+///
+/// The fixed point components are accurate to $\mathrm{extent} / 65534$, and
+/// values beyond the extent are clamped to it. The extent is not stored, so
+/// the same value must be passed to `pack` and `unpack`.
+///
+/// `pack` and `unpack` convert single entities and arrays of entities. With
+/// F16C, the half precision conversions are done in hardware, otherwise
+/// (and for the other types) with SSE2 integer instructions.
+///
+/// To apply a batch transform to packed entities at a fraction of the memory
+/// traffic, unpack them a block at a time into a buffer that stays in the L1
+/// cache.
+///
+/// !!! example
+///
+///     ```cpp
+///         // Transform packed vertices in blocks of 256
+///         kln::point block[256];
+///         for (size_t i = 0; i < count; i += 256)
+///         {
+///             size_t n = std::min<size_t>(256, count - i);
+///             kln::unpack(vertices + i, block, n);
+///             m(block, block, n);
+///             kln::pack(block, vertices + i, n);
+///         }
+///     ```
+
+/// \ingroup packed
+///
+/// A point stored as four half precision floats, in the order of the
+/// components of `point::p3_` ($\mathbf{e}_{123}$, $\mathbf{e}_{032}$,
+/// $\mathbf{e}_{013}$, $\mathbf{e}_{021}$).
+struct point_f16
+{
+    uint16_t data[4];
+};
+
+/// \ingroup packed
+///
+/// A normalized plane stored as four 16 bit integers, in the order of the
+/// components of `plane::p0_` ($\mathbf{e}_0$, $\mathbf{e}_1$,
+/// $\mathbf{e}_2$, $\mathbf{e}_3$). The $\mathbf{e}_0$ component is scaled
+/// by the extent passed to `pack` and `unpack`.
+struct plane_snorm
+{
+    int16_t data[4];
+};
+
+/// \ingroup packed
+///
+/// A normalized motor stored as its rotor and translation, 16 bit integers
+/// each. `rotor` is in the order of the components of `rotor::p1_`.
+/// `translation` holds the translation along $x$, $y$ and $z$ in its last
+/// three entries, scaled by the extent passed to `pack` and `unpack`, so that
+/// it lines up with the components of a translator. Its first entry is zero.
+struct motor_q16
+{
+    int16_t rotor[4];
+    int16_t translation[4];
+};
+
+namespace detail
+{
+    constexpr float snorm16_scale = 32767.f;
+
+    // Rounds the components of a * scale to the nearest integers in
+    // [-32767, 32767]
+    KLN_INLINE __m128i KLN_VEC_CALL quantize16(__m128 a, __m128 scale) noexcept
+    {
+        __m128 limit = _mm_set1_ps(snorm16_scale);
+        __m128 q     = _mm_mul_ps(a, scale);
+        q = _mm_min_ps(_mm_max_ps(q, _mm_sub_ps(_mm_setzero_ps(), limit)),
+                       limit);
+        return _mm_cvtps_epi32(q);
+    }
+
+    // Converts the low (High false) or high four 16 bit integers of a to
+    // floats
+    template <bool High>
+    KLN_INLINE __m128 KLN_VEC_CALL dequantize16(__m128i a) noexcept
+    {
+        // Moving each integer to the upper half of a 32 bit lane and shifting
+        // it back down sign extends it
+        __m128i wide;
+        if constexpr (High)
+        {
+            wide = _mm_unpackhi_epi16(a, a);
+        }
+        else
+        {
+            wide = _mm_unpacklo_epi16(a, a);
+        }
+        return _mm_cvtepi32_ps(_mm_srai_epi32(wide, 16));
+    }
+
+    KLN_INLINE __m128i KLN_VEC_CALL load64(void const* in) noexcept
+    {
+        return _mm_loadl_epi64(reinterpret_cast<__m128i const*>(in));
+    }
+
+    KLN_INLINE void KLN_VEC_CALL store64(void* out, __m128i a) noexcept
+    {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), a);
+    }
+
+#ifndef KLN_F16C
+    // Round to nearest even conversion of a single float to half precision
+    KLN_INLINE uint16_t float_to_half(float f) noexcept
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        uint32_t sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        uint16_t out;
+        if (bits >= 0x47800000u)
+        {
+            // Overflow to infinity, or NaN
+            out = bits > 0x7f800000u ? 0x7e00 : 0x7c00;
+        }
+        else if (bits < 0x38800000u)
+        {
+            // Denormal or zero. Adding 0.5 aligns the significand so that the
+            // float addition rounds it.
+            float magic = 0.5f;
+            float v;
+            std::memcpy(&v, &bits, sizeof(v));
+            v += magic;
+            std::memcpy(&bits, &v, sizeof(bits));
+            out = static_cast<uint16_t>(bits - 0x3f000000u);
+        }
+        else
+        {
+            uint32_t odd = (bits >> 13) & 1;
+            // Rebias the exponent and round the dropped significand bits
+            bits += 0xc8000fffu + odd;
+            out = static_cast<uint16_t>(bits >> 13);
+        }
+        return static_cast<uint16_t>(out | (sign >> 16));
+    }
+#endif
+
+    // Converts the four half precision floats at in
+    KLN_INLINE __m128 KLN_VEC_CALL half4_to_float(void const* in) noexcept
+    {
+#ifdef KLN_F16C
+        return _mm_cvtph_ps(load64(in));
+#else
+        // The exponent and significand are shifted into place and rebiased
+        // by a multiplication, which also normalizes denormals. Infinities
+        // and NaNs are then given the float exponent.
+        __m128i h       = _mm_unpacklo_epi16(load64(in), _mm_setzero_si128());
+        __m128i expmant = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+        __m128i sign    = _mm_slli_epi32(_mm_xor_si128(h, expmant), 16);
+        __m128 scaled   = _mm_mul_ps(
+            _mm_castsi128_ps(_mm_slli_epi32(expmant, 13)),
+            _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23)));
+        __m128i infnan = _mm_and_si128(
+            _mm_cmpgt_epi32(expmant, _mm_set1_epi32(0x7bff)),
+            _mm_set1_epi32(255 << 23));
+        return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infnan)));
+#endif
+    }
+
+    // Converts the four floats of a to half precision, rounding to nearest
+    // even, and writes them to out
+    KLN_INLINE void KLN_VEC_CALL float_to_half4(__m128 a, void* out) noexcept
+    {
+#ifdef KLN_F16C
+        store64(out, _mm_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT));
+#else
+        float f[4];
+        _mm_storeu_ps(f, a);
+        uint16_t h[4];
+        for (size_t i = 0; i != 4; ++i)
+        {
+            h[i] = float_to_half(f[i]);
+        }
+        std::memcpy(out, h, sizeof(h));
+#endif
+    }
+
+    // Scale of the components of a plane_snorm
+    KLN_INLINE __m128 KLN_VEC_CALL plane_scale(float extent) noexcept
+    {
+        return _mm_set_ps(
+            snorm16_scale, snorm16_scale, snorm16_scale, snorm16_scale / extent);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL plane_unscale(float extent) noexcept
+    {
+        constexpr float inv = 1.f / snorm16_scale;
+        return _mm_set_ps(inv, inv, inv, extent / snorm16_scale);
+    }
+
+    // The translator ideal components are minus half the translation
+    KLN_INLINE __m128 KLN_VEC_CALL translation_scale(float extent) noexcept
+    {
+        float s = -2.f * snorm16_scale / extent;
+        return _mm_set_ps(s, s, s, 0.f);
+    }
+
+    KLN_INLINE __m128 KLN_VEC_CALL translation_unscale(float extent) noexcept
+    {
+        float s = -0.5f * extent / snorm16_scale;
+        return _mm_set_ps(s, s, s, 0.f);
+    }
+
+    KLN_INLINE void KLN_VEC_CALL pack_plane(plane p,
+                                            __m128 scale,
+                                            plane_snorm& out) noexcept
+    {
+        __m128i q = quantize16(p.normalized().p0_, scale);
+        store64(out.data, _mm_packs_epi32(q, q));
+    }
+
+    KLN_INLINE plane KLN_VEC_CALL unpack_plane(plane_snorm const& in,
+                                               __m128 unscale) noexcept
+    {
+        plane out;
+        out.p0_ = _mm_mul_ps(dequantize16<false>(load64(in.data)), unscale);
+        return out;
+    }
+
+    KLN_INLINE void KLN_VEC_CALL pack_motor(motor const& m,
+                                            __m128 scale,
+                                            motor_q16& out) noexcept
+    {
+        // m = tr, so the translator is recovered as m~r
+        rotor r{m.p1_};
+        __m128 t  = (m * ~r).p2_;
+        __m128i q = _mm_packs_epi32(
+            quantize16(m.p1_, _mm_set1_ps(snorm16_scale)),
+            quantize16(t, scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&out), q);
+    }
+
+    KLN_INLINE motor KLN_VEC_CALL unpack_motor(motor_q16 const& in,
+                                               __m128 unscale) noexcept
+    {
+        __m128i q = _mm_loadu_si128(reinterpret_cast<__m128i const*>(&in));
+        __m128 r = dequantize16<false>(q);
+        __m128 t = _mm_mul_ps(dequantize16<true>(q), unscale);
+
+        // Quantization leaves the rotor slightly off the unit sphere
+        r = _mm_mul_ps(r, reciprocal_sqrt(dp_bc(r, r)));
+
+        motor out;
+        out.p1_ = r;
+        gpRT<true>(r, t, out.p2_);
+        return out;
+    }
+} // namespace detail
+
+/// \ingroup packed
+[[nodiscard]] inline point_f16 KLN_VEC_CALL pack(point const& p) noexcept
+{
+    point_f16 out;
+    detail::float_to_half4(p.p3_, out.data);
+    return out;
+}
+
+/// \ingroup packed
+[[nodiscard]] inline point KLN_VEC_CALL unpack(point_f16 const& p) noexcept
+{
+    point out;
+    out.p3_ = detail::half4_to_float(p.data);
+    return out;
+}
+
+/// \ingroup packed
+///
+/// Packs the plane `p`, normalizing it first. The distance of the plane to
+/// the origin is clamped to `extent`.
+[[nodiscard]] inline plane_snorm KLN_VEC_CALL pack(plane const& p,
+                                                   float extent) noexcept
+{
+    plane_snorm out;
+    detail::pack_plane(p, detail::plane_scale(extent), out);
+    return out;
+}
+
+/// \ingroup packed
+[[nodiscard]] inline plane KLN_VEC_CALL unpack(plane_snorm const& p,
+                                               float extent) noexcept
+{
+    return detail::unpack_plane(p, detail::plane_unscale(extent));
+}
+
+/// \ingroup packed
+///
+/// Packs the normalized motor `m`. Each component of its translation is
+/// clamped to `[-extent, extent]`.
+[[nodiscard]] inline motor_q16 KLN_VEC_CALL pack(motor const& m,
+                                                 float extent) noexcept
+{
+    motor_q16 out;
+    detail::pack_motor(m, detail::translation_scale(extent), out);
+    return out;
+}
+
+/// \ingroup packed
+///
+/// Unpacks a motor, renormalizing its rotor.
+[[nodiscard]] inline motor KLN_VEC_CALL unpack(motor_q16 const& m,
+                                               float extent) noexcept
+{
+    return detail::unpack_motor(m, detail::translation_unscale(extent));
+}
+
+/// \ingroup packed
+///
+/// Packs the `count` points in `in`.
+inline void pack(point const* in, point_f16* out, size_t count) noexcept
+{
+    size_t i = 0;
+#if defined(KLN_F16C) && defined(KLN_ENABLE_ISE_AVX2)
+    for (; i + 2 <= count; i += 2)
+    {
+        __m256 p = _mm256_loadu_ps(reinterpret_cast<float const*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm256_cvtps_ph(p, _MM_FROUND_TO_NEAREST_INT));
+    }
+#endif
+    for (; i != count; ++i)
+    {
+        out[i] = pack(in[i]);
+    }
+}
+
+/// \ingroup packed
+///
+/// Unpacks the `count` points in `in`.
+inline void unpack(point_f16 const* in, point* out, size_t count) noexcept
+{
+    size_t i = 0;
+#if defined(KLN_F16C) && defined(KLN_ENABLE_ISE_AVX2)
+    for (; i + 2 <= count; i += 2)
+    {
+        __m256 p = _mm256_cvtph_ps(
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i)));
+        _mm256_storeu_ps(reinterpret_cast<float*>(out + i), p);
+    }
+#endif
+    for (; i != count; ++i)
+    {
+        out[i] = unpack(in[i]);
+    }
+}
+
+/// \ingroup packed
+///
+/// Packs the `count` planes in `in`. See `pack(plane const&, float)`.
+inline void pack(plane const* in,
+                 plane_snorm* out,
+                 size_t count,
+                 float extent) noexcept
+{
+    __m128 scale = detail::plane_scale(extent);
+    for (size_t i = 0; i != count; ++i)
+    {
+        detail::pack_plane(in[i], scale, out[i]);
+    }
+}
+
+/// \ingroup packed
+///
+/// Unpacks the `count` planes in `in`.
+inline void unpack(plane_snorm const* in,
+                   plane* out,
+                   size_t count,
+                   float extent) noexcept
+{
+    __m128 unscale = detail::plane_unscale(extent);
+    size_t i       = 0;
+#ifdef KLN_ENABLE_ISE_AVX2
+    __m256 unscale2 = _mm256_set_m128(unscale, unscale);
+    for (; i + 2 <= count; i += 2)
+    {
+        __m256i q = _mm256_cvtepi16_epi32(
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i)));
+        _mm256_storeu_ps(reinterpret_cast<float*>(out + i),
+                         _mm256_mul_ps(_mm256_cvtepi32_ps(q), unscale2));
+    }
+#endif
+    for (; i != count; ++i)
+    {
+        out[i] = detail::unpack_plane(in[i], unscale);
+    }
+}
+
+/// \ingroup packed
+///
+/// Packs the `count` normalized motors in `in`. See
+/// `pack(motor const&, float)`.
+inline void pack(motor const* in,
+                 motor_q16* out,
+                 size_t count,
+                 float extent) noexcept
+{
+    __m128 scale = detail::translation_scale(extent);
+    for (size_t i = 0; i != count; ++i)
+    {
+        detail::pack_motor(in[i], scale, out[i]);
+    }
+}
+
+/// \ingroup packed
+///
+/// Unpacks the `count` motors in `in`, renormalizing their rotors.
+inline void unpack(motor_q16 const* in,
+                   motor* out,
+                   size_t count,
+                   float extent) noexcept
+{
+    __m128 unscale = detail::translation_unscale(extent);
+    for (size_t i = 0; i != count; ++i)
+    {
+        out[i] = detail::unpack_motor(in[i], unscale);
+    }
+}
+/// @}
+} // namespace kln
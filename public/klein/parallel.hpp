@@ -0,0 +1,550 @@
+#pragma once
+
+#include "bvh.hpp"
+#include "exp_log.hpp"
+#include "motor.hpp"
+#include "point.hpp"
+#include "transform.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace kln
+{
+/// \defgroup parallel Parallel batches
+/// @{
+///
+/// The batch routines of the library (the variadic call operators of motors
+/// and rotors, `transform`, the batch `exp` and `log`, ...) run on the calling
+/// thread. The routines in `kln::parallel` split a batch into chunks and
+/// spread the chunks across the threads of a `parallel::thread_pool`.
+///
+/// Each thread of the pool is first assigned a contiguous run of chunks.
+/// A thread that exhausts its own run steals the remaining chunks of the
+/// others, so that threads slowed down by other work on the machine do not
+/// hold up the batch. The thread submitting a batch takes part in it.
+///
+/// Every chunk after the first starts on a cache line boundary of the output,
+/// so that no two threads write to the same cache line, and all chunks but
+/// the first and last span a multiple of eight entities. The first chunk is
+/// shortened when the data is not cache line aligned, which shifts the SIMD
+/// groups of the following chunks: entities may then be handled by a narrower
+/// kernel than in the equivalent serial call. Batches smaller than
+/// `policy::threshold` entities are processed serially on the calling thread,
+/// where waking the pool would cost more than it saves.
+///
+/// This header also defines the `bvh` constructor taking a `thread_pool`.
+///
+/// This header is not included by `klein.hpp`, as it requires linking against
+/// the platform's thread library.
+///
+/// !!! example
+///
+///     ```cpp
+///         #include <klein/parallel.hpp>
+///
+///         // Uses the default pool, with one thread per hardware thread
+///         kln::parallel::apply(m, points, points, count);
+///
+///         kln::parallel::thread_pool pool{4};
+///         kln::parallel::policy p;
+///         p.pool  = &pool;
+///         p.grain = 4096;
+///         kln::parallel::log(motors, lines, count, p);
+///     ```
+
+namespace parallel
+{
+    class thread_pool;
+
+    /// \ingroup parallel
+    ///
+    /// Controls how a batch is split across threads.
+    struct policy
+    {
+        /// The pool to run on. If null, `default_pool()` is used.
+        thread_pool* pool = nullptr;
+
+        /// Number of entities per chunk, rounded up to a multiple of eight.
+        /// Chunks are the unit of work handed to (and stolen between) threads.
+        size_t grain = 8192;
+
+        /// Batches of fewer entities are processed serially on the calling
+        /// thread.
+        size_t threshold = 32768;
+
+        /// If true, `apply` and `transform` use the non-temporal forms of the
+        /// batch routines (see `kln::non_temporal`) where they exist.
+        bool stream = false;
+    };
+
+    /// \ingroup parallel
+    ///
+    /// A fixed set of worker threads executing one batch at a time. Batches
+    /// submitted concurrently from several threads are executed in turn, and
+    /// a batch submitted from within a chunk of another runs serially.
+    class thread_pool final
+    {
+    public:
+        /// Starts `thread_count - 1` worker threads. The thread submitting a
+        /// batch acts as the remaining one.
+        explicit thread_pool(
+            size_t thread_count = std::thread::hardware_concurrency())
+            : thread_count_{std::max<size_t>(thread_count, 1)}
+            , slices_{new slice[thread_count_]}
+        {
+            workers_.reserve(thread_count_ - 1);
+            for (size_t i = 1; i != thread_count_; ++i)
+            {
+                workers_.emplace_back([this, i] { work_loop(i); });
+            }
+        }
+
+        thread_pool(thread_pool const&) = delete;
+        thread_pool& operator=(thread_pool const&) = delete;
+
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                stop_ = true;
+            }
+            wake_.notify_all();
+            for (std::thread& worker : workers_)
+            {
+                worker.join();
+            }
+        }
+
+        /// Number of threads executing a batch, including the caller
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return thread_count_;
+        }
+
+        /// Calls `f(i)` once for each chunk index `i` in `[0, chunk_count)`,
+        /// distributed over the threads of the pool, and returns once all
+        /// calls have returned. `f` must not throw.
+        template <typename F>
+        void run(size_t chunk_count, F&& f)
+        {
+            if (thread_count_ == 1 || chunk_count < 2 || in_batch_)
+            {
+                for (size_t i = 0; i != chunk_count; ++i)
+                {
+                    f(i);
+                }
+                return;
+            }
+
+            std::lock_guard<std::mutex> submit{submit_mutex_};
+
+            // Assign each thread a contiguous run of chunks
+            size_t per_thread = chunk_count / thread_count_;
+            size_t remainder  = chunk_count % thread_count_;
+            size_t first      = 0;
+            for (size_t i = 0; i != thread_count_; ++i)
+            {
+                slices_[i].next.store(first, std::memory_order_relaxed);
+                first += per_thread + (i < remainder ? 1 : 0);
+                slices_[i].end = first;
+            }
+
+            using functor = std::remove_reference_t<F>;
+            context_      = const_cast<void*>(static_cast<void const*>(&f));
+            call_         = [](void* context, size_t i) {
+                (*static_cast<functor*>(context))(i);
+            };
+
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                ++generation_;
+                pending_ = thread_count_ - 1;
+            }
+            wake_.notify_all();
+
+            work(0);
+
+            std::unique_lock<std::mutex> lock{mutex_};
+            done_.wait(lock, [this] { return pending_ == 0; });
+        }
+
+    private:
+        // The chunks [next, end) not yet taken from the run of one thread.
+        // Slices are kept on separate cache lines as every thread updates
+        // the one it is working on.
+        struct alignas(64) slice
+        {
+            std::atomic<size_t> next{0};
+            size_t end = 0;
+        };
+
+        // Processes the chunks of thread self, then those left in the runs of
+        // the others
+        void work(size_t self) noexcept
+        {
+            in_batch_ = true;
+            for (size_t k = 0; k != thread_count_; ++k)
+            {
+                slice& s = slices_[(self + k) % thread_count_];
+                while (true)
+                {
+                    size_t i = s.next.fetch_add(1, std::memory_order_relaxed);
+                    if (i >= s.end)
+                    {
+                        break;
+                    }
+                    call_(context_, i);
+                }
+            }
+            in_batch_ = false;
+        }
+
+        void work_loop(size_t self) noexcept
+        {
+            size_t generation = 0;
+            std::unique_lock<std::mutex> lock{mutex_};
+            while (true)
+            {
+                wake_.wait(lock, [&] {
+                    return stop_ || generation_ != generation;
+                });
+                if (stop_)
+                {
+                    return;
+                }
+                generation = generation_;
+
+                lock.unlock();
+                work(self);
+                lock.lock();
+
+                if (--pending_ == 0)
+                {
+                    done_.notify_one();
+                }
+            }
+        }
+
+        size_t thread_count_;
+        std::unique_ptr<slice[]> slices_;
+        std::vector<std::thread> workers_;
+
+        // The batch being executed
+        void (*call_)(void*, size_t) = nullptr;
+        void* context_               = nullptr;
+
+        std::mutex submit_mutex_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        size_t generation_ = 0;
+        size_t pending_    = 0;
+        bool stop_         = false;
+
+        static inline thread_local bool in_batch_ = false;
+    };
+
+    /// \ingroup parallel
+    ///
+    /// The pool used when a `policy` names none, created on first use with
+    /// one thread per hardware thread.
+    inline thread_pool& default_pool()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+
+    namespace detail
+    {
+        constexpr size_t cache_line = 64;
+
+        // The chunk size for entities of type T: a multiple of eight entities
+        // spanning a whole number of cache lines
+        template <typename T>
+        constexpr size_t grain(size_t requested) noexcept
+        {
+            size_t multiple = 8;
+            if (cache_line % sizeof(T) == 0)
+            {
+                multiple = std::max(multiple, cache_line / sizeof(T));
+            }
+            requested = std::max<size_t>(requested, 1);
+            return (requested + multiple - 1) / multiple * multiple;
+        }
+
+        // The size of the first chunk, chosen so that the following chunks
+        // start on a cache line boundary of data
+        template <typename T>
+        size_t head(T const* data, size_t grain) noexcept
+        {
+            uintptr_t address = reinterpret_cast<uintptr_t>(data);
+            if (cache_line % sizeof(T) != 0 || address % sizeof(T) != 0)
+            {
+                return grain;
+            }
+            return grain - (address % cache_line) / sizeof(T);
+        }
+    } // namespace detail
+
+    /// \ingroup parallel
+    ///
+    /// Splits `[0, count)` into chunks as described above, the cache line
+    /// boundaries being those of `data`, and calls `f(begin, end)` once for
+    /// each chunk `[begin, end)`.
+    template <typename T, typename F>
+    void for_each_chunk(T const* data, size_t count, F&& f, policy p = {})
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        if (count < p.threshold)
+        {
+            f(size_t{0}, count);
+            return;
+        }
+
+        thread_pool& pool = p.pool ? *p.pool : default_pool();
+        size_t grain      = detail::grain<T>(p.grain);
+        size_t head       = std::min(detail::head(data, grain), count);
+        size_t chunks     = 1 + (count - head + grain - 1) / grain;
+
+        pool.run(chunks, [&](size_t i) {
+            size_t begin = i == 0 ? 0 : head + (i - 1) * grain;
+            size_t end   = std::min(count, head + i * grain);
+            f(begin, end);
+        });
+    }
+
+    /// \ingroup parallel
+    ///
+    /// Computes `out[i] = x(in[i])` for each `i` in `[0, count)`, where `x` is
+    /// any object with a batch call operator `x(in, out, count)`, such as a
+    /// `motor`, `rotor`, `motor_chain` or `prepared_motor`. As with the batch
+    /// call operators, `in` and `out` may alias only if they are equal.
+    template <typename X, typename T>
+    void apply(X const& x, T* in, T* out, size_t count, policy p = {})
+    {
+        for_each_chunk(
+            out,
+            count,
+            [&](size_t begin, size_t end) {
+                constexpr bool has_non_temporal = std::
+                    is_invocable_v<X const&, T*, T*, size_t, non_temporal>;
+                if constexpr (has_non_temporal)
+                {
+                    if (p.stream)
+                    {
+                        x(in + begin,
+                          out + begin,
+                          end - begin,
+                          non_temporal{});
+                        return;
+                    }
+                }
+                x(in + begin, out + begin, end - begin);
+            },
+            p);
+    }
+
+    /// \ingroup parallel
+    ///
+    /// Parallel form of `kln::transform(motors, in, out, count)`.
+    inline void transform(motor const* motors,
+                          point const* in,
+                          point* out,
+                          size_t count,
+                          policy p = {})
+    {
+        for_each_chunk(
+            out,
+            count,
+            [&](size_t begin, size_t end) {
+                if (p.stream)
+                {
+                    kln::transform(motors + begin,
+                                   in + begin,
+                                   out + begin,
+                                   end - begin,
+                                   non_temporal{});
+                }
+                else
+                {
+                    kln::transform(
+                        motors + begin, in + begin, out + begin, end - begin);
+                }
+            },
+            p);
+    }
+
+    /// \ingroup parallel
+    ///
+    /// Parallel form of `kln::transform(motors, index, in, out, count)`, with
+    /// `index` an array of `uint16_t` or `uint32_t`.
+    template <typename I>
+    void transform(motor const* motors,
+                   I const* index,
+                   point const* in,
+                   point* out,
+                   size_t count,
+                   policy p = {})
+    {
+        for_each_chunk(
+            out,
+            count,
+            [&](size_t begin, size_t end) {
+                if (p.stream)
+                {
+                    kln::transform(motors,
+                                   index + begin,
+                                   in + begin,
+                                   out + begin,
+                                   end - begin,
+                                   non_temporal{});
+                }
+                else
+                {
+                    kln::transform(motors,
+                                   index + begin,
+                                   in + begin,
+                                   out + begin,
+                                   end - begin);
+                }
+            },
+            p);
+    }
+
+    /// \ingroup parallel
+    ///
+    /// Normalizes each of the `count` entities in `data` at the precision
+    /// `P`.
+    template <precision P = precision::refined, typename T>
+    void normalize(T* data, size_t count, policy p = {})
+    {
+        for_each_chunk(
+            data,
+            count,
+            [&](size_t begin, size_t end) {
+                for (size_t i = begin; i != end; ++i)
+                {
+                    data[i].template normalize<P>();
+                }
+            },
+            p);
+    }
+
+    /// \ingroup parallel
+    ///
+    /// Parallel form of `kln::log(in, out, count)`.
+    inline void log(motor const* in, line* out, size_t count, policy p = {})
+    {
+        for_each_chunk(
+            out,
+            count,
+            [&](size_t begin, size_t end) {
+                kln::log(in + begin, out + begin, end - begin);
+            },
+            p);
+    }
+
+    /// \ingroup parallel
+    ///
+    /// Parallel form of `kln::exp(in, out, count)`.
+    inline void exp(line const* in, motor* out, size_t count, policy p = {})
+    {
+        for_each_chunk(
+            out,
+            count,
+            [&](size_t begin, size_t end) {
+                kln::exp(in + begin, out + begin, end - begin);
+            },
+            p);
+    }
+} // namespace parallel
+
+/// The top levels of the hierarchy are split one level at a time, the nodes
+/// of each level being partitioned concurrently, until every subtree left
+/// holds fewer than `parallel_threshold` primitives. The remaining subtrees
+/// are then each built by a single thread. Each node is split exactly as in
+/// the serial build, so the hierarchy does not depend on the pool.
+inline bvh::bvh(bounding_box const* bounds,
+                size_t count,
+                bvh_node* nodes,
+                uint32_t* order,
+                parallel::thread_pool* pool)
+    : bounds_{bounds}
+    , nodes_{nodes}
+    , order_{order}
+{
+    for (size_t i = 0; i != count; ++i)
+    {
+        order_[i] = static_cast<uint32_t>(i);
+    }
+    if (count == 0)
+    {
+        return;
+    }
+
+    struct subtree
+    {
+        uint32_t begin;
+        uint32_t end;
+        size_t depth;
+        uint32_t index;
+    };
+
+    parallel::thread_pool& threads = pool ? *pool : parallel::default_pool();
+
+    // The subtrees of one level are disjoint ranges of nodes_ and order_
+    std::vector<subtree> level{{0, static_cast<uint32_t>(count), 0, 0}};
+    std::vector<subtree> rest;
+    std::vector<uint32_t> splits;
+    while (!level.empty())
+    {
+        splits.resize(level.size());
+        threads.run(level.size(), [&](size_t i) {
+            subtree const& t = level[i];
+            splits[i]        = partition(t.begin, t.end, t.depth, t.index);
+        });
+
+        std::vector<subtree> next;
+        for (size_t i = 0; i != level.size(); ++i)
+        {
+            subtree const& t = level[i];
+            if (splits[i] == t.begin)
+            {
+                continue;
+            }
+            subtree children[2]
+                = {{t.begin, splits[i], t.depth + 1, t.index + 1},
+                   {splits[i], t.end, t.depth + 1, nodes_[t.index].offset}};
+            for (subtree const& child : children)
+            {
+                if (child.end - child.begin >= parallel_threshold)
+                {
+                    next.push_back(child);
+                }
+                else
+                {
+                    rest.push_back(child);
+                }
+            }
+        }
+        level = std::move(next);
+    }
+
+    threads.run(rest.size(), [&](size_t i) {
+        build(rest[i].begin, rest[i].end, rest[i].depth, rest[i].index);
+    });
+    compact();
+}
+/// @}
+} // namespace kln
@@ -65,24 +65,23 @@ public:
     ///
     /// !!! tip
     ///
-    ///     Normalization here is done using the `rsqrtps`
-    ///     instruction with a maximum relative error of $1.5\times 2^{-12}$.
+    ///     By default, normalization here is done using the `rsqrtps`
+    ///     instruction refined by a Newton-Raphson step. Pass a different
+    ///     `kln::precision` to trade accuracy for throughput.
+    template <precision P = precision::refined>
     void normalize() noexcept
     {
-        __m128 inv_norm = detail::rsqrt_nr1(detail::hi_dp_bc(p0_, p0_));
-#ifdef KLEIN_SSE_4_1
-        inv_norm = _mm_blend_ps(inv_norm, _mm_set_ss(1.f), 1);
-#else
-        inv_norm = _mm_add_ps(inv_norm, _mm_set_ss(1.f));
-#endif
+        __m128 inv_norm
+            = detail::reciprocal_sqrt<P>(detail::hi_dp_bc(p0_, p0_));
         p0_ = _mm_mul_ps(inv_norm, p0_);
     }
 
     /// Return a normalized copy of this plane.
+    template <precision P = precision::refined>
     [[nodiscard]] plane normalized() const noexcept
     {
-        plane out;
-        out.normalize();
+        plane out = *this;
+        out.normalize<P>();
         return out;
     }
 
@@ -92,24 +91,28 @@ public:
     /// Given a normalized point $P$ and normalized line $\ell$, the plane
     /// $P\vee\ell$ containing both $\ell$ and $P$ will have a norm equivalent
     /// to the distance between $P$ and $\ell$.
+    template <precision P = precision::refined>
     [[nodiscard]] float norm() const noexcept
     {
         float out;
-        _mm_store_ss(&out, detail::sqrt_nr1(detail::hi_dp(p0_, p0_)));
+        _mm_store_ss(&out, detail::square_root<P>(detail::hi_dp(p0_, p0_)));
         return out;
     }
 
+    template <precision P = precision::refined>
     void invert() noexcept
     {
-        __m128 inv_norm = detail::rsqrt_nr1(detail::hi_dp_bc(p0_, p0_));
-        p0_             = _mm_mul_ps(inv_norm, p0_);
-        p0_             = _mm_mul_ps(inv_norm, p0_);
+        __m128 inv_norm
+            = detail::reciprocal_sqrt<P>(detail::hi_dp_bc(p0_, p0_));
+        p0_ = _mm_mul_ps(inv_norm, p0_);
+        p0_ = _mm_mul_ps(inv_norm, p0_);
     }
 
+    template <precision P = precision::refined>
     [[nodiscard]] plane inverse() const noexcept
     {
         plane out = *this;
-        out.invert();
+        out.invert<P>();
         return out;
     }
 
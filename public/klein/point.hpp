@@ -50,31 +50,35 @@ public:
 
     /// Normalize this point (division is done via rcpps with an additional
     /// Newton-Raphson refinement).
+    template <precision P = precision::refined>
     void normalize() noexcept
     {
-        __m128 tmp = detail::rcp_nr1(KLN_SWIZZLE(p3_, 0, 0, 0, 0));
+        __m128 tmp = detail::reciprocal<P>(KLN_SWIZZLE(p3_, 0, 0, 0, 0));
         p3_        = _mm_mul_ps(p3_, tmp);
     }
 
     /// Return a normalized copy of this point.
+    template <precision P = precision::refined>
     [[nodiscard]] point normalized() const noexcept
     {
-        point out;
-        out.normalize();
+        point out = *this;
+        out.normalize<P>();
         return out;
     }
 
+    template <precision P = precision::refined>
     void invert() noexcept
     {
-        __m128 inv_norm = detail::rcp_nr1(KLN_SWIZZLE(p3_, 0, 0, 0, 0));
+        __m128 inv_norm = detail::reciprocal<P>(KLN_SWIZZLE(p3_, 0, 0, 0, 0));
         p3_             = _mm_mul_ps(inv_norm, p3_);
         p3_             = _mm_mul_ps(inv_norm, p3_);
     }
 
+    template <precision P = precision::refined>
     [[nodiscard]] point inverse() const noexcept
     {
         point out = *this;
-        out.invert();
+        out.invert<P>();
         return out;
     }
 
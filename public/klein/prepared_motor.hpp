@@ -0,0 +1,196 @@
+#pragma once
+
+#include "direction.hpp"
+#include "line.hpp"
+#include "motor.hpp"
+#include "plane.hpp"
+#include "point.hpp"
+
+#include "detail/soa.hpp"
+
+namespace kln
+{
+/// \defgroup prepared_motor Prepared motors
+/// @{
+///
+/// Every application of a `motor` first expands the products of its
+/// components (the $b_1^2 + b_0^2 - b_3^2 - b_2^2$, $2(b_0b_3 + b_1b_2)$,
+/// ... terms of the sandwich) before touching the entities being transformed.
+/// The batch operators amortize this over a single call, but a motor applied
+/// again in the next call or the next frame pays for it anew.
+///
+/// A `prepared_motor` performs the expansion once. The sandwich is linear in
+/// the entity, so the motor's action on the basis entities determines it
+/// entirely: the images of the origin and the three basis directions give a
+/// 3x4 transform of points and directions, the images of the basis planes a
+/// transform of planes, and the images of the lines through the origin along
+/// each axis the additional (translational) contribution to line moments.
+/// These columns are stored in Klein's own partition layouts, so that applying
+/// a prepared motor is a matrix multiply that consumes and produces the
+/// usual Klein entities.
+///
+/// The motor must be normalized, as for `motor::as_mat3x4`.
+///
+/// !!! example
+///
+///     ```cpp
+///         kln::prepared_motor prepared{m};
+///
+///         // Each frame
+///         prepared(points, points, count);
+///     ```
+
+/// \ingroup prepared_motor
+class prepared_motor final
+{
+public:
+    prepared_motor() = default;
+
+    explicit prepared_motor(motor const& m) noexcept
+    {
+        // Points and directions. The direction columns also map the
+        // direction (p1) and moment (p2) of a line to their rotated values.
+        cols_[0] = m(point{0.f, 0.f, 0.f}).p3_;
+        cols_[1] = m(direction{1.f, 0.f, 0.f}).p3_;
+        cols_[2] = m(direction{0.f, 1.f, 0.f}).p3_;
+        cols_[3] = m(direction{0.f, 0.f, 1.f}).p3_;
+
+        plane_cols_[0] = m(plane{0.f, 0.f, 0.f, 1.f}).p0_;
+        plane_cols_[1] = m(plane{1.f, 0.f, 0.f, 0.f}).p0_;
+        plane_cols_[2] = m(plane{0.f, 1.f, 0.f, 0.f}).p0_;
+        plane_cols_[3] = m(plane{0.f, 0.f, 1.f, 0.f}).p0_;
+
+        // The moments of the lines through the origin along each axis
+        moment_cols_[0] = m(line{0.f, 0.f, 0.f, 1.f, 0.f, 0.f}).p2_;
+        moment_cols_[1] = m(line{0.f, 0.f, 0.f, 0.f, 1.f, 0.f}).p2_;
+        moment_cols_[2] = m(line{0.f, 0.f, 0.f, 0.f, 0.f, 1.f}).p2_;
+    }
+
+    [[nodiscard]] point KLN_VEC_CALL operator()(point const& p) const noexcept
+    {
+        point out;
+        out.p3_ = apply<true>(cols_, p.p3_);
+        return out;
+    }
+
+    [[nodiscard]] direction KLN_VEC_CALL operator()(direction const& d) const
+        noexcept
+    {
+        direction out;
+        out.p3_ = apply<false>(cols_, d.p3_);
+        return out;
+    }
+
+    [[nodiscard]] plane KLN_VEC_CALL operator()(plane const& p) const noexcept
+    {
+        plane out;
+        out.p0_ = apply<true>(plane_cols_, p.p0_);
+        return out;
+    }
+
+    [[nodiscard]] line KLN_VEC_CALL operator()(line const& l) const noexcept
+    {
+        line out;
+        apply(l.p1_, l.p2_, out.p1_, out.p2_);
+        return out;
+    }
+
+    /// Applies the motor to the `count` points in `in` and stores the result
+    /// in `out`. Aliasing is only permitted when `in == out`.
+    void operator()(point const* in, point* out, size_t count) const noexcept
+    {
+        for (size_t i = 0; i != count; ++i)
+        {
+            out[i].p3_ = apply<true>(cols_, in[i].p3_);
+        }
+    }
+
+    /// Applies the motor to the `count` directions in `in` and stores the
+    /// result in `out`. Aliasing is only permitted when `in == out`.
+    void operator()(direction const* in,
+                    direction* out,
+                    size_t count) const noexcept
+    {
+        for (size_t i = 0; i != count; ++i)
+        {
+            out[i].p3_ = apply<false>(cols_, in[i].p3_);
+        }
+    }
+
+    /// Applies the motor to the `count` planes in `in` and stores the result
+    /// in `out`. Aliasing is only permitted when `in == out`.
+    void operator()(plane const* in, plane* out, size_t count) const noexcept
+    {
+        for (size_t i = 0; i != count; ++i)
+        {
+            out[i].p0_ = apply<true>(plane_cols_, in[i].p0_);
+        }
+    }
+
+    /// Applies the motor to the `count` lines in `in` and stores the result
+    /// in `out`. Aliasing is only permitted when `in == out`.
+    void operator()(line const* in, line* out, size_t count) const noexcept
+    {
+        for (size_t i = 0; i != count; ++i)
+        {
+            __m128 p1 = in[i].p1_;
+            __m128 p2 = in[i].p2_;
+            apply(p1, p2, out[i].p1_, out[i].p2_);
+        }
+    }
+
+    /// Images of the origin and the x, y, and z directions
+    __m128 cols_[4];
+
+    /// Images of the planes e0, e1, e2, and e3
+    __m128 plane_cols_[4];
+
+    /// Moments of the images of the lines through the origin along x, y, and
+    /// z
+    __m128 moment_cols_[3];
+
+private:
+    // Sum of the columns c1, c2 and c3 scaled by lanes 1-3 of a
+    [[nodiscard]] static __m128 KLN_VEC_CALL combine(__m128 c1,
+                                                     __m128 c2,
+                                                     __m128 c3,
+                                                     __m128 a) noexcept
+    {
+        using namespace detail::soa;
+
+        __m128 out = mul(c1, KLN_SWIZZLE(a, 1, 1, 1, 1));
+        out        = fmadd(c2, KLN_SWIZZLE(a, 2, 2, 2, 2), out);
+        return fmadd(c3, KLN_SWIZZLE(a, 3, 3, 3, 3), out);
+    }
+
+    // Sum of the four columns scaled by the lanes of a, or of the last three
+    // scaled by lanes 1-3 if the lane 0 coefficient is known to be zero
+    template <bool Lane0>
+    [[nodiscard]] static __m128 KLN_VEC_CALL apply(__m128 const* cols,
+                                                   __m128 a) noexcept
+    {
+        __m128 out = combine(cols[1], cols[2], cols[3], a);
+        if constexpr (Lane0)
+        {
+            out = detail::soa::fmadd(cols[0], KLN_SWIZZLE(a, 0, 0, 0, 0), out);
+        }
+        return out;
+    }
+
+    void KLN_VEC_CALL apply(__m128 p1,
+                            __m128 p2,
+                            __m128& p1_out,
+                            __m128& p2_out) const noexcept
+    {
+        // The direction rotates. The moment rotates and picks up the moment
+        // of the rotated direction about the translated origin. Lane 0 of
+        // each column is zero, as is the scalar of p1 and the e0123
+        // coefficient of p2.
+        p1_out = apply<false>(cols_, p1);
+        p2_out = _mm_add_ps(
+            apply<false>(cols_, p2),
+            combine(moment_cols_[0], moment_cols_[1], moment_cols_[2], p1));
+    }
+};
+/// @}
+} // namespace kln
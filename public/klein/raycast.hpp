@@ -0,0 +1,254 @@
+#pragma once
+
+#include "join.hpp"
+#include "line.hpp"
+#include "plane.hpp"
+#include "point.hpp"
+
+#include "detail/soa.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace kln
+{
+/// \defgroup raycast Ray casting
+/// @{
+///
+/// Ray-triangle intersection in Plücker form. A triangle $ABC$ is represented
+/// by its three edge lines $A\vee B$, $B\vee C$ and $C\vee A$ and its plane
+/// $A\vee B\vee C$. For two lines with directions $\mathbf{u}_1$,
+/// $\mathbf{u}_2$ and moments $\mathbf{m}_1$, $\mathbf{m}_2$, the reciprocal
+/// product $\mathbf{u}_1\cdot\mathbf{m}_2 + \mathbf{u}_2\cdot\mathbf{m}_1$
+/// (the $\mathbf{e}_{0123}$ coefficient of their exterior product, up to sign)
+/// tells on which side of one line the other passes. A ray line passes
+/// through the triangle exactly when it passes on the same side of all three
+/// edges. The distance to the hit is then read off the meet of the ray with
+/// the triangle's plane.
+///
+/// A ray is a `line` oriented from its origin towards its direction of
+/// travel, e.g. `origin & target` for any point `target` along the ray, and
+/// its origin point. Triangles are prepared once with `prepare_triangles`,
+/// after which packets of four (or eight when `KLN_ENABLE_ISE_AVX2` is
+/// defined) rays are transposed to structure-of-arrays form and tested
+/// against each triangle in turn with the triangle's coefficients broadcast.
+/// Triangles are two-sided.
+///
+/// !!! example
+///
+///     ```cpp
+///         kln::triangle_record records[triangle_count];
+///         kln::prepare_triangles(vertices, indices, triangle_count, records);
+///
+///         kln::line ray = origin & target;
+///         kln::ray_hit hit;
+///         kln::intersect(records, triangle_count, &origin, &ray, &hit, 1);
+///     ```
+
+/// \ingroup raycast
+///
+/// Precomputed Plücker coordinates of a triangle's edges and its plane
+struct triangle_record
+{
+    /// Direction (`e23`, `e31`, `e12`) then moment (`e01`, `e02`, `e03`) of
+    /// each edge line
+    float edges[3][6];
+
+    /// The plane as `(d, a, b, c)`
+    float plane[4];
+};
+
+/// \ingroup raycast
+struct ray_hit
+{
+    /// Sentinel `triangle` of a ray that hit nothing
+    static constexpr uint32_t miss = 0xffffffff;
+
+    /// Distance from the ray origin to the closest hit, or infinity
+    float distance;
+
+    /// Index of the triangle hit, or `miss`
+    uint32_t triangle;
+};
+
+/// \ingroup raycast
+///
+/// Prepares the `count` triangles whose vertices are
+/// `vertices[indices[3 * i + k]]` for `k` in `[0, 3)`.
+inline void prepare_triangles(point const* vertices,
+                              uint32_t const* indices,
+                              size_t count,
+                              triangle_record* out) noexcept
+{
+    for (size_t i = 0; i != count; ++i)
+    {
+        point a = vertices[indices[3 * i]];
+        point b = vertices[indices[3 * i + 1]];
+        point c = vertices[indices[3 * i + 2]];
+
+        line edges[3] = {a & b, b & c, c & a};
+        for (size_t k = 0; k != 3; ++k)
+        {
+            float p1[4];
+            float p2[4];
+            _mm_storeu_ps(p1, edges[k].p1_);
+            _mm_storeu_ps(p2, edges[k].p2_);
+            std::copy(p1 + 1, p1 + 4, out[i].edges[k]);
+            std::copy(p2 + 1, p2 + 4, out[i].edges[k] + 3);
+        }
+        _mm_storeu_ps(out[i].plane, (edges[0] & c).p0_);
+    }
+}
+
+namespace detail
+{
+    // Rays of a packet in structure-of-arrays form, and the closest hit found
+    // so far for each
+    template <typename V>
+    struct ray_packet
+    {
+        V o[4];
+        V u[4];
+        V m[4];
+        V u_norm;
+        V best;
+        V nearest;
+
+        KLN_INLINE ray_packet(point const* origins, line const* rays) noexcept
+        {
+            using namespace soa;
+            load<1>(&origins->p3_, o);
+            load<2>(&rays->p1_, u);
+            load<2>(&rays->p2_, m);
+            u_norm  = sqrt(dot3(u[1], u[2], u[3], u[1], u[2], u[3]));
+            best    = set1<V>(std::numeric_limits<float>::infinity());
+            nearest = set1_bits<V>(ray_hit::miss);
+        }
+
+        // Records hits on the triangle t, closer than any found so far
+        KLN_INLINE void intersect(triangle_record const& t,
+                                  uint32_t index) noexcept
+        {
+            using namespace soa;
+
+            // Side of each edge the rays pass on
+            V side[3];
+            for (size_t k = 0; k != 3; ++k)
+            {
+                float const* e = t.edges[k];
+                V eu[3]        = {set1<V>(e[0]), set1<V>(e[1]), set1<V>(e[2])};
+                V em[3]        = {set1<V>(e[3]), set1<V>(e[4]), set1<V>(e[5])};
+
+                side[k] = add(dot3(u[1], u[2], u[3], em[0], em[1], em[2]),
+                              dot3(eu[0], eu[1], eu[2], m[1], m[2], m[3]));
+            }
+            V zero_v = zero<V>();
+            V inside = bit_or(bit_and(bit_and(cmpge(side[0], zero_v),
+                                              cmpge(side[1], zero_v)),
+                                      cmpge(side[2], zero_v)),
+                              bit_and(bit_and(cmple(side[0], zero_v),
+                                              cmple(side[1], zero_v)),
+                                      cmple(side[2], zero_v)));
+            if (movemask(inside) == 0)
+            {
+                return;
+            }
+
+            // Meet the rays with the plane. Relative to the origin O, the
+            // point of intersection lies at O + su where s is the signed
+            // distance of O from the plane over the cosine of the plane's
+            // normal and u.
+            V pa    = set1<V>(t.plane[1]);
+            V pb    = set1<V>(t.plane[2]);
+            V pc    = set1<V>(t.plane[3]);
+            V num   = fmadd(set1<V>(t.plane[0]),
+                          o[0],
+                          dot3(pa, pb, pc, o[1], o[2], o[3]));
+            V denom = dot3(pa, pb, pc, u[1], u[2], u[3]);
+            V dist  = mul(neg(div(num, denom)), u_norm);
+
+            // Rays lying in the plane of the triangle produce NaN here and
+            // fail the comparisons below
+            V hit   = bit_and(inside,
+                            bit_and(cmpge(dist, zero_v), cmplt(dist, best)));
+            best    = select(hit, dist, best);
+            nearest = select(hit, set1_bits<V>(index), nearest);
+        }
+
+        KLN_INLINE void store(ray_hit* hits) const noexcept
+        {
+            constexpr size_t w = soa::width<V>;
+            float distance[w];
+            uint32_t triangle[w];
+            soa::storeu(best, distance);
+            soa::storeu_bits(nearest, triangle);
+            for (size_t j = 0; j != w; ++j)
+            {
+                hits[j] = {distance[j], triangle[j]};
+            }
+        }
+    };
+
+    // Intersects the width<V> rays starting at rays with all triangles
+    template <typename V>
+    KLN_INLINE void intersect(triangle_record const* triangles,
+                              size_t triangle_count,
+                              point const* origins,
+                              line const* rays,
+                              ray_hit* hits) noexcept
+    {
+        ray_packet<V> packet{origins, rays};
+        for (size_t i = 0; i != triangle_count; ++i)
+        {
+            packet.intersect(triangles[i], static_cast<uint32_t>(i));
+        }
+        packet.store(hits);
+    }
+} // namespace detail
+
+/// \ingroup raycast
+///
+/// Finds the closest of the `triangle_count` prepared triangles hit by each
+/// of the `count` rays, where ray `i` starts at the normalized point
+/// `origins[i]` and follows the line `rays[i]`.
+inline void intersect(triangle_record const* triangles,
+                      size_t triangle_count,
+                      point const* origins,
+                      line const* rays,
+                      ray_hit* hits,
+                      size_t count) noexcept
+{
+    size_t i = 0;
+#ifdef KLN_ENABLE_ISE_AVX2
+    for (; i + 8 <= count; i += 8)
+    {
+        detail::intersect<__m256>(
+            triangles, triangle_count, origins + i, rays + i, hits + i);
+    }
+#endif
+    for (; i + 4 <= count; i += 4)
+    {
+        detail::intersect<__m128>(
+            triangles, triangle_count, origins + i, rays + i, hits + i);
+    }
+
+    if (i != count)
+    {
+        // Pad the tail by repeating the last ray
+        size_t n = count - i;
+        point o[4];
+        line r[4];
+        ray_hit h[4];
+        for (size_t j = 0; j != 4; ++j)
+        {
+            size_t src = i + std::min(j, n - 1);
+            o[j]       = origins[src];
+            r[j]       = rays[src];
+        }
+        detail::intersect<__m128>(triangles, triangle_count, o, r, h);
+        std::copy(h, h + n, hits + i);
+    }
+}
+/// @}
+} // namespace kln
@@ -97,35 +97,41 @@ public:
     ///
     /// !!! tip
     ///
-    ///     Normalization here is done using the `rsqrtps`
-    ///     instruction with a maximum relative error of $1.5\times 2^{-12}$.
+    ///     By default, normalization here is done using the `rsqrtps`
+    ///     instruction refined by a Newton-Raphson step. Pass a different
+    ///     `kln::precision` to trade accuracy for throughput.
+    template <precision P = precision::refined>
     void normalize() noexcept
     {
         // A rotor is normalized if r * ~r is unity.
-        __m128 inv_norm = detail::rsqrt_nr1(detail::dp_bc(p1_, p1_));
+        __m128 inv_norm = detail::reciprocal_sqrt<P>(detail::dp_bc(p1_, p1_));
         p1_             = _mm_mul_ps(p1_, inv_norm);
     }
 
     /// Return a normalized copy of this rotor
+    template <precision P = precision::refined>
     [[nodiscard]] rotor normalized() const noexcept
     {
         rotor out = *this;
-        out.normalize();
+        out.normalize<P>();
         return out;
     }
 
+    template <precision P = precision::refined>
     void invert() noexcept
     {
-        __m128 inv_norm = detail::rsqrt_nr1(detail::hi_dp_bc(p1_, p1_));
-        p1_             = _mm_mul_ps(p1_, inv_norm);
-        p1_             = _mm_mul_ps(p1_, inv_norm);
-        p1_             = _mm_xor_ps(_mm_set_ps(-0.f, -0.f, -0.f, 0.f), p1_);
+        __m128 inv_norm
+            = detail::reciprocal_sqrt<P>(detail::hi_dp_bc(p1_, p1_));
+        p1_ = _mm_mul_ps(p1_, inv_norm);
+        p1_ = _mm_mul_ps(p1_, inv_norm);
+        p1_ = _mm_xor_ps(_mm_set_ps(-0.f, -0.f, -0.f, 0.f), p1_);
     }
 
+    template <precision P = precision::refined>
     [[nodiscard]] rotor inverse() const noexcept
     {
         rotor out = *this;
-        out.invert();
+        out.invert<P>();
         return out;
     }
 
@@ -171,6 +177,18 @@ public:
         detail::sw012<true, false>(&in->p0_, p1_, nullptr, &out->p0_, count);
     }
 
+    /// Non-temporal form of the above: the result is written with
+    /// streaming stores that bypass the caches. See `kln::non_temporal`.
+    void KLN_VEC_CALL operator()(plane* in,
+                                 plane* out,
+                                 size_t count,
+                                 non_temporal) const noexcept
+    {
+        detail::sw012<true, false, true>(
+            &in->p0_, p1_, nullptr, &out->p0_, count);
+        _mm_sfence();
+    }
+
     [[nodiscard]] branch KLN_VEC_CALL operator()(branch const& b) const noexcept
     {
         branch out;
@@ -201,6 +219,18 @@ public:
         detail::swMM<true, false, true>(&in->p1_, p1_, nullptr, &out->p1_, count);
     }
 
+    /// Non-temporal form of the above: the result is written with
+    /// streaming stores that bypass the caches. See `kln::non_temporal`.
+    void KLN_VEC_CALL operator()(line* in,
+                                 line* out,
+                                 size_t count,
+                                 non_temporal) const noexcept
+    {
+        detail::swMM<true, false, true, true>(
+            &in->p1_, p1_, nullptr, &out->p1_, count);
+        _mm_sfence();
+    }
+
     /// Conjugates a point $p$ with this rotor and returns the result
     /// $rp\widetilde{r}$.
     [[nodiscard]] point KLN_VEC_CALL operator()(point const& p) const noexcept
@@ -227,6 +257,19 @@ public:
         detail::sw012<true, false>(&in->p3_, p1_, nullptr, &out->p3_, count);
     }
 
+    /// Non-temporal form of the above: the result is written with
+    /// streaming stores that bypass the caches. See `kln::non_temporal`.
+    void KLN_VEC_CALL operator()(point* in,
+                                 point* out,
+                                 size_t count,
+                                 non_temporal) const noexcept
+    {
+        // NOTE: Conjugation of a plane and point with a rotor is identical
+        detail::sw012<true, false, true>(
+            &in->p3_, p1_, nullptr, &out->p3_, count);
+        _mm_sfence();
+    }
+
     /// Conjugates a direction $d$ with this rotor and returns the result
     /// $rd\widetilde{r}$.
     [[nodiscard]] direction KLN_VEC_CALL operator()(direction const& d) const
@@ -254,6 +297,19 @@ public:
         detail::sw012<true, false>(&in->p3_, p1_, nullptr, &out->p3_, count);
     }
 
+    /// Non-temporal form of the above: the result is written with
+    /// streaming stores that bypass the caches. See `kln::non_temporal`.
+    void KLN_VEC_CALL operator()(direction* in,
+                                 direction* out,
+                                 size_t count,
+                                 non_temporal) const noexcept
+    {
+        // NOTE: Conjugation of a plane and point with a rotor is identical
+        detail::sw012<true, false, true>(
+            &in->p3_, p1_, nullptr, &out->p3_, count);
+        _mm_sfence();
+    }
+
     /// Rotor addition
     rotor& KLN_VEC_CALL operator+=(rotor b) noexcept
     {
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "direction.hpp"
+#include "motor.hpp"
+#include "point.hpp"
+
+#include "detail/soa.hpp"
+
+#include <cstdint>
+
+namespace kln
+{
+/// \defgroup skinning Skinning
+/// @{
+///
+/// Linear blend skinning with motors, the motor analogue of dual quaternion
+/// skinning. Each vertex is influenced by up to four joints. The motors of
+/// its joints (typically the joint's world motor composed with the inverse
+/// of its bind pose) are blended with the vertex weights, the blend is
+/// renormalized, and the resulting motor is applied to the vertex position
+/// and, optionally, its normal.
+///
+/// Before blending, each motor is negated if necessary to lie in the same
+/// hemisphere as the vertex's first motor, as $\mathbf{m}$ and $-\mathbf{m}$
+/// represent the same rigid motion but do not blend to the same result.
+/// Unused influences should be given a weight of zero (with any valid joint
+/// index). The weights need not sum to one.
+///
+/// Groups of four vertices (eight when `KLN_ENABLE_ISE_AVX2` is defined) are
+/// processed in structure-of-arrays form: the joint motors are gathered per
+/// influence, and the blend, normalization, and sandwich are evaluated with
+/// vertical arithmetic only. Remaining vertices are skinned individually.
+///
+/// The vertex streams are `indices` and `weights` (four entries per vertex),
+/// the input positions and normals, and the output positions and normals. As
+/// with the other batch routines, inputs and outputs may alias only if they
+/// are equal.
+
+namespace detail
+{
+    // Skins vertices [i, i + width<V>)
+    template <bool Normals, typename V>
+    KLN_INLINE void skin(motor const* KLN_RESTRICT joints,
+                         uint16_t const* KLN_RESTRICT indices,
+                         float const* KLN_RESTRICT weights,
+                         point const* positions,
+                         [[maybe_unused]] direction const* normals,
+                         point* out_positions,
+                         [[maybe_unused]] direction* out_normals,
+                         size_t i) noexcept
+    {
+        using namespace soa;
+        constexpr size_t w = width<V>;
+
+        // Transpose the weights and indices to one register (or array) per
+        // influence
+        __m128 wv[w];
+        uint16_t index[4][w];
+        for (size_t j = 0; j != w; ++j)
+        {
+            wv[j] = _mm_loadu_ps(weights + 4 * (i + j));
+            for (size_t k = 0; k != 4; ++k)
+            {
+                index[k][j] = indices[4 * (i + j) + k];
+            }
+        }
+        V weight[4];
+        load<1>(wv, weight);
+
+        V first[4];
+        V p1[4];
+        V p2[4];
+        gather<2>(&joints->p1_, index[0], first);
+        gather<2>(&joints->p2_, index[0], p2);
+        for (size_t c = 0; c != 4; ++c)
+        {
+            p1[c] = mul(first[c], weight[0]);
+            p2[c] = mul(p2[c], weight[0]);
+        }
+
+        for (size_t k = 1; k != 4; ++k)
+        {
+            V b[4];
+            V c[4];
+            gather<2>(&joints->p1_, index[k], b);
+            gather<2>(&joints->p2_, index[k], c);
+
+            // Flip the weight if this motor lies in the opposite hemisphere
+            // of the first
+            V dp = fmadd(b[0],
+                         first[0],
+                         dot3(b[1], b[2], b[3], first[1], first[2], first[3]));
+            V wk = bit_xor(weight[k], bit_and(dp, set1<V>(-0.f)));
+            for (size_t j = 0; j != 4; ++j)
+            {
+                p1[j] = fmadd(wk, b[j], p1[j]);
+                p2[j] = fmadd(wk, c[j], p2[j]);
+            }
+        }
+
+        normalize_motor(p1, p2);
+
+        V a[4];
+        load<1>(&positions[i].p3_, a);
+        sw312<true>(a, p1, p2, a);
+        store<1>(a, &out_positions[i].p3_);
+
+        if constexpr (Normals)
+        {
+            load<1>(&normals[i].p3_, a);
+            sw312<false>(a, p1, p2, a);
+            store<1>(a, &out_normals[i].p3_);
+        }
+    }
+
+    template <bool Normals>
+    KLN_INLINE void skin(motor const* KLN_RESTRICT joints,
+                         uint16_t const* KLN_RESTRICT indices,
+                         float const* KLN_RESTRICT weights,
+                         point const* positions,
+                         [[maybe_unused]] direction const* normals,
+                         point* out_positions,
+                         [[maybe_unused]] direction* out_normals,
+                         size_t count) noexcept
+    {
+        size_t i = 0;
+#ifdef KLN_ENABLE_ISE_AVX2
+        for (; i + 8 <= count; i += 8)
+        {
+            skin<Normals, __m256>(joints,
+                                  indices,
+                                  weights,
+                                  positions,
+                                  normals,
+                                  out_positions,
+                                  out_normals,
+                                  i);
+        }
+#endif
+        for (; i + 4 <= count; i += 4)
+        {
+            skin<Normals, __m128>(joints,
+                                  indices,
+                                  weights,
+                                  positions,
+                                  normals,
+                                  out_positions,
+                                  out_normals,
+                                  i);
+        }
+
+        for (; i != count; ++i)
+        {
+            uint16_t const* index = indices + 4 * i;
+            float const* weight   = weights + 4 * i;
+
+            motor first = joints[index[0]];
+            motor m     = first * weight[0];
+            for (size_t k = 1; k != 4; ++k)
+            {
+                motor b = joints[index[k]];
+                float s = _mm_cvtss_f32(dp(first.p1_, b.p1_)) < 0.f
+                              ? -weight[k]
+                              : weight[k];
+                m += b * s;
+            }
+            m.normalize();
+
+            out_positions[i] = m(positions[i]);
+            if constexpr (Normals)
+            {
+                out_normals[i] = m(normals[i]);
+            }
+        }
+    }
+} // namespace detail
+
+/// Skins `count` vertex positions. Vertex `i` is influenced by the joints
+/// `indices[4 * i + k]` with weights `weights[4 * i + k]` for `k` in
+/// `[0, 4)`.
+inline void skin(motor const* joints,
+                 uint16_t const* indices,
+                 float const* weights,
+                 point const* positions,
+                 point* out_positions,
+                 size_t count) noexcept
+{
+    detail::skin<false>(joints,
+                        indices,
+                        weights,
+                        positions,
+                        nullptr,
+                        out_positions,
+                        nullptr,
+                        count);
+}
+
+/// Skins `count` vertex positions and normals. Vertex `i` is influenced by
+/// the joints `indices[4 * i + k]` with weights `weights[4 * i + k]` for `k`
+/// in `[0, 4)`.
+inline void skin(motor const* joints,
+                 uint16_t const* indices,
+                 float const* weights,
+                 point const* positions,
+                 direction const* normals,
+                 point* out_positions,
+                 direction* out_normals,
+                 size_t count) noexcept
+{
+    detail::skin<true>(joints,
+                       indices,
+                       weights,
+                       positions,
+                       normals,
+                       out_positions,
+                       out_normals,
+                       count);
+}
+/// @}
+} // namespace kln
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "exp_log.hpp"
+#include "geometric_product.hpp"
+#include "interpolation.hpp"
+#include "line.hpp"
+#include "motor.hpp"
+
+#include <algorithm>
+
+namespace kln
+{
+/// \defgroup spline Motor splines
+/// @{
+///
+/// A `motor_spline` is a cubic curve through a sequence of uniformly spaced
+/// key motors $\mathbf{K}_0, \dots, \mathbf{K}_{n-1}$, constructed in
+/// cumulative form on the Lie algebra of the motor group. With
+/// $\Omega_k = \log{\mathbf{K}_k\widetilde{\mathbf{K}}_{k-1}}$ the motion
+/// between consecutive keys, the curve on the segment $[i, i+1)$ is
+///
+/// $$\mathbf{M}(i + u) = \exp{\left(\tilde{B}_3(u)\Omega_{i+2}\right)}
+/// \exp{\left(\tilde{B}_2(u)\Omega_{i+1}\right)}
+/// \exp{\left(\tilde{B}_1(u)\Omega_i\right)}\mathbf{K}_{i-1}$$
+///
+/// where the $\tilde{B}_j$ are the cumulative basis functions of the chosen
+/// scalar spline. Two bases are provided:
+///
+/// - `spline_basis::catmull_rom` passes through every key and is $C^1$
+///   continuous. Use it when the keys themselves must be reproduced.
+/// - `spline_basis::b_spline` is $C^2$ continuous but only approximates the
+///   keys, which then act as control motors.
+///
+/// Keys beyond either end of the sequence are taken to repeat the first and
+/// last key respectively, so the curve is defined on all of $[0, n-1]$.
+///
+/// The motions $\Omega_k$ are computed once on construction and stored in
+/// caller-provided storage, so evaluating the curve costs three exponentials
+/// and three motor products. Evaluating many times at once with the batch
+/// overload runs the exponentials through the batch `exp` routine.
+///
+/// !!! example
+///
+///     ```cpp
+///         kln::line omega[key_count - 1];
+///         kln::motor_spline spline{keys, key_count, omega};
+///
+///         // Halfway between keys 2 and 3
+///         kln::motor m = spline(2.5f);
+///     ```
+
+enum class spline_basis
+{
+    catmull_rom,
+    b_spline
+};
+
+namespace detail
+{
+    // Cumulative basis weights for the three motions of a segment at u
+    KLN_INLINE void spline_weights(spline_basis basis,
+                                   float u,
+                                   float* w) noexcept
+    {
+        float u2 = u * u;
+        float u3 = u2 * u;
+        if (basis == spline_basis::catmull_rom)
+        {
+            w[0] = (2.f + u - 2.f * u2 + u3) * 0.5f;
+            w[1] = (u + 3.f * u2 - 2.f * u3) * 0.5f;
+            w[2] = (u3 - u2) * 0.5f;
+        }
+        else
+        {
+            w[0] = (5.f + 3.f * u - 3.f * u2 + u3) / 6.f;
+            w[1] = (1.f + 3.f * u + 3.f * u2 - 2.f * u3) / 6.f;
+            w[2] = u3 / 6.f;
+        }
+    }
+} // namespace detail
+
+/// \ingroup spline
+class motor_spline final
+{
+public:
+    motor_spline() = default;
+
+    /// Constructs a spline through the `count` (at least 2) normalized motors
+    /// in `keys`. `omega` must have room for `count - 1` lines and is filled
+    /// with the logarithms of the motions between consecutive keys. The keys
+    /// and `omega` must outlive the spline.
+    motor_spline(motor const* keys,
+                 size_t count,
+                 line* omega,
+                 spline_basis basis = spline_basis::catmull_rom) noexcept
+        : keys_{keys}
+        , omega_{omega}
+        , count_{count}
+        , basis_{basis}
+    {
+        for (size_t k = 1; k != count; ++k)
+        {
+            omega_[k - 1] = log(detail::relative_motion(keys[k - 1], keys[k]));
+        }
+    }
+
+    /// The curve is defined over `[0, duration()]`, with key `k` at `t = k`.
+    [[nodiscard]] float duration() const noexcept
+    {
+        return static_cast<float>(count_ - 1);
+    }
+
+    /// Evaluates the spline at `t`, which is clamped to `[0, duration()]`.
+    [[nodiscard]] motor operator()(float t) const noexcept
+    {
+        line l[3];
+        size_t base = segment(t, l);
+        return exp(l[2]) * exp(l[1]) * exp(l[0]) * keys_[base];
+    }
+
+    /// Evaluates the spline at each of `t[i]` for `i` in `[0, count)`,
+    /// storing the results in `out`.
+    void operator()(float const* t, motor* out, size_t count) const noexcept
+    {
+        constexpr size_t block = detail::interpolation_block / 2;
+        line l[3][block];
+        motor m[3][block];
+
+        for (size_t i = 0; i < count; i += block)
+        {
+            size_t n = std::min(count - i, block);
+            size_t base[block];
+            for (size_t j = 0; j != n; ++j)
+            {
+                line lj[3];
+                base[j] = segment(t[i + j], lj);
+                l[0][j] = lj[0];
+                l[1][j] = lj[1];
+                l[2][j] = lj[2];
+            }
+
+            for (size_t k = 0; k != 3; ++k)
+            {
+                exp(l[k], m[k], n);
+            }
+
+            for (size_t j = 0; j != n; ++j)
+            {
+                out[i + j] = m[2][j] * m[1][j] * m[0][j] * keys_[base[j]];
+            }
+        }
+    }
+
+    motor const* keys_  = nullptr;
+    line* omega_        = nullptr;
+    size_t count_       = 0;
+    spline_basis basis_ = spline_basis::catmull_rom;
+
+private:
+    // The motion from key k - 1 to key k, which vanishes past either end
+    [[nodiscard]] line motion(size_t k) const noexcept
+    {
+        if (k == 0 || k >= count_)
+        {
+            return {_mm_setzero_ps(), _mm_setzero_ps()};
+        }
+        return omega_[k - 1];
+    }
+
+    // Writes the three weighted motions of the segment containing t to l and
+    // returns the index of the segment's base key.
+    size_t segment(float t, line* l) const noexcept
+    {
+        t        = std::min(std::max(t, 0.f), duration());
+        size_t i = std::min(static_cast<size_t>(t), count_ - 2);
+
+        float w[3];
+        detail::spline_weights(basis_, t - static_cast<float>(i), w);
+        for (size_t j = 0; j != 3; ++j)
+        {
+            l[j] = motion(i + j) * w[j];
+        }
+        return i == 0 ? 0 : i - 1;
+    }
+};
+/// @}
+} // namespace kln
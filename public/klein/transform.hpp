@@ -0,0 +1,191 @@
+#pragma once
+
+#include "motor.hpp"
+#include "point.hpp"
+
+#include "detail/soa.hpp"
+
+#include <cstdint>
+
+namespace kln
+{
+/// \defgroup transform Batch transforms
+/// @{
+///
+/// The variadic `motor::operator()(point*, point*, size_t)` applies a single
+/// motor to many points. The routines here instead apply a *different* motor
+/// to each point, either pairwise (`motors[i]` to `in[i]`) or through an index
+/// array (`motors[index[i]]` to `in[i]`) as is common in skinning and particle
+/// systems.
+///
+/// Internally, groups of four points (eight when `KLN_ENABLE_ISE_AVX2` is
+/// defined) and their motors are transposed into structure-of-arrays form.
+/// The per-motor setup that `sw312` performs with shuffles (the rotation
+/// block and translation column) is then evaluated for every lane at once
+/// with vertical arithmetic, and the result is transposed back. Any remaining
+/// points are transformed individually.
+///
+/// As with the member operators, `in` and `out` may alias only if they are
+/// equal (in place application), and each routine has a non-temporal form
+/// taking a trailing `kln::non_temporal` tag.
+
+namespace detail
+{
+    // Prefetches the input of the Width points from i on and, unless Indexed,
+    // of their motors
+    template <bool Stream, bool Indexed, size_t Width>
+    KLN_INLINE void prefetch_transform(motor const* motors,
+                                       point const* in,
+                                       size_t i) noexcept
+    {
+        for (size_t k = 0; k != Width; k += 4)
+        {
+            prefetch_ahead<Stream>(in + i + k);
+            if constexpr (!Indexed)
+            {
+                prefetch_ahead<Stream>(motors + i + k);
+                prefetch_ahead<Stream>(motors + i + k + 2);
+            }
+        }
+    }
+
+    // Point i is transformed by motors[index[i]] if Indexed is true, and by
+    // motors[i] otherwise (in which case index is ignored). If Stream is
+    // true, out is written with streaming stores, followed by a store fence.
+    template <bool Indexed, bool Stream, typename I>
+    KLN_INLINE void transform(motor const* KLN_RESTRICT motors,
+                              [[maybe_unused]] I const* KLN_RESTRICT index,
+                              point const* in,
+                              point* out,
+                              size_t count) noexcept
+    {
+        size_t i = 0;
+#ifdef KLN_ENABLE_ISE_AVX2
+        for (; i + 8 <= count; i += 8)
+        {
+            prefetch_transform<Stream, Indexed, 8>(motors, in, i);
+
+            __m256 b[4];
+            __m256 c[4];
+            __m256 a[4];
+            if constexpr (Indexed)
+            {
+                soa::gather8<2>(&motors->p1_, index + i, b);
+                soa::gather8<2>(&motors->p2_, index + i, c);
+            }
+            else
+            {
+                soa::load8<2>(&motors[i].p1_, b);
+                soa::load8<2>(&motors[i].p2_, c);
+            }
+            soa::load8<1>(&in[i].p3_, a);
+            soa::sw312<true>(a, b, c, a);
+            soa::store8<1, Stream>(a, &out[i].p3_);
+        }
+#endif
+        for (; i + 4 <= count; i += 4)
+        {
+            prefetch_transform<Stream, Indexed, 4>(motors, in, i);
+
+            __m128 b[4];
+            __m128 c[4];
+            __m128 a[4];
+            if constexpr (Indexed)
+            {
+                soa::gather4<2>(&motors->p1_, index + i, b);
+                soa::gather4<2>(&motors->p2_, index + i, c);
+            }
+            else
+            {
+                soa::load4<2>(&motors[i].p1_, b);
+                soa::load4<2>(&motors[i].p2_, c);
+            }
+            soa::load4<1>(&in[i].p3_, a);
+            soa::sw312<true>(a, b, c, a);
+            soa::store4<1, Stream>(a, &out[i].p3_);
+        }
+
+        for (; i != count; ++i)
+        {
+            motor const* m = motors + i;
+            if constexpr (Indexed)
+            {
+                m = motors + index[i];
+            }
+            __m128 p;
+            sw312<false, true>(&in[i].p3_, m->p1_, &m->p2_, &p);
+            store_entity<Stream>(&out[i].p3_, p);
+        }
+
+        if constexpr (Stream)
+        {
+            _mm_sfence();
+        }
+    }
+} // namespace detail
+
+/// Applies `motors[i]` to `in[i]` and stores the result in `out[i]` for each
+/// `i` in `[0, count)`.
+inline void transform(motor const* motors,
+                      point const* in,
+                      point* out,
+                      size_t count) noexcept
+{
+    detail::transform<false, false, uint32_t>(motors, nullptr, in, out, count);
+}
+
+/// Non-temporal form of the above. See `kln::non_temporal`.
+inline void transform(motor const* motors,
+                      point const* in,
+                      point* out,
+                      size_t count,
+                      non_temporal) noexcept
+{
+    detail::transform<false, true, uint32_t>(motors, nullptr, in, out, count);
+}
+
+/// Applies `motors[index[i]]` to `in[i]` and stores the result in `out[i]`
+/// for each `i` in `[0, count)`.
+inline void transform(motor const* motors,
+                      uint16_t const* index,
+                      point const* in,
+                      point* out,
+                      size_t count) noexcept
+{
+    detail::transform<true, false>(motors, index, in, out, count);
+}
+
+/// Non-temporal form of the above. See `kln::non_temporal`.
+inline void transform(motor const* motors,
+                      uint16_t const* index,
+                      point const* in,
+                      point* out,
+                      size_t count,
+                      non_temporal) noexcept
+{
+    detail::transform<true, true>(motors, index, in, out, count);
+}
+
+/// Applies `motors[index[i]]` to `in[i]` and stores the result in `out[i]`
+/// for each `i` in `[0, count)`.
+inline void transform(motor const* motors,
+                      uint32_t const* index,
+                      point const* in,
+                      point* out,
+                      size_t count) noexcept
+{
+    detail::transform<true, false>(motors, index, in, out, count);
+}
+
+/// Non-temporal form of the above. See `kln::non_temporal`.
+inline void transform(motor const* motors,
+                      uint32_t const* index,
+                      point const* in,
+                      point* out,
+                      size_t count,
+                      non_temporal) noexcept
+{
+    detail::transform<true, true>(motors, index, in, out, count);
+}
+/// @}
+} // namespace kln
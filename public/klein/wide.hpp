@@ -0,0 +1,703 @@
+// File: wide.hpp
+// Structure-of-arrays entity types which operate on eight entities at a time.
+// This header is not included by klein.hpp and requires KLN_ENABLE_ISE_AVX2
+// (link klein::klein_avx2).
+
+#pragma once
+
+#include "detail/soa.hpp"
+#include "line.hpp"
+#include "motor.hpp"
+#include "plane.hpp"
+#include "point.hpp"
+#include "rotor.hpp"
+#include "translator.hpp"
+
+#ifdef KLN_ENABLE_ISE_AVX2
+
+namespace kln
+{
+/// \defgroup wide Wide entities
+///
+/// The `_x8` types store eight planes, points, lines, rotors, translators, or
+/// motors in structure-of-arrays (SoA) form. Each `__m256` member holds a
+/// single basis component of all eight entities, indexed exactly as the
+/// corresponding component of the scalar type's partition. For example,
+/// `point_x8::p3_[1]` holds the $\mathbf{e}_{032}$ (or $x$) coordinate of all
+/// eight points.
+///
+/// In this layout, every operation is a sequence of vertical multiplies and
+/// fused multiply-adds without any swizzling, so throughput per entity is
+/// substantially higher than that of the scalar types. The cost is the
+/// transposition required to move data between the two layouts, so wide types
+/// are best used when a batch of entities undergoes several operations in
+/// sequence.
+///
+/// !!! example
+///
+///     ```c++
+///         kln::motor motors[8];
+///         kln::point points[8];
+///         // ...
+///
+///         // Pack motors and points into SoA form
+///         kln::motor_x8 m{motors};
+///         kln::point_x8 p{points};
+///
+///         // Apply each motor to its corresponding point
+///         kln::point_x8 q = m(p);
+///
+///         // Unpack the result
+///         q.store(points);
+///     ```
+///
+/// Entities with unused partition slots (e.g. the scalar slot of a line's p1)
+/// keep those slots zeroed.
+///
+/// !!! note
+///
+///     The wide types are only available when `KLN_ENABLE_ISE_AVX2` is
+///     defined and the translation unit is compiled with AVX2 and FMA support.
+
+/// \addtogroup wide
+/// @{
+
+class plane_x8 final
+{
+public:
+    plane_x8() noexcept = default;
+
+    /// Broadcast a single plane to all eight slots.
+    explicit plane_x8(plane p) noexcept
+    {
+        float data[4];
+        _mm_storeu_ps(data, p.p0_);
+        for (size_t i = 0; i != 4; ++i)
+        {
+            p0_[i] = _mm256_set1_ps(data[i]);
+        }
+    }
+
+    /// Pack eight planes starting at `in`.
+    explicit plane_x8(plane const* in) noexcept
+    {
+        load(in);
+    }
+
+    /// Pack eight planes starting at `in`.
+    void load(plane const* in) noexcept
+    {
+        detail::soa::load8<1>(&in->p0_, p0_);
+    }
+
+    /// Unpack into eight planes starting at `out`.
+    void store(plane* out) const noexcept
+    {
+        detail::soa::store8<1>(p0_, &out->p0_);
+    }
+
+    /// Normalize each plane such that $p \cdot p = 1$.
+    void normalize() noexcept
+    {
+        __m256 inv_norm = detail::soa::rsqrt_nr1(
+            detail::soa::dot3(p0_[1], p0_[2], p0_[3], p0_[1], p0_[2], p0_[3]));
+        for (size_t i = 0; i != 4; ++i)
+        {
+            p0_[i] = _mm256_mul_ps(p0_[i], inv_norm);
+        }
+    }
+
+    /// Return normalized copies of these planes.
+    [[nodiscard]] plane_x8 normalized() const noexcept
+    {
+        plane_x8 out = *this;
+        out.normalize();
+        return out;
+    }
+
+    [[nodiscard]] __m256 x() const noexcept
+    {
+        return p0_[1];
+    }
+
+    [[nodiscard]] __m256 y() const noexcept
+    {
+        return p0_[2];
+    }
+
+    [[nodiscard]] __m256 z() const noexcept
+    {
+        return p0_[3];
+    }
+
+    [[nodiscard]] __m256 d() const noexcept
+    {
+        return p0_[0];
+    }
+
+    /// (e0, e1, e2, e3)
+    __m256 p0_[4];
+};
+
+class point_x8 final
+{
+public:
+    point_x8() noexcept = default;
+
+    /// Broadcast a single point to all eight slots.
+    explicit point_x8(point p) noexcept
+    {
+        float data[4];
+        _mm_storeu_ps(data, p.p3_);
+        for (size_t i = 0; i != 4; ++i)
+        {
+            p3_[i] = _mm256_set1_ps(data[i]);
+        }
+    }
+
+    /// Pack eight points starting at `in`.
+    explicit point_x8(point const* in) noexcept
+    {
+        load(in);
+    }
+
+    /// Pack eight points starting at `in`.
+    void load(point const* in) noexcept
+    {
+        detail::soa::load8<1>(&in->p3_, p3_);
+    }
+
+    /// Unpack into eight points starting at `out`.
+    void store(point* out) const noexcept
+    {
+        detail::soa::store8<1>(p3_, &out->p3_);
+    }
+
+    /// Normalize each point such that its homogeneous coordinate is 1.
+    void normalize() noexcept
+    {
+        __m256 inv_w = detail::soa::rcp_nr1(p3_[0]);
+        for (size_t i = 0; i != 4; ++i)
+        {
+            p3_[i] = _mm256_mul_ps(p3_[i], inv_w);
+        }
+    }
+
+    /// Return normalized copies of these points.
+    [[nodiscard]] point_x8 normalized() const noexcept
+    {
+        point_x8 out = *this;
+        out.normalize();
+        return out;
+    }
+
+    [[nodiscard]] __m256 x() const noexcept
+    {
+        return p3_[1];
+    }
+
+    [[nodiscard]] __m256 y() const noexcept
+    {
+        return p3_[2];
+    }
+
+    [[nodiscard]] __m256 z() const noexcept
+    {
+        return p3_[3];
+    }
+
+    [[nodiscard]] __m256 w() const noexcept
+    {
+        return p3_[0];
+    }
+
+    /// (e123, e032, e013, e021)
+    __m256 p3_[4];
+};
+
+class line_x8 final
+{
+public:
+    line_x8() noexcept = default;
+
+    /// Broadcast a single line to all eight slots.
+    explicit line_x8(line l) noexcept
+    {
+        float data[8];
+        _mm_storeu_ps(data, l.p1_);
+        _mm_storeu_ps(data + 4, l.p2_);
+        for (size_t i = 0; i != 4; ++i)
+        {
+            p1_[i] = _mm256_set1_ps(data[i]);
+            p2_[i] = _mm256_set1_ps(data[i + 4]);
+        }
+    }
+
+    /// Pack eight lines starting at `in`.
+    explicit line_x8(line const* in) noexcept
+    {
+        load(in);
+    }
+
+    /// Pack eight lines starting at `in`.
+    void load(line const* in) noexcept
+    {
+        detail::soa::load8<2>(&in->p1_, p1_);
+        detail::soa::load8<2>(&in->p2_, p2_);
+    }
+
+    /// Unpack into eight lines starting at `out`.
+    void store(line* out) const noexcept
+    {
+        detail::soa::store8<2>(p1_, &out->p1_);
+        detail::soa::store8<2>(p2_, &out->p2_);
+    }
+
+    /// Normalize each line such that $\ell^2 = -1$.
+    void normalize() noexcept
+    {
+        // See line::normalize
+        using namespace detail::soa;
+        __m256 b2 = dot3(p1_[1], p1_[2], p1_[3], p1_[1], p1_[2], p1_[3]);
+        __m256 s  = rsqrt_nr1(b2);
+        __m256 bc = dot3(p1_[1], p1_[2], p1_[3], p2_[1], p2_[2], p2_[3]);
+        __m256 t  = mul(mul(bc, rcp_nr1(b2)), s);
+
+        for (size_t i = 1; i != 4; ++i)
+        {
+            p2_[i] = fnmadd(p1_[i], t, mul(p2_[i], s));
+            p1_[i] = mul(p1_[i], s);
+        }
+    }
+
+    /// Return normalized copies of these lines.
+    [[nodiscard]] line_x8 normalized() const noexcept
+    {
+        line_x8 out = *this;
+        out.normalize();
+        return out;
+    }
+
+    /// (0, e23, e31, e12)
+    __m256 p1_[4];
+    /// (0, e01, e02, e03)
+    __m256 p2_[4];
+};
+
+class rotor_x8 final
+{
+public:
+    rotor_x8() noexcept = default;
+
+    /// Broadcast a single rotor to all eight slots.
+    explicit rotor_x8(rotor r) noexcept
+    {
+        float data[4];
+        _mm_storeu_ps(data, r.p1_);
+        for (size_t i = 0; i != 4; ++i)
+        {
+            p1_[i] = _mm256_set1_ps(data[i]);
+        }
+    }
+
+    /// Pack eight rotors starting at `in`.
+    explicit rotor_x8(rotor const* in) noexcept
+    {
+        load(in);
+    }
+
+    /// Pack eight rotors starting at `in`.
+    void load(rotor const* in) noexcept
+    {
+        detail::soa::load8<1>(&in->p1_, p1_);
+    }
+
+    /// Unpack into eight rotors starting at `out`.
+    void store(rotor* out) const noexcept
+    {
+        detail::soa::store8<1>(p1_, &out->p1_);
+    }
+
+    /// Normalize each rotor $r$ such that $r\widetilde{r} = 1$.
+    void normalize() noexcept
+    {
+        using namespace detail::soa;
+        __m256 b2
+            = fmadd(p1_[0],
+                    p1_[0],
+                    dot3(p1_[1], p1_[2], p1_[3], p1_[1], p1_[2], p1_[3]));
+        __m256 inv_norm = rsqrt_nr1(b2);
+        for (size_t i = 0; i != 4; ++i)
+        {
+            p1_[i] = mul(p1_[i], inv_norm);
+        }
+    }
+
+    /// Return normalized copies of these rotors.
+    [[nodiscard]] rotor_x8 normalized() const noexcept
+    {
+        rotor_x8 out = *this;
+        out.normalize();
+        return out;
+    }
+
+    /// Conjugates each plane with the corresponding rotor.
+    [[nodiscard]] plane_x8 operator()(plane_x8 const& p) const noexcept
+    {
+        plane_x8 out;
+        detail::soa::sw012<false>(p.p0_, p1_, p1_, out.p0_);
+        return out;
+    }
+
+    /// Conjugates each line with the corresponding rotor.
+    [[nodiscard]] line_x8 operator()(line_x8 const& l) const noexcept
+    {
+        line_x8 out;
+        detail::soa::swMM<false>(l.p1_, l.p2_, p1_, p1_, out.p1_, out.p2_);
+        return out;
+    }
+
+    /// Conjugates each point with the corresponding rotor.
+    [[nodiscard]] point_x8 operator()(point_x8 const& p) const noexcept
+    {
+        point_x8 out;
+        detail::soa::sw312<false>(p.p3_, p1_, p1_, out.p3_);
+        return out;
+    }
+
+    /// (1, e23, e31, e12)
+    __m256 p1_[4];
+};
+
+class translator_x8 final
+{
+public:
+    translator_x8() noexcept = default;
+
+    /// Broadcast a single translator to all eight slots.
+    explicit translator_x8(translator t) noexcept
+    {
+        float data[4];
+        _mm_storeu_ps(data, t.p2_);
+        for (size_t i = 0; i != 4; ++i)
+        {
+            p2_[i] = _mm256_set1_ps(data[i]);
+        }
+    }
+
+    /// Pack eight translators starting at `in`.
+    explicit translator_x8(translator const* in) noexcept
+    {
+        load(in);
+    }
+
+    /// Pack eight translators starting at `in`.
+    void load(translator const* in) noexcept
+    {
+        detail::soa::load8<1>(&in->p2_, p2_);
+    }
+
+    /// Unpack into eight translators starting at `out`.
+    void store(translator* out) const noexcept
+    {
+        detail::soa::store8<1>(p2_, &out->p2_);
+    }
+
+    /// Conjugates each plane with the corresponding translator.
+    [[nodiscard]] plane_x8 operator()(plane_x8 const& p) const noexcept
+    {
+        plane_x8 out;
+        detail::soa::sw02(p.p0_, p2_, out.p0_);
+        return out;
+    }
+
+    /// Conjugates each line with the corresponding translator.
+    [[nodiscard]] line_x8 operator()(line_x8 const& l) const noexcept
+    {
+        line_x8 out;
+        detail::soa::swL2(l.p1_, l.p2_, p2_, out.p1_, out.p2_);
+        return out;
+    }
+
+    /// Conjugates each point with the corresponding translator.
+    [[nodiscard]] point_x8 operator()(point_x8 const& p) const noexcept
+    {
+        point_x8 out;
+        detail::soa::sw32(p.p3_, p2_, out.p3_);
+        return out;
+    }
+
+    /// (0, e01, e02, e03)
+    __m256 p2_[4];
+};
+
+class motor_x8 final
+{
+public:
+    motor_x8() noexcept = default;
+
+    /// Broadcast a single motor to all eight slots.
+    explicit motor_x8(motor m) noexcept
+    {
+        float data[8];
+        _mm_storeu_ps(data, m.p1_);
+        _mm_storeu_ps(data + 4, m.p2_);
+        for (size_t i = 0; i != 4; ++i)
+        {
+            p1_[i] = _mm256_set1_ps(data[i]);
+            p2_[i] = _mm256_set1_ps(data[i + 4]);
+        }
+    }
+
+    /// Pack eight motors starting at `in`.
+    explicit motor_x8(motor const* in) noexcept
+    {
+        load(in);
+    }
+
+    /// Pack eight motors starting at `in`.
+    void load(motor const* in) noexcept
+    {
+        detail::soa::load8<2>(&in->p1_, p1_);
+        detail::soa::load8<2>(&in->p2_, p2_);
+    }
+
+    /// Unpack into eight motors starting at `out`.
+    void store(motor* out) const noexcept
+    {
+        detail::soa::store8<2>(p1_, &out->p1_);
+        detail::soa::store8<2>(p2_, &out->p2_);
+    }
+
+    /// Normalizes each motor $m$ such that $m\widetilde{m} = 1$.
+    void normalize() noexcept
+    {
+        detail::soa::normalize_motor(p1_, p2_);
+    }
+
+    /// Return normalized copies of these motors.
+    [[nodiscard]] motor_x8 normalized() const noexcept
+    {
+        motor_x8 out = *this;
+        out.normalize();
+        return out;
+    }
+
+    /// Conjugates each plane with the corresponding motor.
+    [[nodiscard]] plane_x8 operator()(plane_x8 const& p) const noexcept
+    {
+        plane_x8 out;
+        detail::soa::sw012<true>(p.p0_, p1_, p2_, out.p0_);
+        return out;
+    }
+
+    /// Conjugates each line with the corresponding motor.
+    [[nodiscard]] line_x8 operator()(line_x8 const& l) const noexcept
+    {
+        line_x8 out;
+        detail::soa::swMM<true>(l.p1_, l.p2_, p1_, p2_, out.p1_, out.p2_);
+        return out;
+    }
+
+    /// Conjugates each point with the corresponding motor.
+    [[nodiscard]] point_x8 operator()(point_x8 const& p) const noexcept
+    {
+        point_x8 out;
+        detail::soa::sw312<true>(p.p3_, p1_, p2_, out.p3_);
+        return out;
+    }
+
+    /// (1, e23, e31, e12)
+    __m256 p1_[4];
+    /// (e0123, e01, e02, e03)
+    __m256 p2_[4];
+};
+
+[[nodiscard]] inline motor_x8 operator*(plane_x8 const& a,
+                                        plane_x8 const& b) noexcept
+{
+    motor_x8 out;
+    detail::soa::gp00(a.p0_, b.p0_, out.p1_, out.p2_);
+    return out;
+}
+
+[[nodiscard]] inline motor_x8 operator*(plane_x8 const& a,
+                                        point_x8 const& b) noexcept
+{
+    motor_x8 out;
+    detail::soa::gp03<false>(a.p0_, b.p3_, out.p1_, out.p2_);
+    return out;
+}
+
+[[nodiscard]] inline motor_x8 operator*(point_x8 const& b,
+                                        plane_x8 const& a) noexcept
+{
+    motor_x8 out;
+    detail::soa::gp03<true>(a.p0_, b.p3_, out.p1_, out.p2_);
+    return out;
+}
+
+[[nodiscard]] inline translator_x8 operator*(point_x8 const& a,
+                                             point_x8 const& b) noexcept
+{
+    translator_x8 out;
+    detail::soa::gp33(a.p3_, b.p3_, out.p2_);
+    return out;
+}
+
+[[nodiscard]] inline motor_x8 operator*(line_x8 const& a,
+                                        line_x8 const& b) noexcept
+{
+    motor_x8 out;
+    detail::soa::gpLL(a.p1_, a.p2_, b.p1_, b.p2_, out.p1_, out.p2_);
+    return out;
+}
+
+[[nodiscard]] inline rotor_x8 operator*(rotor_x8 const& a,
+                                        rotor_x8 const& b) noexcept
+{
+    rotor_x8 out;
+    detail::soa::gp11(a.p1_, b.p1_, out.p1_);
+    return out;
+}
+
+[[nodiscard]] inline motor_x8 operator*(rotor_x8 const& a,
+                                        translator_x8 const& b) noexcept
+{
+    motor_x8 out;
+    for (size_t i = 0; i != 4; ++i)
+    {
+        out.p1_[i] = a.p1_[i];
+    }
+    detail::soa::gpRT<false>(a.p1_, b.p2_, out.p2_);
+    return out;
+}
+
+[[nodiscard]] inline motor_x8 operator*(translator_x8 const& b,
+                                        rotor_x8 const& a) noexcept
+{
+    motor_x8 out;
+    for (size_t i = 0; i != 4; ++i)
+    {
+        out.p1_[i] = a.p1_[i];
+    }
+    detail::soa::gpRT<true>(a.p1_, b.p2_, out.p2_);
+    return out;
+}
+
+[[nodiscard]] inline translator_x8 operator*(translator_x8 const& a,
+                                             translator_x8 const& b) noexcept
+{
+    translator_x8 out;
+    for (size_t i = 0; i != 4; ++i)
+    {
+        out.p2_[i] = _mm256_add_ps(a.p2_[i], b.p2_[i]);
+    }
+    return out;
+}
+
+[[nodiscard]] inline motor_x8 operator*(rotor_x8 const& a,
+                                        motor_x8 const& b) noexcept
+{
+    motor_x8 out;
+    detail::soa::gp11(a.p1_, b.p1_, out.p1_);
+    detail::soa::gp12<false>(a.p1_, b.p2_, out.p2_);
+    return out;
+}
+
+[[nodiscard]] inline motor_x8 operator*(motor_x8 const& b,
+                                        rotor_x8 const& a) noexcept
+{
+    motor_x8 out;
+    detail::soa::gp11(b.p1_, a.p1_, out.p1_);
+    detail::soa::gp12<true>(a.p1_, b.p2_, out.p2_);
+    return out;
+}
+
+[[nodiscard]] inline motor_x8 operator*(translator_x8 const& a,
+                                        motor_x8 const& b) noexcept
+{
+    motor_x8 out;
+    detail::soa::gpRT<true>(b.p1_, a.p2_, out.p2_);
+    for (size_t i = 0; i != 4; ++i)
+    {
+        out.p1_[i] = b.p1_[i];
+        out.p2_[i] = _mm256_add_ps(out.p2_[i], b.p2_[i]);
+    }
+    return out;
+}
+
+[[nodiscard]] inline motor_x8 operator*(motor_x8 const& b,
+                                        translator_x8 const& a) noexcept
+{
+    motor_x8 out;
+    detail::soa::gpRT<false>(b.p1_, a.p2_, out.p2_);
+    for (size_t i = 0; i != 4; ++i)
+    {
+        out.p1_[i] = b.p1_[i];
+        out.p2_[i] = _mm256_add_ps(out.p2_[i], b.p2_[i]);
+    }
+    return out;
+}
+
+[[nodiscard]] inline motor_x8 operator*(motor_x8 const& a,
+                                        motor_x8 const& b) noexcept
+{
+    motor_x8 out;
+    detail::soa::gpMM(a.p1_, a.p2_, b.p1_, b.p2_, out.p1_, out.p2_);
+    return out;
+}
+
+/// Reversion operator
+[[nodiscard]] inline rotor_x8 operator~(rotor_x8 r) noexcept
+{
+    for (size_t i = 1; i != 4; ++i)
+    {
+        r.p1_[i] = detail::soa::neg(r.p1_[i]);
+    }
+    return r;
+}
+
+/// Reversion operator
+[[nodiscard]] inline motor_x8 operator~(motor_x8 m) noexcept
+{
+    for (size_t i = 1; i != 4; ++i)
+    {
+        m.p1_[i] = detail::soa::neg(m.p1_[i]);
+        m.p2_[i] = detail::soa::neg(m.p2_[i]);
+    }
+    return m;
+}
+
+/// Reversion operator
+[[nodiscard]] inline line_x8 operator~(line_x8 l) noexcept
+{
+    for (size_t i = 1; i != 4; ++i)
+    {
+        l.p1_[i] = detail::soa::neg(l.p1_[i]);
+        l.p2_[i] = detail::soa::neg(l.p2_[i]);
+    }
+    return l;
+}
+
+/// Takes the principal branch of the logarithm of each motor, returning a
+/// bivector (line). Lanes holding pure translations are handled without
+/// producing NaNs.
+[[nodiscard]] inline line_x8 log(motor_x8 const& m) noexcept
+{
+    line_x8 out;
+    detail::soa::log(m.p1_, m.p2_, out.p1_, out.p2_);
+    return out;
+}
+
+/// Exponentiates each bivector (line) to produce a motor.
+[[nodiscard]] inline motor_x8 exp(line_x8 const& l) noexcept
+{
+    motor_x8 out;
+    detail::soa::exp(l.p1_, l.p2_, out.p1_, out.p2_);
+    return out;
+}
+/// @}
+} // namespace kln
+
+#endif
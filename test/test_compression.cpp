@@ -0,0 +1,92 @@
+#include <doctest/doctest.h>
+
+#include <klein/klein.hpp>
+
+using namespace kln;
+
+TEST_CASE("clip-compression")
+{
+    CHECK_EQ(sizeof(compressed_key), 12);
+
+    constexpr size_t track_count = 5;
+    constexpr size_t frame_count = 24;
+    motor poses[frame_count][track_count];
+    for (size_t f = 0; f != frame_count; ++f)
+    {
+        float t = static_cast<float>(f) * 0.1f;
+        for (size_t i = 0; i != track_count; ++i)
+        {
+            float s = static_cast<float>(i);
+            // Track 2 is constant
+            float u     = i == 2 ? 0.f : t;
+            poses[f][i] = translator{1.f + s + u, 0.5f, -1.f, 0.2f * s}
+                          * rotor{u * (1.f + s), 1.f, -0.5f * s, 0.3f};
+        }
+    }
+
+    compressed_track tracks[track_count];
+    compressed_key stream[track_count * frame_count];
+    compressed_clip clip = compress_clip(
+        &poses[0][0], track_count, frame_count, 1e-4f, tracks, stream);
+
+    CHECK_EQ(clip.animated_count, track_count - 1);
+    CHECK_EQ(tracks[2].stream_index, compressed_track::constant);
+    CHECK_EQ(clip.key_count(), (track_count - 1) * frame_count);
+
+    for (size_t i = 0; i != track_count; ++i)
+    {
+        CHECK_LT(tracks[i].rotation_error, 1e-4f);
+        CHECK_LT(tracks[i].translation_error, 1e-3f);
+    }
+
+    // Every decoded motor moves a point to within the reported bounds
+    point p{1.f, -2.f, 0.5f};
+    motor decoded[track_count];
+    for (size_t f = 0; f != frame_count; ++f)
+    {
+        clip.decode(f, decoded);
+        for (size_t i = 0; i != track_count; ++i)
+        {
+            point expected = poses[f][i](p);
+            point actual   = decoded[i](p);
+            CHECK_EQ(actual.x(), doctest::Approx(expected.x()).epsilon(1e-3));
+            CHECK_EQ(actual.y(), doctest::Approx(expected.y()).epsilon(1e-3));
+            CHECK_EQ(actual.z(), doctest::Approx(expected.z()).epsilon(1e-3));
+        }
+    }
+
+    // Sampling between frames blends the neighboring poses
+    motor a[track_count];
+    motor b[track_count];
+    motor mid[track_count];
+    clip.decode(size_t{3}, a);
+    clip.decode(size_t{4}, b);
+    clip.sample(3.5f, mid);
+    for (size_t i = 0; i != track_count; ++i)
+    {
+        motor expected = nlerp(a[i], b[i], 0.5f);
+        CHECK_EQ(mid[i].scalar(), doctest::Approx(expected.scalar()));
+        CHECK_EQ(mid[i].e12(), doctest::Approx(expected.e12()));
+        CHECK_EQ(mid[i].e01(), doctest::Approx(expected.e01()));
+    }
+}
+
+TEST_CASE("clip-compression-empty")
+{
+    compressed_track tracks[2];
+    compressed_key stream[1];
+    compressed_clip clip
+        = compress_clip(nullptr, 2, 0, 1e-4f, tracks, stream);
+    CHECK_EQ(clip.track_count, 0u);
+    CHECK_EQ(clip.frame_count, 0u);
+    CHECK_EQ(clip.key_count(), 0u);
+
+    // Sampling an empty clip leaves the output untouched
+    motor out[2] = {motor{1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f},
+                    motor{1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f}};
+    clip.sample(0.5f, out);
+    CHECK_EQ(out[0].e12(), 4.f);
+    compressed_clip hand_built{tracks, stream, 2, 0, 1};
+    hand_built.sample(2.f, out);
+    CHECK_EQ(out[1].e12(), 4.f);
+}
@@ -0,0 +1,190 @@
+#define _USE_MATH_DEFINES
+#include <doctest/doctest.h>
+
+#include <klein/klein.hpp>
+#ifdef KLN_ENABLE_ISE_AVX2
+#    include <klein/wide.hpp>
+#endif
+
+#include <cstdint>
+
+using namespace kln;
+
+namespace
+{
+bool aligned(void const* p)
+{
+    return reinterpret_cast<uintptr_t>(p) % container_alignment == 0;
+}
+} // namespace
+
+TEST_CASE("aligned-vector")
+{
+    aligned_vector<point> points;
+    CHECK(points.empty());
+    for (size_t i = 0; i != 21; ++i)
+    {
+        float f = static_cast<float>(i);
+        CHECK(points.push_back(point{f, 2.f * f, -f}));
+    }
+    CHECK_EQ(points.size(), 21u);
+    CHECK_EQ(points.capacity() % aligned_vector<point>::padding, 0u);
+    CHECK(aligned(points.data()));
+    CHECK_EQ(points[20].y(), 40.f);
+
+    // The padding past the last entity is zeroed
+    for (size_t i = points.size(); i != points.capacity(); ++i)
+    {
+        CHECK_EQ(points.data()[i].w(), 0.f);
+        CHECK_EQ(points.data()[i].x(), 0.f);
+    }
+
+    // Batch routines accept the storage directly
+    motor m{1.f, 4.f, 3.f, 2.f, 5.f, 6.f, 7.f, 8.f};
+    m.normalize();
+    point expected = m(points[7]);
+    m(points.data(), points.data(), points.size());
+    CHECK_EQ(points[7].x(), doctest::Approx(expected.x()));
+    CHECK_EQ(points[7].y(), doctest::Approx(expected.y()));
+    CHECK_EQ(points[7].z(), doctest::Approx(expected.z()));
+
+    // Pushing back an entity of the vector itself survives reallocation
+    while (points.size() != points.capacity())
+    {
+        CHECK(points.push_back(points[0]));
+    }
+    point first = points[0];
+    CHECK(points.push_back(points[0]));
+    CHECK_EQ(points[points.size() - 1].x(), first.x());
+    CHECK_EQ(points[points.size() - 1].y(), first.y());
+    CHECK_EQ(points[points.size() - 1].z(), first.z());
+
+    CHECK(points.resize(3));
+    CHECK_EQ(points.data()[3].x(), 0.f);
+
+    aligned_vector<point> moved = std::move(points);
+    CHECK_EQ(moved.size(), 3u);
+    CHECK_EQ(points.size(), 0u);
+    CHECK_EQ(points.data(), nullptr);
+}
+
+TEST_CASE("arena")
+{
+    alignas(64) static char memory[4096];
+    arena frame{memory, sizeof(memory)};
+
+    {
+        aligned_vector<motor, arena_allocator> motors{frame};
+        CHECK(motors.resize(10));
+        CHECK(aligned(motors.data()));
+        CHECK_GE(static_cast<void*>(motors.data()),
+                 static_cast<void*>(memory));
+        CHECK_LE(static_cast<void*>(motors.data() + motors.capacity()),
+                 static_cast<void*>(memory + sizeof(memory)));
+        CHECK_EQ(frame.used(), 16 * sizeof(motor));
+
+        // Exhausting the arena fails without altering the container
+        CHECK_FALSE(motors.resize(1000));
+        CHECK_EQ(motors.size(), 10u);
+    }
+    // The most recent allocation is reclaimed when freed
+    CHECK_EQ(frame.used(), 0u);
+
+    soa_vector<line, arena_allocator> lines{frame};
+    CHECK(lines.resize(5));
+    CHECK(aligned(lines.component(0)));
+    CHECK(aligned(lines.component(7)));
+    frame.reset();
+    CHECK_EQ(frame.used(), 0u);
+}
+
+TEST_CASE("soa-vector")
+{
+    constexpr size_t count = 19;
+    motor motors[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float f   = static_cast<float>(i);
+        motors[i] = motor{f, 1.f + f, 2.f - f, 3.f, 4.f * f, 5.f, -f, 7.f};
+    }
+
+    soa_vector<motor> soa;
+    CHECK(soa.assign(motors, count));
+    CHECK_EQ(soa.size(), count);
+    CHECK_EQ(soa.capacity(), 32u);
+    for (size_t k = 0; k != soa_vector<motor>::components; ++k)
+    {
+        CHECK(aligned(soa.component(k)));
+    }
+
+    // Component k of the motor i is the float k of its partitions
+    for (size_t i = 0; i != count; ++i)
+    {
+        float f = static_cast<float>(i);
+        CHECK_EQ(soa.component(0)[i], f);
+        CHECK_EQ(soa.component(1)[i], 1.f + f);
+        CHECK_EQ(soa.component(4)[i], 7.f);
+        CHECK_EQ(soa.component(5)[i], 4.f * f);
+        CHECK_EQ(soa.component(7)[i], -f);
+        CHECK(soa.get(i) == motors[i]);
+    }
+    CHECK_EQ(soa.component(0)[count], 0.f);
+
+    CHECK(soa.push_back(motors[3]));
+    CHECK(soa.get(count) == motors[3]);
+
+    motor out[count + 1];
+    soa.store(out);
+    for (size_t i = 0; i != count; ++i)
+    {
+        CHECK(out[i] == motors[i]);
+    }
+
+    // Groups load into SoA registers
+    __m128 group[8];
+    soa.load(4, group);
+    float lanes[4];
+    _mm_storeu_ps(lanes, group[1]);
+    CHECK_EQ(lanes[0], 5.f);
+    CHECK_EQ(lanes[3], 8.f);
+
+    // Growing preserves the contents
+    CHECK(soa.reserve(100));
+    CHECK(soa.get(18) == motors[18]);
+    CHECK_EQ(soa.component(2)[count + 1], 0.f);
+}
+
+#ifdef KLN_ENABLE_ISE_AVX2
+TEST_CASE("soa-vector-wide")
+{
+    constexpr size_t count = 13;
+    point points[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float f   = static_cast<float>(i);
+        points[i] = point{f, -f, 2.f + f};
+    }
+
+    motor m{1.f, 4.f, 3.f, 2.f, 5.f, 6.f, 7.f, 8.f};
+    m.normalize();
+    motor_x8 m8{m};
+
+    soa_vector<point> soa;
+    CHECK(soa.assign(points, count));
+    for (size_t i = 0; i < soa.size(); i += 8)
+    {
+        point_x8 p;
+        soa.load(i, p.p3_);
+        soa.store(i, m8(p).p3_);
+    }
+
+    for (size_t i = 0; i != count; ++i)
+    {
+        point expected = m(points[i]);
+        point actual   = soa.get(i);
+        CHECK_EQ(actual.x(), doctest::Approx(expected.x()));
+        CHECK_EQ(actual.y(), doctest::Approx(expected.y()));
+        CHECK_EQ(actual.z(), doctest::Approx(expected.z()));
+    }
+}
+#endif
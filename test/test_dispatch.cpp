@@ -0,0 +1,123 @@
+#include <doctest/doctest.h>
+
+#include <klein/klein.hpp>
+#include <klein_dispatch.hpp>
+
+using namespace kln;
+
+namespace
+{
+void check_equal(__m128 expected, __m128 actual)
+{
+    float e[4];
+    float a[4];
+    _mm_storeu_ps(e, expected);
+    _mm_storeu_ps(a, actual);
+    for (size_t i = 0; i != 4; ++i)
+    {
+        CHECK_EQ(a[i], doctest::Approx(e[i]));
+    }
+}
+
+constexpr dispatch::isa all_isas[]
+    = {dispatch::isa::sse3,
+       dispatch::isa::sse41,
+       dispatch::isa::avx2,
+       dispatch::isa::avx512};
+
+// Odd count to exercise the remainder handling of every kernel width
+constexpr size_t count = 11;
+} // namespace
+
+TEST_CASE("dispatch-selects-widest")
+{
+    dispatch::isa widest = dispatch::isa::sse3;
+    for (dispatch::isa set : all_isas)
+    {
+        if (dispatch::is_supported(set))
+        {
+            widest = set;
+        }
+    }
+    CHECK(dispatch::is_supported(dispatch::isa::sse3));
+    CHECK_EQ(dispatch::active_isa(), widest);
+    MESSAGE(dispatch::isa_name(dispatch::active_isa()));
+}
+
+TEST_CASE("dispatch-conjugate")
+{
+    rotor r{1.3f, -0.4f, 2.f, 0.7f};
+    translator t{3.f, 1.f, 0.5f, -2.f};
+    motor m = r * t;
+
+    plane planes[count];
+    line lines[count];
+    point points[count];
+    direction directions[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float f       = static_cast<float>(i);
+        planes[i]     = plane{1.f + f, -2.f, 0.5f * f, 3.f};
+        lines[i]      = line{f, 1.f, -2.f, 0.3f, 4.f - f, 1.f};
+        points[i]     = point{f, -1.f + f, 2.f};
+        directions[i] = direction{1.f, f, -3.f};
+    }
+
+    for (dispatch::isa set : all_isas)
+    {
+        if (!dispatch::select_isa(set))
+        {
+            CHECK_UNARY_FALSE(dispatch::is_supported(set));
+            continue;
+        }
+        CHECK_EQ(dispatch::active_isa(), set);
+
+        plane plane_out[count];
+        line line_out[count];
+        point point_out[count];
+        direction direction_out[count];
+
+        dispatch::conjugate(m, planes, plane_out, count);
+        dispatch::conjugate(m, lines, line_out, count);
+        dispatch::conjugate(m, points, point_out, count);
+        dispatch::conjugate(m, directions, direction_out, count);
+        for (size_t i = 0; i != count; ++i)
+        {
+            check_equal(m(planes[i]).p0_, plane_out[i].p0_);
+            check_equal(m(lines[i]).p1_, line_out[i].p1_);
+            check_equal(m(lines[i]).p2_, line_out[i].p2_);
+            check_equal(m(points[i]).p3_, point_out[i].p3_);
+            check_equal(m(directions[i]).p3_, direction_out[i].p3_);
+        }
+
+        dispatch::conjugate(r, planes, plane_out, count);
+        dispatch::conjugate(r, lines, line_out, count);
+        dispatch::conjugate(r, points, point_out, count);
+        dispatch::conjugate(r, directions, direction_out, count);
+        for (size_t i = 0; i != count; ++i)
+        {
+            check_equal(r(planes[i]).p0_, plane_out[i].p0_);
+            check_equal(r(lines[i]).p1_, line_out[i].p1_);
+            check_equal(r(lines[i]).p2_, line_out[i].p2_);
+            check_equal(r(points[i]).p3_, point_out[i].p3_);
+            check_equal(r(directions[i]).p3_, direction_out[i].p3_);
+        }
+
+        // In place application
+        point points_in_place[count];
+        line lines_in_place[count];
+        for (size_t i = 0; i != count; ++i)
+        {
+            points_in_place[i] = points[i];
+            lines_in_place[i]  = lines[i];
+        }
+        dispatch::conjugate(m, points_in_place, points_in_place, count);
+        dispatch::conjugate(m, lines_in_place, lines_in_place, count);
+        for (size_t i = 0; i != count; ++i)
+        {
+            check_equal(m(points[i]).p3_, points_in_place[i].p3_);
+            check_equal(m(lines[i]).p1_, lines_in_place[i].p1_);
+            check_equal(m(lines[i]).p2_, lines_in_place[i].p2_);
+        }
+    }
+}
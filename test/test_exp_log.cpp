@@ -103,4 +103,254 @@ TEST_CASE("motor-blend")
     CHECK_EQ(result.e02(), doctest::Approx(m2.e02()));
     CHECK_EQ(result.e03(), doctest::Approx(m2.e03()));
     CHECK_EQ(result.e0123(), doctest::Approx(m2.e0123()));
-}
\ No newline at end of file
+}
+
+TEST_CASE("motor-exp-log-small-angle")
+{
+    // Rotations by angles around 1e-6 are kept, with the values of the
+    // closed forms. The comparisons are relative (scale 0), as the default
+    // absolute tolerance would accept zero.
+    auto rel = [](float x) { return doctest::Approx(x).scale(0.0); };
+    motor m = exp(line{0.f, 0.f, 0.f, 5e-7f, 0.f, 0.f});
+    CHECK_EQ(m.scalar(), doctest::Approx(1.f));
+    CHECK_EQ(m.e23(), rel(5e-7f));
+
+    m = exp(line{1.f, 2.f, 3.f, 5e-7f, -2e-7f, 1e-7f});
+    CHECK_EQ(m.e23(), rel(5e-7f));
+    CHECK_EQ(m.e31(), rel(-2e-7f));
+    CHECK_EQ(m.e12(), rel(1e-7f));
+    CHECK_EQ(m.e01(), doctest::Approx(1.f));
+    CHECK_EQ(m.e0123(), rel(4e-7f));
+
+    // Half the angle about the normalized axis (1, 2, -1)
+    rotor r{1e-6f, 1.f, 2.f, -1.f};
+    float k = -0.5e-6f / std::sqrt(6.f);
+    line l  = log(motor{r});
+    CHECK_EQ(l.e23(), rel(k));
+    CHECK_EQ(l.e31(), rel(2.f * k));
+    CHECK_EQ(l.e12(), rel(-k));
+
+    l = log(translator{2.f, 1.f, 0.f, 0.f} * r);
+    CHECK_EQ(l.e23(), rel(k));
+    CHECK_EQ(l.e31(), rel(2.f * k));
+    CHECK_EQ(l.e12(), rel(-k));
+    CHECK_EQ(l.e01(), doctest::Approx(-1.f));
+
+    // Below the threshold, the first order expansion takes over
+    m = exp(line{0.f, 0.f, 0.f, 1e-13f, 0.f, 0.f});
+    CHECK_EQ(m.scalar(), 1.f);
+    CHECK_EQ(m.e23(), rel(1e-13f));
+    CHECK_EQ(log(m).e23(), rel(1e-13f));
+}
+
+TEST_CASE("motor-exp-log-batch")
+{
+    // 11 motors exercise the full width groups and the padded tail
+    constexpr size_t count = 11;
+    motor m[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float f = static_cast<float>(i);
+        rotor r{0.5f + 0.25f * f, 0.3f, -3.f + f, 1.f};
+        translator t{12.f - f, -2.f, 0.4f * f, 1.f};
+        m[i] = r * t;
+    }
+
+    line l[count];
+    motor m2[count];
+    log(m, l, count);
+    exp(l, m2, count);
+
+    for (size_t i = 0; i != count; ++i)
+    {
+        line expected = log(m[i]);
+        CHECK_EQ(l[i].e12(), doctest::Approx(expected.e12()).epsilon(1e-5));
+        CHECK_EQ(l[i].e31(), doctest::Approx(expected.e31()).epsilon(1e-5));
+        CHECK_EQ(l[i].e23(), doctest::Approx(expected.e23()).epsilon(1e-5));
+        CHECK_EQ(l[i].e01(), doctest::Approx(expected.e01()).epsilon(1e-5));
+        CHECK_EQ(l[i].e02(), doctest::Approx(expected.e02()).epsilon(1e-5));
+        CHECK_EQ(l[i].e03(), doctest::Approx(expected.e03()).epsilon(1e-5));
+
+        CHECK_EQ(m2[i].scalar(), doctest::Approx(m[i].scalar()));
+        CHECK_EQ(m2[i].e12(), doctest::Approx(m[i].e12()));
+        CHECK_EQ(m2[i].e31(), doctest::Approx(m[i].e31()));
+        CHECK_EQ(m2[i].e23(), doctest::Approx(m[i].e23()));
+        CHECK_EQ(m2[i].e01(), doctest::Approx(m[i].e01()));
+        CHECK_EQ(m2[i].e02(), doctest::Approx(m[i].e02()));
+        CHECK_EQ(m2[i].e03(), doctest::Approx(m[i].e03()));
+        CHECK_EQ(m2[i].e0123(), doctest::Approx(m[i].e0123()));
+    }
+
+    // Pure translations map to their ideal axis and back
+    translator t{3.f, 1.f, -2.f, 0.5f};
+    motor pure[3];
+    for (motor& m_t : pure)
+    {
+        m_t = motor{_mm_set_ss(1.f), t.p2_};
+    }
+    line ideal[3];
+    log(pure, ideal, 3);
+    exp(ideal, pure, 3);
+    CHECK_EQ(ideal[2].e01(), doctest::Approx(t.e01()));
+    CHECK_EQ(ideal[2].e23(), 0.f);
+    CHECK_EQ(pure[2].scalar(), doctest::Approx(1.f));
+    CHECK_EQ(pure[2].e02(), doctest::Approx(t.e02()));
+
+    // Small rotations match the scalar routines rather than being dropped
+    constexpr size_t small_count = 9;
+    line small[small_count];
+    for (size_t i = 0; i != small_count; ++i)
+    {
+        float f  = static_cast<float>(i);
+        small[i] = line{f + 1.f, 1.f, -2.f, 5e-7f * (f + 1.f), -2e-7f, 1e-7f};
+    }
+    small[small_count - 1] = line{1.f, 2.f, 3.f, 1e-13f, -2e-13f, 3e-13f};
+    motor small_exp[small_count];
+    line small_log[small_count];
+    exp(small, small_exp, small_count);
+    log(small_exp, small_log, small_count);
+    auto rel = [](float x) { return doctest::Approx(x).scale(0.0); };
+    for (size_t i = 0; i != small_count; ++i)
+    {
+        motor expected = exp(small[i]);
+        CHECK_EQ(small_exp[i].e23(), rel(expected.e23()));
+        CHECK_EQ(small_exp[i].e31(), rel(expected.e31()));
+        CHECK_EQ(small_exp[i].e01(), rel(expected.e01()));
+        CHECK_EQ(small_exp[i].e0123(), rel(expected.e0123()));
+        CHECK_EQ(small_log[i].e23(), rel(small[i].e23()));
+        CHECK_EQ(small_log[i].e12(), rel(small[i].e12()));
+        CHECK_EQ(small_log[i].e02(), rel(small[i].e02()));
+    }
+}
+
+namespace
+{
+void check_motor(motor const& expected,
+                 motor const& actual,
+                 double epsilon = 1e-5)
+{
+    auto approx = [epsilon](float f) {
+        return doctest::Approx(f).epsilon(epsilon);
+    };
+    CHECK_EQ(actual.scalar(), approx(expected.scalar()));
+    CHECK_EQ(actual.e12(), approx(expected.e12()));
+    CHECK_EQ(actual.e31(), approx(expected.e31()));
+    CHECK_EQ(actual.e23(), approx(expected.e23()));
+    CHECK_EQ(actual.e01(), approx(expected.e01()));
+    CHECK_EQ(actual.e02(), approx(expected.e02()));
+    CHECK_EQ(actual.e03(), approx(expected.e03()));
+    CHECK_EQ(actual.e0123(), approx(expected.e0123()));
+}
+} // namespace
+
+TEST_CASE("motor-interpolation")
+{
+    rotor r1{M_PI * 0.5f, 0, 0, 1.f};
+    translator t1{1.f, 0.f, 0.f, 1.f};
+    motor m1 = r1 * t1;
+
+    rotor r2{M_PI * 0.5f, 0.3f, -3.f, 1.f};
+    translator t2{12.f, -2.f, 0.4f, 1.f};
+    motor m2 = r2 * t2;
+
+    check_motor(m1, sclerp(m1, m2, 0.f));
+    check_motor(m2, sclerp(m1, m2, 1.f));
+    check_motor(exp(log(m2 * ~m1) * 0.3f) * m1, sclerp(m1, m2, 0.3f));
+
+    // Both representations of the end motor produce the same path
+    check_motor(sclerp(m1, m2, 0.6f), sclerp(m1, -m2, 0.6f));
+    check_motor(m1, sclerp(m1, m1, 0.5f));
+    check_motor(m1, nlerp(m1, m2, 0.f));
+    check_motor(m2, nlerp(m1, -m2, 1.f));
+
+    // Pure translations interpolate linearly
+    motor pure{_mm_set_ss(1.f), t2.p2_};
+    check_motor(motor{_mm_set_ss(1.f), (t2 * 0.25f).p2_},
+                sclerp(motor{r1} * ~motor{r1}, pure, 0.25f));
+
+    motor_interpolant blend{m1, m2};
+    check_motor(sclerp(m1, m2, 0.7f), blend(0.7f));
+
+    float t[9];
+    motor samples[9];
+    for (size_t i = 0; i != 9; ++i)
+    {
+        t[i] = static_cast<float>(i) / 8.f;
+    }
+    blend(t, samples, 9);
+    for (size_t i = 0; i != 9; ++i)
+    {
+        check_motor(blend(t[i]), samples[i]);
+    }
+
+    // Pose blending across more than one internal block
+    constexpr size_t count = 70;
+    motor a[count];
+    motor b[count];
+    motor sc[count];
+    motor nl[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float f = static_cast<float>(i);
+        a[i]    = rotor{0.1f * f, 1.f, 0.f, 0.5f} * t1;
+        b[i]    = rotor{0.2f + 0.05f * f, 0.3f, -1.f, 1.f} * t2;
+    }
+    sclerp(a, b, 0.4f, sc, count);
+    nlerp(a, b, 0.4f, nl, count);
+    for (size_t i = 0; i != count; ++i)
+    {
+        check_motor(sclerp(a[i], b[i], 0.4f), sc[i]);
+        check_motor(nlerp(a[i], b[i], 0.4f), nl[i]);
+    }
+}
+
+TEST_CASE("motor-spline")
+{
+    constexpr size_t key_count = 6;
+    motor keys[key_count];
+    for (size_t k = 0; k != key_count; ++k)
+    {
+        float f = static_cast<float>(k);
+        keys[k] = rotor{0.4f * f, 0.3f, 1.f, -0.5f + 0.2f * f}
+                  * translator{1.f + f, 1.f, -f, 0.5f};
+    }
+
+    line omega[key_count - 1];
+    motor_spline catmull_rom{keys, key_count, omega};
+    CHECK_EQ(catmull_rom.duration(), 5.f);
+
+    // The Catmull-Rom spline interpolates the keys
+    for (size_t k = 0; k != key_count; ++k)
+    {
+        check_motor(keys[k], catmull_rom(static_cast<float>(k)));
+    }
+    check_motor(keys[0], catmull_rom(-1.f));
+
+    line b_omega[key_count - 1];
+    motor_spline b_spline{keys, key_count, b_omega, spline_basis::b_spline};
+
+    // Both curves are continuous across segment boundaries
+    for (size_t k = 1; k + 1 != key_count; ++k)
+    {
+        float f = static_cast<float>(k);
+        check_motor(catmull_rom(f - 1e-4f), catmull_rom(f + 1e-4f), 1e-3);
+        check_motor(b_spline(f - 1e-4f), b_spline(f + 1e-4f), 1e-3);
+    }
+
+    float t[41];
+    motor samples[41];
+    for (size_t i = 0; i != 41; ++i)
+    {
+        t[i] = static_cast<float>(i) * 0.125f;
+    }
+    catmull_rom(t, samples, 41);
+    for (size_t i = 0; i != 41; ++i)
+    {
+        check_motor(catmull_rom(t[i]), samples[i]);
+    }
+    b_spline(t, samples, 41);
+    for (size_t i = 0; i != 41; ++i)
+    {
+        check_motor(b_spline(t[i]), samples[i]);
+    }
+}
@@ -0,0 +1,155 @@
+#define _USE_MATH_DEFINES
+#include <doctest/doctest.h>
+
+#include <klein/klein.hpp>
+
+#ifdef KLN_ENABLE_ISE_AVX2
+#    include <klein/f64.hpp>
+
+#    include <cmath>
+
+using namespace kln;
+
+namespace
+{
+bool approx_eq(point a, point b, float epsilon)
+{
+    return std::abs(a.w() - b.w()) < epsilon
+           && std::abs(a.x() - b.x()) < epsilon
+           && std::abs(a.y() - b.y()) < epsilon
+           && std::abs(a.z() - b.z()) < epsilon;
+}
+
+bool approx_eq(plane a, plane b, float epsilon)
+{
+    return std::abs(a.e0() - b.e0()) < epsilon
+           && std::abs(a.e1() - b.e1()) < epsilon
+           && std::abs(a.e2() - b.e2()) < epsilon
+           && std::abs(a.e3() - b.e3()) < epsilon;
+}
+} // namespace
+
+TEST_CASE("f64-conversion")
+{
+    motor m = translator{2.f, 1.f, -1.f, 0.5f} * rotor{0.7f, 1.f, 2.f, -1.f};
+    d::motor dm{m};
+    CHECK_EQ(dm.scalar(), static_cast<double>(m.scalar()));
+    CHECK_EQ(dm.e12(), static_cast<double>(m.e12()));
+    CHECK_EQ(dm.e02(), static_cast<double>(m.e02()));
+    CHECK_EQ(dm.e0123(), static_cast<double>(m.e0123()));
+
+    // Floats round trip exactly
+    motor back = dm.as_float();
+    CHECK_EQ(back, m);
+
+    d::point p{1.0 / 3.0, -2.0, 0.1};
+    point q = p.as_float();
+    CHECK_EQ(q.x(), 1.f / 3.f);
+    CHECK_EQ(q.z(), 0.1f);
+    CHECK_EQ(d::point{q}.y(), -2.0);
+}
+
+TEST_CASE("f64-matches-float")
+{
+    rotor r{1.1f, 1.f, -2.f, 0.5f};
+    translator t{3.f, -1.f, 0.f, 2.f};
+    motor m1 = t * r;
+    motor m2 = r * t;
+    motor m3 = m1 * m2;
+    line l{1.f, -2.f, 0.5f, 3.f, 1.f, -1.f};
+
+    d::rotor dr{r};
+    d::translator dt{t};
+    d::motor dm1 = dt * dr;
+    d::motor dm2 = dr * dt;
+    d::motor dm3 = dm1 * dm2;
+    d::line dl{l};
+
+    constexpr float eps = 1e-5f;
+    CHECK(dm1.as_float().approx_eq(m1, eps));
+    CHECK(dm2.as_float().approx_eq(m2, eps));
+    CHECK(dm3.as_float().approx_eq(m3, eps));
+    CHECK((dr * dm1).as_float().approx_eq(r * m1, eps));
+    CHECK((dm1 * dr).as_float().approx_eq(m1 * r, eps));
+    CHECK((dt * dm2).as_float().approx_eq(t * m2, eps));
+    CHECK((dm2 * dt).as_float().approx_eq(m2 * t, eps));
+    CHECK(motor{(dr * dr).as_float()}.approx_eq(motor{r * r}, eps));
+    CHECK((dl * dl).as_float().approx_eq(l * l, 1e-4f));
+    CHECK(dm3.inverse().as_float().approx_eq(m3.inverse(), eps));
+    CHECK((~dm3).as_float().approx_eq(~m3, eps));
+
+    point p{1.f, -3.f, 2.f};
+    CHECK(approx_eq(dm3(d::point{p}).as_float(), m3(p), 1e-4f));
+    CHECK(approx_eq(dr(d::point{p}).as_float(), r(p), eps));
+    CHECK(approx_eq(dt(d::point{p}).as_float(), t(p), eps));
+    CHECK(approx_eq(dm3(origin{}).as_float(), m3(origin{}), 1e-4f));
+
+    plane pl{1.f, 2.f, -1.f, 4.f};
+    CHECK(approx_eq(dm3(d::plane{pl}).as_float(), m3(pl), 1e-4f));
+    CHECK(approx_eq(dr(d::plane{pl}).as_float(), r(pl), eps));
+    CHECK(approx_eq(dt(d::plane{pl}).as_float(), t(pl), 1e-4f));
+
+    CHECK(dm3(dl).as_float().approx_eq(m3(l), 1e-4f));
+    CHECK(dr(dl).as_float().approx_eq(r(l), 1e-4f));
+    CHECK(dt(dl).as_float().approx_eq(t(l), 1e-4f));
+
+    direction dir{1.f, 1.f, -2.f};
+    direction rotated = dm3(d::direction{dir}).as_float();
+    direction expected = m3(dir);
+    CHECK_EQ(rotated.x(), doctest::Approx(expected.x()));
+    CHECK_EQ(rotated.y(), doctest::Approx(expected.y()));
+    CHECK_EQ(rotated.z(), doctest::Approx(expected.z()));
+
+    CHECK(d::log(dm3).as_float().approx_eq(log(m3), 1e-4f));
+    CHECK(d::exp(dl).as_float().approx_eq(exp(l), 1e-4f));
+}
+
+TEST_CASE("f64-exp-log")
+{
+    d::motor m = d::translator{5.0, 1.0, 2.0, -1.0}
+                 * d::rotor{2.5, -1.0, 0.5, 1.0};
+    d::motor round_trip = d::exp(d::log(m));
+    CHECK(round_trip.approx_eq(m, 1e-13));
+
+    // Pure translations take the ideal branch
+    d::translator t{4.0, 0.0, 1.0, 0.0};
+    d::line lt = d::log(d::motor{t});
+    CHECK_EQ(lt.e02(), doctest::Approx(t.e02()));
+    CHECK(d::exp(lt).approx_eq(d::motor{t}, 1e-15));
+
+    // Screw motion about an axis
+    d::line axis{0.0, 0.0, 0.0, 0.0, 0.0, 1.0};
+    d::motor screw{M_PI / 2.0, 3.0, axis};
+    d::point p = screw(d::point{1.0, 0.0, 0.0});
+    CHECK_EQ(p.x(), doctest::Approx(0.0));
+    CHECK_EQ(std::abs(p.y()), doctest::Approx(1.0));
+    CHECK_EQ(std::abs(p.z()), doctest::Approx(3.0));
+}
+
+TEST_CASE("f64-drift")
+{
+    // Integrate a small screw motion many times. In double precision, the
+    // accumulated motor stays normalized and matches the closed form result
+    // to about 1e-11.
+    constexpr size_t steps = 100000;
+    d::line velocity{0.3, -0.1, 0.2, 0.5, -1.0, 0.25};
+    d::line step_log = velocity * (1.0 / steps);
+    d::motor step    = d::exp(step_log);
+
+    d::motor pose{d::rotor{0.0, 0.0, 0.0, 1.0}};
+    for (size_t i = 0; i != steps; ++i)
+    {
+        pose = step * pose;
+    }
+
+    d::motor expected = d::exp(velocity);
+    CHECK(pose.approx_eq(expected, 1e-9));
+
+    d::motor unit = pose * ~pose;
+    CHECK_LT(std::abs(unit.scalar() - 1.0), 1e-10);
+    CHECK_LT(std::abs(unit.e0123()), 1e-10);
+
+    d::motor n = pose.normalized();
+    CHECK(n.approx_eq(pose, 1e-10));
+}
+#endif
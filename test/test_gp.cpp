@@ -307,4 +307,79 @@ TEST_CASE("multivector-gp")
         CHECK_EQ(m2.e03(), doctest::Approx(0.f));
         CHECK_EQ(m2.e0123(), doctest::Approx(0.f));
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("forward-kinematics")
+{
+    // Three roots, chains, and fan-outs stored depth-first so that groups of
+    // every width (and the scalar fallback) are exercised.
+    constexpr size_t count = 61;
+    uint16_t parent[count];
+    uint8_t offset[count];
+    motor local[count];
+    for (size_t j = 0; j != count; ++j)
+    {
+        size_t root = j - j % 20;
+        size_t back = j % 7 == 0 ? 1 : 1 + j % 3;
+        size_t p    = j - std::min(back, j - root);
+        parent[j] = static_cast<uint16_t>(p);
+        offset[j] = static_cast<uint8_t>(j - p);
+
+        float f  = static_cast<float>(j);
+        local[j] = rotor{0.1f * f, 1.f, -0.5f, 0.3f + 0.01f * f}
+                   * translator{0.2f, 1.f, f * 0.1f, -1.f};
+    }
+
+    motor expected[count];
+    for (size_t j = 0; j != count; ++j)
+    {
+        expected[j] = parent[j] == j ? local[j] : expected[parent[j]] * local[j];
+    }
+
+    auto check = [&](motor const* world) {
+        for (size_t j = 0; j != count; ++j)
+        {
+            for (size_t k = 0; k != 4; ++k)
+            {
+                float e1[4];
+                float e2[4];
+                float w1[4];
+                float w2[4];
+                _mm_storeu_ps(e1, expected[j].p1_);
+                _mm_storeu_ps(e2, expected[j].p2_);
+                _mm_storeu_ps(w1, world[j].p1_);
+                _mm_storeu_ps(w2, world[j].p2_);
+                CHECK_EQ(w1[k], doctest::Approx(e1[k]).epsilon(1e-4));
+                CHECK_EQ(w2[k], doctest::Approx(e2[k]).epsilon(1e-4));
+            }
+        }
+    };
+
+    motor world[count];
+    forward_kinematics(local, parent, world, count);
+    check(world);
+
+    motor world_offset[count];
+    forward_kinematics(local, offset, world_offset, count);
+    check(world_offset);
+
+    // Evaluate the first tree, then the remaining trees as separate ranges
+    motor world_range[count];
+    forward_kinematics(local, parent, world_range, 0, 20);
+    forward_kinematics(local, parent, world_range, 40, count);
+    forward_kinematics(local, parent, world_range, 20, 40);
+    check(world_range);
+
+    uint16_t order[count];
+    uint16_t depth[count];
+    size_t levels = level_order(parent, count, order, depth);
+    CHECK_GT(levels, 1u);
+    for (size_t i = 1; i != count; ++i)
+    {
+        CHECK_LE(depth[order[i - 1]], depth[order[i]]);
+    }
+
+    motor world_ordered[count];
+    forward_kinematics(local, parent, order, world_ordered, count);
+    check(world_ordered);
+}
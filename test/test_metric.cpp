@@ -40,4 +40,231 @@ TEST_CASE("measure-point-to-line")
     point p{0, 1, 2};
     float distance = plane{l & p}.norm();
     CHECK_EQ(distance, doctest::Approx(std::sqrt(2.f)));
-}
\ No newline at end of file
+}
+
+TEST_CASE("plane-set-culling")
+{
+    // Inward facing planes of the box [-1, 1] x [-1, 2] x [-1, 1], some of
+    // them not normalized
+    plane box[6] = {{2.f, 0.f, 0.f, 2.f},
+                    {-1.f, 0.f, 0.f, 1.f},
+                    {0.f, 1.f, 0.f, 1.f},
+                    {0.f, -3.f, 0.f, 6.f},
+                    {0.f, 0.f, 1.f, 1.f},
+                    {0.f, 0.f, -1.f, 1.f}};
+    plane_set planes{box, 6};
+    CHECK_EQ(planes.size(), 6u);
+
+    constexpr size_t count = 37;
+    point centers[count];
+    float radii[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float t    = static_cast<float>(i);
+        centers[i] = point{2.5f * std::sin(t * 1.3f),
+                           3.f * std::cos(t * 0.7f),
+                           1.5f * std::sin(t * 2.9f + 1.f)};
+        radii[i]   = 0.1f + 0.05f * static_cast<float>(i % 11);
+    }
+
+    uint32_t outside[count];
+    uint32_t inside[count];
+    planes.classify(centers, radii, outside, inside, count);
+
+    uint32_t point_outside[count];
+    planes.classify(centers, point_outside, nullptr, count);
+
+    uint32_t visible[count];
+    size_t visible_count = planes.cull(centers, radii, visible, count);
+    uint32_t visible_points[count];
+    size_t visible_point_count = planes.cull(centers, visible_points, count);
+
+    size_t expected_visible       = 0;
+    size_t expected_visible_point = 0;
+    for (size_t i = 0; i != count; ++i)
+    {
+        uint32_t out   = 0;
+        uint32_t in    = 0;
+        uint32_t p_out = 0;
+        for (size_t k = 0; k != 6; ++k)
+        {
+            float d = (box[k].normalized() ^ centers[i]).e0123();
+            out |= d < -radii[i] ? 1u << k : 0u;
+            in |= d > radii[i] ? 1u << k : 0u;
+            p_out |= d < 0.f ? 1u << k : 0u;
+        }
+        CHECK_EQ(outside[i], out);
+        CHECK_EQ(inside[i], in);
+        CHECK_EQ(point_outside[i], p_out);
+
+        if (out == 0)
+        {
+            REQUIRE_LT(expected_visible, visible_count);
+            CHECK_EQ(visible[expected_visible++], i);
+        }
+        if (p_out == 0)
+        {
+            REQUIRE_LT(expected_visible_point, visible_point_count);
+            CHECK_EQ(visible_points[expected_visible_point++], i);
+        }
+    }
+    CHECK_EQ(expected_visible, visible_count);
+    CHECK_EQ(expected_visible_point, visible_point_count);
+    CHECK_GT(visible_count, 0u);
+    CHECK_LT(visible_count, count);
+}
+
+TEST_CASE("plane-set-offsets")
+{
+    // The plane y = 2 facing -y, scaled by 3. The stored plane must be scaled
+    // as a whole, offset included.
+    plane top{0.f, -3.f, 0.f, 6.f};
+    plane_set planes{&top, 1};
+    CHECK_EQ(planes[0].y(), doctest::Approx(-1.f));
+    CHECK_EQ(planes[0].d(), doctest::Approx(2.f));
+
+    point centers[4] = {{0.f, 1.5f, 0.f},
+                        {1.f, 1.95f, -1.f},
+                        {-2.f, 2.25f, 3.f},
+                        {0.f, 2.5f, 0.f}};
+    float radii[4]   = {0.3f, 0.3f, 0.3f, 0.3f};
+    uint32_t outside[4];
+    uint32_t inside[4];
+    planes.classify(centers, radii, outside, inside, 4);
+    CHECK_EQ(inside[0], 1u);
+    CHECK_EQ(outside[0], 0u);
+    CHECK_EQ(inside[1], 0u);
+    CHECK_EQ(outside[1], 0u);
+    CHECK_EQ(inside[2], 0u);
+    CHECK_EQ(outside[2], 0u);
+    CHECK_EQ(inside[3], 0u);
+    CHECK_EQ(outside[3], 1u);
+
+    uint32_t point_outside[4];
+    planes.classify(centers, point_outside, nullptr, 4);
+    CHECK_EQ(point_outside[1], 0u);
+    CHECK_EQ(point_outside[2], 1u);
+
+    // Planes past max_planes are dropped
+    plane many[plane_set::max_planes + 8];
+    for (plane& pl : many)
+    {
+        pl = top;
+    }
+    plane_set clamped{many, plane_set::max_planes + 8};
+    CHECK_EQ(clamped.size(), plane_set::max_planes);
+}
+
+namespace
+{
+// Reference distance between the line through a0, a1 and the line through
+// b0, b1
+float line_distance(float const* a0,
+                    float const* a1,
+                    float const* b0,
+                    float const* b1)
+{
+    float u[3];
+    float v[3];
+    float w[3];
+    for (size_t i = 0; i != 3; ++i)
+    {
+        u[i] = a1[i] - a0[i];
+        v[i] = b1[i] - b0[i];
+        w[i] = b0[i] - a0[i];
+    }
+    float c[3] = {u[1] * v[2] - u[2] * v[1],
+                  u[2] * v[0] - u[0] * v[2],
+                  u[0] * v[1] - u[1] * v[0]};
+    float c2   = c[0] * c[0] + c[1] * c[1] + c[2] * c[2];
+    float n    = std::abs(c[0] * w[0] + c[1] * w[1] + c[2] * w[2]);
+    return n / std::sqrt(c2);
+}
+} // namespace
+
+TEST_CASE("batch-distance")
+{
+    constexpr size_t count = 19;
+    float p[count][3];
+    float q[count][3];
+    float r[count][3];
+    float s[count][3];
+    point points[count];
+    line lines[count];
+    line others[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float t   = static_cast<float>(i);
+        p[i][0]   = std::sin(t);
+        p[i][1]   = 2.f * std::cos(t * 0.3f);
+        p[i][2]   = t * 0.25f;
+        q[i][0]   = std::cos(t * 1.7f);
+        q[i][1]   = -t * 0.1f;
+        q[i][2]   = 1.f;
+        r[i][0]   = -std::cos(t);
+        r[i][1]   = 1.f + std::sin(t * 0.4f);
+        r[i][2]   = -1.f;
+        s[i][0]   = 0.5f * t - 2.f;
+        s[i][1]   = std::cos(t * 0.9f);
+        s[i][2]   = 2.f + std::sin(t);
+        points[i] = point{p[i][0], p[i][1], p[i][2]};
+        point pq{q[i][0], q[i][1], q[i][2]};
+        point pr{r[i][0], r[i][1], r[i][2]};
+        point ps{s[i][0], s[i][1], s[i][2]};
+        lines[i] = points[i] & pq;
+        // Skew to lines[i], at a nonzero distance
+        others[i] = (pr & ps) * (1.f + t);
+    }
+
+    // A pair of parallel lines
+    others[3] = point{p[3][0], p[3][1], p[3][2] + 2.f}
+                & point{q[3][0], q[3][1], q[3][2] + 2.f};
+
+    float out[count];
+
+    plane pl{1.f, -2.f, 0.5f, 3.f};
+    distance(points, pl, out, count);
+    for (size_t i = 0; i != count; ++i)
+    {
+        float expected = (pl.normalized() ^ points[i]).e0123();
+        CHECK_EQ(out[i], doctest::Approx(expected).epsilon(1e-5f));
+    }
+
+    line l = point{1.f, 2.f, 3.f} & point{-1.f, 0.f, 4.f};
+    distance(points, l, out, count);
+    for (size_t i = 0; i != count; ++i)
+    {
+        // Norm of the plane through the point and the line
+        float expected = (points[i] & l).norm() / l.norm();
+        CHECK_EQ(out[i], doctest::Approx(expected).epsilon(1e-5f));
+    }
+
+    float l0[3] = {1.f, 2.f, 3.f};
+    float l1[3] = {-1.f, 0.f, 4.f};
+    distance(lines, l, out, count);
+    for (size_t i = 0; i != count; ++i)
+    {
+        float expected = line_distance(p[i], q[i], l0, l1);
+        CHECK_EQ(out[i], doctest::Approx(expected).epsilon(1e-4f));
+    }
+
+    distance(lines, others, out, count);
+    {
+        // |(0, 0, 2) x u| / |u| for the direction u of the parallel lines
+        float u[3]     = {q[3][0] - p[3][0],
+                          q[3][1] - p[3][1],
+                          q[3][2] - p[3][2]};
+        float expected = 2.f * std::sqrt(u[0] * u[0] + u[1] * u[1])
+                         / std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+        CHECK_EQ(out[3], doctest::Approx(expected).epsilon(1e-5f));
+    }
+    for (size_t i = 0; i != count; ++i)
+    {
+        if (i != 3)
+        {
+            float expected = line_distance(p[i], q[i], r[i], s[i]);
+            CHECK_GT(expected, 0.1f);
+            CHECK_EQ(out[i], doctest::Approx(expected).epsilon(1e-4f));
+        }
+    }
+}
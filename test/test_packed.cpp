@@ -0,0 +1,137 @@
+#define _USE_MATH_DEFINES
+#include <doctest/doctest.h>
+
+#include <klein/klein.hpp>
+
+#include <cmath>
+#include <limits>
+
+using namespace kln;
+
+TEST_CASE("packed-point")
+{
+    CHECK_EQ(sizeof(point_f16), 8);
+
+    // Representable values are exact
+    point p{1.5f, -2.f, 0.25f};
+    point_f16 h = pack(p);
+    CHECK_EQ(h.data[0], 0x3c00);
+    point q = unpack(h);
+    CHECK_EQ(q.w(), 1.f);
+    CHECK_EQ(q.x(), 1.5f);
+    CHECK_EQ(q.y(), -2.f);
+    CHECK_EQ(q.z(), 0.25f);
+
+    // Rounding to nearest even, overflow, and denormals
+    point r{1.f + 1.f / 2048.f, 1e5f, 1e-6f};
+    q = unpack(pack(r));
+    CHECK_EQ(q.x(), 1.f);
+    CHECK_EQ(q.y(), std::numeric_limits<float>::infinity());
+    CHECK_EQ(q.z(), doctest::Approx(1e-6f).epsilon(0.03f));
+
+    // The batch routines match the single ones
+    constexpr size_t count = 13;
+    point points[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float f   = static_cast<float>(i);
+        points[i] = point{f * 3.7f, -f, 100.f / (f + 1.f)};
+    }
+    point_f16 packed[count];
+    point unpacked[count];
+    pack(points, packed, count);
+    unpack(packed, unpacked, count);
+    for (size_t i = 0; i != count; ++i)
+    {
+        point_f16 expected = pack(points[i]);
+        for (size_t j = 0; j != 4; ++j)
+        {
+            CHECK_EQ(packed[i].data[j], expected.data[j]);
+        }
+        CHECK_EQ(unpacked[i].x(),
+                 doctest::Approx(points[i].x()).epsilon(1e-3));
+        CHECK_EQ(unpacked[i].y(),
+                 doctest::Approx(points[i].y()).epsilon(1e-3));
+        CHECK_EQ(unpacked[i].z(),
+                 doctest::Approx(points[i].z()).epsilon(1e-3));
+    }
+}
+
+TEST_CASE("packed-plane")
+{
+    CHECK_EQ(sizeof(plane_snorm), 8);
+
+    constexpr float extent = 10.f;
+    plane p{1.f, 2.f, -2.f, 3.f};
+    plane n = p.normalized();
+    plane q = unpack(pack(p, extent), extent);
+    CHECK_EQ(q.x(), doctest::Approx(n.x()).epsilon(1e-4));
+    CHECK_EQ(q.y(), doctest::Approx(n.y()).epsilon(1e-4));
+    CHECK_EQ(q.z(), doctest::Approx(n.z()).epsilon(1e-4));
+    CHECK_EQ(q.d(), doctest::Approx(n.d()).epsilon(1e-3));
+
+    // The distance saturates at the extent
+    q = unpack(pack(plane{0.f, 0.f, 1.f, -50.f}, extent), extent);
+    CHECK_EQ(q.d(), doctest::Approx(-extent));
+
+    constexpr size_t count = 11;
+    plane planes[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float f   = static_cast<float>(i);
+        planes[i] = plane{1.f, -f, 0.5f * f, f - 5.f};
+    }
+    plane_snorm packed[count];
+    plane unpacked[count];
+    pack(planes, packed, count, extent);
+    unpack(packed, unpacked, count, extent);
+    for (size_t i = 0; i != count; ++i)
+    {
+        plane expected = unpack(pack(planes[i], extent), extent);
+        CHECK_EQ(unpacked[i].e0(), expected.e0());
+        CHECK_EQ(unpacked[i].e1(), expected.e1());
+        CHECK_EQ(unpacked[i].e2(), expected.e2());
+        CHECK_EQ(unpacked[i].e3(), expected.e3());
+    }
+}
+
+TEST_CASE("packed-motor")
+{
+    CHECK_EQ(sizeof(motor_q16), 16);
+
+    constexpr float extent = 16.f;
+    constexpr size_t count = 9;
+    motor motors[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float f   = static_cast<float>(i);
+        motors[i] = translator{1.f + f, 1.f, -2.f, 0.5f}
+                    * rotor{0.3f * f - 1.f, f, 1.f, -1.f};
+    }
+    motor_q16 packed[count];
+    motor unpacked[count];
+    pack(motors, packed, count, extent);
+    unpack(packed, unpacked, count, extent);
+
+    point p{1.f, -3.f, 2.f};
+    for (size_t i = 0; i != count; ++i)
+    {
+        CHECK_EQ(packed[i].translation[0], 0);
+
+        point expected = motors[i](p);
+        point actual   = unpacked[i](p);
+        CHECK_EQ(actual.x(), doctest::Approx(expected.x()).epsilon(1e-3));
+        CHECK_EQ(actual.y(), doctest::Approx(expected.y()).epsilon(1e-3));
+        CHECK_EQ(actual.z(), doctest::Approx(expected.z()).epsilon(1e-3));
+
+        motor single = unpack(pack(motors[i], extent), extent);
+        CHECK_EQ(unpacked[i].scalar(), single.scalar());
+        CHECK_EQ(unpacked[i].e01(), single.e01());
+        CHECK_EQ(unpacked[i].e0123(), single.e0123());
+    }
+
+    // Translations beyond the extent are clamped per axis
+    motor far   = translator{40.f, 1.f, 0.f, 0.f} * rotor{0.5f, 0.f, 0.f, 1.f};
+    point moved = unpack(pack(far, extent), extent)(origin{});
+    CHECK_EQ(moved.x(), doctest::Approx(extent).epsilon(1e-3));
+}
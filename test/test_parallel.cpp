@@ -0,0 +1,251 @@
+#define _USE_MATH_DEFINES
+#include <doctest/doctest.h>
+
+#include <klein/klein.hpp>
+#include <klein/parallel.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+using namespace kln;
+
+TEST_CASE("parallel-chunks")
+{
+    parallel::thread_pool pool{4};
+    CHECK_EQ(pool.size(), 4u);
+
+    parallel::policy p;
+    p.pool      = &pool;
+    p.grain     = 10;
+    p.threshold = 0;
+
+    // Offset the data so that the first chunk is shortened to reach a cache
+    // line boundary
+    std::vector<point> storage(1001);
+    point* data       = storage.data() + 1;
+    size_t count      = 999;
+    size_t chunk_size = 16; // The grain rounded up to a multiple of eight
+
+    // The chunks are processed on several threads, so violations are
+    // counted rather than checked where they occur
+    std::vector<std::atomic<int>> visits(count);
+    std::atomic<size_t> chunks{0};
+    std::atomic<size_t> bad_chunks{0};
+    parallel::for_each_chunk(
+        data,
+        count,
+        [&](size_t begin, size_t end) {
+            bool aligned = end == count
+                           || reinterpret_cast<uintptr_t>(data + end) % 64 == 0;
+            if (begin >= end || end - begin > chunk_size || !aligned)
+            {
+                bad_chunks.fetch_add(1);
+            }
+            for (size_t i = begin; i != end; ++i)
+            {
+                visits[i].fetch_add(1);
+            }
+            chunks.fetch_add(1);
+        },
+        p);
+
+    for (size_t i = 0; i != count; ++i)
+    {
+        CHECK_EQ(visits[i].load(), 1);
+    }
+    CHECK_EQ(bad_chunks.load(), 0u);
+    CHECK_GE(chunks.load(), count / chunk_size);
+
+    // A batch submitted from within a chunk runs serially
+    std::atomic<size_t> nested{0};
+    pool.run(8, [&](size_t) {
+        pool.run(4, [&](size_t) { nested.fetch_add(1); });
+    });
+    CHECK_EQ(nested.load(), 32u);
+
+    // Below the threshold, the caller processes the batch in one piece
+    p.threshold = count + 1;
+    chunks      = 0;
+    parallel::for_each_chunk(
+        data,
+        count,
+        [&](size_t begin, size_t end) {
+            CHECK_EQ(begin, 0u);
+            CHECK_EQ(end, count);
+            chunks.fetch_add(1);
+        },
+        p);
+    CHECK_EQ(chunks.load(), 1u);
+}
+
+TEST_CASE("parallel-batches")
+{
+    parallel::thread_pool pool{3};
+    parallel::policy p;
+    p.pool      = &pool;
+    p.grain     = 64;
+    p.threshold = 100;
+
+    constexpr size_t count = 1003;
+    std::vector<motor> motors(count);
+    std::vector<point> points(count);
+    std::vector<uint32_t> index(count);
+    for (size_t i = 0; i != count; ++i)
+    {
+        float f    = static_cast<float>(i % 17);
+        motors[i] = rotor{0.1f * f, 1.f, -f, 2.f}
+                    * translator{1.f + f, 0.f, 1.f, -1.f};
+        points[i] = point{f, 2.f - f, 1.f + 2.f * f};
+        index[i]  = static_cast<uint32_t>((i * 7) % count);
+    }
+
+    motor m = motors[5];
+    std::vector<point> expected(count);
+    std::vector<point> out(count);
+
+    SUBCASE("apply")
+    {
+        m(points.data(), expected.data(), count);
+        parallel::apply(m, points.data(), out.data(), count, p);
+        for (size_t i = 0; i != count; ++i)
+        {
+            CHECK_EQ(out[i].x(), expected[i].x());
+            CHECK_EQ(out[i].y(), expected[i].y());
+            CHECK_EQ(out[i].z(), expected[i].z());
+        }
+
+        // With the non-temporal batch routines
+        p.stream = true;
+        parallel::apply(m, points.data(), out.data(), count, p);
+        for (size_t i = 0; i != count; ++i)
+        {
+            CHECK_EQ(out[i].x(), expected[i].x());
+            CHECK_EQ(out[i].z(), expected[i].z());
+        }
+
+        // In place, with the default pool
+        parallel::policy d;
+        d.threshold = 100;
+        parallel::apply(m, points.data(), points.data(), count, d);
+        for (size_t i = 0; i != count; ++i)
+        {
+            CHECK_EQ(points[i].x(), expected[i].x());
+            CHECK_EQ(points[i].y(), expected[i].y());
+            CHECK_EQ(points[i].z(), expected[i].z());
+        }
+    }
+
+    SUBCASE("transform")
+    {
+        parallel::transform(
+            motors.data(), points.data(), out.data(), count, p);
+        for (size_t i = 0; i != count; ++i)
+        {
+            point q = motors[i](points[i]);
+            CHECK_EQ(out[i].x(), doctest::Approx(q.x()));
+            CHECK_EQ(out[i].y(), doctest::Approx(q.y()));
+            CHECK_EQ(out[i].z(), doctest::Approx(q.z()));
+        }
+
+        parallel::transform(
+            motors.data(), index.data(), points.data(), out.data(), count, p);
+        for (size_t i = 0; i != count; ++i)
+        {
+            point q = motors[index[i]](points[i]);
+            CHECK_EQ(out[i].x(), doctest::Approx(q.x()));
+            CHECK_EQ(out[i].y(), doctest::Approx(q.y()));
+            CHECK_EQ(out[i].z(), doctest::Approx(q.z()));
+        }
+    }
+
+    SUBCASE("normalize-exp-log")
+    {
+        std::vector<motor> normalized = motors;
+        for (motor& x : normalized)
+        {
+            x = x * 3.f;
+        }
+        parallel::normalize(normalized.data(), count, p);
+        for (size_t i = 0; i != count; ++i)
+        {
+            motor n = (motors[i] * 3.f).normalized();
+            CHECK_EQ(normalized[i].scalar(), n.scalar());
+            CHECK_EQ(normalized[i].e0123(), n.e0123());
+        }
+
+        std::vector<line> logs(count);
+        std::vector<line> expected_logs(count);
+        std::vector<motor> exps(count);
+        std::vector<motor> expected_exps(count);
+        kln::log(motors.data(), expected_logs.data(), count);
+        parallel::log(motors.data(), logs.data(), count, p);
+        kln::exp(logs.data(), expected_exps.data(), count);
+        parallel::exp(logs.data(), exps.data(), count, p);
+        // The first chunk's length depends on the alignment of the data, so
+        // an entity may be handled by a narrower kernel than in the serial
+        // call
+        for (size_t i = 0; i != count; ++i)
+        {
+            CHECK_EQ(logs[i].e12(), doctest::Approx(expected_logs[i].e12()));
+            CHECK_EQ(logs[i].e01(), doctest::Approx(expected_logs[i].e01()));
+            CHECK_EQ(exps[i].scalar(),
+                     doctest::Approx(expected_exps[i].scalar()));
+            CHECK_EQ(exps[i].e03(), doctest::Approx(expected_exps[i].e03()));
+        }
+    }
+}
+
+TEST_CASE("bvh-parallel-build")
+{
+    // Enough boxes for the builder to split the top levels across threads
+    constexpr size_t count = 5 * bvh::parallel_threshold;
+    std::vector<bounding_box> boxes(count);
+    for (size_t i = 0; i != count; ++i)
+    {
+        float t    = static_cast<float>(i);
+        float c[3] = {20.f * std::sin(t * 0.013f),
+                      15.f * std::cos(t * 0.0071f),
+                      10.f * std::sin(t * 0.29f + 1.f)};
+        float r    = 0.1f + 0.05f * std::abs(std::sin(t));
+        boxes[i]   = {{c[0] - r, c[1] - r, c[2] - r},
+                    {c[0] + r, c[1] + r, c[2] + r}};
+    }
+
+    std::vector<bvh_node> serial_nodes(bvh::node_capacity(count));
+    std::vector<uint32_t> serial_order(count);
+    bvh serial{boxes.data(), count, serial_nodes.data(), serial_order.data()};
+
+    parallel::thread_pool pool{4};
+    std::vector<bvh_node> nodes(bvh::node_capacity(count));
+    std::vector<uint32_t> order(count);
+    bvh tree{boxes.data(), count, nodes.data(), order.data(), &pool};
+
+    // The hierarchy does not depend on the number of threads
+    REQUIRE_EQ(tree.node_count(), serial.node_count());
+    CHECK_LT(tree.node_count(), bvh::node_capacity(count));
+    CHECK(order == serial_order);
+    size_t mismatches = 0;
+    size_t leaves     = 0;
+    for (size_t i = 0; i != tree.node_count(); ++i)
+    {
+        bvh_node const& a = nodes[i];
+        bvh_node const& b = serial_nodes[i];
+        bool same         = a.offset == b.offset && a.count == b.count;
+        for (size_t k = 0; k != 3; ++k)
+        {
+            same = same && a.min[k] == b.min[k] && a.max[k] == b.max[k];
+        }
+        mismatches += same ? 0 : 1;
+        leaves += a.is_leaf() ? a.count : 0;
+
+        // Second children follow the nodes of the first child's subtree
+        if (!a.is_leaf())
+        {
+            CHECK_GT(a.offset, i + 1);
+            CHECK_LT(a.offset, tree.node_count());
+        }
+    }
+    CHECK_EQ(mismatches, 0u);
+    CHECK_EQ(leaves, count);
+}
@@ -0,0 +1,354 @@
+#include <doctest/doctest.h>
+
+#include <klein/klein.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace kln;
+
+namespace
+{
+// Reference Möller-Trumbore intersection, returning the ray parameter or
+// infinity
+float moller_trumbore(float const* o,
+                      float const* d,
+                      float const* a,
+                      float const* b,
+                      float const* c)
+{
+    float e1[3];
+    float e2[3];
+    float s[3];
+    for (size_t i = 0; i != 3; ++i)
+    {
+        e1[i] = b[i] - a[i];
+        e2[i] = c[i] - a[i];
+        s[i]  = o[i] - a[i];
+    }
+    auto cross = [](float const* x, float const* y, float* out) {
+        out[0] = x[1] * y[2] - x[2] * y[1];
+        out[1] = x[2] * y[0] - x[0] * y[2];
+        out[2] = x[0] * y[1] - x[1] * y[0];
+    };
+    auto dot = [](float const* x, float const* y) {
+        return x[0] * y[0] + x[1] * y[1] + x[2] * y[2];
+    };
+
+    float p[3];
+    float q[3];
+    cross(d, e2, p);
+    cross(s, e1, q);
+    float det = dot(e1, p);
+    float u   = dot(s, p) / det;
+    float v   = dot(d, q) / det;
+    float t   = dot(e2, q) / det;
+    if (std::abs(det) < 1e-8f || u < 0.f || v < 0.f || u + v > 1.f || t < 0.f)
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+    return t;
+}
+} // namespace
+
+TEST_CASE("ray-triangle")
+{
+    float v[6][3] = {{-1.f, -1.f, 0.f},
+                     {1.f, -1.f, 0.f},
+                     {1.f, 1.f, 0.f},
+                     {-1.f, 1.f, 0.f},
+                     {0.f, 0.f, 2.f},
+                     {2.f, 0.f, -1.f}};
+    point vertices[6];
+    for (size_t i = 0; i != 6; ++i)
+    {
+        vertices[i] = point{v[i][0], v[i][1], v[i][2]};
+    }
+    // A unit quad in the xy-plane, a slanted triangle above it, and one
+    // facing the other way below it
+    uint32_t indices[4][3] = {{0, 1, 2}, {0, 2, 3}, {1, 4, 2}, {5, 3, 0}};
+    triangle_record records[4];
+    prepare_triangles(vertices, &indices[0][0], 4, records);
+
+    constexpr size_t count = 23;
+    point origins[count];
+    line rays[count];
+    float o[count][3];
+    float d[count][3];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float t = static_cast<float>(i);
+        o[i][0] = 1.5f * std::sin(t * 0.7f);
+        o[i][1] = 1.5f * std::cos(t * 1.3f);
+        o[i][2] = i % 3 == 0 ? -3.f : 3.f;
+        d[i][0] = 0.2f * std::cos(t);
+        d[i][1] = 0.1f * std::sin(t * 2.f);
+        d[i][2] = i % 3 == 0 ? 1.f : -1.f;
+        if (i % 5 == 4)
+        {
+            // Pointing away from every triangle
+            d[i][2] = -d[i][2];
+        }
+
+        point target{o[i][0] + d[i][0], o[i][1] + d[i][1], o[i][2] + d[i][2]};
+        origins[i] = point{o[i][0], o[i][1], o[i][2]};
+        rays[i]    = origins[i] & target;
+    }
+
+    ray_hit hits[count];
+    intersect(records, 4, origins, rays, hits, count);
+
+    size_t hit_count = 0;
+    for (size_t i = 0; i != count; ++i)
+    {
+        float best       = std::numeric_limits<float>::infinity();
+        uint32_t nearest = ray_hit::miss;
+        for (uint32_t k = 0; k != 4; ++k)
+        {
+            float t = moller_trumbore(o[i],
+                                      d[i],
+                                      v[indices[k][0]],
+                                      v[indices[k][1]],
+                                      v[indices[k][2]]);
+            if (t < best)
+            {
+                best    = t;
+                nearest = k;
+            }
+        }
+
+        CHECK_EQ(hits[i].triangle, nearest);
+        if (nearest != ray_hit::miss)
+        {
+            ++hit_count;
+            float length = std::sqrt(
+                d[i][0] * d[i][0] + d[i][1] * d[i][1] + d[i][2] * d[i][2]);
+            CHECK_EQ(hits[i].distance,
+                     doctest::Approx(best * length).epsilon(1e-5f));
+        }
+        else
+        {
+            CHECK(std::isinf(hits[i].distance));
+        }
+    }
+    CHECK_GT(hit_count, 0u);
+    CHECK_LT(hit_count, count);
+}
+
+TEST_CASE("bvh")
+{
+    // A soup of small triangles scattered through a box, with a cluster of
+    // coincident ones
+    constexpr size_t triangle_count = 211;
+    point vertices[3 * triangle_count];
+    uint32_t indices[3 * triangle_count];
+    for (size_t i = 0; i != triangle_count; ++i)
+    {
+        float t = static_cast<float>(i % 200);
+        float c[3]
+            = {4.f * std::sin(t * 1.37f), 3.f * std::cos(t * 0.61f), t * 0.05f};
+        for (size_t k = 0; k != 3; ++k)
+        {
+            float s             = static_cast<float>(k);
+            indices[3 * i + k]  = static_cast<uint32_t>(3 * i + k);
+            vertices[3 * i + k] = point{c[0] + 0.4f * std::cos(t + s * 2.1f),
+                                        c[1] + 0.4f * std::sin(t * 0.3f + s),
+                                        c[2] + 0.3f * std::sin(t + s * 1.7f)};
+        }
+    }
+
+    triangle_record records[triangle_count];
+    prepare_triangles(vertices, indices, triangle_count, records);
+    bounding_box boxes[triangle_count];
+    triangle_bounds(vertices, indices, triangle_count, boxes);
+
+    bvh_node nodes[bvh::node_capacity(triangle_count)];
+    uint32_t order[triangle_count];
+    bvh tree{boxes, triangle_count, nodes, order};
+    CHECK_GT(tree.node_count(), 1u);
+    CHECK_LE(tree.node_count(), bvh::node_capacity(triangle_count));
+
+    // Every primitive appears in exactly one leaf, whose bounds contain it
+    size_t seen[triangle_count] = {};
+    for (size_t i = 0; i != tree.node_count(); ++i)
+    {
+        bvh_node const& node = nodes[i];
+        if (!node.is_leaf())
+        {
+            continue;
+        }
+        for (uint32_t k = 0; k != node.count; ++k)
+        {
+            uint32_t primitive = order[node.offset + k];
+            ++seen[primitive];
+            for (size_t j = 0; j != 3; ++j)
+            {
+                CHECK_LE(node.min[j], boxes[primitive].min[j]);
+                CHECK_GE(node.max[j], boxes[primitive].max[j]);
+            }
+        }
+    }
+    for (size_t i = 0; i != triangle_count; ++i)
+    {
+        CHECK_EQ(seen[i], 1u);
+    }
+
+    constexpr size_t ray_count = 29;
+    point origins[ray_count];
+    line rays[ray_count];
+    for (size_t i = 0; i != ray_count; ++i)
+    {
+        float t = static_cast<float>(i);
+        point target{6.f, 2.f * std::sin(t), 10.f * std::cos(t * 0.4f)};
+        origins[i] = point{-6.f, 0.3f * t - 4.f, 5.f - 0.2f * t};
+        rays[i]    = origins[i] & target;
+    }
+
+    ray_hit expected[ray_count];
+    ray_hit hits[ray_count];
+    intersect(records, triangle_count, origins, rays, expected, ray_count);
+    tree.intersect(records, origins, rays, hits, ray_count);
+    size_t hit_count = 0;
+    for (size_t i = 0; i != ray_count; ++i)
+    {
+        CHECK_EQ(hits[i].triangle, expected[i].triangle);
+        if (expected[i].triangle != ray_hit::miss)
+        {
+            ++hit_count;
+            CHECK_EQ(hits[i].distance, expected[i].distance);
+        }
+    }
+    CHECK_GT(hit_count, 0u);
+
+    // Point queries against the primitive bounds
+    constexpr size_t point_count = 13;
+    point points[point_count];
+    for (size_t i = 0; i != point_count; ++i)
+    {
+        points[i] = vertices[17 * i];
+    }
+    size_t found[point_count] = {};
+    tree.query(points, point_count, [&](size_t i, uint32_t primitive) {
+        ++found[i];
+        float p[3] = {points[i].x(), points[i].y(), points[i].z()};
+        for (size_t j = 0; j != 3; ++j)
+        {
+            CHECK_LE(boxes[primitive].min[j], p[j]);
+            CHECK_GE(boxes[primitive].max[j], p[j]);
+        }
+    });
+    for (size_t i = 0; i != point_count; ++i)
+    {
+        size_t containing = 0;
+        float p[3]        = {points[i].x(), points[i].y(), points[i].z()};
+        for (size_t k = 0; k != triangle_count; ++k)
+        {
+            bool inside = true;
+            for (size_t j = 0; j != 3; ++j)
+            {
+                inside = inside && boxes[k].min[j] <= p[j]
+                         && p[j] <= boxes[k].max[j];
+            }
+            containing += inside ? 1 : 0;
+        }
+        CHECK_GE(found[i], 1u);
+        CHECK_EQ(found[i], containing);
+    }
+
+    // Visibility against a box
+    plane frustum[4] = {{1.f, 0.f, 0.f, 1.f},
+                        {-1.f, 0.f, 0.f, 2.f},
+                        {0.f, 1.f, 0.f, 0.5f},
+                        {0.f, 0.f, -1.f, 6.f}};
+    plane_set planes{frustum, 4};
+    bool visible[triangle_count] = {};
+    size_t visible_count         = 0;
+    tree.cull(planes, [&](uint32_t primitive) {
+        CHECK(!visible[primitive]);
+        visible[primitive] = true;
+        ++visible_count;
+    });
+    for (size_t i = 0; i != triangle_count; ++i)
+    {
+        bool outside = false;
+        for (size_t k = 0; k != 4; ++k)
+        {
+            plane p = planes[k];
+            float d = 0.f;
+            for (size_t corner = 0; corner != 8; ++corner)
+            {
+                point c{corner & 1 ? boxes[i].max[0] : boxes[i].min[0],
+                        corner & 2 ? boxes[i].max[1] : boxes[i].min[1],
+                        corner & 4 ? boxes[i].max[2] : boxes[i].min[2]};
+                float dc = (p ^ c).e0123();
+                d        = corner == 0 ? dc : std::max(d, dc);
+            }
+            outside = outside || d < 0.f;
+        }
+        CHECK_EQ(visible[i], !outside);
+    }
+    CHECK_GT(visible_count, 0u);
+    CHECK_LT(visible_count, triangle_count);
+}
+
+TEST_CASE("bvh-axis-aligned-rays")
+{
+    // Two triangles with an edge on the plane y = 0, which is also the lower
+    // y bound of their boxes, and a third one off the axis
+    point vertices[9] = {{5.f, 0.f, -1.f},
+                         {5.f, 2.f, 0.f},
+                         {5.f, 0.f, 1.f},
+                         {8.f, 0.f, -1.f},
+                         {8.f, 1.f, 1.f},
+                         {8.f, 0.f, 1.f},
+                         {-3.f, 4.f, 4.f},
+                         {-3.f, 5.f, 4.f},
+                         {-3.f, 4.f, 5.f}};
+    uint32_t indices[9] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    triangle_record records[3];
+    prepare_triangles(vertices, indices, 3, records);
+    bounding_box boxes[3];
+    triangle_bounds(vertices, indices, 3, boxes);
+
+    bvh_node nodes[bvh::node_capacity(3)];
+    uint32_t order[3];
+    bvh tree{boxes, 3, nodes, order};
+
+    // Rays along the x axis from origins on the plane y = 0 graze the boxes
+    // of the first two triangles, and have no y or z component
+    constexpr size_t ray_count = 5;
+    point origins[ray_count]   = {{0.f, 0.f, 0.f},
+                                {10.f, 0.f, 0.f},
+                                {0.f, 0.5f, 0.f},
+                                {6.f, 0.f, 0.5f},
+                                {0.f, 0.f, 3.f}};
+    point targets[ray_count]   = {{1.f, 0.f, 0.f},
+                                {9.f, 0.f, 0.f},
+                                {1.f, 0.5f, 0.f},
+                                {7.f, 0.f, 0.5f},
+                                {1.f, 0.f, 3.f}};
+    line rays[ray_count];
+    for (size_t i = 0; i != ray_count; ++i)
+    {
+        rays[i] = origins[i] & targets[i];
+    }
+
+    ray_hit expected[ray_count];
+    ray_hit hits[ray_count];
+    intersect(records, 3, origins, rays, expected, ray_count);
+    tree.intersect(records, origins, rays, hits, ray_count);
+    CHECK_EQ(expected[0].triangle, 0u);
+    CHECK_EQ(expected[1].triangle, 1u);
+    CHECK_EQ(expected[2].triangle, 0u);
+    CHECK_EQ(expected[3].triangle, 1u);
+    CHECK_EQ(expected[4].triangle, ray_hit::miss);
+    for (size_t i = 0; i != ray_count; ++i)
+    {
+        CHECK_EQ(hits[i].triangle, expected[i].triangle);
+        if (expected[i].triangle != ray_hit::miss)
+        {
+            CHECK_EQ(hits[i].distance, expected[i].distance);
+        }
+    }
+}
@@ -17,4 +17,75 @@ TEST_CASE("rcp_nr1")
     CHECK_EQ(buf[1], doctest::Approx(0.5f));
     CHECK_EQ(buf[2], doctest::Approx(1.f / 3.f));
     CHECK_EQ(buf[3], doctest::Approx(0.25f));
-}
\ No newline at end of file
+}
+
+TEST_CASE("precision")
+{
+    __m128 a = _mm_set_ps(16.f, 9.f, 2.f, 0.25f);
+    float fast[4];
+    float refined[4];
+    float exact[4];
+
+    SUBCASE("reciprocal")
+    {
+        _mm_storeu_ps(fast, detail::reciprocal<precision::fast>(a));
+        _mm_storeu_ps(refined, detail::reciprocal<precision::refined>(a));
+        _mm_storeu_ps(exact, detail::reciprocal<precision::exact>(a));
+
+        float expected[4] = {4.f, 0.5f, 1.f / 9.f, 1.f / 16.f};
+        for (size_t i = 0; i != 4; ++i)
+        {
+            CHECK_EQ(fast[i], doctest::Approx(expected[i]).epsilon(1e-3));
+            CHECK_EQ(refined[i], doctest::Approx(expected[i]).epsilon(1e-6));
+            CHECK_EQ(exact[i], expected[i]);
+        }
+    }
+
+    SUBCASE("reciprocal-sqrt")
+    {
+        _mm_storeu_ps(fast, detail::reciprocal_sqrt<precision::fast>(a));
+        _mm_storeu_ps(refined,
+                      detail::reciprocal_sqrt<precision::refined>(a));
+        _mm_storeu_ps(exact, detail::reciprocal_sqrt<precision::exact>(a));
+
+        float expected[4] = {2.f, 1.f / std::sqrt(2.f), 1.f / 3.f, 0.25f};
+        for (size_t i = 0; i != 4; ++i)
+        {
+            CHECK_EQ(fast[i], doctest::Approx(expected[i]).epsilon(1e-3));
+            CHECK_EQ(refined[i], doctest::Approx(expected[i]).epsilon(1e-6));
+            CHECK_EQ(exact[i], doctest::Approx(expected[i]).epsilon(1e-7));
+        }
+    }
+
+    SUBCASE("square-root")
+    {
+        _mm_storeu_ps(fast, detail::square_root<precision::fast>(a));
+        _mm_storeu_ps(refined, detail::square_root<precision::refined>(a));
+        _mm_storeu_ps(exact, detail::square_root<precision::exact>(a));
+
+        float expected[4] = {0.5f, std::sqrt(2.f), 3.f, 4.f};
+        for (size_t i = 0; i != 4; ++i)
+        {
+            CHECK_EQ(fast[i], doctest::Approx(expected[i]).epsilon(1e-3));
+            CHECK_EQ(refined[i], doctest::Approx(expected[i]).epsilon(1e-6));
+            CHECK_EQ(exact[i], expected[i]);
+        }
+    }
+
+    SUBCASE("normalize")
+    {
+        motor m{1.f, 4.f, 3.f, 2.f, 5.f, 6.f, 7.f, 8.f};
+        motor n = m.normalized<precision::exact>();
+        motor r = m.normalized<precision::fast>();
+        motor i = m.inverse<precision::exact>();
+        CHECK_EQ((n * ~n).scalar(), doctest::Approx(1.f).epsilon(1e-7));
+        CHECK_EQ((n * ~n).e0123(), doctest::Approx(0.f).epsilon(1e-6));
+        CHECK_EQ((r * ~r).scalar(), doctest::Approx(1.f).epsilon(1e-3));
+        CHECK_EQ((m * i).scalar(), doctest::Approx(1.f).epsilon(1e-6));
+
+        // All four coefficients of a plane scale with its norm
+        plane p = plane{0.f, 0.f, 2.f, 4.f}.normalized<precision::exact>();
+        CHECK_EQ(p.z(), 1.f);
+        CHECK_EQ(p.d(), 2.f);
+    }
+}
@@ -223,6 +223,131 @@ TEST_CASE("motor-to-matrix-3x4")
     CHECK_EQ(buf[3], 1.f);
 }
 
+TEST_CASE("mat4x4-operations")
+{
+    motor m1 = translator{2.f, 1.f, 0.f, -1.f} * rotor{0.7f, 1.f, 2.f, 3.f};
+    motor m2 = translator{-1.f, 0.f, 1.f, 1.f} * rotor{-1.3f, 0.f, 1.f, 0.f};
+    mat4x4 a = m1.as_mat4x4();
+    mat4x4 b = m2.as_mat4x4();
+
+    mat4x4 t = a.transposed();
+    for (size_t i = 0; i != 4; ++i)
+    {
+        for (size_t j = 0; j != 4; ++j)
+        {
+            CHECK_EQ(t.data[4 * i + j], a.data[4 * j + i]);
+        }
+    }
+
+    mat4x4 ab       = a * b;
+    mat4x4 expected = (m1 * m2).as_mat4x4();
+    for (size_t i = 0; i != 16; ++i)
+    {
+        CHECK_EQ(ab.data[i], doctest::Approx(expected.data[i]));
+    }
+
+    // Non-uniform scale to exercise the general affine inverse
+    mat4x4 s;
+    s.cols[0] = _mm_set_ps(0.f, 0.f, 0.f, 2.f);
+    s.cols[1] = _mm_set_ps(0.f, 0.f, 0.5f, 0.f);
+    s.cols[2] = _mm_set_ps(0.f, 3.f, 0.f, 0.f);
+    s.cols[3] = _mm_set_ps(1.f, 0.f, 0.f, 0.f);
+    mat4x4 as = a * s;
+    mat4x4 id = as.affine_inverse() * as;
+    for (size_t i = 0; i != 4; ++i)
+    {
+        for (size_t j = 0; j != 4; ++j)
+        {
+            CHECK_EQ(id.data[4 * i + j],
+                     doctest::Approx(i == j ? 1.f : 0.f).epsilon(1e-5f));
+        }
+    }
+
+    constexpr size_t count = 5;
+    point points[count];
+    point out[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float f   = static_cast<float>(i);
+        points[i] = point{f, 1.f - f, 0.5f * f};
+    }
+    apply(a, points, out, count);
+    for (size_t i = 0; i != count; ++i)
+    {
+        point q = m1(points[i]);
+        CHECK_EQ(out[i].w(), doctest::Approx(q.w()));
+        CHECK_EQ(out[i].x(), doctest::Approx(q.x()));
+        CHECK_EQ(out[i].y(), doctest::Approx(q.y()));
+        CHECK_EQ(out[i].z(), doctest::Approx(q.z()));
+    }
+}
+
+TEST_CASE("matrix-to-motor")
+{
+    // Rotations near pi about each axis exercise every branch of the rotor
+    // extraction
+    constexpr size_t count = 11;
+    motor motors[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float t   = static_cast<float>(i);
+        float ang = i % 2 == 0 ? 3.1f : 0.4f * t;
+        float x   = i % 3 == 0 ? 1.f : 0.1f;
+        float y   = i % 3 == 1 ? 1.f : 0.2f;
+        float z   = i % 3 == 2 ? 1.f : -0.1f;
+        motors[i] = translator{t, 1.f, -t, 0.5f} * rotor{ang, x, y, z};
+    }
+
+    mat3x4 mat3[count];
+    mat4x4 mat4[count];
+    float packed[count * 12];
+    as_mat3x4(motors, mat3, count);
+    as_mat4x4(motors, mat4, count);
+    as_packed3x4(motors, packed, count);
+
+    motor from3[count];
+    motor from4[count];
+    motor from_packed[count];
+    from_mat3x4(mat3, from3, count);
+    from_mat4x4(mat4, from4, count);
+    from_packed3x4(packed, from_packed, count);
+
+    point p{1.f, -2.f, 0.5f};
+    for (size_t i = 0; i != count; ++i)
+    {
+        mat3x4 expected3 = motors[i].as_mat3x4();
+        mat4x4 expected4 = motors[i].as_mat4x4();
+        for (size_t j = 0; j != 16; ++j)
+        {
+            CHECK_EQ(mat3[i].data[j], doctest::Approx(expected3.data[j]));
+            CHECK_EQ(mat4[i].data[j], doctest::Approx(expected4.data[j]));
+        }
+        for (size_t r = 0; r != 3; ++r)
+        {
+            for (size_t c = 0; c != 4; ++c)
+            {
+                CHECK_EQ(packed[12 * i + 4 * r + c],
+                         doctest::Approx(expected3.data[4 * c + r]));
+            }
+        }
+
+        motor single = motor::from_mat3x4(expected3);
+        point q      = motors[i](p);
+        for (motor const& m : {single, from3[i], from4[i], from_packed[i]})
+        {
+            CHECK_EQ(m.scalar() * m.scalar() + m.e23() * m.e23()
+                         + m.e31() * m.e31() + m.e12() * m.e12(),
+                     doctest::Approx(1.f));
+            point r = m(p);
+            CHECK_EQ(r.x(), doctest::Approx(q.x()));
+            CHECK_EQ(r.y(), doctest::Approx(q.y()));
+            CHECK_EQ(r.z(), doctest::Approx(q.z()));
+        }
+        CHECK_EQ(from3[i].scalar(), doctest::Approx(single.scalar()));
+        CHECK_EQ(from3[i].e0123(), doctest::Approx(single.e0123()));
+    }
+}
+
 TEST_CASE("normalize-motor")
 {
     motor m{1.f, 4.f, 3.f, 2.f, 5.f, 6.f, 7.f, 8.f};
@@ -270,4 +395,459 @@ TEST_CASE("normalize-rotor")
     CHECK_EQ(norm.e12(), doctest::Approx(0.f));
     CHECK_EQ(norm.e31(), doctest::Approx(0.f));
     CHECK_EQ(norm.e23(), doctest::Approx(0.f));
-}
\ No newline at end of file
+}
+
+TEST_CASE("motor-variadic")
+{
+    // The variadic routines may take a different code path from the single
+    // entity routines (e.g. two entities per register with AVX2). An odd count
+    // exercises the remainder handling as well.
+    motor m{M_PI * 0.5f, 3.f, line{3.f, 1.f, 2.f, 4.f, -2.f, 1.f}.normalized()};
+
+    point points[5];
+    plane planes[5];
+    line lines[5];
+    direction directions[5];
+    for (int i = 0; i != 5; ++i)
+    {
+        float f       = static_cast<float>(i);
+        points[i]     = point{f, 2.f - f, 1.f + 2.f * f};
+        planes[i]     = plane{1.f, f, -f, 3.f - f};
+        lines[i]      = line{f, 1.f, -2.f, 3.f - f, 2.f * f, 1.f};
+        directions[i] = direction{1.f + f, -f, 2.f};
+    }
+
+    point points_out[5];
+    plane planes_out[5];
+    line lines_out[5];
+    direction directions_out[5];
+    m(points, points_out, 5);
+    m(planes, planes_out, 5);
+    m(lines, lines_out, 5);
+    m(directions, directions_out, 5);
+
+    for (int i = 0; i != 5; ++i)
+    {
+        point p = m(points[i]);
+        CHECK_EQ(points_out[i].e123(), doctest::Approx(p.e123()));
+        CHECK_EQ(points_out[i].e032(), doctest::Approx(p.e032()));
+        CHECK_EQ(points_out[i].e013(), doctest::Approx(p.e013()));
+        CHECK_EQ(points_out[i].e021(), doctest::Approx(p.e021()));
+
+        plane q = m(planes[i]);
+        CHECK_EQ(planes_out[i].e0(), doctest::Approx(q.e0()));
+        CHECK_EQ(planes_out[i].e1(), doctest::Approx(q.e1()));
+        CHECK_EQ(planes_out[i].e2(), doctest::Approx(q.e2()));
+        CHECK_EQ(planes_out[i].e3(), doctest::Approx(q.e3()));
+
+        line l = m(lines[i]);
+        CHECK_EQ(lines_out[i].e01(), doctest::Approx(l.e01()));
+        CHECK_EQ(lines_out[i].e02(), doctest::Approx(l.e02()));
+        CHECK_EQ(lines_out[i].e03(), doctest::Approx(l.e03()));
+        CHECK_EQ(lines_out[i].e23(), doctest::Approx(l.e23()));
+        CHECK_EQ(lines_out[i].e31(), doctest::Approx(l.e31()));
+        CHECK_EQ(lines_out[i].e12(), doctest::Approx(l.e12()));
+
+        direction d = m(directions[i]);
+        CHECK_EQ(directions_out[i].x(), doctest::Approx(d.x()));
+        CHECK_EQ(directions_out[i].y(), doctest::Approx(d.y()));
+        CHECK_EQ(directions_out[i].z(), doctest::Approx(d.z()));
+    }
+}
+
+TEST_CASE("rotor-variadic")
+{
+    rotor r{M_PI * 0.5f, 1.f, 2.f, 3.f};
+
+    point points[3];
+    line lines[3];
+    for (int i = 0; i != 3; ++i)
+    {
+        float f   = static_cast<float>(i);
+        points[i] = point{f, 2.f - f, 1.f + 2.f * f};
+        lines[i]  = line{f, 1.f, -2.f, 3.f - f, 2.f * f, 1.f};
+    }
+
+    point points_out[3];
+    line lines_out[3];
+    r(points, points_out, 3);
+    r(lines, lines_out, 3);
+
+    for (int i = 0; i != 3; ++i)
+    {
+        point p = r(points[i]);
+        CHECK_EQ(points_out[i].x(), doctest::Approx(p.x()));
+        CHECK_EQ(points_out[i].y(), doctest::Approx(p.y()));
+        CHECK_EQ(points_out[i].z(), doctest::Approx(p.z()));
+
+        line l = r(lines[i]);
+        CHECK_EQ(lines_out[i].e01(), doctest::Approx(l.e01()));
+        CHECK_EQ(lines_out[i].e02(), doctest::Approx(l.e02()));
+        CHECK_EQ(lines_out[i].e03(), doctest::Approx(l.e03()));
+        CHECK_EQ(lines_out[i].e23(), doctest::Approx(l.e23()));
+        CHECK_EQ(lines_out[i].e31(), doctest::Approx(l.e31()));
+        CHECK_EQ(lines_out[i].e12(), doctest::Approx(l.e12()));
+    }
+}
+
+TEST_CASE("batch-transform")
+{
+    // 13 = 8 + 4 + 1 exercises every code path
+    constexpr size_t count = 13;
+    motor motors[count];
+    point points[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float f   = static_cast<float>(i);
+        motors[i] = rotor{0.2f * f, 1.f, -f, 2.f}
+                    * translator{1.f + f, 0.f, 1.f, -1.f};
+        points[i] = point{f, 2.f - f, 1.f + 2.f * f};
+    }
+
+    point out[count];
+    transform(motors, points, out, count);
+    for (size_t i = 0; i != count; ++i)
+    {
+        point p = motors[i](points[i]);
+        CHECK_EQ(out[i].w(), doctest::Approx(p.w()));
+        CHECK_EQ(out[i].x(), doctest::Approx(p.x()));
+        CHECK_EQ(out[i].y(), doctest::Approx(p.y()));
+        CHECK_EQ(out[i].z(), doctest::Approx(p.z()));
+    }
+
+    uint16_t index16[count];
+    uint32_t index32[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        index16[i] = static_cast<uint16_t>((i * 5) % 3);
+        index32[i] = static_cast<uint32_t>(count - 1 - i);
+    }
+
+    transform(motors, index16, points, out, count);
+    for (size_t i = 0; i != count; ++i)
+    {
+        point p = motors[index16[i]](points[i]);
+        CHECK_EQ(out[i].x(), doctest::Approx(p.x()));
+        CHECK_EQ(out[i].y(), doctest::Approx(p.y()));
+        CHECK_EQ(out[i].z(), doctest::Approx(p.z()));
+    }
+
+    // In place
+    for (size_t i = 0; i != count; ++i)
+    {
+        out[i] = points[i];
+    }
+    transform(motors, index32, out, out, count);
+    for (size_t i = 0; i != count; ++i)
+    {
+        point p = motors[index32[i]](points[i]);
+        CHECK_EQ(out[i].x(), doctest::Approx(p.x()));
+        CHECK_EQ(out[i].y(), doctest::Approx(p.y()));
+        CHECK_EQ(out[i].z(), doctest::Approx(p.z()));
+    }
+}
+
+TEST_CASE("non-temporal")
+{
+    // The non-temporal forms must match the regular ones (up to the
+    // contraction of products and sums the compiler may apply to either). 13
+    // entities exercise the remainder handling of every kernel width.
+    constexpr size_t count = 13;
+    motor m{M_PI * 0.5f, 3.f, line{3.f, 1.f, 2.f, 4.f, -2.f, 1.f}.normalized()};
+    rotor r{M_PI * 0.25f, 1.f, -2.f, 3.f};
+
+    motor motors[count];
+    uint16_t index[count];
+    point points[count];
+    plane planes[count];
+    line lines[count];
+    direction directions[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float f       = static_cast<float>(i);
+        motors[i]     = m * rotor{0.1f * f, 1.f, f, -1.f};
+        index[i]      = static_cast<uint16_t>((i * 5) % count);
+        points[i]     = point{f, 2.f - f, 1.f + 2.f * f};
+        planes[i]     = plane{1.f, f, -f, 3.f - f};
+        lines[i]      = line{f, 1.f, -2.f, 3.f - f, 2.f * f, 1.f};
+        directions[i] = direction{1.f + f, -f, 2.f};
+    }
+
+    point points_out[count];
+    point points_nt[count];
+    plane planes_out[count];
+    plane planes_nt[count];
+    line lines_out[count];
+    line lines_nt[count];
+    direction directions_out[count];
+    direction directions_nt[count];
+
+    auto check_points = [&] {
+        for (size_t i = 0; i != count; ++i)
+        {
+            CHECK_EQ(points_nt[i].w(), doctest::Approx(points_out[i].w()));
+            CHECK_EQ(points_nt[i].x(), doctest::Approx(points_out[i].x()));
+            CHECK_EQ(points_nt[i].y(), doctest::Approx(points_out[i].y()));
+            CHECK_EQ(points_nt[i].z(), doctest::Approx(points_out[i].z()));
+        }
+    };
+    auto check_others = [&] {
+        for (size_t i = 0; i != count; ++i)
+        {
+            CHECK_EQ(planes_nt[i].e0(), doctest::Approx(planes_out[i].e0()));
+            CHECK_EQ(planes_nt[i].e1(), doctest::Approx(planes_out[i].e1()));
+            CHECK_EQ(planes_nt[i].e3(), doctest::Approx(planes_out[i].e3()));
+            CHECK_EQ(lines_nt[i].e01(), doctest::Approx(lines_out[i].e01()));
+            CHECK_EQ(lines_nt[i].e03(), doctest::Approx(lines_out[i].e03()));
+            CHECK_EQ(lines_nt[i].e23(), doctest::Approx(lines_out[i].e23()));
+            CHECK_EQ(lines_nt[i].e12(), doctest::Approx(lines_out[i].e12()));
+            CHECK_EQ(directions_nt[i].x(),
+                     doctest::Approx(directions_out[i].x()));
+            CHECK_EQ(directions_nt[i].z(),
+                     doctest::Approx(directions_out[i].z()));
+        }
+    };
+
+    SUBCASE("motor")
+    {
+        m(points, points_out, count);
+        m(points, points_nt, count, non_temporal{});
+        m(planes, planes_out, count);
+        m(planes, planes_nt, count, non_temporal{});
+        m(lines, lines_out, count);
+        m(lines, lines_nt, count, non_temporal{});
+        m(directions, directions_out, count);
+        m(directions, directions_nt, count, non_temporal{});
+        check_points();
+        check_others();
+
+        // In place
+        m(lines, lines, count, non_temporal{});
+        CHECK_EQ(lines[count - 1].e02(),
+                 doctest::Approx(lines_out[count - 1].e02()));
+    }
+
+    SUBCASE("rotor")
+    {
+        r(points, points_out, count);
+        r(points, points_nt, count, non_temporal{});
+        r(planes, planes_out, count);
+        r(planes, planes_nt, count, non_temporal{});
+        r(lines, lines_out, count);
+        r(lines, lines_nt, count, non_temporal{});
+        r(directions, directions_out, count);
+        r(directions, directions_nt, count, non_temporal{});
+        check_points();
+        check_others();
+    }
+
+    SUBCASE("transform")
+    {
+        transform(motors, points, points_out, count);
+        transform(motors, points, points_nt, count, non_temporal{});
+        check_points();
+
+        transform(motors, index, points, points_out, count);
+        transform(motors, index, points, points_nt, count, non_temporal{});
+        check_points();
+    }
+}
+
+TEST_CASE("skinning")
+{
+    constexpr size_t joint_count = 5;
+    motor joints[joint_count];
+    for (size_t j = 0; j != joint_count; ++j)
+    {
+        float f   = static_cast<float>(j);
+        joints[j] = rotor{0.3f * f, 1.f, 0.5f, -f}
+                    * translator{0.5f * f, 1.f, 0.f, 1.f};
+    }
+    // Represent one joint with the opposite sign to exercise the hemisphere
+    // check
+    joints[3] = -joints[3];
+
+    // 13 = 8 + 4 + 1 exercises every code path
+    constexpr size_t count = 13;
+    uint16_t indices[4 * count];
+    float weights[4 * count];
+    point positions[count];
+    direction normals[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float f = static_cast<float>(i);
+        for (size_t k = 0; k != 4; ++k)
+        {
+            indices[4 * i + k]
+                = static_cast<uint16_t>((i + 2 * k) % joint_count);
+        }
+        weights[4 * i]     = 0.5f;
+        weights[4 * i + 1] = 0.25f;
+        weights[4 * i + 2] = i % 2 == 0 ? 0.25f : 0.f;
+        weights[4 * i + 3] = i % 2 == 0 ? 0.f : 0.25f;
+        positions[i]       = point{f, 1.f - f, 2.f};
+        normals[i]         = direction{0.f, 1.f, f};
+    }
+
+    point out_positions[count];
+    direction out_normals[count];
+    skin(joints,
+         indices,
+         weights,
+         positions,
+         normals,
+         out_positions,
+         out_normals,
+         count);
+
+    point out_only[count];
+    skin(joints, indices, weights, positions, out_only, count);
+
+    for (size_t i = 0; i != count; ++i)
+    {
+        motor first = joints[indices[4 * i]];
+        motor m     = first * weights[4 * i];
+        for (size_t k = 1; k != 4; ++k)
+        {
+            motor b = joints[indices[4 * i + k]];
+            float d = first.scalar() * b.scalar() + first.e23() * b.e23()
+                      + first.e31() * b.e31() + first.e12() * b.e12();
+            m += b * (d < 0.f ? -weights[4 * i + k] : weights[4 * i + k]);
+        }
+        m.normalize();
+
+        point p     = m(positions[i]);
+        direction n = m(normals[i]);
+        CHECK_EQ(out_positions[i].x(), doctest::Approx(p.x()));
+        CHECK_EQ(out_positions[i].y(), doctest::Approx(p.y()));
+        CHECK_EQ(out_positions[i].z(), doctest::Approx(p.z()));
+        CHECK_EQ(out_only[i].x(), doctest::Approx(p.x()));
+        CHECK_EQ(out_normals[i].x(), doctest::Approx(n.x()));
+        CHECK_EQ(out_normals[i].y(), doctest::Approx(n.y()));
+        CHECK_EQ(out_normals[i].z(), doctest::Approx(n.z()));
+    }
+
+    // A vertex bound to a single joint moves rigidly with it
+    uint16_t single_index[4] = {3, 0, 0, 0};
+    float single_weight[4]   = {1.f, 0.f, 0.f, 0.f};
+    point single;
+    skin(joints, single_index, single_weight, positions, &single, 1);
+    point expected = joints[3](positions[0]);
+    CHECK_EQ(single.x(), doctest::Approx(expected.x()));
+    CHECK_EQ(single.y(), doctest::Approx(expected.y()));
+    CHECK_EQ(single.z(), doctest::Approx(expected.z()));
+}
+
+TEST_CASE("motor-chain")
+{
+    motor m1 = translator{1.f, 0.f, 1.f, 0.f} * rotor{0.6f, 1.f, 0.f, 1.f};
+    motor m2 = translator{-0.5f, 1.f, 1.f, 1.f} * rotor{1.2f, 0.f, 1.f, -1.f};
+    motor m3 = translator{2.f, 0.f, 0.f, 1.f} * rotor{-0.4f, 1.f, 2.f, 3.f};
+    motor m  = m3 * m2 * m1;
+
+    motor_chain chain = motor_chain{m3} * m2 * m1;
+    CHECK_EQ(chain.length(), 3u);
+    CHECK(chain.compose().approx_eq(m, 1e-6f));
+    motor identity{1.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+    CHECK(motor_chain{}.compose() == identity);
+
+    constexpr size_t count = 7;
+    point points[count];
+    plane planes[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float t   = static_cast<float>(i);
+        points[i] = point{t, 1.f - t, 0.5f * t};
+        planes[i] = plane{1.f, t, -2.f, 0.3f * t};
+    }
+
+    // Composed (batch) and direct (single entity) application
+    for (size_t n : {count, size_t{1}})
+    {
+        point out[count];
+        chain(points, out, n);
+        plane plane_out[count];
+        chain(planes, plane_out, n);
+        for (size_t i = 0; i != n; ++i)
+        {
+            point expected = m(points[i]);
+            CHECK_EQ(out[i].x(), doctest::Approx(expected.x()).epsilon(1e-5f));
+            CHECK_EQ(out[i].y(), doctest::Approx(expected.y()).epsilon(1e-5f));
+            CHECK_EQ(out[i].z(), doctest::Approx(expected.z()).epsilon(1e-5f));
+
+            plane e = m(planes[i]);
+            CHECK_EQ(plane_out[i].x(), doctest::Approx(e.x()).epsilon(1e-5f));
+            CHECK_EQ(plane_out[i].y(), doctest::Approx(e.y()).epsilon(1e-5f));
+            CHECK_EQ(plane_out[i].z(), doctest::Approx(e.z()).epsilon(1e-5f));
+            CHECK_EQ(plane_out[i].d(), doctest::Approx(e.d()).epsilon(1e-5f));
+        }
+    }
+
+    point single = chain(points[2]);
+    CHECK_EQ(single.x(), doctest::Approx(m(points[2]).x()).epsilon(1e-5f));
+
+    mat4x4 expected = m.as_mat4x4();
+    mat4x4 actual   = chain.as_mat4x4();
+    for (size_t i = 0; i != 16; ++i)
+    {
+        CHECK_EQ(actual.data[i], doctest::Approx(expected.data[i]));
+    }
+}
+
+TEST_CASE("prepared-motor")
+{
+    motor m = translator{1.5f, 0.f, 1.f, -1.f} * rotor{0.8f, 1.f, -2.f, 0.5f};
+    prepared_motor prepared{m};
+
+    constexpr size_t count = 5;
+    point points[count];
+    direction directions[count];
+    plane planes[count];
+    line lines[count];
+    for (size_t i = 0; i != count; ++i)
+    {
+        float t       = static_cast<float>(i);
+        points[i]     = point{t, 1.f - t, 0.5f * t};
+        directions[i] = direction{1.f, -t, 2.f};
+        planes[i]     = plane{1.f, t, -2.f, 0.3f * t};
+        lines[i]      = points[i] & point{2.f, t, -1.f};
+    }
+
+    point point_out[count];
+    direction direction_out[count];
+    plane plane_out[count];
+    line line_out[count];
+    prepared(points, point_out, count);
+    prepared(directions, direction_out, count);
+    prepared(planes, plane_out, count);
+    prepared(lines, line_out, count);
+
+    for (size_t i = 0; i != count; ++i)
+    {
+        point p = m(points[i]);
+        CHECK_EQ(point_out[i].w(), doctest::Approx(p.w()));
+        CHECK_EQ(point_out[i].x(), doctest::Approx(p.x()));
+        CHECK_EQ(point_out[i].y(), doctest::Approx(p.y()));
+        CHECK_EQ(point_out[i].z(), doctest::Approx(p.z()));
+        CHECK_EQ(prepared(points[i]).x(), point_out[i].x());
+
+        direction d = m(directions[i]);
+        CHECK_EQ(direction_out[i].x(), doctest::Approx(d.x()));
+        CHECK_EQ(direction_out[i].y(), doctest::Approx(d.y()));
+        CHECK_EQ(direction_out[i].z(), doctest::Approx(d.z()));
+
+        plane q = m(planes[i]);
+        CHECK_EQ(plane_out[i].x(), doctest::Approx(q.x()));
+        CHECK_EQ(plane_out[i].y(), doctest::Approx(q.y()));
+        CHECK_EQ(plane_out[i].z(), doctest::Approx(q.z()));
+        CHECK_EQ(plane_out[i].d(), doctest::Approx(q.d()));
+
+        line l = m(lines[i]);
+        CHECK_EQ(line_out[i].e01(), doctest::Approx(l.e01()));
+        CHECK_EQ(line_out[i].e02(), doctest::Approx(l.e02()));
+        CHECK_EQ(line_out[i].e03(), doctest::Approx(l.e03()));
+        CHECK_EQ(line_out[i].e23(), doctest::Approx(l.e23()));
+        CHECK_EQ(line_out[i].e31(), doctest::Approx(l.e31()));
+        CHECK_EQ(line_out[i].e12(), doctest::Approx(l.e12()));
+    }
+}
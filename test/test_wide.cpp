@@ -0,0 +1,322 @@
+#define _USE_MATH_DEFINES
+#include <doctest/doctest.h>
+
+#include <klein/klein.hpp>
+
+#ifdef KLN_ENABLE_ISE_AVX2
+#    include <klein/wide.hpp>
+
+#    include <cmath>
+
+using namespace kln;
+
+namespace
+{
+void check_lanes(__m128 expected, __m128 actual)
+{
+    float e[4];
+    float a[4];
+    _mm_storeu_ps(e, expected);
+    _mm_storeu_ps(a, actual);
+    for (size_t i = 0; i != 4; ++i)
+    {
+        CHECK_EQ(a[i], doctest::Approx(e[i]).epsilon(1e-4));
+    }
+}
+
+void check(point const& expected, point const& actual)
+{
+    check_lanes(expected.p3_, actual.p3_);
+}
+
+void check(plane const& expected, plane const& actual)
+{
+    check_lanes(expected.p0_, actual.p0_);
+}
+
+void check(line const& expected, line const& actual)
+{
+    check_lanes(expected.p1_, actual.p1_);
+    check_lanes(expected.p2_, actual.p2_);
+}
+
+void check(rotor const& expected, rotor const& actual)
+{
+    check_lanes(expected.p1_, actual.p1_);
+}
+
+void check(translator const& expected, translator const& actual)
+{
+    check_lanes(expected.p2_, actual.p2_);
+}
+
+void check(motor const& expected, motor const& actual)
+{
+    check_lanes(expected.p1_, actual.p1_);
+    check_lanes(expected.p2_, actual.p2_);
+}
+
+// Eight distinct entities of each type
+struct fixture
+{
+    fixture()
+    {
+        for (size_t i = 0; i != 8; ++i)
+        {
+            float f        = static_cast<float>(i);
+            planes[i]      = plane{1.f + f, -2.f + 0.5f * f, 0.3f, 4.f - f};
+            points[i]      = point{0.5f * f - 1.f, 2.f, -3.f + f};
+            lines[i]       = line{1.f, -2.f + f, 3.f, 0.4f + f, 5.f, -1.f - f};
+            rotors[i]      = rotor{0.3f + 0.4f * f, 1.f, -f, 2.f};
+            translators[i] = translator{1.f + f, 2.f, -1.f, 0.5f * f};
+            motors[i]      = rotors[i] * translators[(i + 3) % 8];
+        }
+    }
+
+    plane planes[8];
+    point points[8];
+    line lines[8];
+    rotor rotors[8];
+    translator translators[8];
+    motor motors[8];
+};
+} // namespace
+
+TEST_CASE_FIXTURE(fixture, "wide-pack-unpack")
+{
+    point_x8 p{points};
+    motor_x8 m{motors};
+    line_x8 l{lines};
+
+    CHECK_EQ(_mm256_cvtss_f32(p.x()), points[0].x());
+
+    point p_out[8];
+    motor m_out[8];
+    line l_out[8];
+    p.store(p_out);
+    m.store(m_out);
+    l.store(l_out);
+
+    for (size_t i = 0; i != 8; ++i)
+    {
+        check(points[i], p_out[i]);
+        check(motors[i], m_out[i]);
+        check(lines[i], l_out[i]);
+    }
+
+    plane_x8 broadcast{planes[5]};
+    plane b_out[8];
+    broadcast.store(b_out);
+    for (size_t i = 0; i != 8; ++i)
+    {
+        check(planes[5], b_out[i]);
+    }
+}
+
+TEST_CASE_FIXTURE(fixture, "wide-gp")
+{
+    plane_x8 p0{planes};
+    point_x8 p3{points};
+    line_x8 l{lines};
+    rotor_x8 r{rotors};
+    translator_x8 t{translators};
+    motor_x8 m{motors};
+
+    motor pp[8];
+    motor pq[8];
+    motor qp[8];
+    translator qq[8];
+    motor ll[8];
+    rotor rr[8];
+    motor rt[8];
+    motor tr[8];
+    motor rm[8];
+    motor mr[8];
+    motor tm[8];
+    motor mt[8];
+    motor mm[8];
+
+    (p0 * p0).store(pp);
+    (p0 * p3).store(pq);
+    (p3 * p0).store(qp);
+    (p3 * point_x8{points[2]}).store(qq);
+    (l * l).store(ll);
+    (r * r).store(rr);
+    (r * t).store(rt);
+    (t * r).store(tr);
+    (r * m).store(rm);
+    (m * r).store(mr);
+    (t * m).store(tm);
+    (m * t).store(mt);
+    (m * m).store(mm);
+
+    for (size_t i = 0; i != 8; ++i)
+    {
+        check(planes[i] * planes[i], pp[i]);
+        check(planes[i] * points[i], pq[i]);
+        check(points[i] * planes[i], qp[i]);
+        check(points[i] * points[2], qq[i]);
+        check(lines[i] * lines[i], ll[i]);
+        check(rotors[i] * rotors[i], rr[i]);
+        check(rotors[i] * translators[i], rt[i]);
+        check(translators[i] * rotors[i], tr[i]);
+        check(rotors[i] * motors[i], rm[i]);
+        check(motors[i] * rotors[i], mr[i]);
+        check(translators[i] * motors[i], tm[i]);
+        check(motors[i] * translators[i], mt[i]);
+        check(motors[i] * motors[i], mm[i]);
+    }
+}
+
+TEST_CASE_FIXTURE(fixture, "wide-sandwich")
+{
+    plane_x8 p0{planes};
+    point_x8 p3{points};
+    line_x8 l{lines};
+    rotor_x8 r{rotors};
+    translator_x8 t{translators};
+    motor_x8 m{motors};
+
+    plane m_p0[8];
+    point m_p3[8];
+    line m_l[8];
+    plane r_p0[8];
+    point r_p3[8];
+    line r_l[8];
+    plane t_p0[8];
+    point t_p3[8];
+    line t_l[8];
+
+    m(p0).store(m_p0);
+    m(p3).store(m_p3);
+    m(l).store(m_l);
+    r(p0).store(r_p0);
+    r(p3).store(r_p3);
+    r(l).store(r_l);
+    t(p0).store(t_p0);
+    t(p3).store(t_p3);
+    t(l).store(t_l);
+
+    for (size_t i = 0; i != 8; ++i)
+    {
+        check(motors[i](planes[i]), m_p0[i]);
+        check(motors[i](points[i]), m_p3[i]);
+        check(motors[i](lines[i]), m_l[i]);
+        check(rotors[i](planes[i]), r_p0[i]);
+        check(rotors[i](points[i]), r_p3[i]);
+        check(rotors[i](lines[i]), r_l[i]);
+        check(translators[i](planes[i]), t_p0[i]);
+        check(translators[i](points[i]), t_p3[i]);
+        check(translators[i](lines[i]), t_l[i]);
+    }
+}
+
+TEST_CASE_FIXTURE(fixture, "wide-normalize")
+{
+    motor unnormalized[8];
+    for (size_t i = 0; i != 8; ++i)
+    {
+        unnormalized[i] = motors[i] * (1.f + static_cast<float>(i));
+    }
+
+    motor m_out[8];
+    line l_out[8];
+    rotor r_out[8];
+    motor_x8{unnormalized}.normalized().store(m_out);
+    line_x8{lines}.normalized().store(l_out);
+    (rotor_x8{rotors} * rotor_x8{rotors[1]}).normalized().store(r_out);
+
+    for (size_t i = 0; i != 8; ++i)
+    {
+        check(unnormalized[i].normalized(), m_out[i]);
+        check(lines[i].normalized(), l_out[i]);
+        check((rotors[i] * rotors[1]).normalized(), r_out[i]);
+    }
+
+    // The AoS plane normalization leaves the distance unscaled so check the
+    // wide result by its defining property instead.
+    plane p_out[8];
+    plane_x8{planes}.normalized().store(p_out);
+    for (size_t i = 0; i != 8; ++i)
+    {
+        float x = p_out[i].x();
+        float y = p_out[i].y();
+        float z = p_out[i].z();
+        CHECK_EQ(x * x + y * y + z * z, doctest::Approx(1.f));
+        CHECK_EQ(p_out[i].d() * planes[i].x(),
+                 doctest::Approx(planes[i].d() * x));
+    }
+}
+
+TEST_CASE_FIXTURE(fixture, "wide-exp-log")
+{
+    motor_x8 m{motors};
+    line log_m[8];
+    motor exp_log_m[8];
+    log(m).store(log_m);
+    exp(log(m)).store(exp_log_m);
+
+    for (size_t i = 0; i != 8; ++i)
+    {
+        check(log(motors[i]), log_m[i]);
+        check(motors[i], exp_log_m[i]);
+    }
+
+    // Pure translations take the degenerate path in every lane
+    motor translations[8];
+    for (size_t i = 0; i != 8; ++i)
+    {
+        translations[i]     = motor{};
+        translations[i].p1_ = _mm_set_ss(1.f);
+        translations[i].p2_ = translators[i].p2_;
+    }
+    motor round_trip[8];
+    exp(log(motor_x8{translations})).store(round_trip);
+    for (size_t i = 0; i != 8; ++i)
+    {
+        check(translations[i], round_trip[i]);
+    }
+}
+
+TEST_CASE("wide-trig")
+{
+    float max_sin_error   = 0.f;
+    float max_cos_error   = 0.f;
+    float max_atan2_error = 0.f;
+
+    for (int i = -512; i != 512; i += 8)
+    {
+        float x[8];
+        float s[8];
+        float c[8];
+        float a[8];
+        for (int j = 0; j != 8; ++j)
+        {
+            x[j] = static_cast<float>(i + j) * 0.0125f;
+        }
+
+        __m256 xv = _mm256_loadu_ps(x);
+        __m256 sv;
+        __m256 cv;
+        detail::soa::sincos(xv, sv, cv);
+        _mm256_storeu_ps(s, sv);
+        _mm256_storeu_ps(c, cv);
+        _mm256_storeu_ps(a, detail::soa::atan2(sv, cv));
+
+        for (int j = 0; j != 8; ++j)
+        {
+            float angle = std::atan2(std::sin(x[j]), std::cos(x[j]));
+            max_sin_error
+                = std::fmax(max_sin_error, std::fabs(s[j] - std::sin(x[j])));
+            max_cos_error
+                = std::fmax(max_cos_error, std::fabs(c[j] - std::cos(x[j])));
+            max_atan2_error
+                = std::fmax(max_atan2_error, std::fabs(a[j] - angle));
+        }
+    }
+
+    CHECK_LT(max_sin_error, 1e-6f);
+    CHECK_LT(max_cos_error, 1e-6f);
+    CHECK_LT(max_atan2_error, 2e-6f);
+}
+#endif